@@ -0,0 +1,309 @@
+/*!
+ * \file      CayenneLppCompact.c
+ *
+ * \brief     Implements a schema driven compact encoding of Cayenne LPP data
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2018 Semtech
+ *
+ * \endcode
+ */
+#include <stddef.h>
+
+#include "utilities.h"
+#include "CayenneLppCompact.h"
+
+/*!
+ * Payload header size in bits
+ */
+#define CAYENNE_LPP_COMPACT_HEADER_BITS             8
+
+/*!
+ * Number of value bits per variable length group
+ */
+#define CAYENNE_LPP_COMPACT_GROUP_BITS              3
+
+/*!
+ * Counts the values of a schema
+ *
+ * \retval nbValues Number of values, 0 if the schema is invalid
+ */
+static uint8_t GetNbValues( const CayenneLppCompactChannel_t *channels, uint8_t nbChannels )
+{
+    uint16_t nbValues = 0;
+
+    if( channels == NULL )
+    {
+        return 0;
+    }
+    for( uint8_t i = 0; i < nbChannels; i++ )
+    {
+        if( ( channels[i].NbValues == 0 ) || ( channels[i].Bits == 0 ) || ( channels[i].Bits > 32 ) )
+        {
+            return 0;
+        }
+        nbValues += channels[i].NbValues;
+    }
+    if( nbValues > CAYENNE_LPP_COMPACT_MAX_VALUES )
+    {
+        return 0;
+    }
+    return ( uint8_t )nbValues;
+}
+
+/*!
+ * Writes the nbBits least significant bits of value, MSB first
+ *
+ * \retval status Returns false if the buffer is full
+ */
+static bool WriteBits( CayenneLppCompact_t *ctx, uint32_t value, uint8_t nbBits )
+{
+    if( ( ctx->BitCursor + nbBits ) > ( ( uint16_t )ctx->BufferSize * 8 ) )
+    {
+        return false;
+    }
+    while( nbBits-- > 0 )
+    {
+        uint8_t mask = 0x80 >> ( ctx->BitCursor & 0x07 );
+
+        if( ( ( value >> nbBits ) & 0x01 ) != 0 )
+        {
+            ctx->Buffer[ctx->BitCursor >> 3] |= mask;
+        }
+        else
+        {
+            ctx->Buffer[ctx->BitCursor >> 3] &= ~mask;
+        }
+        ctx->BitCursor++;
+    }
+    return true;
+}
+
+/*!
+ * Reads nbBits bits, MSB first
+ *
+ * \retval status Returns false at the end of the payload
+ */
+static bool ReadBits( CayenneLppCompact_t *ctx, uint32_t *value, uint8_t nbBits )
+{
+    if( ( ctx->BitCursor + nbBits ) > ( ( uint16_t )ctx->BufferSize * 8 ) )
+    {
+        return false;
+    }
+    *value = 0;
+    while( nbBits-- > 0 )
+    {
+        *value = ( *value << 1 ) | ( ( ctx->Buffer[ctx->BitCursor >> 3] >> ( 7 - ( ctx->BitCursor & 0x07 ) ) ) & 0x01 );
+        ctx->BitCursor++;
+    }
+    return true;
+}
+
+/*!
+ * Writes a difference with the variable length encoding
+ *
+ * \retval status Returns false if the buffer is full
+ */
+static bool WriteDelta( CayenneLppCompact_t *ctx, int32_t delta )
+{
+    // Zig-zag mapping keeps the small negative differences short
+    uint32_t value = ( ( uint32_t )delta << 1 ) ^ ( 0 - ( ( uint32_t )delta >> 31 ) );
+
+    do
+    {
+        uint32_t group = value & ( ( 1 << CAYENNE_LPP_COMPACT_GROUP_BITS ) - 1 );
+
+        value >>= CAYENNE_LPP_COMPACT_GROUP_BITS;
+        if( ( WriteBits( ctx, ( value != 0 ) ? 1 : 0, 1 ) == false ) ||
+            ( WriteBits( ctx, group, CAYENNE_LPP_COMPACT_GROUP_BITS ) == false ) )
+        {
+            return false;
+        }
+    } while( value != 0 );
+    return true;
+}
+
+/*!
+ * Reads a difference written by WriteDelta
+ *
+ * \retval status Returns false at the end of the payload or if the difference is malformed
+ */
+static bool ReadDelta( CayenneLppCompact_t *ctx, int32_t *delta )
+{
+    uint32_t value = 0;
+    uint32_t more = 0;
+    uint32_t group = 0;
+    uint8_t shift = 0;
+
+    do
+    {
+        if( ( shift >= 32 ) ||
+            ( ReadBits( ctx, &more, 1 ) == false ) ||
+            ( ReadBits( ctx, &group, CAYENNE_LPP_COMPACT_GROUP_BITS ) == false ) )
+        {
+            return false;
+        }
+        value |= group << shift;
+        shift += CAYENNE_LPP_COMPACT_GROUP_BITS;
+    } while( more != 0 );
+
+    *delta = ( int32_t )( ( value >> 1 ) ^ ( 0 - ( value & 0x01 ) ) );
+    return true;
+}
+
+bool CayenneLppCompactInit( CayenneLppCompact_t *ctx, const CayenneLppCompactChannel_t *channels, uint8_t nbChannels,
+                            uint8_t *buffer, uint8_t bufferSize )
+{
+    if( ( ctx == NULL ) || ( buffer == NULL ) || ( bufferSize == 0 ) ||
+        ( GetNbValues( channels, nbChannels ) == 0 ) )
+    {
+        return false;
+    }
+    ctx->Channels = channels;
+    ctx->NbChannels = nbChannels;
+    ctx->Buffer = buffer;
+    ctx->BufferSize = bufferSize;
+    CayenneLppCompactReset( ctx );
+    return true;
+}
+
+void CayenneLppCompactReset( CayenneLppCompact_t *ctx )
+{
+    ctx->NbSamples = 0;
+    ctx->Buffer[0] = 0;
+    ctx->BitCursor = CAYENNE_LPP_COMPACT_HEADER_BITS;
+}
+
+uint8_t CayenneLppCompactAddSample( CayenneLppCompact_t *ctx, const int32_t *values )
+{
+    int32_t previous[CAYENNE_LPP_COMPACT_MAX_VALUES];
+    uint16_t bitCursor = ctx->BitCursor;
+    uint8_t index = 0;
+    bool status = true;
+
+    if( ( values == NULL ) || ( ctx->NbSamples == UINT8_MAX ) )
+    {
+        return 0;
+    }
+    memcpy1( ( uint8_t* )previous, ( uint8_t* )ctx->Previous, sizeof( previous ) );
+
+    for( uint8_t i = 0; ( i < ctx->NbChannels ) && ( status == true ); i++ )
+    {
+        const CayenneLppCompactChannel_t *channel = &ctx->Channels[i];
+
+        for( uint8_t j = 0; ( j < channel->NbValues ) && ( status == true ); j++, index++ )
+        {
+            int32_t value = values[index];
+
+            if( channel->Bits < 32 )
+            {
+                // Verify the value fits the channel width
+                int32_t max = ( int32_t )( ( 1UL << ( channel->Bits - 1 ) ) - 1 );
+
+                if( ( value > max ) || ( value < ( -max - 1 ) ) )
+                {
+                    status = false;
+                    break;
+                }
+            }
+
+            if( ( channel->IsDelta == true ) && ( ctx->NbSamples > 0 ) )
+            {
+                // Unsigned arithmetic, the decoder wraps around the same way
+                status = WriteDelta( ctx, ( int32_t )( ( uint32_t )value - ( uint32_t )ctx->Previous[index] ) );
+            }
+            else
+            {
+                status = WriteBits( ctx, ( uint32_t )value & ( 0xFFFFFFFF >> ( 32 - channel->Bits ) ), channel->Bits );
+            }
+            ctx->Previous[index] = value;
+        }
+    }
+
+    if( status == false )
+    {
+        // Drop the partially encoded sample
+        ctx->BitCursor = bitCursor;
+        memcpy1( ( uint8_t* )ctx->Previous, ( uint8_t* )previous, sizeof( previous ) );
+        return 0;
+    }
+    ctx->Buffer[0] = ++ctx->NbSamples;
+    return CayenneLppCompactGetSize( ctx );
+}
+
+uint8_t CayenneLppCompactGetSize( CayenneLppCompact_t *ctx )
+{
+    return ( ctx->BitCursor + 7 ) >> 3;
+}
+
+bool CayenneLppCompactDecodeInit( CayenneLppCompact_t *ctx, const CayenneLppCompactChannel_t *channels, uint8_t nbChannels,
+                                  uint8_t *buffer, uint8_t size )
+{
+    if( ( ctx == NULL ) || ( buffer == NULL ) || ( size == 0 ) ||
+        ( GetNbValues( channels, nbChannels ) == 0 ) )
+    {
+        return false;
+    }
+    ctx->Channels = channels;
+    ctx->NbChannels = nbChannels;
+    ctx->Buffer = buffer;
+    ctx->BufferSize = size;
+    ctx->NbSamples = 0;
+    ctx->BitCursor = CAYENNE_LPP_COMPACT_HEADER_BITS;
+    return true;
+}
+
+bool CayenneLppCompactGetSample( CayenneLppCompact_t *ctx, int32_t *values )
+{
+    uint8_t index = 0;
+
+    if( ( values == NULL ) || ( ctx->NbSamples >= ctx->Buffer[0] ) )
+    {
+        return false;
+    }
+
+    for( uint8_t i = 0; i < ctx->NbChannels; i++ )
+    {
+        const CayenneLppCompactChannel_t *channel = &ctx->Channels[i];
+
+        for( uint8_t j = 0; j < channel->NbValues; j++, index++ )
+        {
+            if( ( channel->IsDelta == true ) && ( ctx->NbSamples > 0 ) )
+            {
+                int32_t delta;
+
+                if( ReadDelta( ctx, &delta ) == false )
+                {
+                    return false;
+                }
+                values[index] = ( int32_t )( ( uint32_t )ctx->Previous[index] + ( uint32_t )delta );
+            }
+            else
+            {
+                uint32_t value;
+
+                if( ReadBits( ctx, &value, channel->Bits ) == false )
+                {
+                    return false;
+                }
+                // Sign extension
+                if( ( channel->Bits < 32 ) && ( ( value >> ( channel->Bits - 1 ) ) != 0 ) )
+                {
+                    value |= 0xFFFFFFFF << channel->Bits;
+                }
+                values[index] = ( int32_t )value;
+            }
+            ctx->Previous[index] = values[index];
+        }
+    }
+    ctx->NbSamples++;
+    return true;
+}
@@ -0,0 +1,183 @@
+/*!
+ * \file      CayenneLppCompact.h
+ *
+ * \brief     Implements a schema driven compact encoding of Cayenne LPP data
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2018 Semtech
+ *
+ * \endcode
+ *
+ * \remark    Both ends share the channels schema, so the payload carries
+ *            neither the channels nor the data types.
+ *
+ *            Payload format:
+ *            - Byte 0: number of samples
+ *            - Bit stream, MSB first, of the samples values in the schema
+ *              order. The first sample of a payload is always encoded with
+ *              absolute values, Bits wide, two's complement. The next samples
+ *              encode the channels having IsDelta set as the difference to
+ *              the previous sample: zig-zag mapped, in 3 bits groups, least
+ *              significant group first, each group preceded by a continuation
+ *              bit.
+ *
+ *            Every payload can be decoded on its own.
+ *            The values are integers in the resolution of the LPP data type,
+ *            e.g. 0.1 degree Celsius for \ref LPP_TEMPERATURE.
+ */
+#ifndef __CAYENNE_LPP_COMPACT_H__
+#define __CAYENNE_LPP_COMPACT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * Maximum number of values of a sample, all channels included
+ */
+#define CAYENNE_LPP_COMPACT_MAX_VALUES              16
+
+/*!
+ * Schema of a channel
+ */
+typedef struct CayenneLppCompactChannel_s
+{
+    /*!
+     * LPP channel
+     */
+    uint8_t Channel;
+    /*!
+     * LPP data type. Refer to LPP_TEMPERATURE, LPP_GPS, ...
+     */
+    uint8_t Type;
+    /*!
+     * Number of values of the channel, e.g. 3 for LPP_ACCELEROMETER
+     */
+    uint8_t NbValues;
+    /*!
+     * Width of the absolute values [1:32]
+     */
+    uint8_t Bits;
+    /*!
+     * Set to true to encode the difference to the previous sample
+     */
+    bool IsDelta;
+}CayenneLppCompactChannel_t;
+
+/*!
+ * Encoding or decoding context
+ */
+typedef struct CayenneLppCompact_s
+{
+    /*!
+     * Channels schema
+     */
+    const CayenneLppCompactChannel_t *Channels;
+    /*!
+     * Number of channels of the schema
+     */
+    uint8_t NbChannels;
+    /*!
+     * Payload buffer
+     */
+    uint8_t *Buffer;
+    /*!
+     * Payload buffer size, or payload size when decoding
+     */
+    uint8_t BufferSize;
+    /*!
+     * Bit position of the next value
+     */
+    uint16_t BitCursor;
+    /*!
+     * Number of samples encoded or decoded
+     */
+    uint8_t NbSamples;
+    /*!
+     * Values of the previous sample
+     */
+    int32_t Previous[CAYENNE_LPP_COMPACT_MAX_VALUES];
+}CayenneLppCompact_t;
+
+/*!
+ * Initializes an encoding context and starts a new payload
+ *
+ * \param [IN] ctx        Context
+ * \param [IN] channels   Channels schema
+ * \param [IN] nbChannels Number of channels of the schema
+ * \param [IN] buffer     Payload buffer
+ * \param [IN] bufferSize Payload buffer size
+ *
+ * \retval status Returns false if the schema is invalid
+ */
+bool CayenneLppCompactInit( CayenneLppCompact_t *ctx, const CayenneLppCompactChannel_t *channels, uint8_t nbChannels,
+                            uint8_t *buffer, uint8_t bufferSize );
+
+/*!
+ * Starts a new payload
+ *
+ * \param [IN] ctx Context
+ */
+void CayenneLppCompactReset( CayenneLppCompact_t *ctx );
+
+/*!
+ * Encodes a sample
+ *
+ * \param [IN] ctx    Context
+ * \param [IN] values Values of all the channels, in the schema order
+ *
+ * \retval size Payload size, 0 if the sample does not fit in the buffer or
+ *              if a value does not fit its channel width
+ */
+uint8_t CayenneLppCompactAddSample( CayenneLppCompact_t *ctx, const int32_t *values );
+
+/*!
+ * Gets the payload size
+ *
+ * \param [IN] ctx Context
+ *
+ * \retval size Payload size
+ */
+uint8_t CayenneLppCompactGetSize( CayenneLppCompact_t *ctx );
+
+/*!
+ * Initializes a decoding context
+ *
+ * \param [IN] ctx        Context
+ * \param [IN] channels   Channels schema used by the encoder
+ * \param [IN] nbChannels Number of channels of the schema
+ * \param [IN] buffer     Payload
+ * \param [IN] size       Payload size
+ *
+ * \retval status Returns false if the schema or the payload is invalid
+ */
+bool CayenneLppCompactDecodeInit( CayenneLppCompact_t *ctx, const CayenneLppCompactChannel_t *channels, uint8_t nbChannels,
+                                  uint8_t *buffer, uint8_t size );
+
+/*!
+ * Decodes the next sample
+ *
+ * \param [IN]  ctx    Context
+ * \param [OUT] values Values of all the channels, in the schema order
+ *
+ * \retval status Returns false once all the samples are decoded or if the
+ *                payload is malformed
+ */
+bool CayenneLppCompactGetSample( CayenneLppCompact_t *ctx, int32_t *values );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CAYENNE_LPP_COMPACT_H__
@@ -0,0 +1,237 @@
+/*!
+ * \file      DeferredLog.c
+ *
+ * \brief     Deferred logging of the application messages
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2019 Semtech
+ *
+ * \endcode
+ */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "utilities.h"
+#include "DeferredLog.h"
+
+#if( ( DEFERRED_LOG_BUFFER_SIZE & ( DEFERRED_LOG_BUFFER_SIZE - 1 ) ) != 0 ) || ( DEFERRED_LOG_BUFFER_SIZE > 32768 )
+#error "DEFERRED_LOG_BUFFER_SIZE must be a power of 2, up to 32768"
+#endif
+
+/*!
+ * Record types of a HEX buffer and of a constant string. Other values give
+ * the number of arguments of a message record.
+ *
+ * Records layout:
+ * - Message: type ( 1 byte ), format string address, arguments ( 4 bytes each )
+ * - HEX buffer: type ( 1 byte ), size ( 1 byte ), data
+ * - Constant string: type ( 1 byte ), string address
+ */
+#define DEFERRED_LOG_RECORD_HEX                     0xFF
+#define DEFERRED_LOG_RECORD_STRING                  0xFE
+
+/*!
+ * Ring buffer
+ */
+static volatile uint8_t LogBuffer[DEFERRED_LOG_BUFFER_SIZE];
+
+/*!
+ * Free running write index, only updated by the writer
+ */
+static volatile uint16_t LogHead = 0;
+
+/*!
+ * Free running read index, only updated by \ref DeferredLogProcess
+ */
+static volatile uint16_t LogTail = 0;
+
+/*!
+ * Number of dropped records
+ */
+static volatile uint32_t LogDropCount = 0;
+
+/*!
+ * Number of dropped records already reported
+ */
+static uint32_t LogDropCountReported = 0;
+
+/*!
+ * Reserves room for a record
+ *
+ * \retval status Returns false and counts the record as dropped if the ring
+ *                is full
+ */
+static bool LogReserve( uint16_t size )
+{
+    if( ( uint16_t )( DEFERRED_LOG_BUFFER_SIZE - ( uint16_t )( LogHead - LogTail ) ) < size )
+    {
+        LogDropCount++;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * Copies data to the ring at the given free running index
+ */
+static void LogCopyTo( uint16_t index, const uint8_t* src, uint16_t size )
+{
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        LogBuffer[( uint16_t )( index + i ) & ( DEFERRED_LOG_BUFFER_SIZE - 1 )] = src[i];
+    }
+}
+
+/*!
+ * Copies data from the ring at the given free running index
+ */
+static void LogCopyFrom( uint16_t index, uint8_t* dst, uint16_t size )
+{
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        dst[i] = LogBuffer[( uint16_t )( index + i ) & ( DEFERRED_LOG_BUFFER_SIZE - 1 )];
+    }
+}
+
+void DeferredLogWrite( uint8_t nbArgs, const char* format, ... )
+{
+    uint32_t args[DEFERRED_LOG_MAX_ARGS];
+    uint16_t head = LogHead;
+    va_list ap;
+
+    if( nbArgs > DEFERRED_LOG_MAX_ARGS )
+    {
+        nbArgs = DEFERRED_LOG_MAX_ARGS;
+    }
+    if( LogReserve( 1 + sizeof( format ) + ( nbArgs * sizeof( uint32_t ) ) ) == false )
+    {
+        return;
+    }
+
+    // Only integer conversions are allowed, the arguments are promoted to int
+    va_start( ap, format );
+    for( uint8_t i = 0; i < nbArgs; i++ )
+    {
+        args[i] = ( uint32_t )va_arg( ap, int );
+    }
+    va_end( ap );
+
+    LogCopyTo( head, &nbArgs, 1 );
+    LogCopyTo( head + 1, ( const uint8_t* )&format, sizeof( format ) );
+    LogCopyTo( head + 1 + sizeof( format ), ( const uint8_t* )args, nbArgs * sizeof( uint32_t ) );
+
+    // Publish the record
+    LogHead = head + 1 + sizeof( format ) + ( nbArgs * sizeof( uint32_t ) );
+}
+
+void DeferredLogWriteHex( const uint8_t* buffer, uint8_t size )
+{
+    uint8_t header[2] = { DEFERRED_LOG_RECORD_HEX, size };
+    uint16_t head = LogHead;
+
+    if( LogReserve( sizeof( header ) + size ) == false )
+    {
+        return;
+    }
+
+    LogCopyTo( head, header, sizeof( header ) );
+    LogCopyTo( head + sizeof( header ), buffer, size );
+
+    // Publish the record
+    LogHead = head + sizeof( header ) + size;
+}
+
+void DeferredLogWriteString( const char* string )
+{
+    uint8_t type = DEFERRED_LOG_RECORD_STRING;
+    uint16_t head = LogHead;
+
+    if( LogReserve( 1 + sizeof( string ) ) == false )
+    {
+        return;
+    }
+
+    LogCopyTo( head, &type, 1 );
+    LogCopyTo( head + 1, ( const uint8_t* )&string, sizeof( string ) );
+
+    // Publish the record
+    LogHead = head + 1 + sizeof( string );
+}
+
+void DeferredLogProcess( void )
+{
+    uint16_t tail = LogTail;
+
+    while( tail != LogHead )
+    {
+        uint8_t type;
+
+        LogCopyFrom( tail, &type, 1 );
+        tail++;
+
+        if( type == DEFERRED_LOG_RECORD_HEX )
+        {
+            uint8_t size;
+
+            LogCopyFrom( tail, &size, 1 );
+            tail++;
+            for( uint8_t i = 0; i < size; i++ )
+            {
+                uint8_t data;
+
+                LogCopyFrom( tail + i, &data, 1 );
+                printf( "%02X ", data );
+                if( ( ( ( i + 1 ) % 16 ) == 0 ) && ( ( i + 1 ) < size ) )
+                {
+                    printf( "\n" );
+                }
+            }
+            printf( "\n" );
+            tail += size;
+        }
+        else if( type == DEFERRED_LOG_RECORD_STRING )
+        {
+            const char* string;
+
+            LogCopyFrom( tail, ( uint8_t* )&string, sizeof( string ) );
+            tail += sizeof( string );
+
+            printf( "%s", string );
+        }
+        else
+        {
+            uint32_t args[DEFERRED_LOG_MAX_ARGS] = { 0 };
+            const char* format;
+
+            LogCopyFrom( tail, ( uint8_t* )&format, sizeof( format ) );
+            tail += sizeof( format );
+            LogCopyFrom( tail, ( uint8_t* )args, type * sizeof( uint32_t ) );
+            tail += type * sizeof( uint32_t );
+
+            printf( format, args[0], args[1], args[2], args[3] );
+        }
+
+        // Release the record
+        LogTail = tail;
+    }
+
+    if( LogDropCount != LogDropCountReported )
+    {
+        LogDropCountReported = LogDropCount;
+        printf( "\n###### ===== LOG: %8lu DROPPED ===== ######\n", ( unsigned long )LogDropCountReported );
+    }
+}
+
+uint32_t DeferredLogGetDropCount( void )
+{
+    return LogDropCount;
+}
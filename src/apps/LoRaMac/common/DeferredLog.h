@@ -0,0 +1,174 @@
+/*!
+ * \file      DeferredLog.h
+ *
+ * \brief     Deferred logging of the application messages
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2019 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The LOG_* macros store a binary record ( format string address
+ *            and arguments ) into a ring buffer. Nothing is formatted nor
+ *            sent over the UART at this time. \ref DeferredLogProcess formats
+ *            and prints the records, it must be called when the timing does
+ *            not matter, e.g. by the main loop while the MAC is idle.
+ *
+ *            - The format string must be a string literal or a constant.
+ *            - At most DEFERRED_LOG_MAX_ARGS arguments are allowed. Only the
+ *              integer conversions ( %c, %d, %i, %u, %x, %X ) are allowed:
+ *              the arguments are read as int and stored on 32 bits. The
+ *              uint32_t and int32_t arguments use the inttypes.h PRIu32,
+ *              PRIX32 and PRId32 macros. Strings, pointers and floating point
+ *              values are not supported, \ref DEFERRED_LOG_STRING stores a
+ *              constant string instead.
+ *            - Records are written by the main context and read by
+ *              \ref DeferredLogProcess. The ring is lock-free for this single
+ *              producer and single consumer.
+ *            - A record which doesn't fit in the ring is dropped and counted.
+ *
+ *            The messages above DEFERRED_LOG_LEVEL are removed at compile time.
+ */
+#ifndef __DEFERRED_LOG_H__
+#define __DEFERRED_LOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Log levels
+ */
+#define DEFERRED_LOG_LEVEL_NONE                     0
+#define DEFERRED_LOG_LEVEL_ERROR                    1
+#define DEFERRED_LOG_LEVEL_WARNING                  2
+#define DEFERRED_LOG_LEVEL_INFO                     3
+#define DEFERRED_LOG_LEVEL_DEBUG                    4
+
+/*!
+ * Highest level of the messages kept at compile time
+ */
+#ifndef DEFERRED_LOG_LEVEL
+#define DEFERRED_LOG_LEVEL                          DEFERRED_LOG_LEVEL_DEBUG
+#endif
+
+/*!
+ * Ring buffer size. Must be a power of 2
+ */
+#ifndef DEFERRED_LOG_BUFFER_SIZE
+#define DEFERRED_LOG_BUFFER_SIZE                    1024
+#endif
+
+/*!
+ * Maximum number of arguments of a message
+ */
+#define DEFERRED_LOG_MAX_ARGS                       4
+
+/*!
+ * Counts the arguments following the format string
+ */
+#define DEFERRED_LOG_NB_ARGS( ... )                 DEFERRED_LOG_NB_ARGS_( __VA_ARGS__, 4, 3, 2, 1, 0, 0 )
+#define DEFERRED_LOG_NB_ARGS_( format, a1, a2, a3, a4, n, ... ) n
+
+/*!
+ * Stores a message if its level is kept at compile time
+ */
+#define DEFERRED_LOG( level, ... )                                                  \
+    do                                                                              \
+    {                                                                               \
+        if( ( level ) <= DEFERRED_LOG_LEVEL )                                       \
+        {                                                                           \
+            DeferredLogWrite( DEFERRED_LOG_NB_ARGS( __VA_ARGS__ ), __VA_ARGS__ );   \
+        }                                                                           \
+    } while( 0 )
+
+/*!
+ * Stores a buffer to be printed in HEX if its level is kept at compile time
+ */
+#define DEFERRED_LOG_HEX( level, buffer, size )                                     \
+    do                                                                              \
+    {                                                                               \
+        if( ( level ) <= DEFERRED_LOG_LEVEL )                                       \
+        {                                                                           \
+            DeferredLogWriteHex( buffer, size );                                    \
+        }                                                                           \
+    } while( 0 )
+
+/*!
+ * Stores a constant string to be printed as is if its level is kept at
+ * compile time
+ */
+#define DEFERRED_LOG_STRING( level, string )                                        \
+    do                                                                              \
+    {                                                                               \
+        if( ( level ) <= DEFERRED_LOG_LEVEL )                                       \
+        {                                                                           \
+            DeferredLogWriteString( string );                                       \
+        }                                                                           \
+    } while( 0 )
+
+#define LOG_ERROR( ... )                            DEFERRED_LOG( DEFERRED_LOG_LEVEL_ERROR, __VA_ARGS__ )
+#define LOG_WARNING( ... )                          DEFERRED_LOG( DEFERRED_LOG_LEVEL_WARNING, __VA_ARGS__ )
+#define LOG_INFO( ... )                             DEFERRED_LOG( DEFERRED_LOG_LEVEL_INFO, __VA_ARGS__ )
+#define LOG_DEBUG( ... )                            DEFERRED_LOG( DEFERRED_LOG_LEVEL_DEBUG, __VA_ARGS__ )
+#define LOG_HEX_INFO( buffer, size )                DEFERRED_LOG_HEX( DEFERRED_LOG_LEVEL_INFO, buffer, size )
+#define LOG_HEX_DEBUG( buffer, size )               DEFERRED_LOG_HEX( DEFERRED_LOG_LEVEL_DEBUG, buffer, size )
+#define LOG_STRING_INFO( string )                   DEFERRED_LOG_STRING( DEFERRED_LOG_LEVEL_INFO, string )
+#define LOG_STRING_DEBUG( string )                  DEFERRED_LOG_STRING( DEFERRED_LOG_LEVEL_DEBUG, string )
+
+/*!
+ * \brief Stores a message. Use the LOG_* macros instead.
+ *
+ * \param [IN] nbArgs Number of arguments following the format string
+ * \param [IN] format printf format string, with integer conversions only
+ */
+#if defined( __GNUC__ )
+void DeferredLogWrite( uint8_t nbArgs, const char* format, ... ) __attribute__( ( format( printf, 2, 3 ) ) );
+#else
+void DeferredLogWrite( uint8_t nbArgs, const char* format, ... );
+#endif
+
+/*!
+ * \brief Stores a copy of a buffer to be printed in HEX. Use the LOG_HEX_*
+ *        macros instead.
+ *
+ * \param [IN] buffer Buffer to be printed
+ * \param [IN] size   Buffer size to be printed
+ */
+void DeferredLogWriteHex( const uint8_t* buffer, uint8_t size );
+
+/*!
+ * \brief Stores the address of a constant string to be printed as is. Use
+ *        the LOG_STRING_* macros instead.
+ *
+ * \param [IN] string String literal or constant string
+ */
+void DeferredLogWriteString( const char* string );
+
+/*!
+ * \brief Formats and prints all the stored messages
+ */
+void DeferredLogProcess( void );
+
+/*!
+ * \brief Gets the number of messages dropped because the ring was full
+ *
+ * \retval count Number of dropped messages
+ */
+uint32_t DeferredLogGetDropCount( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DEFERRED_LOG_H__
@@ -51,6 +51,32 @@ static CommissioningParams_t CommissioningParams =
 
 static LmhPackage_t *LmHandlerPackages[PKG_MAX_NUMBER];
 
+/*!
+ * Package identifier value of the FPorts not handled by any package
+ */
+#define PKG_ID_NONE                                 0xFF
+
+/*!
+ * FPort to registered package identifier lookup table.
+ * Used to dispatch the received data to its package only.
+ */
+static uint8_t LmHandlerPortPackageIds[UINT8_MAX + 1];
+
+/*!
+ * Bit mask of the registered packages monitoring every MCPS indication
+ */
+static uint8_t LmHandlerPackagesMonitorMask = 0;
+
+/*!
+ * Bit mask of the packages having signaled \ref LMH_PACKAGE_EVENT_PROCESS
+ */
+static volatile uint8_t LmHandlerPackagesProcessMask = 0;
+
+/*!
+ * Bit mask of the packages having signaled \ref LMH_PACKAGE_EVENT_TX_PENDING
+ */
+static volatile uint8_t LmHandlerPackagesTxPendingMask = 0;
+
 /*!
  * Upper layer LoRaMac parameters
  */
@@ -146,6 +172,96 @@ static TimerTime_t DutyCycleWaitTime = 0;
  */
 static bool IsUplinkTxPending = false;
 
+/*!
+ * Priority of the uplinks queued while the MAC is busy
+ */
+#ifndef LM_HANDLER_MCPS_QUEUE_PRIORITY
+#define LM_HANDLER_MCPS_QUEUE_PRIORITY              0
+#endif
+
+/*!
+ * Number of ports the uplink aggregation accumulates records for at once.
+ * 0 compiles the aggregation out.
+ */
+#ifndef LM_HANDLER_AGGREGATE_NB_PORTS
+#define LM_HANDLER_AGGREGATE_NB_PORTS               0
+#endif
+
+#if( LM_HANDLER_AGGREGATE_NB_PORTS > 0 )
+/*!
+ * Maximum aggregated payload size
+ */
+#ifndef LM_HANDLER_AGGREGATE_BUFFER_SIZE
+#define LM_HANDLER_AGGREGATE_BUFFER_SIZE            242
+#endif
+
+/*!
+ * Records aggregated for one port
+ */
+typedef struct LmHandlerAggregate_s
+{
+    /*!
+     * Uplink port
+     */
+    uint8_t Port;
+    /*!
+     * Aggregated payload size. 0 when no record is aggregated
+     */
+    uint8_t Size;
+    /*!
+     * Set to true, if the uplink must be sent as soon as possible
+     */
+    bool IsSendPending;
+    /*!
+     * Reference time of the deadline
+     */
+    TimerTime_t DeadlineStart;
+    /*!
+     * Earliest deadline of the aggregated records [ms]
+     */
+    uint32_t Deadline;
+    /*!
+     * Aggregated [size][record] pairs
+     */
+    uint8_t Buffer[LM_HANDLER_AGGREGATE_BUFFER_SIZE];
+}LmHandlerAggregate_t;
+
+/*!
+ * Uplink aggregation contexts
+ */
+static LmHandlerAggregate_t LmHandlerAggregates[LM_HANDLER_AGGREGATE_NB_PORTS];
+
+/*!
+ * Wakes up the application when the earliest aggregation deadline expires
+ */
+static TimerEvent_t AggregateTimer;
+
+/*!
+ * Sends the aggregated records fitting the current datarate
+ *
+ * \param [IN] aggregate Aggregation context
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if an uplink has been
+ *                scheduled else \ref LORAMAC_HANDLER_ERROR
+ */
+static LmHandlerErrorStatus_t LmHandlerAggregateSend( LmHandlerAggregate_t *aggregate );
+
+/*!
+ * Sends the pending and expired aggregated uplinks
+ */
+static void LmHandlerAggregateProcess( void );
+
+/*!
+ * Restarts the aggregation timer on the earliest deadline
+ */
+static void LmHandlerAggregateTimerUpdate( void );
+
+/*!
+ * Function executed on aggregation timer event
+ */
+static void OnAggregateTimerEvent( void* context );
+#endif
+
 /*!
  * \brief   MCPS-Confirm event function
  *
@@ -236,10 +352,28 @@ typedef enum PackageNotifyTypes_e
  */
 static void LmHandlerPackagesNotify( PackageNotifyTypes_t notifyType, void *params );
 
+/*!
+ * Notifies the packages of a MCPS indication.
+ *
+ * \remark The monitoring packages are notified first. Then the received data
+ *         is only dispatched to the package registered on the FPort.
+ *
+ * \param[IN] mcpsIndication MCPS indication primitive data
+ */
+static void LmHandlerPackagesNotifyMcpsIndication( McpsIndication_t *mcpsIndication );
+
 static bool LmHandlerPackageIsTxPending( void );
 
 static void LmHandlerPackagesProcess( void );
 
+/*!
+ * Records the events signaled by a package
+ *
+ * \param [IN] port   Package port
+ * \param [IN] events Pending events bit mask. Refer to \ref LmhPackageEvents_t
+ */
+static void LmHandlerPackageEventNotify( uint8_t port, uint8_t events );
+
 LmHandlerErrorStatus_t LmHandlerInit( LmHandlerCallbacks_t *handlerCallbacks,
                                       LmHandlerParams_t *handlerParams )
 {
@@ -261,6 +395,16 @@ LmHandlerErrorStatus_t LmHandlerInit( LmHandlerCallbacks_t *handlerCallbacks,
     IsClassBSwitchPending = false;
     IsUplinkTxPending = false;
 
+#if( LM_HANDLER_AGGREGATE_NB_PORTS > 0 )
+    memset1( ( uint8_t* )LmHandlerAggregates, 0, sizeof( LmHandlerAggregates ) );
+    TimerInit( &AggregateTimer, OnAggregateTimerEvent );
+#endif
+
+    memset1( LmHandlerPortPackageIds, PKG_ID_NONE, sizeof( LmHandlerPortPackageIds ) );
+    LmHandlerPackagesMonitorMask = 0;
+    LmHandlerPackagesProcessMask = 0;
+    LmHandlerPackagesTxPendingMask = 0;
+
     if( LoRaMacInitialization( &LoRaMacPrimitives, &LoRaMacCallbacks, LmHandlerParams->Region ) != LORAMAC_STATUS_OK )
     {
         return LORAMAC_HANDLER_ERROR;
@@ -375,6 +519,7 @@ bool LmHandlerIsBusy( void )
 void LmHandlerProcess( void )
 {
     uint16_t size = 0;
+    bool isStorePending = false;
 
     // Process Radio IRQ
     if( Radio.IrqProcess != NULL )
@@ -386,15 +531,25 @@ void LmHandlerProcess( void )
     LoRaMacProcess( );
 
     // Store to NVM if required
+    isStorePending = NvmDataMgmtIsStorePending( );
     size = NvmDataMgmtStore( );
 
-    if( size > 0 )
+    // A split store is also complete when its writes failed
+    if( ( size > 0 ) || ( ( isStorePending == true ) && ( NvmDataMgmtIsStorePending( ) == false ) ) )
     {
         if( LmHandlerCallbacks->OnNvmDataChange != NULL )
         {
             LmHandlerCallbacks->OnNvmDataChange( LORAMAC_HANDLER_NVM_STORE, size );
         }
     }
+    else if( NvmDataMgmtIsStorePending( ) == true )
+    {
+        // Keep the application awake until the staged NVM groups are written
+        if( LmHandlerCallbacks->OnMacProcess != NULL )
+        {
+            LmHandlerCallbacks->OnMacProcess( );
+        }
+    }
 
     // Call all packages process functions
     LmHandlerPackagesProcess( );
@@ -406,6 +561,11 @@ void LmHandlerProcess( void )
         return;
     }
 
+#if( LM_HANDLER_AGGREGATE_NB_PORTS > 0 )
+    // Send the expired aggregated uplinks. They also serve a MAC layer scheduled uplink.
+    LmHandlerAggregateProcess( );
+#endif
+
     // If a MAC layer scheduled uplink is still pending try to send it.
     if( IsUplinkTxPending == true )
     {
@@ -424,6 +584,232 @@ void LmHandlerProcess( void )
     }
 }
 
+#if( LM_HANDLER_AGGREGATE_NB_PORTS > 0 )
+static void OnAggregateTimerEvent( void* context )
+{
+    TimerStop( &AggregateTimer );
+
+    // Wake up the application. The expired uplinks are sent by LmHandlerProcess
+    if( LmHandlerCallbacks->OnMacProcess != NULL )
+    {
+        LmHandlerCallbacks->OnMacProcess( );
+    }
+}
+
+static uint8_t LmHandlerAggregateGetMaxSize( LoRaMacTxInfo_t *txInfo )
+{
+    uint8_t maxSize = 0;
+
+    if( LoRaMacQueryTxPossible( 0, txInfo ) == LORAMAC_STATUS_OK )
+    {
+        maxSize = txInfo->MaxPossibleApplicationDataSize;
+    }
+    return MIN( maxSize, LM_HANDLER_AGGREGATE_BUFFER_SIZE );
+}
+
+static LmHandlerErrorStatus_t LmHandlerAggregateSend( LmHandlerAggregate_t *aggregate )
+{
+    LoRaMacTxInfo_t txInfo = { 0 };
+    uint8_t maxSize = LmHandlerAggregateGetMaxSize( &txInfo );
+    uint8_t size = 0;
+    LmHandlerAppData_t appData =
+    {
+        .Buffer = aggregate->Buffer,
+        .BufferSize = 0,
+        .Port = aggregate->Port,
+    };
+
+    aggregate->IsSendPending = true;
+    if( LmHandlerJoinStatus( ) != LORAMAC_HANDLER_SET )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    // Send the leading records fitting the current datarate. The others wait for the next uplink.
+    while( ( size < aggregate->Size ) && ( ( size + 1 + aggregate->Buffer[size] ) <= maxSize ) )
+    {
+        size += 1 + aggregate->Buffer[size];
+    }
+    if( size == 0 )
+    {
+        // The first record is kept until it fits. The datarate may have decreased since its aggregation.
+        if( ( 1 + aggregate->Buffer[0] ) <= txInfo.CurrentPossiblePayloadSize )
+        {
+            // The pending MAC commands leave no room for the first record. Send them alone.
+            appData.Buffer = NULL;
+            appData.Port = 0;
+            LmHandlerSend( &appData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+        }
+        return LORAMAC_HANDLER_ERROR;
+    }
+    appData.BufferSize = size;
+
+    // LmHandlerSend replaces a payload which does not fit by an empty frame. Keep the records in this case.
+    if( ( LoRaMacQueryTxPossible( size, &txInfo ) != LORAMAC_STATUS_OK ) ||
+        ( LmHandlerSend( &appData, LmHandlerParams->IsTxConfirmed ) != LORAMAC_HANDLER_SUCCESS ) )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    // The MAC layer holds a copy of the payload
+    aggregate->Size -= size;
+    memcpy1( aggregate->Buffer, aggregate->Buffer + size, aggregate->Size );
+    aggregate->IsSendPending = ( aggregate->Size > 0 );
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
+static void LmHandlerAggregateTimerUpdate( void )
+{
+    uint32_t earliest = UINT32_MAX;
+
+    for( uint8_t i = 0; i < LM_HANDLER_AGGREGATE_NB_PORTS; i++ )
+    {
+        LmHandlerAggregate_t *aggregate = &LmHandlerAggregates[i];
+        TimerTime_t elapsed = TimerGetElapsedTime( aggregate->DeadlineStart );
+
+        if( ( aggregate->Size > 0 ) && ( aggregate->IsSendPending == false ) )
+        {
+            earliest = MIN( earliest, ( elapsed < aggregate->Deadline ) ? ( aggregate->Deadline - elapsed ) : 1 );
+        }
+    }
+
+    TimerStop( &AggregateTimer );
+    if( earliest != UINT32_MAX )
+    {
+        TimerSetValue( &AggregateTimer, earliest );
+        TimerStart( &AggregateTimer );
+    }
+}
+
+static void LmHandlerAggregateProcess( void )
+{
+    for( uint8_t i = 0; i < LM_HANDLER_AGGREGATE_NB_PORTS; i++ )
+    {
+        LmHandlerAggregate_t *aggregate = &LmHandlerAggregates[i];
+
+        if( aggregate->Size == 0 )
+        {
+            continue;
+        }
+        if( ( aggregate->IsSendPending == true ) ||
+            ( TimerGetElapsedTime( aggregate->DeadlineStart ) >= aggregate->Deadline ) )
+        {
+            LmHandlerAggregateSend( aggregate );
+        }
+    }
+    LmHandlerAggregateTimerUpdate( );
+}
+
+LmHandlerErrorStatus_t LmHandlerAggregate( LmHandlerAppData_t *appData, uint32_t deadline, bool isUrgent )
+{
+    LmHandlerAggregate_t *aggregate = NULL;
+    LoRaMacTxInfo_t txInfo = { 0 };
+    uint8_t maxSize = LmHandlerAggregateGetMaxSize( &txInfo );
+
+    // A record must fit alone in an uplink of the current datarate
+    if( ( appData == NULL ) || ( appData->Buffer == NULL ) || ( appData->BufferSize == 0 ) ||
+        ( ( 1 + appData->BufferSize ) > MIN( txInfo.CurrentPossiblePayloadSize, LM_HANDLER_AGGREGATE_BUFFER_SIZE ) ) ||
+        ( appData->Port == 0 ) || ( appData->Port >= LORAMAC_CERT_FPORT ) )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    // Aggregate on the port uplink or on a free context
+    for( uint8_t i = 0; i < LM_HANDLER_AGGREGATE_NB_PORTS; i++ )
+    {
+        if( ( LmHandlerAggregates[i].Size > 0 ) && ( LmHandlerAggregates[i].Port == appData->Port ) )
+        {
+            aggregate = &LmHandlerAggregates[i];
+            break;
+        }
+        if( ( LmHandlerAggregates[i].Size == 0 ) && ( aggregate == NULL ) )
+        {
+            aggregate = &LmHandlerAggregates[i];
+        }
+    }
+    if( aggregate == NULL )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    // Send the current uplink when the record does not fit in anymore
+    if( ( aggregate->Size > 0 ) && ( ( aggregate->Size + 1 + appData->BufferSize ) > maxSize ) )
+    {
+        LmHandlerAggregateSend( aggregate );
+    }
+    if( ( aggregate->Size + 1 + appData->BufferSize ) > LM_HANDLER_AGGREGATE_BUFFER_SIZE )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    if( aggregate->Size == 0 )
+    {
+        aggregate->Port = appData->Port;
+        aggregate->IsSendPending = false;
+        aggregate->DeadlineStart = TimerGetCurrentTime( );
+        aggregate->Deadline = deadline;
+    }
+    else
+    {
+        TimerTime_t elapsed = TimerGetElapsedTime( aggregate->DeadlineStart );
+
+        if( ( elapsed < aggregate->Deadline ) && ( deadline < ( aggregate->Deadline - elapsed ) ) )
+        {
+            aggregate->DeadlineStart = TimerGetCurrentTime( );
+            aggregate->Deadline = deadline;
+        }
+    }
+
+    aggregate->Buffer[aggregate->Size++] = appData->BufferSize;
+    memcpy1( aggregate->Buffer + aggregate->Size, appData->Buffer, appData->BufferSize );
+    aggregate->Size += appData->BufferSize;
+
+    if( isUrgent == true )
+    {
+        LmHandlerAggregateSend( aggregate );
+    }
+    LmHandlerAggregateTimerUpdate( );
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
+void LmHandlerAggregateFlush( void )
+{
+    for( uint8_t i = 0; i < LM_HANDLER_AGGREGATE_NB_PORTS; i++ )
+    {
+        if( LmHandlerAggregates[i].Size > 0 )
+        {
+            LmHandlerAggregateSend( &LmHandlerAggregates[i] );
+        }
+    }
+    LmHandlerAggregateTimerUpdate( );
+}
+#else
+LmHandlerErrorStatus_t LmHandlerAggregate( LmHandlerAppData_t *appData, uint32_t deadline, bool isUrgent )
+{
+    // The aggregation is compiled out
+    return LORAMAC_HANDLER_ERROR;
+}
+
+void LmHandlerAggregateFlush( void )
+{
+}
+#endif
+
+bool LmHandlerAggregateUnpack( uint8_t *buffer, uint8_t size, uint8_t *offset, LmHandlerAppData_t *record )
+{
+    if( ( buffer == NULL ) || ( offset == NULL ) || ( record == NULL ) ||
+        ( *offset >= size ) || ( buffer[*offset] == 0 ) ||
+        ( ( *offset + 1 + buffer[*offset] ) > size ) )
+    {
+        return false;
+    }
+
+    record->BufferSize = buffer[*offset];
+    record->Buffer = buffer + *offset + 1;
+    *offset += 1 + record->BufferSize;
+    return true;
+}
+
 TimerTime_t LmHandlerGetDutyCycleWaitTime( void )
 {
     return DutyCycleWaitTime;
@@ -527,7 +913,14 @@ LmHandlerErrorStatus_t LmHandlerSend( LmHandlerAppData_t *appData, LmHandlerMsgT
     TxParams.AppData = *appData;
     TxParams.Datarate = LmHandlerParams->TxDatarate;
 
-    status = LoRaMacMcpsRequest( &mcpsReq );
+    // Keep the order of the already queued requests
+    status = ( LoRaMacMcpsQueueGetCnt( ) == 0 ) ? LoRaMacMcpsRequest( &mcpsReq ) : LORAMAC_STATUS_BUSY;
+    if( ( status == LORAMAC_STATUS_BUSY ) || ( status == LORAMAC_STATUS_BUSY_BEACON_RESERVED_TIME ) ||
+        ( status == LORAMAC_STATUS_BUSY_PING_SLOT_WINDOW_TIME ) || ( status == LORAMAC_STATUS_BUSY_UPLINK_COLLISION ) )
+    {
+        // The MAC sends the request as soon as it is idle
+        status = LoRaMacMcpsQueueRequest( &mcpsReq, LM_HANDLER_MCPS_QUEUE_PRIORITY, 0 );
+    }
     if( LmHandlerCallbacks->OnMacMcpsRequest != NULL )
     {
         LmHandlerCallbacks->OnMacMcpsRequest( status, &mcpsReq, mcpsReq.ReqReturn.DutyCycleWaitTime );
@@ -999,10 +1392,16 @@ LmHandlerErrorStatus_t LmHandlerPackageRegister( uint8_t id, void *params )
     if( package != NULL )
     {
         LmHandlerPackages[id] = package;
+        LmHandlerPortPackageIds[package->Port] = id;
+        if( package->OnMcpsIndicationMonitor != NULL )
+        {
+            LmHandlerPackagesMonitorMask |= ( 1 << id );
+        }
         LmHandlerPackages[id]->OnMacMcpsRequest = LmHandlerCallbacks->OnMacMcpsRequest;
         LmHandlerPackages[id]->OnMacMlmeRequest = LmHandlerCallbacks->OnMacMlmeRequest;
         LmHandlerPackages[id]->OnJoinRequest = LmHandlerJoinRequest;
         LmHandlerPackages[id]->OnDeviceTimeRequest = LmHandlerDeviceTimeReq;
+        LmHandlerPackages[id]->OnPackageEventNotify = LmHandlerPackageEventNotify;
         LmHandlerPackages[id]->OnSysTimeUpdate = LmHandlerCallbacks->OnSysTimeUpdate;
         LmHandlerPackages[id]->Init( params, LmHandlerParams->DataBuffer, LmHandlerParams->DataBufferMaxSize );
 
@@ -1028,6 +1427,12 @@ bool LmHandlerPackageIsInitialized( uint8_t id )
 
 static void LmHandlerPackagesNotify( PackageNotifyTypes_t notifyType, void *params )
 {
+    if( notifyType == PACKAGE_MCPS_INDICATION )
+    {
+        LmHandlerPackagesNotifyMcpsIndication( ( McpsIndication_t* )params );
+        return;
+    }
+
     for( int8_t i = 0; i < PKG_MAX_NUMBER; i++ )
     {
         if( LmHandlerPackages[i] != NULL )
@@ -1044,10 +1449,7 @@ static void LmHandlerPackagesNotify( PackageNotifyTypes_t notifyType, void *para
                 }
                 case PACKAGE_MCPS_INDICATION:
                 {
-                    if( LmHandlerPackages[i]->OnMcpsIndicationProcess != NULL )
-                    {
-                        LmHandlerPackages[i]->OnMcpsIndicationProcess( ( McpsIndication_t* )params );
-                    }
+                    // Handled by LmHandlerPackagesNotifyMcpsIndication
                     break;
                 }
                 case PACKAGE_MLME_CONFIRM:
@@ -1071,26 +1473,64 @@ static void LmHandlerPackagesNotify( PackageNotifyTypes_t notifyType, void *para
     }
 }
 
+static void LmHandlerPackagesNotifyMcpsIndication( McpsIndication_t *mcpsIndication )
+{
+    uint8_t id;
+
+    for( id = 0; ( id < PKG_MAX_NUMBER ) && ( ( LmHandlerPackagesMonitorMask >> id ) != 0 ); id++ )
+    {
+        if( ( LmHandlerPackagesMonitorMask & ( 1 << id ) ) != 0 )
+        {
+            LmHandlerPackages[id]->OnMcpsIndicationMonitor( mcpsIndication );
+        }
+    }
+
+    if( mcpsIndication->RxData == false )
+    {
+        return;
+    }
+
+    id = LmHandlerPortPackageIds[mcpsIndication->Port];
+    if( ( id != PKG_ID_NONE ) && ( LmHandlerPackages[id]->OnMcpsIndicationProcess != NULL ) )
+    {
+        LmHandlerPackages[id]->OnMcpsIndicationProcess( mcpsIndication );
+    }
+}
+
 static bool LmHandlerPackageIsTxPending( void )
 {
-    for( int8_t i = 0; i < PKG_MAX_NUMBER; i++ )
+    uint8_t pending = LmHandlerPackagesTxPendingMask;
+
+    for( uint8_t i = 0; pending != 0; i++, pending >>= 1 )
     {
-        if( LmHandlerPackages[i] != NULL )
+        if( ( pending & 0x01 ) == 0 )
         {
-            if( LmHandlerPackages[i]->IsTxPending( ) == true )
-            {
-                return true;
-            }
+            continue;
         }
+        if( LmHandlerPackages[i]->IsTxPending( ) == true )
+        {
+            return true;
+        }
+        // The transmission is done. Stop polling the package.
+        CRITICAL_SECTION_BEGIN( );
+        LmHandlerPackagesTxPendingMask &= ~( 1 << i );
+        CRITICAL_SECTION_END( );
     }
     return false;
 }
 
 static void LmHandlerPackagesProcess( void )
 {
-    for( int8_t i = 0; i < PKG_MAX_NUMBER; i++ )
+    uint8_t pending;
+
+    CRITICAL_SECTION_BEGIN( );
+    pending = LmHandlerPackagesProcessMask;
+    LmHandlerPackagesProcessMask = 0;
+    CRITICAL_SECTION_END( );
+
+    for( uint8_t i = 0; pending != 0; i++, pending >>= 1 )
     {
-        if( ( LmHandlerPackages[i] != NULL ) &&
+        if( ( ( pending & 0x01 ) != 0 ) &&
             ( LmHandlerPackages[i]->Process != NULL ) &&
             ( LmHandlerPackageIsInitialized( i ) != false ) )
         {
@@ -1098,3 +1538,24 @@ static void LmHandlerPackagesProcess( void )
         }
     }
 }
+
+static void LmHandlerPackageEventNotify( uint8_t port, uint8_t events )
+{
+    uint8_t id = LmHandlerPortPackageIds[port];
+
+    if( id == PKG_ID_NONE )
+    {
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    if( ( events & LMH_PACKAGE_EVENT_PROCESS ) != 0 )
+    {
+        LmHandlerPackagesProcessMask |= ( 1 << id );
+    }
+    if( ( events & LMH_PACKAGE_EVENT_TX_PENDING ) != 0 )
+    {
+        LmHandlerPackagesTxPendingMask |= ( 1 << id );
+    }
+    CRITICAL_SECTION_END( );
+}
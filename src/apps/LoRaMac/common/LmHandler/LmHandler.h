@@ -148,6 +148,7 @@ typedef struct LmHandlerCallbacks_s
      *                   restoring (false) the NVM context
      *
      * \param [IN] size Number of data bytes which were stored or restored.
+     *                  0 when all the writes of a split NVM store failed.
      */
     void ( *OnNvmDataChange )( LmHandlerNvmContextStates_t state, uint16_t size );
     /*!
@@ -258,11 +259,56 @@ TimerTime_t LmHandlerGetDutyCycleWaitTime( void );
  * \param [IN] appData Data to be sent
  * \param [IN] isTxConfirmed Indicates if the uplink requires an acknowledgement
  *
+ * \remark While the MAC is busy the uplink is queued with
+ *         \ref LoRaMacMcpsQueueRequest and sent as soon as the MAC is idle.
+ *
  * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if request has been
  *                processed else \ref LORAMAC_HANDLER_ERROR
  */
 LmHandlerErrorStatus_t LmHandlerSend( LmHandlerAppData_t *appData, LmHandlerMsgTypes_t isTxConfirmed );
 
+/*!
+ * Aggregates an application record into the next uplink of its port
+ *
+ * \remark The records of a port are packed as [size][record] pairs. The
+ *         uplink is sent when the next record does not fit the maximum
+ *         payload size of the current datarate, when the earliest record
+ *         deadline expires or right away if \a isUrgent is true.
+ *         A record larger than the maximum payload size of the current
+ *         datarate is rejected. The records sent while the datarate has
+ *         decreased below their size wait until it increases again.
+ *         \ref LmHandlerAggregateUnpack splits a received payload.
+ *
+ * \remark The aggregation is compiled out when LM_HANDLER_AGGREGATE_NB_PORTS
+ *         is 0, which is the default. The records are then rejected.
+ *
+ * \param [IN] appData Record to aggregate. The port selects the uplink
+ * \param [IN] deadline Maximum time the record waits for its uplink [ms]
+ * \param [IN] isUrgent Sends the uplink right after the record aggregation
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if the record has
+ *                been aggregated else \ref LORAMAC_HANDLER_ERROR
+ */
+LmHandlerErrorStatus_t LmHandlerAggregate( LmHandlerAppData_t *appData, uint32_t deadline, bool isUrgent );
+
+/*!
+ * Sends the uplinks of all the ports having aggregated records
+ */
+void LmHandlerAggregateFlush( void );
+
+/*!
+ * Extracts the next record of an aggregated payload
+ *
+ * \param [IN]     buffer Aggregated payload
+ * \param [IN]     size   Aggregated payload size
+ * \param [IN/OUT] offset Offset of the next record. Start with 0
+ * \param [OUT]    record Extracted record buffer and size. The port is not modified
+ *
+ * \retval isExtracted Returns true if a record has been extracted, false at
+ *                     the end of the payload or if the payload is malformed
+ */
+bool LmHandlerAggregateUnpack( uint8_t *buffer, uint8_t size, uint8_t *offset, LmHandlerAppData_t *record );
+
 /*!
  * Join a LoRa Network in classA
  *
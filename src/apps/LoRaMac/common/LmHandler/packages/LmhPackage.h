@@ -34,6 +34,27 @@ extern "C" {
  */
 #define PKG_MAX_NUMBER                              4
 
+/*!
+ * Package events. Signaled to LmHandler through \ref LmhPackage_t.OnPackageEventNotify
+ * in order to only have the packages with pending work being handled.
+ */
+typedef enum LmhPackageEvents_e
+{
+    /*!
+     * No pending event
+     */
+    LMH_PACKAGE_EVENT_NONE                          = 0x00,
+    /*!
+     * The package Process function must be called
+     */
+    LMH_PACKAGE_EVENT_PROCESS                       = 0x01,
+    /*!
+     * The package has a pending transmission. LmHandler will poll the package
+     * IsTxPending function until it returns false.
+     */
+    LMH_PACKAGE_EVENT_TX_PENDING                    = 0x02,
+}LmhPackageEvents_t;
+
 typedef struct LmhPackage_s
 {
     uint8_t Port;
@@ -67,6 +88,10 @@ typedef struct LmhPackage_s
     bool ( *IsTxPending )( void );
     /*!
      * Processes the internal package events.
+     *
+     * \remark Only called after \ref LMH_PACKAGE_EVENT_PROCESS has been
+     *         signaled. The package must signal it again if it needs to be
+     *         called on the next LmHandler processing.
      */
     void ( *Process )( void );
     /*!
@@ -78,9 +103,23 @@ typedef struct LmhPackage_s
     /*!
      * Processes the MCPS Indication
      *
+     * \remark Only called for received data on the package \ref Port.
+     *         mcpsIndication->Buffer is lent by the MAC layer for the duration
+     *         of the call. The package is the only consumer of the data from
+     *         now on, so it may process it in place ( e.g. FragDecoder ) but
+     *         must copy whatever it needs after returning.
+     *
      * \param [IN] mcpsIndication     MCPS indication primitive data
      */
     void ( *OnMcpsIndicationProcess )( McpsIndication_t *mcpsIndication );
+    /*!
+     * Monitors every MCPS Indication whatever its port. Optional.
+     *
+     * \remark mcpsIndication->Buffer must not be modified.
+     *
+     * \param [IN] mcpsIndication     MCPS indication primitive data
+     */
+    void ( *OnMcpsIndicationMonitor )( McpsIndication_t *mcpsIndication );
     /*!
      * Processes the MLME Confirm
      *
@@ -131,6 +170,15 @@ typedef struct LmhPackage_s
     * \retval status Returns \ref LORAMAC_HANDLER_SET if joined else \ref LORAMAC_HANDLER_RESET
     */
     LmHandlerErrorStatus_t ( *OnDeviceTimeRequest )( void );
+    /*!
+     * Signals LmHandler that the package has pending events.
+     *
+     * \remark May be called from an interrupt context ( e.g. timer callbacks )
+     *
+     * \param [IN] port   Package port
+     * \param [IN] events Pending events bit mask. Refer to \ref LmhPackageEvents_t
+     */
+    void ( *OnPackageEventNotify )( uint8_t port, uint8_t events );
 #if( LMH_SYS_TIME_UPDATE_NEW_API == 1 )
     /*!
      * Notifies the upper layer that the system time has been updated.
@@ -30,6 +30,11 @@
 #define CLOCK_SYNC_ID                               1
 #define CLOCK_SYNC_VERSION                          1
 
+/*!
+ * Accuracy of the AppTimeAns time correction [ms]
+ */
+#define CLOCK_SYNC_TIME_ACCURACY                    1000
+
 /*!
  * Package current context
  */
@@ -136,12 +141,14 @@ static LmhPackage_t LmhpClockSyncPackage =
     .Process = LmhpClockSyncProcess,
     .OnMcpsConfirmProcess = LmhpClockSyncOnMcpsConfirm,
     .OnMcpsIndicationProcess = LmhpClockSyncOnMcpsIndication,
+    .OnMcpsIndicationMonitor = NULL,                           // Not used in this package
     .OnMlmeConfirmProcess = NULL,                              // Not used in this package
     .OnMlmeIndicationProcess = NULL,                           // Not used in this package
     .OnMacMcpsRequest = NULL,                                  // To be initialized by LmHandler
     .OnMacMlmeRequest = NULL,                                  // To be initialized by LmHandler
     .OnJoinRequest = NULL,                                     // To be initialized by LmHandler
     .OnDeviceTimeRequest = NULL,                               // To be initialized by LmHandler
+    .OnPackageEventNotify = NULL,                              // To be initialized by LmHandler
     .OnSysTimeUpdate = NULL,                                   // To be initialized by LmHandler
 };
 
@@ -184,6 +191,11 @@ static void LmhpClockSyncProcess( void )
             LmhpClockSyncState.NbTransmissions--;
         }
     }
+    if( LmhpClockSyncState.NbTransmissions > 0 )
+    {
+        // Keep on trying on next processing
+        LmhpClockSyncPackage.OnPackageEventNotify( CLOCK_SYNC_PORT, LMH_PACKAGE_EVENT_PROCESS );
+    }
 }
 
 static void LmhpClockSyncOnMcpsConfirm( McpsConfirm_t *mcpsConfirm )
@@ -250,10 +262,13 @@ static void LmhpClockSyncOnMcpsIndication( McpsIndication_t *mcpsIndication )
                 timeCorrection += ( mcpsIndication->Buffer[cmdIndex++] << 24 ) & 0xFF000000;
                 if( ( mcpsIndication->Buffer[cmdIndex++] & 0x0F ) == LmhpClockSyncState.TimeReqParam.Fields.TokenReq )
                 {
+                    // The correction has a 1 second resolution. Null
+                    // corrections are given too as they feed the drift
+                    // estimate over long intervals.
                     SysTime_t curTime = { .Seconds = 0, .SubSeconds = 0 };
                     curTime = SysTimeGet( );
                     curTime.Seconds += timeCorrection;
-                    SysTimeSet( curTime );
+                    SysTimeSyncCoarse( curTime, CLOCK_SYNC_TIME_ACCURACY );
                     LmhpClockSyncState.TimeReqParam.Fields.TokenReq = ( LmhpClockSyncState.TimeReqParam.Fields.TokenReq + 1 ) & 0x0F;
                     if( LmhpClockSyncPackage.OnSysTimeUpdate != NULL )
                     {
@@ -292,6 +307,7 @@ static void LmhpClockSyncOnMcpsIndication( McpsIndication_t *mcpsIndication )
             case CLOCK_SYNC_FORCE_RESYNC_REQ:
             {
                 LmhpClockSyncState.NbTransmissions = mcpsIndication->Buffer[cmdIndex++] & 0X07;
+                LmhpClockSyncPackage.OnPackageEventNotify( CLOCK_SYNC_PORT, LMH_PACKAGE_EVENT_PROCESS );
                 break;
             }
         }
@@ -169,6 +169,13 @@ static void LmhpComplianceProcess( void );
  */
 static void LmhpComplianceOnMcpsIndication( McpsIndication_t* mcpsIndication );
 
+/*!
+ * Monitors all the MCPS Indications in order to count the received downlinks
+ *
+ * \param [IN] mcpsIndication     MCPS indication primitive data
+ */
+static void LmhpComplianceOnMcpsIndicationMonitor( McpsIndication_t* mcpsIndication );
+
 /*!
  * Processes the MLME Confirm
  *
@@ -190,6 +197,11 @@ static void LmhpComplianceOnMlmeIndication( MlmeIndication_t* mlmeIndication );
  */
 static void SendBeaconRxStatusInd( bool isBeaconRxStatusIndOn );
 
+/*!
+ * Signals LmHandler the package pending events according to the current state
+ */
+static void ComplianceEventsNotify( void );
+
 LmhPackage_t CompliancePackage = {
     .Port                    = COMPLIANCE_PORT,
     .Init                    = LmhpComplianceInit,
@@ -198,12 +210,14 @@ LmhPackage_t CompliancePackage = {
     .Process                 = LmhpComplianceProcess,
     .OnMcpsConfirmProcess    = NULL,  // Not used in this package
     .OnMcpsIndicationProcess = LmhpComplianceOnMcpsIndication,
+    .OnMcpsIndicationMonitor = LmhpComplianceOnMcpsIndicationMonitor,
     .OnMlmeConfirmProcess    = LmhpComplianceOnMlmeConfirm,
     .OnMlmeIndicationProcess = LmhpComplianceOnMlmeIndication,
     .OnMacMcpsRequest        = NULL,  // To be initialized by LmHandler
     .OnMacMlmeRequest        = NULL,  // To be initialized by LmHandler
     .OnJoinRequest           = NULL,  // To be initialized by LmHandler
     .OnDeviceTimeRequest     = NULL,  // To be initialized by LmHandler
+    .OnPackageEventNotify    = NULL,  // To be initialized by LmHandler
     .OnSysTimeUpdate         = NULL,  // To be initialized by LmHandler
 };
 
@@ -289,13 +303,12 @@ static void LmhpComplianceProcess( void )
         // Call platform MCU reset API
         BoardResetMcu( );
     }
+
+    ComplianceEventsNotify( );
 }
 
-static void LmhpComplianceOnMcpsIndication( McpsIndication_t* mcpsIndication )
+static void LmhpComplianceOnMcpsIndicationMonitor( McpsIndication_t* mcpsIndication )
 {
-    uint8_t cmdIndex        = 0;
-    MibRequestConfirm_t mibReq;
-
     if( ComplianceTestState.Initialized == false )
     {
         return;
@@ -307,6 +320,17 @@ static void LmhpComplianceOnMcpsIndication( McpsIndication_t* mcpsIndication )
     {
         ComplianceTestState.RxAppCnt++;
     }
+}
+
+static void LmhpComplianceOnMcpsIndication( McpsIndication_t* mcpsIndication )
+{
+    uint8_t cmdIndex        = 0;
+    MibRequestConfirm_t mibReq;
+
+    if( ComplianceTestState.Initialized == false )
+    {
+        return;
+    }
 
     if( mcpsIndication->RxData == false )
     {
@@ -522,6 +546,8 @@ static void LmhpComplianceOnMcpsIndication( McpsIndication_t* mcpsIndication )
         // Abort any pending Tx as a new command has been processed
         ComplianceTestState.IsTxPending = false;
     }
+
+    ComplianceEventsNotify( );
 }
 
 static void LmhpComplianceOnMlmeConfirm( MlmeConfirm_t *mlmeConfirm )
@@ -615,4 +641,23 @@ static void SendBeaconRxStatusInd( bool isBeaconRxStatusIndOn )
     ComplianceTestState.DataBuffer[ComplianceTestState.DataBufferSize++] = ( uint8_t )( ComplianceTestState.ClassBStatus.Info.GwSpecific.Info[5] );
 
     ComplianceTestState.IsTxPending = true;
+    ComplianceEventsNotify( );
+}
+
+static void ComplianceEventsNotify( void )
+{
+    uint8_t events = LMH_PACKAGE_EVENT_NONE;
+
+    if( ComplianceTestState.IsTxPending == true )
+    {
+        events |= LMH_PACKAGE_EVENT_PROCESS | LMH_PACKAGE_EVENT_TX_PENDING;
+    }
+    if( ( ComplianceTestState.IsClassReqCmdPending == true ) || ( ComplianceTestState.IsResetCmdPending == true ) )
+    {
+        events |= LMH_PACKAGE_EVENT_PROCESS;
+    }
+    if( events != LMH_PACKAGE_EVENT_NONE )
+    {
+        CompliancePackage.OnPackageEventNotify( COMPLIANCE_PORT, events );
+    }
 }
@@ -173,12 +173,14 @@ static LmhPackage_t LmhpFragmentationPackage =
     .Process = LmhpFragmentationProcess,
     .OnMcpsConfirmProcess = NULL,                              // Not used in this package
     .OnMcpsIndicationProcess = LmhpFragmentationOnMcpsIndication,
+    .OnMcpsIndicationMonitor = NULL,                           // Not used in this package
     .OnMlmeConfirmProcess = NULL,                              // Not used in this package
     .OnMlmeIndicationProcess = NULL,                           // Not used in this package
     .OnMacMcpsRequest = NULL,                                  // To be initialized by LmHandler
     .OnMacMlmeRequest = NULL,                                  // To be initialized by LmHandler
     .OnJoinRequest = NULL,                                     // To be initialized by LmHandler
     .OnDeviceTimeRequest = NULL,                               // To be initialized by LmHandler
+    .OnPackageEventNotify = NULL,                              // To be initialized by LmHandler
     .OnSysTimeUpdate = NULL,                                   // To be initialized by LmHandler
 };
 
@@ -197,6 +199,7 @@ static void OnFragmentTxDelay( void* context )
     TimerStop( &FragmentTxDelayTimer );
     // Set the state.
     LmhpFragmentationState.TxDelayState = FRAGMENTATION_TX_DELAY_STATE_STOP;
+    LmhpFragmentationPackage.OnPackageEventNotify( FRAGMENTATION_PORT, LMH_PACKAGE_EVENT_PROCESS );
 }
 
 LmhPackage_t *LmhpFragmentationPackageFactory( void )
@@ -516,6 +519,7 @@ static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication
             TxDelayTime = randr( 0, 1000 ) * ( 1 << ( blockAckDelay + 4 ) );
             DelayedReplyAppData = cmdReplyAppData;
             LmhpFragmentationState.TxDelayState = FRAGMENTATION_TX_DELAY_STATE_START;
+            LmhpFragmentationPackage.OnPackageEventNotify( FRAGMENTATION_PORT, LMH_PACKAGE_EVENT_PROCESS );
         }
         else
         {
@@ -218,12 +218,14 @@ static LmhPackage_t LmhpRemoteMcastSetupPackage =
     .Process = LmhpRemoteMcastSetupProcess,
     .OnMcpsConfirmProcess = NULL,                              // Not used in this package
     .OnMcpsIndicationProcess = LmhpRemoteMcastSetupOnMcpsIndication,
+    .OnMcpsIndicationMonitor = NULL,                           // Not used in this package
     .OnMlmeConfirmProcess = NULL,                              // Not used in this package
     .OnMlmeIndicationProcess = NULL,                           // Not used in this package
     .OnMacMcpsRequest = NULL,                                  // To be initialized by LmHandler
     .OnMacMlmeRequest = NULL,                                  // To be initialized by LmHandler
     .OnJoinRequest = NULL,                                     // To be initialized by LmHandler
     .OnDeviceTimeRequest = NULL,                               // To be initialized by LmHandler
+    .OnPackageEventNotify = NULL,                              // To be initialized by LmHandler
     .OnSysTimeUpdate = NULL,                                   // To be initialized by LmHandler
 };
 
@@ -545,6 +547,7 @@ static void OnSessionStartTimer( void *context )
     TimerStop( &SessionStartTimer );
 
     LmhpRemoteMcastSetupState.SessionState = REMOTE_MCAST_SETUP_SESSION_STATE_START;
+    LmhpRemoteMcastSetupPackage.OnPackageEventNotify( REMOTE_MCAST_SETUP_PORT, LMH_PACKAGE_EVENT_PROCESS );
 }
 
 static void OnSessionStopTimer( void *context )
@@ -552,4 +555,5 @@ static void OnSessionStopTimer( void *context )
     TimerStop( &SessionStopTimer );
 
     LmhpRemoteMcastSetupState.SessionState = REMOTE_MCAST_SETUP_SESSION_STATE_STOP;
+    LmhpRemoteMcastSetupPackage.OnPackageEventNotify( REMOTE_MCAST_SETUP_PORT, LMH_PACKAGE_EVENT_PROCESS );
 }
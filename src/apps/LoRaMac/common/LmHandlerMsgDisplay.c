@@ -21,12 +21,15 @@
  */
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include "utilities.h"
 #include "timer.h"
 
 #include "LmHandlerMsgDisplay.h"
+#include "LoRaMacTrace.h"
+#include "DeferredLog.h"
 
 /*!
  * MAC status strings
@@ -79,71 +82,55 @@ const char* EventInfoStatusStrings[] =
     "Multicast fail",                // LORAMAC_EVENT_INFO_STATUS_MULTICAST_FAIL
     "Beacon locked",                 // LORAMAC_EVENT_INFO_STATUS_BEACON_LOCKED
     "Beacon lost",                   // LORAMAC_EVENT_INFO_STATUS_BEACON_LOST
-    "Beacon not found"               // LORAMAC_EVENT_INFO_STATUS_BEACON_NOT_FOUND
+    "Beacon not found",              // LORAMAC_EVENT_INFO_STATUS_BEACON_NOT_FOUND
+    "Tx expired"                     // LORAMAC_EVENT_INFO_STATUS_TX_EXPIRED
 };
 
 /*!
- * Prints the provided buffer in HEX
+ * Stores the provided buffer to be printed in HEX
  * 
  * \param buffer Buffer to be printed
  * \param size   Buffer size to be printed
  */
 void PrintHexBuffer( uint8_t *buffer, uint8_t size )
 {
-    uint8_t newline = 0;
-
-    for( uint8_t i = 0; i < size; i++ )
-    {
-        if( newline != 0 )
-        {
-            printf( "\n" );
-            newline = 0;
-        }
-
-        printf( "%02X ", buffer[i] );
-
-        if( ( ( i + 1 ) % 16 ) == 0 )
-        {
-            newline = 1;
-        }
-    }
-    printf( "\n" );
+    LOG_HEX_DEBUG( buffer, size );
 }
 
 void DisplayNvmDataChange( LmHandlerNvmContextStates_t state, uint16_t size )
 {
     if( state == LORAMAC_HANDLER_NVM_STORE )
     {
-        printf( "\n###### ============ CTXS STORED ============ ######\n" );
+        LOG_INFO( "\n###### ============ CTXS STORED ============ ######\n" );
 
     }
     else
     {
-        printf( "\n###### =========== CTXS RESTORED =========== ######\n" );
+        LOG_INFO( "\n###### =========== CTXS RESTORED =========== ######\n" );
     }
-    printf( "Size        : %i\n\n", size );
+    LOG_INFO( "Size        : %i\n\n", size );
 }
 
 void DisplayNetworkParametersUpdate( CommissioningParams_t *commissioningParams )
 {
-    printf( "DevEui      : %02X", commissioningParams->DevEui[0] );
+    LOG_INFO( "DevEui      : %02X", commissioningParams->DevEui[0] );
     for( int i = 1; i < 8; i++ )
     {
-        printf( "-%02X", commissioningParams->DevEui[i] );
+        LOG_INFO( "-%02X", commissioningParams->DevEui[i] );
     }
-    printf( "\n" );
-    printf( "JoinEui     : %02X", commissioningParams->JoinEui[0] );
+    LOG_INFO( "\n" );
+    LOG_INFO( "JoinEui     : %02X", commissioningParams->JoinEui[0] );
     for( int i = 1; i < 8; i++ )
     {
-        printf( "-%02X", commissioningParams->JoinEui[i] );
+        LOG_INFO( "-%02X", commissioningParams->JoinEui[i] );
     }
-    printf( "\n" );
-    printf( "Pin         : %02X", commissioningParams->SePin[0] );
+    LOG_INFO( "\n" );
+    LOG_INFO( "Pin         : %02X", commissioningParams->SePin[0] );
     for( int i = 1; i < 4; i++ )
     {
-        printf( "-%02X", commissioningParams->SePin[i] );
+        LOG_INFO( "-%02X", commissioningParams->SePin[i] );
     }
-    printf( "\n\n" );
+    LOG_INFO( "\n\n" );
 }
 
 void DisplayMacMcpsRequestUpdate( LoRaMacStatus_t status, McpsReq_t *mcpsReq, TimerTime_t nextTxIn )
@@ -152,37 +139,39 @@ void DisplayMacMcpsRequestUpdate( LoRaMacStatus_t status, McpsReq_t *mcpsReq, Ti
     {
         case MCPS_CONFIRMED:
         {
-            printf( "\n###### =========== MCPS-Request ============ ######\n" );
-            printf( "######            MCPS_CONFIRMED             ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MCPS-Request ============ ######\n" );
+            LOG_INFO( "######            MCPS_CONFIRMED             ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         case MCPS_UNCONFIRMED:
         {
-            printf( "\n###### =========== MCPS-Request ============ ######\n" );
-            printf( "######           MCPS_UNCONFIRMED            ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MCPS-Request ============ ######\n" );
+            LOG_INFO( "######           MCPS_UNCONFIRMED            ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         case MCPS_PROPRIETARY:
         {
-            printf( "\n###### =========== MCPS-Request ============ ######\n" );
-            printf( "######           MCPS_PROPRIETARY            ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MCPS-Request ============ ######\n" );
+            LOG_INFO( "######           MCPS_PROPRIETARY            ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         default:
         {
-            printf( "\n###### =========== MCPS-Request ============ ######\n" );
-            printf( "######                MCPS_ERROR             ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MCPS-Request ============ ######\n" );
+            LOG_INFO( "######                MCPS_ERROR             ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
     }
-    printf( "STATUS      : %s\n", MacStatusStrings[status] );
+    LOG_INFO( "STATUS      : " );
+    LOG_STRING_INFO( MacStatusStrings[status] );
+    LOG_INFO( "\n" );
     if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
     {
-        printf( "Next Tx in  : %lu [ms]\n", nextTxIn );
+        LOG_INFO( "Next Tx in  : %" PRIu32 " [ms]\n", nextTxIn );
     }
 }
 
@@ -192,44 +181,46 @@ void DisplayMacMlmeRequestUpdate( LoRaMacStatus_t status, MlmeReq_t *mlmeReq, Ti
     {
         case MLME_JOIN:
         {
-            printf( "\n###### =========== MLME-Request ============ ######\n" );
-            printf( "######               MLME_JOIN               ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MLME-Request ============ ######\n" );
+            LOG_INFO( "######               MLME_JOIN               ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         case MLME_LINK_CHECK:
         {
-            printf( "\n###### =========== MLME-Request ============ ######\n" );
-            printf( "######            MLME_LINK_CHECK            ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MLME-Request ============ ######\n" );
+            LOG_INFO( "######            MLME_LINK_CHECK            ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         case MLME_DEVICE_TIME:
         {
-            printf( "\n###### =========== MLME-Request ============ ######\n" );
-            printf( "######            MLME_DEVICE_TIME           ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MLME-Request ============ ######\n" );
+            LOG_INFO( "######            MLME_DEVICE_TIME           ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         case MLME_TXCW:
         {
-            printf( "\n###### =========== MLME-Request ============ ######\n" );
-            printf( "######               MLME_TXCW               ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MLME-Request ============ ######\n" );
+            LOG_INFO( "######               MLME_TXCW               ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
         default:
         {
-            printf( "\n###### =========== MLME-Request ============ ######\n" );
-            printf( "######              MLME_UNKNOWN             ######\n");
-            printf( "###### ===================================== ######\n");
+            LOG_INFO( "\n###### =========== MLME-Request ============ ######\n" );
+            LOG_INFO( "######              MLME_UNKNOWN             ######\n");
+            LOG_INFO( "###### ===================================== ######\n");
             break;
         }
     }
-    printf( "STATUS      : %s\n", MacStatusStrings[status] );
+    LOG_INFO( "STATUS      : " );
+    LOG_STRING_INFO( MacStatusStrings[status] );
+    LOG_INFO( "\n" );
     if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
     {
-        printf( "Next Tx in  : %lu [ms]\n", nextTxIn );
+        LOG_INFO( "Next Tx in  : %" PRIu32 " [ms]\n", nextTxIn );
     }
 }
 
@@ -239,20 +230,20 @@ void DisplayJoinRequestUpdate( LmHandlerJoinParams_t *params )
     {
         if( params->Status == LORAMAC_HANDLER_SUCCESS )
         {
-            printf( "###### ===========   JOINED     ============ ######\n" );
-            printf( "\nOTAA\n\n" );
-            printf( "DevAddr     :  %08lX\n", params->CommissioningParams->DevAddr );
-            printf( "\n\n" );
-            printf( "DATA RATE   : DR_%d\n\n", params->Datarate );
+            LOG_INFO( "###### ===========   JOINED     ============ ######\n" );
+            LOG_INFO( "\nOTAA\n\n" );
+            LOG_INFO( "DevAddr     :  %08" PRIX32 "\n", params->CommissioningParams->DevAddr );
+            LOG_INFO( "\n\n" );
+            LOG_INFO( "DATA RATE   : DR_%d\n\n", params->Datarate );
         }
     }
 #if ( OVER_THE_AIR_ACTIVATION == 0 )
     else
     {
-        printf( "###### ===========   JOINED     ============ ######\n" );
-        printf( "\nABP\n\n" );
-        printf( "DevAddr     : %08lX\n", params->CommissioningParams->DevAddr );
-        printf( "\n\n" );
+        LOG_INFO( "###### ===========   JOINED     ============ ######\n" );
+        LOG_INFO( "\nABP\n\n" );
+        LOG_INFO( "DevAddr     : %08" PRIX32 "\n", params->CommissioningParams->DevAddr );
+        LOG_INFO( "\n\n" );
     }
 #endif
 }
@@ -263,50 +254,73 @@ void DisplayTxUpdate( LmHandlerTxParams_t *params )
 
     if( params->IsMcpsConfirm == 0 )
     {
-        printf( "\n###### =========== MLME-Confirm ============ ######\n" );
-        printf( "STATUS      : %s\n", EventInfoStatusStrings[params->Status] );
+        LOG_INFO( "\n###### =========== MLME-Confirm ============ ######\n" );
+        LOG_INFO( "STATUS      : " );
+        LOG_STRING_INFO( EventInfoStatusStrings[params->Status] );
+        LOG_INFO( "\n" );
         return;
     }
 
-    printf( "\n###### =========== MCPS-Confirm ============ ######\n" );
-    printf( "STATUS      : %s\n", EventInfoStatusStrings[params->Status] );
+    LOG_INFO( "\n###### =========== MCPS-Confirm ============ ######\n" );
+    LOG_INFO( "STATUS      : " );
+    LOG_STRING_INFO( EventInfoStatusStrings[params->Status] );
+    LOG_INFO( "\n" );
 
-    printf( "\n###### =====   UPLINK FRAME %8lu   ===== ######\n", params->UplinkCounter );
-    printf( "\n" );
+    LOG_INFO( "\n###### =====   UPLINK FRAME %8" PRIu32 "   ===== ######\n", params->UplinkCounter );
+    LOG_INFO( "\n" );
 
-    printf( "CLASS       : %c\n", "ABC"[LmHandlerGetCurrentClass( )] );
-    printf( "\n" );
-    printf( "TX PORT     : %d\n", params->AppData.Port );
+    LOG_INFO( "CLASS       : %c\n", "ABC"[LmHandlerGetCurrentClass( )] );
+    LOG_INFO( "\n" );
+    LOG_INFO( "TX PORT     : %d\n", params->AppData.Port );
 
     if( params->AppData.BufferSize != 0 )
     {
-        printf( "TX DATA     : " );
+        LOG_INFO( "TX DATA     : " );
         if( params->MsgType == LORAMAC_HANDLER_CONFIRMED_MSG )
         {
-            printf( "CONFIRMED - %s\n", ( params->AckReceived != 0 ) ? "ACK" : "NACK" );
+            LOG_INFO( "CONFIRMED - " );
+            LOG_STRING_INFO( ( params->AckReceived != 0 ) ? "ACK" : "NACK" );
+            LOG_INFO( "\n" );
         }
         else
         {
-            printf( "UNCONFIRMED\n" );
+            LOG_INFO( "UNCONFIRMED\n" );
         }
         PrintHexBuffer( params->AppData.Buffer, params->AppData.BufferSize );
     }
 
-    printf( "\n" );
-    printf( "DATA RATE   : DR_%d\n", params->Datarate );
+    LOG_INFO( "\n" );
+    LOG_INFO( "DATA RATE   : DR_%d\n", params->Datarate );
 
     mibGet.Type  = MIB_CHANNELS;
     if( LoRaMacMibGetRequestConfirm( &mibGet ) == LORAMAC_STATUS_OK )
     {
-        printf( "U/L FREQ    : %lu\n", mibGet.Param.ChannelList[params->Channel].Frequency );
+        LOG_INFO( "U/L FREQ    : %" PRIu32 "\n", mibGet.Param.ChannelList[params->Channel].Frequency );
     }
 
-    printf( "TX POWER    : %d\n", params->TxPower );
+    LOG_INFO( "TX POWER    : %d\n", params->TxPower );
+
+    mibGet.Type  = MIB_ENERGY_LEDGER;
+    if( LoRaMacMibGetRequestConfirm( &mibGet ) == LORAMAC_STATUS_OK )
+    {
+        const LoRaMacEnergyLedger_t* ledger = mibGet.Param.EnergyLedger;
+        LoRaMacEnergyMsgType_t msgType = ( params->MsgType == LORAMAC_HANDLER_CONFIRMED_MSG ) ? LORAMAC_ENERGY_MSG_CONFIRMED : LORAMAC_ENERGY_MSG_UNCONFIRMED;
+        uint8_t port = ( params->AppData.BufferSize != 0 ) ? params->AppData.Port : 0;
+
+        for( uint8_t i = 0; i < ledger->NbEntries; i++ )
+        {
+            if( ( ledger->Entries[i].FPort == port ) && ( ledger->Entries[i].MsgType == msgType ) )
+            {
+                LOG_INFO( "PORT ENERGY : %" PRIu32 " TX, %" PRIu32 " uC\n", ledger->Entries[i].NbTx, LoRaMacEnergyGetCharge( &ledger->Entries[i] ) );
+                break;
+            }
+        }
+    }
 
     mibGet.Type  = MIB_CHANNELS_MASK;
     if( LoRaMacMibGetRequestConfirm( &mibGet ) == LORAMAC_STATUS_OK )
     {
-        printf("CHANNEL MASK: ");
+        LOG_INFO("CHANNEL MASK: ");
         switch( LmHandlerGetActiveRegion( ) )
         {
             case LORAMAC_REGION_AS923:
@@ -317,7 +331,7 @@ void DisplayTxUpdate( LmHandlerTxParams_t *params )
             case LORAMAC_REGION_EU433:
             case LORAMAC_REGION_RU864:
             {
-                printf( "%04X ", mibGet.Param.ChannelsMask[0] );
+                LOG_INFO( "%04X ", mibGet.Param.ChannelsMask[0] );
                 break;
             }
             case LORAMAC_REGION_AU915:
@@ -326,20 +340,20 @@ void DisplayTxUpdate( LmHandlerTxParams_t *params )
             {
                 for( uint8_t i = 0; i < 5; i++)
                 {
-                    printf( "%04X ", mibGet.Param.ChannelsMask[i] );
+                    LOG_INFO( "%04X ", mibGet.Param.ChannelsMask[i] );
                 }
                 break;
             }
             default:
             {
-                printf( "\n###### ========= Unknown Region ============ ######" );
+                LOG_INFO( "\n###### ========= Unknown Region ============ ######" );
                 break;
             }
         }
-        printf("\n");
+        LOG_INFO("\n");
     }
 
-    printf( "\n" );
+    LOG_INFO( "\n" );
 }
 
 void DisplayRxUpdate( LmHandlerAppData_t *appData, LmHandlerRxParams_t *params )
@@ -348,32 +362,38 @@ void DisplayRxUpdate( LmHandlerAppData_t *appData, LmHandlerRxParams_t *params )
 
     if( params->IsMcpsIndication == 0 )
     {
-        printf( "\n###### ========== MLME-Indication ========== ######\n" );
-        printf( "STATUS      : %s\n", EventInfoStatusStrings[params->Status] );
+        LOG_INFO( "\n###### ========== MLME-Indication ========== ######\n" );
+        LOG_INFO( "STATUS      : " );
+        LOG_STRING_INFO( EventInfoStatusStrings[params->Status] );
+        LOG_INFO( "\n" );
         return;
     }
 
-    printf( "\n###### ========== MCPS-Indication ========== ######\n" );
-    printf( "STATUS      : %s\n", EventInfoStatusStrings[params->Status] );
+    LOG_INFO( "\n###### ========== MCPS-Indication ========== ######\n" );
+    LOG_INFO( "STATUS      : " );
+    LOG_STRING_INFO( EventInfoStatusStrings[params->Status] );
+    LOG_INFO( "\n" );
 
-    printf( "\n###### =====  DOWNLINK FRAME %8lu  ===== ######\n", params->DownlinkCounter );
+    LOG_INFO( "\n###### =====  DOWNLINK FRAME %8" PRIu32 "  ===== ######\n", params->DownlinkCounter );
 
-    printf( "RX WINDOW   : %s\n", slotStrings[params->RxSlot] );
+    LOG_INFO( "RX WINDOW   : " );
+    LOG_STRING_INFO( slotStrings[params->RxSlot] );
+    LOG_INFO( "\n" );
     
-    printf( "RX PORT     : %d\n", appData->Port );
+    LOG_INFO( "RX PORT     : %d\n", appData->Port );
 
     if( appData->BufferSize != 0 )
     {
-        printf( "RX DATA     : \n" );
+        LOG_INFO( "RX DATA     : \n" );
         PrintHexBuffer( appData->Buffer, appData->BufferSize );
     }
 
-    printf( "\n" );
-    printf( "DATA RATE   : DR_%d\n", params->Datarate );
-    printf( "RX RSSI     : %d\n", params->Rssi );
-    printf( "RX SNR      : %d\n", params->Snr );
+    LOG_INFO( "\n" );
+    LOG_INFO( "DATA RATE   : DR_%d\n", params->Datarate );
+    LOG_INFO( "RX RSSI     : %d\n", params->Rssi );
+    LOG_INFO( "RX SNR      : %d\n", params->Snr );
 
-    printf( "\n" );
+    LOG_INFO( "\n" );
 }
 
 void DisplayBeaconUpdate( LoRaMacHandlerBeaconParams_t *params )
@@ -383,31 +403,31 @@ void DisplayBeaconUpdate( LoRaMacHandlerBeaconParams_t *params )
         default:
         case LORAMAC_HANDLER_BEACON_ACQUIRING:
         {
-            printf( "\n###### ========= BEACON ACQUIRING ========== ######\n" );
+            LOG_INFO( "\n###### ========= BEACON ACQUIRING ========== ######\n" );
             break;
         }
         case LORAMAC_HANDLER_BEACON_LOST:
         {
-            printf( "\n###### ============ BEACON LOST ============ ######\n" );
+            LOG_INFO( "\n###### ============ BEACON LOST ============ ######\n" );
             break;
         }
         case LORAMAC_HANDLER_BEACON_RX:
         {
-            printf( "\n###### ===== BEACON %8lu ==== ######\n", params->Info.Time.Seconds );
-            printf( "GW DESC     : %d\n", params->Info.GwSpecific.InfoDesc );
-            printf( "GW INFO     : " );
+            LOG_INFO( "\n###### ===== BEACON %8" PRIu32 " ==== ######\n", params->Info.Time.Seconds );
+            LOG_INFO( "GW DESC     : %d\n", params->Info.GwSpecific.InfoDesc );
+            LOG_INFO( "GW INFO     : " );
             PrintHexBuffer( params->Info.GwSpecific.Info, 6 );
-            printf( "\n" );
-            printf( "FREQ        : %lu\n", params->Info.Frequency );
-            printf( "DATA RATE   : DR_%d\n", params->Info.Datarate );
-            printf( "RX RSSI     : %d\n", params->Info.Rssi );
-            printf( "RX SNR      : %d\n", params->Info.Snr );
-            printf( "\n" );
+            LOG_INFO( "\n" );
+            LOG_INFO( "FREQ        : %" PRIu32 "\n", params->Info.Frequency );
+            LOG_INFO( "DATA RATE   : DR_%d\n", params->Info.Datarate );
+            LOG_INFO( "RX RSSI     : %d\n", params->Info.Rssi );
+            LOG_INFO( "RX SNR      : %d\n", params->Info.Snr );
+            LOG_INFO( "\n" );
             break;
         }
         case LORAMAC_HANDLER_BEACON_NRX:
         {
-            printf( "\n###### ======== BEACON NOT RECEIVED ======== ######\n" );
+            LOG_INFO( "\n###### ======== BEACON NOT RECEIVED ======== ######\n" );
             break;
         }
     }
@@ -415,14 +435,107 @@ void DisplayBeaconUpdate( LoRaMacHandlerBeaconParams_t *params )
 
 void DisplayClassUpdate( DeviceClass_t deviceClass )
 {
-    printf( "\n\n###### ===== Switch to Class %c done.  ===== ######\n\n", "ABC"[deviceClass] );
+    LOG_INFO( "\n\n###### ===== Switch to Class %c done.  ===== ######\n\n", "ABC"[deviceClass] );
 }
 
 void DisplayAppInfo( const char* appName, const Version_t* appVersion, const Version_t* gitHubVersion )
 {
-    printf( "\n###### ===================================== ######\n\n" );
-    printf( "Application name   : %s\n", appName );
-    printf( "Application version: %d.%d.%d\n", appVersion->Fields.Major, appVersion->Fields.Minor, appVersion->Fields.Patch );
-    printf( "GitHub base version: %d.%d.%d\n", gitHubVersion->Fields.Major, gitHubVersion->Fields.Minor, gitHubVersion->Fields.Patch );
-    printf( "\n###### ===================================== ######\n\n" );
+    LOG_INFO( "\n###### ===================================== ######\n\n" );
+    LOG_INFO( "Application name   : " );
+    LOG_STRING_INFO( appName );
+    LOG_INFO( "\n" );
+    LOG_INFO( "Application version: %d.%d.%d\n", appVersion->Fields.Major, appVersion->Fields.Minor, appVersion->Fields.Patch );
+    LOG_INFO( "GitHub base version: %d.%d.%d\n", gitHubVersion->Fields.Major, gitHubVersion->Fields.Minor, gitHubVersion->Fields.Patch );
+    LOG_INFO( "\n###### ===================================== ######\n\n" );
+}
+
+void DisplayMacTraceStats( void )
+{
+#if defined( LORAMAC_TRACE_ENABLED )
+    const char* siteStrings[] =
+    {
+        "ProcessRadioRxDone",            // LORAMAC_TRACE_SITE_PROCESS_RADIO_RX_DONE
+        "UnsecureMessage",               // LORAMAC_TRACE_SITE_UNSECURE_MESSAGE
+        "ScheduleTx",                    // LORAMAC_TRACE_SITE_SCHEDULE_TX
+        "NextChannel",                   // LORAMAC_TRACE_SITE_NEXT_CHANNEL
+        "HandleNvm",                     // LORAMAC_TRACE_SITE_HANDLE_NVM
+    };
+    LoRaMacTraceStats_t stats;
+
+    // Keep the messages order
+    DeferredLogProcess( );
+
+    printf( "\n###### ===== MAC TRACE ===== ######\n" );
+    for( uint8_t site = 0; site < LORAMAC_TRACE_SITE_MAX; site++ )
+    {
+        if( ( LoRaMacTraceGetStats( ( LoRaMacTraceSite_t )site, &stats ) != 0 ) || ( stats.Count == 0 ) )
+        {
+            continue;
+        }
+        printf( "%-18s: N %lu, MIN %lu, MAX %lu, AVG %lu\n", siteStrings[site], ( unsigned long )stats.Count,
+                ( unsigned long )stats.Min, ( unsigned long )stats.Max, ( unsigned long )( stats.Sum / stats.Count ) );
+        printf( "%-18s:", "HISTOGRAM" );
+        for( uint8_t bin = 0; bin < LORAMAC_TRACE_HISTOGRAM_BINS; bin++ )
+        {
+            if( stats.Histogram[bin] != 0 )
+            {
+                // Upper bound of the bin and number of samples
+                printf( " <%lu:%u", ( bin < 32 ) ? ( 1UL << bin ) : 0xFFFFFFFFUL, stats.Histogram[bin] );
+            }
+        }
+        printf( "\n" );
+    }
+    printf( "\n" );
+#endif
+}
+
+/*!
+ * \brief Prints a ledger entry
+ */
+static void PrintEnergyEntry( const char* name, const LoRaMacEnergyEntry_t* entry )
+{
+    uint32_t txTime = 0;
+
+    for( uint8_t i = 0; i < LORAMAC_ENERGY_TX_POWER_LEVELS; i++ )
+    {
+        txTime += entry->TxTime[i];
+    }
+    printf( "%-18s: TX %lu, TX TIME %lu ms, RX TIME %lu ms, LBT TIME %lu ms, SE OPS %lu, CHARGE %lu uC\n", name,
+            ( unsigned long )entry->NbTx, ( unsigned long )txTime, ( unsigned long )entry->RxTime,
+            ( unsigned long )entry->LbtTime, ( unsigned long )entry->NbSeOps, ( unsigned long )LoRaMacEnergyGetCharge( entry ) );
+}
+
+void DisplayEnergyLedger( void )
+{
+    const char* msgTypeStrings[] =
+    {
+        "JOIN",                          // LORAMAC_ENERGY_MSG_JOIN
+        "UNCONFIRMED",                   // LORAMAC_ENERGY_MSG_UNCONFIRMED
+        "CONFIRMED",                     // LORAMAC_ENERGY_MSG_CONFIRMED
+    };
+    MibRequestConfirm_t mibGet;
+    char name[24];
+
+    mibGet.Type = MIB_ENERGY_LEDGER;
+    if( LoRaMacMibGetRequestConfirm( &mibGet ) != LORAMAC_STATUS_OK )
+    {
+        return;
+    }
+
+    // Keep the messages order
+    DeferredLogProcess( );
+
+    printf( "\n###### ===== ENERGY LEDGER ===== ######\n" );
+    for( uint8_t i = 0; i < mibGet.Param.EnergyLedger->NbEntries; i++ )
+    {
+        const LoRaMacEnergyEntry_t* entry = &mibGet.Param.EnergyLedger->Entries[i];
+
+        snprintf( name, sizeof( name ), "PORT %3u %s", entry->FPort, msgTypeStrings[entry->MsgType] );
+        PrintEnergyEntry( name, entry );
+    }
+    if( mibGet.Param.EnergyLedger->Overflow.NbTx != 0 )
+    {
+        PrintEnergyEntry( "OTHERS", &mibGet.Param.EnergyLedger->Overflow );
+    }
+    printf( "\n" );
 }
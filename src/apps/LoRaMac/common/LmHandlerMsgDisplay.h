@@ -105,6 +105,20 @@ void DisplayClassUpdate( DeviceClass_t deviceClass );
  */
 void DisplayAppInfo( const char* appName, const Version_t* appVersion, const Version_t* gitHubVersion );
 
+/*!
+ * \brief Displays the LoRaMAC execution time trace statistics
+ *
+ * \remark Only displays data when LORAMAC_TRACE_ENABLED is defined
+ */
+void DisplayMacTraceStats( void );
+
+/*!
+ * \brief Displays the LoRaMAC energy and airtime ledger
+ *
+ * \remark Only displays data when LORAMAC_ENERGY_LEDGER_ENABLED is defined
+ */
+void DisplayEnergyLedger( void );
+
 #ifdef __cplusplus
 }
 #endif
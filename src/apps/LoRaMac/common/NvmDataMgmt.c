@@ -32,6 +32,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include "utilities.h"
 #include "nvmm.h"
 #include "LoRaMac.h"
@@ -46,11 +47,76 @@
 #endif
 
 
+/*!
+ * Enables/Disables the split context storage.
+ * When enabled, a first NvmDataMgmtStore call copies the changed NVM groups
+ * to a staging buffer while the MAC is stopped. The MAC is then restarted and
+ * each next call writes one staged group with a synchronous NvmmWrite call.
+ *
+ * \remark Requires a staging buffer of sizeof( LoRaMacNvmData_t ) bytes of RAM
+ */
+#ifndef NVM_DATA_MGMT_ASYNC_STORE_ENABLED
+#define NVM_DATA_MGMT_ASYNC_STORE_ENABLED  0
+#endif
+
+#if( CONTEXT_MANAGEMENT_ENABLED == 1 )
+/*!
+ * NVM context group
+ */
+typedef struct NvmDataMgmtGroup_s
+{
+    /*!
+     * Notification flag of the group
+     */
+    uint16_t NotifyFlag;
+    /*!
+     * Offset of the group in LoRaMacNvmData_t
+     */
+    uint16_t Offset;
+    /*!
+     * Size of the group
+     */
+    uint16_t Size;
+}NvmDataMgmtGroup_t;
+
+/*!
+ * NVM context groups, in the NVM storage order
+ */
+static const NvmDataMgmtGroup_t NvmGroups[] =
+{
+    { LORAMAC_NVM_NOTIFY_FLAG_CRYPTO, offsetof( LoRaMacNvmData_t, Crypto ), sizeof( LoRaMacCryptoNvmData_t ) },
+    { LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP1, offsetof( LoRaMacNvmData_t, MacGroup1 ), sizeof( LoRaMacNvmDataGroup1_t ) },
+    { LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP2, offsetof( LoRaMacNvmData_t, MacGroup2 ), sizeof( LoRaMacNvmDataGroup2_t ) },
+    { LORAMAC_NVM_NOTIFY_FLAG_SECURE_ELEMENT, offsetof( LoRaMacNvmData_t, SecureElement ), sizeof( SecureElementNvmData_t ) },
+    { LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP1, offsetof( LoRaMacNvmData_t, RegionGroup1 ), sizeof( RegionNvmDataGroup1_t ) },
+    { LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP2, offsetof( LoRaMacNvmData_t, RegionGroup2 ), sizeof( RegionNvmDataGroup2_t ) },
+    { LORAMAC_NVM_NOTIFY_FLAG_CLASS_B, offsetof( LoRaMacNvmData_t, ClassB ), sizeof( LoRaMacClassBNvmData_t ) },
+};
+#endif
+
 static uint16_t NvmNotifyFlags = 0;
 
+#if( ( CONTEXT_MANAGEMENT_ENABLED == 1 ) && ( NVM_DATA_MGMT_ASYNC_STORE_ENABLED == 1 ) )
+/*!
+ * Copy of the NVM groups being stored
+ */
+static LoRaMacNvmData_t StagedNvm;
+
+/*!
+ * Groups of StagedNvm not yet written
+ */
+static uint16_t StagedNotifyFlags = 0;
+
+/*!
+ * Number of bytes written since the staging of the groups
+ */
+static uint16_t StagedDataSize = 0;
+#endif
+
 void NvmDataMgmtEvent( uint16_t notifyFlags )
 {
-    NvmNotifyFlags = notifyFlags;
+    // Keep the groups not yet stored
+    NvmNotifyFlags |= notifyFlags;
 }
 
 uint16_t NvmDataMgmtStore( void )
@@ -63,79 +129,79 @@ uint16_t NvmDataMgmtStore( void )
     LoRaMacMibGetRequestConfirm( &mibReq );
     LoRaMacNvmData_t* nvm = mibReq.Param.Contexts;
 
-    // Input checks
-    if( NvmNotifyFlags == LORAMAC_NVM_NOTIFY_FLAG_NONE )
-    {
-        // There was no update.
-        return 0;
-    }
-    if( LoRaMacStop( ) != LORAMAC_STATUS_OK )
+#if( NVM_DATA_MGMT_ASYNC_STORE_ENABLED == 1 )
+    if( StagedNotifyFlags == LORAMAC_NVM_NOTIFY_FLAG_NONE )
     {
-        return 0;
-    }
+        // Input checks
+        if( NvmNotifyFlags == LORAMAC_NVM_NOTIFY_FLAG_NONE )
+        {
+            // There was no update.
+            return 0;
+        }
+        if( LoRaMacStop( ) != LORAMAC_STATUS_OK )
+        {
+            return 0;
+        }
 
-    // Crypto
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_CRYPTO ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_CRYPTO )
-    {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->Crypto, sizeof( nvm->Crypto ),
-                               offset );
-    }
-    offset += sizeof( nvm->Crypto );
+        // Snapshot the updated groups
+        for( uint8_t i = 0; i < ( sizeof( NvmGroups ) / sizeof( NvmGroups[0] ) ); i++ )
+        {
+            if( ( NvmNotifyFlags & NvmGroups[i].NotifyFlag ) == NvmGroups[i].NotifyFlag )
+            {
+                memcpy1( ( uint8_t* )&StagedNvm + NvmGroups[i].Offset,
+                         ( uint8_t* )nvm + NvmGroups[i].Offset, NvmGroups[i].Size );
+            }
+        }
+        StagedNotifyFlags = NvmNotifyFlags;
+        StagedDataSize = 0;
 
-    // MacGroup1
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP1 ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP1 )
-    {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->MacGroup1,
-                               sizeof( nvm->MacGroup1 ), offset );
+        // Reset notification flags
+        NvmNotifyFlags = LORAMAC_NVM_NOTIFY_FLAG_NONE;
+
+        // Resume LoRaMac. The groups are written by the next calls.
+        LoRaMacStart( );
+        return 0;
     }
-    offset += sizeof( nvm->MacGroup1 );
 
-    // MacGroup2
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP2 ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP2 )
+    // Write the first staged group
+    for( uint8_t i = 0; i < ( sizeof( NvmGroups ) / sizeof( NvmGroups[0] ) ); i++ )
     {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->MacGroup2,
-                               sizeof( nvm->MacGroup2 ), offset );
+        if( ( StagedNotifyFlags & NvmGroups[i].NotifyFlag ) == NvmGroups[i].NotifyFlag )
+        {
+            StagedDataSize += NvmmWrite( ( uint8_t* )&StagedNvm + NvmGroups[i].Offset,
+                                         NvmGroups[i].Size, offset );
+            StagedNotifyFlags &= ~NvmGroups[i].NotifyFlag;
+            break;
+        }
+        offset += NvmGroups[i].Size;
     }
-    offset += sizeof( nvm->MacGroup2 );
 
-    // Secure element
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_SECURE_ELEMENT ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_SECURE_ELEMENT )
+    if( StagedNotifyFlags == LORAMAC_NVM_NOTIFY_FLAG_NONE )
     {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->SecureElement, sizeof( nvm->SecureElement ),
-                               offset );
+        dataSize = StagedDataSize;
+        StagedDataSize = 0;
     }
-    offset += sizeof( nvm->SecureElement );
-
-    // Region group 1
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP1 ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP1 )
+    return dataSize;
+#else
+    // Input checks
+    if( NvmNotifyFlags == LORAMAC_NVM_NOTIFY_FLAG_NONE )
     {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->RegionGroup1,
-                               sizeof( nvm->RegionGroup1 ), offset );
+        // There was no update.
+        return 0;
     }
-    offset += sizeof( nvm->RegionGroup1 );
-
-    // Region group 2
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP2 ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP2 )
+    if( LoRaMacStop( ) != LORAMAC_STATUS_OK )
     {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->RegionGroup2,
-                               sizeof( nvm->RegionGroup2 ), offset );
+        return 0;
     }
-    offset += sizeof( nvm->RegionGroup2 );
 
-    // Class b
-    if( ( NvmNotifyFlags & LORAMAC_NVM_NOTIFY_FLAG_CLASS_B ) ==
-        LORAMAC_NVM_NOTIFY_FLAG_CLASS_B )
+    for( uint8_t i = 0; i < ( sizeof( NvmGroups ) / sizeof( NvmGroups[0] ) ); i++ )
     {
-        dataSize += NvmmWrite( ( uint8_t* ) &nvm->ClassB, sizeof( nvm->ClassB ),
-                               offset );
+        if( ( NvmNotifyFlags & NvmGroups[i].NotifyFlag ) == NvmGroups[i].NotifyFlag )
+        {
+            dataSize += NvmmWrite( ( uint8_t* )nvm + NvmGroups[i].Offset, NvmGroups[i].Size, offset );
+        }
+        offset += NvmGroups[i].Size;
     }
-    offset += sizeof( nvm->ClassB );
 
     // Reset notification flags
     NvmNotifyFlags = LORAMAC_NVM_NOTIFY_FLAG_NONE;
@@ -143,11 +209,21 @@ uint16_t NvmDataMgmtStore( void )
     // Resume LoRaMac
     LoRaMacStart( );
     return dataSize;
+#endif
 #else
     return 0;
 #endif
 }
 
+bool NvmDataMgmtIsStorePending( void )
+{
+#if( ( CONTEXT_MANAGEMENT_ENABLED == 1 ) && ( NVM_DATA_MGMT_ASYNC_STORE_ENABLED == 1 ) )
+    return StagedNotifyFlags != LORAMAC_NVM_NOTIFY_FLAG_NONE;
+#else
+    return false;
+#endif
+}
+
 uint16_t NvmDataMgmtRestore( void )
 {
 #if( CONTEXT_MANAGEMENT_ENABLED == 1 )
@@ -222,6 +298,12 @@ bool NvmDataMgmtFactoryReset( void )
 {
     uint16_t offset = 0;
 #if( CONTEXT_MANAGEMENT_ENABLED == 1 )
+#if( NVM_DATA_MGMT_ASYNC_STORE_ENABLED == 1 )
+    // Drop the groups not yet stored
+    StagedNotifyFlags = LORAMAC_NVM_NOTIFY_FLAG_NONE;
+    StagedDataSize = 0;
+#endif
+
     // Crypto
     if( NvmmReset( sizeof( LoRaMacCryptoNvmData_t ), offset ) == false )
     {
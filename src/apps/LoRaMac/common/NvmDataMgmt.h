@@ -52,10 +52,26 @@ void NvmDataMgmtEvent( uint16_t notifyFlags );
 /*!
  * \brief Function which stores the MAC data into NVM, if required.
  *
- * \retval Number of bytes which were stored.
+ * \remark When NVM_DATA_MGMT_ASYNC_STORE_ENABLED is set to 1, the store is
+ *         split over several calls: the first one copies the updated NVM
+ *         groups, each next one writes a single group. The writes remain
+ *         synchronous NvmmWrite calls. The store is complete when
+ *         \ref NvmDataMgmtIsStorePending turns false, even if this call
+ *         returns 0 because the writes failed.
+ *
+ * \retval Number of bytes which were stored. Returned once all the updated
+ *         groups are stored.
  */
 uint16_t NvmDataMgmtStore( void );
 
+/*!
+ * \brief Indicates if updated NVM groups are waiting to be written by
+ *        \ref NvmDataMgmtStore.
+ *
+ * \retval Returns true, if a store is pending.
+ */
+bool NvmDataMgmtIsStorePending( void );
+
 /*!
  * \brief Function which restores the MAC data from NVM, if required.
  *
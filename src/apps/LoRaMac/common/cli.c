@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "NvmDataMgmt.h"
+#include "LmHandlerMsgDisplay.h"
 #include "cli.h"
 
 void CliProcess( Uart_t* uart )
@@ -51,6 +52,16 @@ void CliProcess( Uart_t* uart )
                 printf( "\n\nPLEASE RESET THE END-DEVICE\n\n" );
                 while( 1 );
             }
+            else if( data == 'T' )
+            { // T character has been received
+                data = 0;
+                DisplayMacTraceStats( );
+            }
+            else if( data == 'E' )
+            { // E character has been received
+                data = 0;
+                DisplayEnergyLedger( );
+            }
         }
     }
 }
\ No newline at end of file
@@ -28,6 +28,8 @@
 /*!
  * Process characters received on the serial interface
  * \remark Characters sequence 'ESC' + 'N' execute a NVM factory reset
+ *         Characters sequence 'ESC' + 'T' display the LoRaMAC trace statistics
+ *         Characters sequence 'ESC' + 'E' display the LoRaMAC energy ledger
  *         All other sequences are ignored
  *
  * \param [IN] uart UART interface object used by the command line interface
@@ -38,6 +38,7 @@
 #include "LmhpRemoteMcastSetup.h"
 #include "LmhpFragmentation.h"
 #include "LmHandlerMsgDisplay.h"
+#include "DeferredLog.h"
 
 #ifndef ACTIVE_REGION
 
@@ -374,6 +375,12 @@ int main( void )
         // Process application uplinks management
         UplinkProcess( );
 
+        // Print the deferred messages while the MAC is idle
+        if( LoRaMacIsBusy( ) == false )
+        {
+            DeferredLogProcess( );
+        }
+
         CRITICAL_SECTION_BEGIN( );
         if( IsMacProcessPending == 1 )
         {
@@ -542,12 +549,12 @@ static void OnFragProgress( uint16_t fragCounter, uint16_t fragNb, uint8_t fragS
     GpioWrite( &Led3, 0 );
     TimerStart( &Led3Timer );
 
-    printf( "\n###### =========== FRAG_DECODER ============ ######\n" );
-    printf( "######               PROGRESS                ######\n");
-    printf( "###### ===================================== ######\n");
-    printf( "RECEIVED    : %5d / %5d Fragments\n", fragCounter, fragNb );
-    printf( "              %5d / %5d Bytes\n", fragCounter * fragSize, fragNb * fragSize );
-    printf( "LOST        :       %7d Fragments\n\n", fragNbLost );
+    LOG_INFO( "\n###### =========== FRAG_DECODER ============ ######\n" );
+    LOG_INFO( "######               PROGRESS                ######\n");
+    LOG_INFO( "###### ===================================== ######\n");
+    LOG_INFO( "RECEIVED    : %5d / %5d Fragments\n", fragCounter, fragNb );
+    LOG_INFO( "              %5d / %5d Bytes\n", fragCounter * fragSize, fragNb * fragSize );
+    LOG_INFO( "LOST        :       %7d Fragments\n\n", fragNbLost );
 }
 
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
@@ -558,11 +565,11 @@ static void OnFragDone( int32_t status, uint32_t size )
     // Switch LED 3 OFF
     GpioWrite( &Led3, 0 );
 
-    printf( "\n###### =========== FRAG_DECODER ============ ######\n" );
-    printf( "######               FINISHED                ######\n");
-    printf( "###### ===================================== ######\n");
-    printf( "STATUS      : %ld\n", status );
-    printf( "CRC         : %08lX\n\n", FileRxCrc );
+    LOG_INFO( "\n###### =========== FRAG_DECODER ============ ######\n" );
+    LOG_INFO( "######               FINISHED                ######\n");
+    LOG_INFO( "###### ===================================== ######\n");
+    LOG_INFO( "STATUS      : %ld\n", status );
+    LOG_INFO( "CRC         : %08lX\n\n", FileRxCrc );
 }
 #else
 static void OnFragDone( int32_t status, uint8_t *file, uint32_t size )
@@ -572,11 +579,11 @@ static void OnFragDone( int32_t status, uint8_t *file, uint32_t size )
     // Switch LED 3 OFF
     GpioWrite( &Led3, 0 );
 
-    printf( "\n###### =========== FRAG_DECODER ============ ######\n" );
-    printf( "######               FINISHED                ######\n");
-    printf( "###### ===================================== ######\n");
-    printf( "STATUS      : %ld\n", status );
-    printf( "CRC         : %08lX\n\n", FileRxCrc );
+    LOG_INFO( "\n###### =========== FRAG_DECODER ============ ######\n" );
+    LOG_INFO( "######               FINISHED                ######\n");
+    LOG_INFO( "###### ===================================== ######\n");
+    LOG_INFO( "STATUS      : %ld\n", status );
+    LOG_INFO( "CRC         : %08lX\n\n", FileRxCrc );
 }
 #endif
 
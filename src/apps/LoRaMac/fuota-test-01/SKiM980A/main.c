@@ -38,6 +38,7 @@
 #include "LmhpRemoteMcastSetup.h"
 #include "LmhpFragmentation.h"
 #include "LmHandlerMsgDisplay.h"
+#include "DeferredLog.h"
 
 #ifndef ACTIVE_REGION
 
@@ -348,6 +349,12 @@ int main( void )
         // Process application uplinks management
         UplinkProcess( );
 
+        // Print the deferred messages while the MAC is idle
+        if( LoRaMacIsBusy( ) == false )
+        {
+            DeferredLogProcess( );
+        }
+
         CRITICAL_SECTION_BEGIN( );
         if( IsMacProcessPending == 1 )
         {
@@ -514,12 +521,12 @@ static void OnFragProgress( uint16_t fragCounter, uint16_t fragNb, uint8_t fragS
     GpioWrite( &Led2, 0 );
     TimerStart( &Led2Timer );
 
-    printf( "\n###### =========== FRAG_DECODER ============ ######\n" );
-    printf( "######               PROGRESS                ######\n");
-    printf( "###### ===================================== ######\n");
-    printf( "RECEIVED    : %5d / %5d Fragments\n", fragCounter, fragNb );
-    printf( "              %5d / %5d Bytes\n", fragCounter * fragSize, fragNb * fragSize );
-    printf( "LOST        :       %7d Fragments\n\n", fragNbLost );
+    LOG_INFO( "\n###### =========== FRAG_DECODER ============ ######\n" );
+    LOG_INFO( "######               PROGRESS                ######\n");
+    LOG_INFO( "###### ===================================== ######\n");
+    LOG_INFO( "RECEIVED    : %5d / %5d Fragments\n", fragCounter, fragNb );
+    LOG_INFO( "              %5d / %5d Bytes\n", fragCounter * fragSize, fragNb * fragSize );
+    LOG_INFO( "LOST        :       %7d Fragments\n\n", fragNbLost );
 }
 
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
@@ -530,11 +537,11 @@ static void OnFragDone( int32_t status, uint32_t size )
     // Switch LED 2 OFF
     GpioWrite( &Led2, 0 );
 
-    printf( "\n###### =========== FRAG_DECODER ============ ######\n" );
-    printf( "######               FINISHED                ######\n");
-    printf( "###### ===================================== ######\n");
-    printf( "STATUS      : %ld\n", status );
-    printf( "CRC         : %08lX\n\n", FileRxCrc );
+    LOG_INFO( "\n###### =========== FRAG_DECODER ============ ######\n" );
+    LOG_INFO( "######               FINISHED                ######\n");
+    LOG_INFO( "###### ===================================== ######\n");
+    LOG_INFO( "STATUS      : %ld\n", status );
+    LOG_INFO( "CRC         : %08lX\n\n", FileRxCrc );
 }
 #else
 static void OnFragDone( int32_t status, uint8_t *file, uint32_t size )
@@ -544,11 +551,11 @@ static void OnFragDone( int32_t status, uint8_t *file, uint32_t size )
     // Switch LED 2 OFF
     GpioWrite( &Led2, 0 );
 
-    printf( "\n###### =========== FRAG_DECODER ============ ######\n" );
-    printf( "######               FINISHED                ######\n");
-    printf( "###### ===================================== ######\n");
-    printf( "STATUS      : %ld\n", status );
-    printf( "CRC         : %08lX\n\n", FileRxCrc );
+    LOG_INFO( "\n###### =========== FRAG_DECODER ============ ######\n" );
+    LOG_INFO( "######               FINISHED                ######\n");
+    LOG_INFO( "###### ===================================== ######\n");
+    LOG_INFO( "STATUS      : %ld\n", status );
+    LOG_INFO( "CRC         : %08lX\n\n", FileRxCrc );
 }
 #endif
 
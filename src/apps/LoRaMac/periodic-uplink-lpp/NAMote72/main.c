@@ -38,7 +38,9 @@
 #include "LmHandler.h"
 #include "LmhpCompliance.h"
 #include "CayenneLpp.h"
+#include "CayenneLppCompact.h"
 #include "LmHandlerMsgDisplay.h"
+#include "DeferredLog.h"
 
 #ifndef ACTIVE_REGION
 
@@ -127,6 +129,22 @@ static LmHandlerAppData_t AppData =
     .Port = 0,
 };
 
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+/*!
+ * Compact Cayenne LPP channels schema of the uplinks. The decoder must use
+ * the same schema.
+ * Every uplink carries the sensors and the GPS position.
+ */
+static const CayenneLppCompactChannel_t AppLppSchema[] =
+{
+    { .Channel = 0, .Type = LPP_DIGITAL_INPUT, .NbValues = 1, .Bits = 2, .IsDelta = false },
+    { .Channel = 1, .Type = LPP_ANALOG_INPUT, .NbValues = 1, .Bits = 16, .IsDelta = true },
+    { .Channel = 2, .Type = LPP_TEMPERATURE, .NbValues = 1, .Bits = 16, .IsDelta = true },
+    { .Channel = 3, .Type = LPP_BAROMETRIC_PRESSURE, .NbValues = 1, .Bits = 16, .IsDelta = true },
+    { .Channel = 4, .Type = LPP_GPS, .NbValues = 3, .Bits = 24, .IsDelta = true },
+};
+#endif
+
 /*!
  * Specifies the state of the application LED
  */
@@ -314,6 +332,12 @@ int main( void )
         // Process application uplinks management
         UplinkProcess( );
 
+        // Print the deferred messages while the MAC is idle
+        if( LoRaMacIsBusy( ) == false )
+        {
+            DeferredLogProcess( );
+        }
+
         CRITICAL_SECTION_BEGIN( );
         if( IsMacProcessPending == 1 )
         {
@@ -475,6 +499,26 @@ static void PrepareTxFrame( void )
 
     AppData.Port = LORAWAN_APP_PORT;
 
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+    // Values in the LPP data types resolution
+    int32_t values[] = { AppLedStateOn, BoardGetBatteryLevel( ) * 10000 / 254, MPL3115ReadTemperature( ) * 10,
+                         MPL3115ReadPressure( ) / 10, 0, 0, 0 };
+
+    if( GpsHasFix( ) == true )
+    {
+        double latitude = 0, longitude = 0;
+
+        GpsGetLatestGpsPositionDouble( &latitude, &longitude );
+        values[4] = latitude * 10000;
+        values[5] = longitude * 10000;
+        values[6] = GpsGetLatestGpsAltitude( ) * 100;                 // in cm
+    }
+    CayenneLppCompact_t lpp;
+
+    CayenneLppCompactInit( &lpp, AppLppSchema, sizeof( AppLppSchema ) / sizeof( AppLppSchema[0] ),
+                           AppData.Buffer, LORAWAN_APP_DATA_BUFFER_MAX_SIZE );
+    AppData.BufferSize = CayenneLppCompactAddSample( &lpp, values );
+#else
     CayenneLppReset( );
     if( TxGpsData == 0 )
     {
@@ -503,6 +547,7 @@ static void PrepareTxFrame( void )
 
     CayenneLppCopy( AppData.Buffer );
     AppData.BufferSize = CayenneLppGetSize( );
+#endif
 
     if( LmHandlerSend( &AppData, LmHandlerParams.IsTxConfirmed ) == LORAMAC_HANDLER_SUCCESS )
     {
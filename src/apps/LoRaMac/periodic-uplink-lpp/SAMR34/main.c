@@ -35,7 +35,9 @@
 #include "LmHandler.h"
 #include "LmhpCompliance.h"
 #include "CayenneLpp.h"
+#include "CayenneLppCompact.h"
 #include "LmHandlerMsgDisplay.h"
+#include "DeferredLog.h"
 
 #ifndef ACTIVE_REGION
 
@@ -124,6 +126,18 @@ static LmHandlerAppData_t AppData =
     .Port = 0,
 };
 
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+/*!
+ * Compact Cayenne LPP channels schema of the uplinks. The decoder must use
+ * the same schema.
+ */
+static const CayenneLppCompactChannel_t AppLppSchema[] =
+{
+    { .Channel = 0, .Type = LPP_DIGITAL_INPUT, .NbValues = 1, .Bits = 2, .IsDelta = false },
+    { .Channel = 1, .Type = LPP_ANALOG_INPUT, .NbValues = 1, .Bits = 16, .IsDelta = true },
+};
+#endif
+
 /*!
  * Specifies the state of the application LED
  */
@@ -312,6 +326,12 @@ int main( void )
         // Process application uplinks management
         UplinkProcess( );
 
+        // Print the deferred messages while the MAC is idle
+        if( LoRaMacIsBusy( ) == false )
+        {
+            DeferredLogProcess( );
+        }
+
         CRITICAL_SECTION_BEGIN( );
         if( IsMacProcessPending == 1 )
         {
@@ -451,16 +471,26 @@ static void PrepareTxFrame( void )
         return;
     }
 
-    uint8_t channel = 0;
-
     AppData.Port = LORAWAN_APP_PORT;
 
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+    // Values in the LPP data types resolution
+    int32_t values[] = { AppLedStateOn, BoardGetBatteryLevel( ) * 10000 / 254 };
+    CayenneLppCompact_t lpp;
+
+    CayenneLppCompactInit( &lpp, AppLppSchema, sizeof( AppLppSchema ) / sizeof( AppLppSchema[0] ),
+                           AppData.Buffer, LORAWAN_APP_DATA_BUFFER_MAX_SIZE );
+    AppData.BufferSize = CayenneLppCompactAddSample( &lpp, values );
+#else
+    uint8_t channel = 0;
+
     CayenneLppReset( );
     CayenneLppAddDigitalInput( channel++, AppLedStateOn );
     CayenneLppAddAnalogInput( channel++, BoardGetBatteryLevel( ) * 100 / 254 );
 
     CayenneLppCopy( AppData.Buffer );
     AppData.BufferSize = CayenneLppGetSize( );
+#endif
 
     if( LmHandlerSend( &AppData, LmHandlerParams.IsTxConfirmed ) == LORAMAC_HANDLER_SUCCESS )
     {
@@ -0,0 +1,813 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Performs a periodic uplink on the simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2018 Semtech
+ *
+ * \endcode
+ *
+ * \author    Miguel Luis ( Semtech )
+ *
+ * \remark    The application runs on the host, in virtual time, against the
+ *            virtual radio channel and the network server stub of the
+ *            Simulation board. The SIM_* settings can be overridden at compile
+ *            time. The statistics are printed at the end of the simulation.
+ */
+
+/*! \file periodic-uplink/Simulation/main.c */
+
+#include <stdio.h>
+#include "../firmwareVersion.h"
+#include "../../common/githubVersion.h"
+#include "utilities.h"
+#include "board.h"
+#include "gpio.h"
+#include "uart.h"
+#include "RegionCommon.h"
+
+#include "cli.h"
+#include "Commissioning.h"
+#include "LmHandler.h"
+#include "LmhpCompliance.h"
+#include "CayenneLpp.h"
+#include "CayenneLppCompact.h"
+#include "LmHandlerMsgDisplay.h"
+#include "DeferredLog.h"
+#include "sim.h"
+#include "sim-channel.h"
+#include "sim-network.h"
+
+#ifndef ACTIVE_REGION
+
+#warning "No active region defined, LORAMAC_REGION_EU868 will be used as default."
+
+#define ACTIVE_REGION LORAMAC_REGION_EU868
+
+#endif
+
+/*!
+ * Simulation random generator seed
+ */
+#ifndef SIM_SEED
+#define SIM_SEED                                    1
+#endif
+
+/*!
+ * Simulation duration [s]
+ */
+#ifndef SIM_DURATION
+#define SIM_DURATION                                3600
+#endif
+
+/*!
+ * Mean link SNR [dB]
+ */
+#ifndef SIM_SNR_MEAN
+#define SIM_SNR_MEAN                                0
+#endif
+
+/*!
+ * Link SNR standard deviation [dB]
+ */
+#ifndef SIM_SNR_STD_DEV
+#define SIM_SNR_STD_DEV                             3
+#endif
+
+/*!
+ * Random frame loss rate [per mille]
+ */
+#ifndef SIM_LOSS_RATE
+#define SIM_LOSS_RATE                               0
+#endif
+
+/*!
+ * Mean interval between the interferer frames [s], 0 disables the interferer
+ */
+#ifndef SIM_INTERFERER_INTERVAL
+#define SIM_INTERFERER_INTERVAL                     0
+#endif
+
+/*!
+ * Number of uplinks between two DevStatusReq, 0 to disable
+ */
+#ifndef SIM_DEV_STATUS_INTERVAL
+#define SIM_DEV_STATUS_INTERVAL                     0
+#endif
+
+/*!
+ * LoRaWAN default end-device class
+ */
+#ifndef LORAWAN_DEFAULT_CLASS
+#define LORAWAN_DEFAULT_CLASS                       CLASS_A
+#endif
+
+/*!
+ * Defines the application data transmission duty cycle. 5s, value in [ms].
+ */
+#define APP_TX_DUTYCYCLE                            5000
+
+/*!
+ * Defines a random delay for application data transmission duty cycle. 1s,
+ * value in [ms].
+ */
+#define APP_TX_DUTYCYCLE_RND                        1000
+
+/*!
+ * LoRaWAN Adaptive Data Rate
+ *
+ * \remark Please note that when ADR is enabled the end-device should be static
+ */
+#define LORAWAN_ADR_STATE                           LORAMAC_HANDLER_ADR_ON
+
+/*!
+ * Default datarate
+ *
+ * \remark Please note that LORAWAN_DEFAULT_DATARATE is used only when ADR is disabled 
+ */
+#define LORAWAN_DEFAULT_DATARATE                    DR_0
+
+/*!
+ * LoRaWAN confirmed messages
+ */
+#define LORAWAN_DEFAULT_CONFIRMED_MSG_STATE         LORAMAC_HANDLER_UNCONFIRMED_MSG
+
+/*!
+ * User application data buffer size
+ */
+#define LORAWAN_APP_DATA_BUFFER_MAX_SIZE            242
+
+/*!
+ * LoRaWAN ETSI duty cycle control enable/disable
+ *
+ * \remark Please note that ETSI mandates duty cycled transmissions. Use only for test purposes
+ */
+#define LORAWAN_DUTYCYCLE_ON                        true
+
+/*!
+ * LoRaWAN application port
+ * @remark The allowed port range is from 1 up to 223. Other values are reserved.
+ */
+#define LORAWAN_APP_PORT                            2
+
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+/*!
+ * Energy model of the Simulation board. SX1276 radio on the PA_BOOST output,
+ * the TX currents are indexed by the EU868 TX power indexes ( 16 dBm EIRP
+ * down to 2 dBm ). The secure element operations are software AES-CMAC
+ * computations of about 0.5 ms at 3 mA.
+ */
+static const LoRaMacEnergyModel_t EnergyModel =
+{
+    .TxCurrent = { 90000, 78000, 68000, 60000, 53000, 47000, 42000, 38000,
+                   38000, 38000, 38000, 38000, 38000, 38000, 38000, 38000 },
+    .RxCurrent = 11500,
+    .SeOpCharge = 1500,
+};
+#endif
+
+/*!
+ *
+ */
+typedef enum
+{
+    LORAMAC_HANDLER_TX_ON_TIMER,
+    LORAMAC_HANDLER_TX_ON_EVENT,
+}LmHandlerTxEvents_t;
+
+/*!
+ * User application data
+ */
+static uint8_t AppDataBuffer[LORAWAN_APP_DATA_BUFFER_MAX_SIZE];
+
+/*!
+ * User application data structure
+ */
+static LmHandlerAppData_t AppData =
+{
+    .Buffer = AppDataBuffer,
+    .BufferSize = 0,
+    .Port = 0,
+};
+
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+/*!
+ * Compact Cayenne LPP channels schema of the uplinks. The decoder must use
+ * the same schema.
+ */
+static const CayenneLppCompactChannel_t AppLppSchema[] =
+{
+    { .Channel = 0, .Type = LPP_DIGITAL_INPUT, .NbValues = 1, .Bits = 2, .IsDelta = false },
+    { .Channel = 1, .Type = LPP_ANALOG_INPUT, .NbValues = 1, .Bits = 16, .IsDelta = true },
+};
+#endif
+
+/*!
+ * Specifies the state of the application LED
+ */
+static bool AppLedStateOn = false;
+
+/*!
+ * Timer to handle the application data transmission duty cycle
+ */
+static TimerEvent_t TxTimer;
+
+/*!
+ * Timer to handle the state of LED1
+ */
+static TimerEvent_t Led1Timer;
+
+/*!
+ * Timer to handle the state of LED2
+ */
+static TimerEvent_t Led2Timer;
+
+/*!
+ * Timer to handle the state of LED beacon indicator
+ */
+static TimerEvent_t LedBeaconTimer;
+
+static void OnMacProcessNotify( void );
+static void OnNvmDataChange( LmHandlerNvmContextStates_t state, uint16_t size );
+static void OnNetworkParametersChange( CommissioningParams_t* params );
+static void OnMacMcpsRequest( LoRaMacStatus_t status, McpsReq_t *mcpsReq, TimerTime_t nextTxIn );
+static void OnMacMlmeRequest( LoRaMacStatus_t status, MlmeReq_t *mlmeReq, TimerTime_t nextTxIn );
+static void OnJoinRequest( LmHandlerJoinParams_t* params );
+static void OnTxData( LmHandlerTxParams_t* params );
+static void OnRxData( LmHandlerAppData_t* appData, LmHandlerRxParams_t* params );
+static void OnClassChange( DeviceClass_t deviceClass );
+static void OnBeaconStatusChange( LoRaMacHandlerBeaconParams_t* params );
+#if( LMH_SYS_TIME_UPDATE_NEW_API == 1 )
+static void OnSysTimeUpdate( bool isSynchronized, int32_t timeCorrection );
+#else
+static void OnSysTimeUpdate( void );
+#endif
+static void PrepareTxFrame( void );
+static void StartTxProcess( LmHandlerTxEvents_t txEvent );
+static void UplinkProcess( void );
+
+static void OnTxPeriodicityChanged( uint32_t periodicity );
+static void OnTxFrameCtrlChanged( LmHandlerMsgTypes_t isTxConfirmed );
+static void OnPingSlotPeriodicityChanged( uint8_t pingSlotPeriodicity );
+
+/*!
+ * Function executed on TxTimer event
+ */
+static void OnTxTimerEvent( void* context );
+
+/*!
+ * Function executed on Led 1 Timeout event
+ */
+static void OnLed1TimerEvent( void* context );
+
+/*!
+ * Function executed on Led 2 Timeout event
+ */
+static void OnLed2TimerEvent( void* context );
+
+/*!
+ * \brief Function executed on Beacon timer Timeout event
+ */
+static void OnLedBeaconTimerEvent( void* context );
+
+static LmHandlerCallbacks_t LmHandlerCallbacks =
+{
+    .GetBatteryLevel = BoardGetBatteryLevel,
+    .GetTemperature = NULL,
+    .GetRandomSeed = BoardGetRandomSeed,
+    .OnMacProcess = OnMacProcessNotify,
+    .OnNvmDataChange = OnNvmDataChange,
+    .OnNetworkParametersChange = OnNetworkParametersChange,
+    .OnMacMcpsRequest = OnMacMcpsRequest,
+    .OnMacMlmeRequest = OnMacMlmeRequest,
+    .OnJoinRequest = OnJoinRequest,
+    .OnTxData = OnTxData,
+    .OnRxData = OnRxData,
+    .OnClassChange= OnClassChange,
+    .OnBeaconStatusChange = OnBeaconStatusChange,
+    .OnSysTimeUpdate = OnSysTimeUpdate,
+};
+
+static LmHandlerParams_t LmHandlerParams =
+{
+    .Region = ACTIVE_REGION,
+    .AdrEnable = LORAWAN_ADR_STATE,
+    .IsTxConfirmed = LORAWAN_DEFAULT_CONFIRMED_MSG_STATE,
+    .TxDatarate = LORAWAN_DEFAULT_DATARATE,
+    .PublicNetworkEnable = LORAWAN_PUBLIC_NETWORK,
+    .DutyCycleEnabled = LORAWAN_DUTYCYCLE_ON,
+    .DataBufferMaxSize = LORAWAN_APP_DATA_BUFFER_MAX_SIZE,
+    .DataBuffer = AppDataBuffer,
+    .PingSlotPeriodicity = REGION_COMMON_DEFAULT_PING_SLOT_PERIODICITY,
+};
+
+static LmhpComplianceParams_t LmhpComplianceParams =
+{
+    .FwVersion.Value = FIRMWARE_VERSION,
+    .OnTxPeriodicityChanged = OnTxPeriodicityChanged,
+    .OnTxFrameCtrlChanged = OnTxFrameCtrlChanged,
+    .OnPingSlotPeriodicityChanged = OnPingSlotPeriodicityChanged,
+};
+
+/*!
+ * Indicates if LoRaMacProcess call is pending.
+ * 
+ * \warning If variable is equal to 0 then the MCU can be set in low power mode
+ */
+static volatile uint8_t IsMacProcessPending = 0;
+
+static volatile uint8_t IsTxFramePending = 0;
+
+static volatile uint32_t TxPeriodicity = 0;
+
+/*!
+ * EU868 default channels frequencies, used by the interferer
+ */
+static const uint32_t InterfererFrequencies[] = { 868100000, 868300000, 868500000 };
+
+/*!
+ * Virtual radio channel parameters
+ */
+static const SimChannelParams_t SimChannelParams =
+{
+    .SnrMean = SIM_SNR_MEAN,
+    .SnrStdDev = SIM_SNR_STD_DEV,
+    .NoiseFloor = -117,
+    .LossRate = SIM_LOSS_RATE,
+    .CaptureMargin = 6,
+    .InterfererInterval = SIM_INTERFERER_INTERVAL,
+    .InterfererSize = 20,
+    .InterfererFrequencies = InterfererFrequencies,
+    .NbInterfererFrequencies = 3,
+};
+
+/*!
+ * EU868 channel frequency list: 867.1, 867.3, 867.5, 867.7 and 867.9 MHz
+ */
+static const uint8_t SimCfList[16] =
+{
+    0x18, 0x4F, 0x84, 0xE8, 0x56, 0x84, 0xB8, 0x5E, 0x84, 0x88, 0x66, 0x84, 0x58, 0x6E, 0x84, 0x00,
+};
+
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+/*!
+ * Number of compact Cayenne LPP samples decoded by the network side and of
+ * the uplinks which failed to decode
+ */
+static uint32_t NbLppSamples = 0;
+static uint32_t NbLppErrors = 0;
+
+static void OnNetworkUplink( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size );
+#endif
+
+/*!
+ * Network server stub parameters. The NwkKey is the se-identity.h default one.
+ */
+static const SimNetworkParams_t SimNetworkParams =
+{
+    .NwkKey = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C },
+    .NetId = 0x000013,
+    .DevAddr = 0x26011234,
+    .CfList = SimCfList,
+    .AdrEnabled = true,
+    .AdrMaxDatarate = DR_5,
+    .AdrChMask = 0x00FF,
+    .DevStatusInterval = SIM_DEV_STATUS_INTERVAL,
+    .GpsTimeOffset = 1300000000,
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+    .OnUplink = OnNetworkUplink,
+#endif
+};
+
+/*!
+ * LED GPIO pins objects
+ */
+extern Gpio_t Led1; // Tx
+extern Gpio_t Led2; // Rx
+
+/*!
+ * UART object used for command line interface handling
+ */
+extern Uart_t Uart2;
+
+static void DisplaySimulationStats( void );
+
+/*!
+ * Main application entry point.
+ */
+int main( void )
+{
+    SimInit( SIM_SEED, SIM_DURATION );
+    SimChannelInit( &SimChannelParams );
+    SimNetworkInit( &SimNetworkParams );
+
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    TimerInit( &Led1Timer, OnLed1TimerEvent );
+    TimerSetValue( &Led1Timer, 25 );
+
+    TimerInit( &Led2Timer, OnLed2TimerEvent );
+    TimerSetValue( &Led2Timer, 25 );
+
+    TimerInit( &LedBeaconTimer, OnLedBeaconTimerEvent );
+    TimerSetValue( &LedBeaconTimer, 5000 );
+
+    // Initialize transmission periodicity variable
+    TxPeriodicity = APP_TX_DUTYCYCLE + randr( -APP_TX_DUTYCYCLE_RND, APP_TX_DUTYCYCLE_RND );
+
+    const Version_t appVersion = { .Value = FIRMWARE_VERSION };
+    const Version_t gitHubVersion = { .Value = GITHUB_VERSION };
+    DisplayAppInfo( "periodic-uplink-lpp", 
+                    &appVersion,
+                    &gitHubVersion );
+
+    if ( LmHandlerInit( &LmHandlerCallbacks, &LmHandlerParams ) != LORAMAC_HANDLER_SUCCESS )
+    {
+        printf( "LoRaMac wasn't properly initialized\n" );
+        // Fatal error, endless loop.
+        return 1;
+    }
+
+    // Set system maximum tolerated rx error in milliseconds
+    LmHandlerSetSystemMaxRxError( 20 );
+
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+    MibRequestConfirm_t mibReq;
+
+    mibReq.Type = MIB_ENERGY_MODEL;
+    mibReq.Param.EnergyModel = &EnergyModel;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+#endif
+
+    // The LoRa-Alliance Compliance protocol package should always be
+    // initialized and activated.
+    LmHandlerPackageRegister( PACKAGE_ID_COMPLIANCE, &LmhpComplianceParams );
+
+    LmHandlerJoin( );
+
+    StartTxProcess( LORAMAC_HANDLER_TX_ON_TIMER );
+
+    while( SimIsRunning( ) == true )
+    {
+        // Process characters sent over the command line interface
+        CliProcess( &Uart2 );
+
+        // Processes the LoRaMac events
+        LmHandlerProcess( );
+
+        // Process application uplinks management
+        UplinkProcess( );
+
+        // Print the deferred messages while the MAC is idle
+        if( LoRaMacIsBusy( ) == false )
+        {
+            DeferredLogProcess( );
+        }
+
+        CRITICAL_SECTION_BEGIN( );
+        if( IsMacProcessPending == 1 )
+        {
+            // Clear flag and prevent MCU to go into low power modes.
+            IsMacProcessPending = 0;
+        }
+        else
+        {
+            // The MCU wakes up through events
+            BoardLowPowerHandler( );
+        }
+        CRITICAL_SECTION_END( );
+    }
+
+    DeferredLogProcess( );
+    DisplayMacTraceStats( );
+    DisplayEnergyLedger( );
+    DisplaySimulationStats( );
+    return 0;
+}
+
+/*!
+ * Prints the channel and network statistics
+ */
+static void DisplaySimulationStats( void )
+{
+    const SimChannelStats_t* channelStats = SimChannelGetStats( );
+    const SimNetworkStats_t* networkStats = SimNetworkGetStats( );
+
+    printf( "\n###### ===== Simulation: %u s, seed %u ==== ######\n", SIM_DURATION, SIM_SEED );
+    printf( "Channel  : device TX %u, network TX %u, interferer TX %u\n",
+            ( unsigned )channelStats->NbTx[SIM_CHANNEL_NODE_DEVICE],
+            ( unsigned )channelStats->NbTx[SIM_CHANNEL_NODE_NETWORK],
+            ( unsigned )channelStats->NbTx[SIM_CHANNEL_NODE_INTERFERER] );
+    printf( "Channel  : received %u, lost %u, collisions %u\n",
+            ( unsigned )channelStats->NbRx, ( unsigned )channelStats->NbLost,
+            ( unsigned )channelStats->NbCollisions );
+    printf( "Network  : join requests %u, uplinks %u ( confirmed %u ), rejected %u, FCnt gaps %u\n",
+            ( unsigned )networkStats->NbJoinRequests, ( unsigned )networkStats->NbUplinks,
+            ( unsigned )networkStats->NbConfirmedUplinks, ( unsigned )networkStats->NbRejected,
+            ( unsigned )networkStats->NbFCntGaps );
+    printf( "Network  : downlinks %u, LinkADRReq %u\n",
+            ( unsigned )networkStats->NbDownlinks, ( unsigned )networkStats->NbAdrRequests );
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+    printf( "Network  : compact LPP samples %u, decoding errors %u\n",
+            ( unsigned )NbLppSamples, ( unsigned )NbLppErrors );
+#endif
+}
+
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+/*!
+ * Decodes the application uplinks on the network side
+ */
+static void OnNetworkUplink( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size )
+{
+    int32_t values[CAYENNE_LPP_COMPACT_MAX_VALUES];
+    CayenneLppCompact_t lpp;
+
+    if( port != LORAWAN_APP_PORT )
+    {
+        return;
+    }
+    if( CayenneLppCompactDecodeInit( &lpp, AppLppSchema, sizeof( AppLppSchema ) / sizeof( AppLppSchema[0] ),
+                                     ( uint8_t* )buffer, size ) == false )
+    {
+        NbLppErrors++;
+        return;
+    }
+    while( CayenneLppCompactGetSample( &lpp, values ) == true )
+    {
+        NbLppSamples++;
+    }
+    // Every sample of the payload must be decoded, with valid values
+    if( ( lpp.NbSamples == 0 ) || ( lpp.NbSamples != buffer[0] ) || ( values[0] < 0 ) || ( values[0] > 1 ) ||
+        ( values[1] < 0 ) || ( values[1] > 10000 ) )
+    {
+        NbLppErrors++;
+    }
+}
+#endif
+
+static void OnMacProcessNotify( void )
+{
+    IsMacProcessPending = 1;
+}
+
+static void OnNvmDataChange( LmHandlerNvmContextStates_t state, uint16_t size )
+{
+    DisplayNvmDataChange( state, size );
+}
+
+static void OnNetworkParametersChange( CommissioningParams_t* params )
+{
+    DisplayNetworkParametersUpdate( params );
+}
+
+static void OnMacMcpsRequest( LoRaMacStatus_t status, McpsReq_t *mcpsReq, TimerTime_t nextTxIn )
+{
+    DisplayMacMcpsRequestUpdate( status, mcpsReq, nextTxIn );
+}
+
+static void OnMacMlmeRequest( LoRaMacStatus_t status, MlmeReq_t *mlmeReq, TimerTime_t nextTxIn )
+{
+    DisplayMacMlmeRequestUpdate( status, mlmeReq, nextTxIn );
+}
+
+static void OnJoinRequest( LmHandlerJoinParams_t* params )
+{
+    DisplayJoinRequestUpdate( params );
+    if( params->Status == LORAMAC_HANDLER_ERROR )
+    {
+        LmHandlerJoin( );
+    }
+    else
+    {
+        LmHandlerRequestClass( LORAWAN_DEFAULT_CLASS );
+    }
+}
+
+static void OnTxData( LmHandlerTxParams_t* params )
+{
+    DisplayTxUpdate( params );
+}
+
+static void OnRxData( LmHandlerAppData_t* appData, LmHandlerRxParams_t* params )
+{
+    DisplayRxUpdate( appData, params );
+
+    switch( appData->Port )
+    {
+    case 1: // The application LED can be controlled on port 1 or 2
+    case LORAWAN_APP_PORT:
+        {
+            AppLedStateOn = appData->Buffer[0] & 0x01;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Switch LED 2 ON for each received downlink
+    GpioWrite( &Led2, 1 );
+    TimerStart( &Led2Timer );
+}
+
+static void OnClassChange( DeviceClass_t deviceClass )
+{
+    DisplayClassUpdate( deviceClass );
+
+    // Inform the server as soon as possible that the end-device has switched to ClassB
+    LmHandlerAppData_t appData =
+    {
+        .Buffer = NULL,
+        .BufferSize = 0,
+        .Port = 0,
+    };
+    LmHandlerSend( &appData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+}
+
+static void OnBeaconStatusChange( LoRaMacHandlerBeaconParams_t* params )
+{
+    switch( params->State )
+    {
+        case LORAMAC_HANDLER_BEACON_RX:
+        {
+            TimerStart( &LedBeaconTimer );
+            break;
+        }
+        case LORAMAC_HANDLER_BEACON_LOST:
+        case LORAMAC_HANDLER_BEACON_NRX:
+        {
+            TimerStop( &LedBeaconTimer );
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    DisplayBeaconUpdate( params );
+}
+
+#if( LMH_SYS_TIME_UPDATE_NEW_API == 1 )
+static void OnSysTimeUpdate( bool isSynchronized, int32_t timeCorrection )
+{
+
+}
+#else
+static void OnSysTimeUpdate( void )
+{
+
+}
+#endif
+
+/*!
+ * Prepares the payload of the frame and transmits it.
+ */
+static void PrepareTxFrame( void )
+{
+    if( LmHandlerIsBusy( ) == true )
+    {
+        return;
+    }
+
+    AppData.Port = LORAWAN_APP_PORT;
+
+#if defined( CAYENNE_LPP_COMPACT_ENABLED )
+    // Values in the LPP data types resolution
+    int32_t values[] = { AppLedStateOn, BoardGetBatteryLevel( ) * 10000 / 254 };
+    CayenneLppCompact_t lpp;
+
+    CayenneLppCompactInit( &lpp, AppLppSchema, sizeof( AppLppSchema ) / sizeof( AppLppSchema[0] ),
+                           AppData.Buffer, LORAWAN_APP_DATA_BUFFER_MAX_SIZE );
+    AppData.BufferSize = CayenneLppCompactAddSample( &lpp, values );
+#else
+    uint8_t channel = 0;
+
+    CayenneLppReset( );
+    CayenneLppAddDigitalInput( channel++, AppLedStateOn );
+    CayenneLppAddAnalogInput( channel++, BoardGetBatteryLevel( ) * 100 / 254 );
+
+    CayenneLppCopy( AppData.Buffer );
+    AppData.BufferSize = CayenneLppGetSize( );
+#endif
+
+    if( LmHandlerSend( &AppData, LmHandlerParams.IsTxConfirmed ) == LORAMAC_HANDLER_SUCCESS )
+    {
+        // Switch LED 1 ON
+        GpioWrite( &Led1, 1 );
+        TimerStart( &Led1Timer );
+    }
+}
+
+static void StartTxProcess( LmHandlerTxEvents_t txEvent )
+{
+    switch( txEvent )
+    {
+    default:
+        // Intentional fall through
+    case LORAMAC_HANDLER_TX_ON_TIMER:
+        {
+            // Schedule 1st packet transmission
+            TimerInit( &TxTimer, OnTxTimerEvent );
+            TimerSetValue( &TxTimer, TxPeriodicity );
+            OnTxTimerEvent( NULL );
+        }
+        break;
+    case LORAMAC_HANDLER_TX_ON_EVENT:
+        {
+        }
+        break;
+    }
+}
+
+static void UplinkProcess( void )
+{
+    uint8_t isPending = 0;
+    CRITICAL_SECTION_BEGIN( );
+    isPending = IsTxFramePending;
+    IsTxFramePending = 0;
+    CRITICAL_SECTION_END( );
+    if( isPending == 1 )
+    {
+        PrepareTxFrame( );
+    }
+}
+
+static void OnTxPeriodicityChanged( uint32_t periodicity )
+{
+    TxPeriodicity = periodicity;
+
+    if( TxPeriodicity == 0 )
+    { // Revert to application default periodicity
+        TxPeriodicity = APP_TX_DUTYCYCLE + randr( -APP_TX_DUTYCYCLE_RND, APP_TX_DUTYCYCLE_RND );
+    }
+
+    // Update timer periodicity
+    TimerStop( &TxTimer );
+    TimerSetValue( &TxTimer, TxPeriodicity );
+    TimerStart( &TxTimer );
+}
+
+static void OnTxFrameCtrlChanged( LmHandlerMsgTypes_t isTxConfirmed )
+{
+    LmHandlerParams.IsTxConfirmed = isTxConfirmed;
+}
+
+static void OnPingSlotPeriodicityChanged( uint8_t pingSlotPeriodicity )
+{
+    LmHandlerParams.PingSlotPeriodicity = pingSlotPeriodicity;
+}
+
+/*!
+ * Function executed on TxTimer event
+ */
+static void OnTxTimerEvent( void* context )
+{
+    TimerStop( &TxTimer );
+
+    IsTxFramePending = 1;
+
+    // Schedule next transmission
+    TimerSetValue( &TxTimer, TxPeriodicity );
+    TimerStart( &TxTimer );
+}
+
+/*!
+ * Function executed on Led 1 Timeout event
+ */
+static void OnLed1TimerEvent( void* context )
+{
+    TimerStop( &Led1Timer );
+    // Switch LED 1 OFF
+    GpioWrite( &Led1, 0 );
+}
+
+/*!
+ * Function executed on Led 2 Timeout event
+ */
+static void OnLed2TimerEvent( void* context )
+{
+    TimerStop( &Led2Timer );
+    // Switch LED 2 OFF
+    GpioWrite( &Led2, 0 );
+}
+
+/*!
+ * \brief Function executed on Beacon timer Timeout event
+ */
+static void OnLedBeaconTimerEvent( void* context )
+{
+    GpioWrite( &Led2, 1 );
+    TimerStart( &Led2Timer );
+
+    TimerStart( &LedBeaconTimer );
+}
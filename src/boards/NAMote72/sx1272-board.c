@@ -64,6 +64,7 @@ const struct Radio_s Radio =
     NULL, // void ( *IrqProcess )( void )
     NULL, // void ( *RxBoosted )( uint32_t timeout ) - SX126x Only
     NULL, // void ( *SetRxDutyCycle )( uint32_t rxTime, uint32_t sleepTime ) - SX126x Only
+    NULL, // uint32_t ( *GetIrqTimestamp )( void ) - Events are notified from the DIO IRQ
 };
 
 /*!
@@ -24,42 +24,63 @@
 #include <stdbool.h>
 #include "stm32l4xx.h"
 #include "eeprom_emul.h"
+#include "flash-log.h"
 #include "eeprom-board.h"
 #include "utilities.h"
 
-uint16_t EepromVirtualAddress[NB_OF_VARIABLES];
-__IO uint32_t ErasingOnGoing = 0;
+/*!
+ * Start address of the EEPROM emulation flash area, after the pages of the ST
+ * EEPROM_Emul variables used by the previous firmware versions. Must be page
+ * aligned.
+ */
+#define EEPROM_FLASH_START_ADDRESS                  ( END_EEPROM_ADDRESS + 1 )
 
 /*!
- * \brief Initializes the EEPROM emulation module.
+ * Size of each of the two EEPROM emulation banks
  */
-void EepromMcuInit( void )
+#define EEPROM_FLASH_BANK_SIZE                      ( 8 * FLASH_PAGE_SIZE )
+
+static LmnStatus_t EepromFlashRead( uint32_t offset, uint8_t *buffer, uint16_t size );
+static LmnStatus_t EepromFlashProgram( uint32_t offset, uint8_t *buffer, uint16_t size );
+static LmnStatus_t EepromFlashEraseBank( uint32_t offset );
+static LmnStatus_t EepromEmulRead( uint16_t addr, uint8_t *buffer, uint16_t size );
+static LmnStatus_t EepromEmulErase( void );
+
+/*!
+ * Flash access functions of the EEPROM emulation
+ */
+static const FlashLogDriver_t EepromFlashDriver =
 {
-    EE_Status eeStatus = EE_OK;
+    .BankSize = EEPROM_FLASH_BANK_SIZE,
+    .ProgramUnit = 8,
+    .Read = EepromFlashRead,
+    .Program = EepromFlashProgram,
+    .EraseBank = EepromFlashEraseBank,
+    .LegacySize = NB_OF_VARIABLES,
+    .ReadLegacy = EepromEmulRead,
+    .EraseLegacy = EepromEmulErase,
+};
 
-    // Unlock the Flash Program Erase controller
-    HAL_FLASH_Unlock( );
+/*!
+ * Virtual addresses of the ST EEPROM_Emul variables, one per EEPROM byte
+ */
+static uint16_t EepromVirtualAddress[NB_OF_VARIABLES];
 
-    // Set user List of Virtual Address variables: 0x0000 and 0xFFFF values are prohibited
-    for( uint16_t varValue = 0; varValue < NB_OF_VARIABLES; varValue++ )
-    {
-        EepromVirtualAddress[varValue] = varValue + 1;
-    }
+/*!
+ * Set once the ST EEPROM_Emul driver is initialized
+ */
+static bool IsEepromEmulInitialized = false;
 
-    // Set EEPROM emulation firmware to erase all potentially incompletely erased
-    // pages if the system came from an asynchronous reset. Conditional erase is
-    // safe to use if all Flash operations where completed before the system reset
-    if( __HAL_PWR_GET_FLAG( PWR_FLAG_SB ) == RESET )
-    {
-        // System reset comes from a power-on reset: Forced Erase
-        // Initialize EEPROM emulation driver (mandatory)
-        eeStatus = EE_Init( EepromVirtualAddress, EE_FORCED_ERASE );
-        if( eeStatus != EE_OK )
-        {
-            assert_param( LMN_STATUS_ERROR );
-        }
-    }
-    else
+/*!
+ * \brief Initializes the EEPROM emulation module.
+ *
+ * \remark At the first start, the content of the ST EEPROM_Emul variables of
+ *         the previous firmware versions is imported in the flash log and
+ *         their pages are erased. The NVM context is kept.
+ */
+void EepromMcuInit( void )
+{
+    if( __HAL_PWR_GET_FLAG( PWR_FLAG_SB ) != RESET )
     {
         // Clear the Standby flag
         __HAL_PWR_CLEAR_FLAG( PWR_FLAG_SB );
@@ -69,14 +90,15 @@ void EepromMcuInit( void )
         {
             __HAL_PWR_CLEAR_FLAG( PWR_FLAG_WUF1 );
         }
+    }
 
-        // System reset comes from a STANDBY wakeup: Conditional Erase
-        // Initialize EEPROM emulation driver (mandatory)
-        eeStatus = EE_Init( EepromVirtualAddress, EE_CONDITIONAL_ERASE );
-        if( eeStatus != EE_OK )
-        {
-            assert_param( LMN_STATUS_ERROR );
-        }
+    // Unlock the Flash Program Erase controller
+    HAL_FLASH_Unlock( );
+
+    // Selects the valid bank and drops the records interrupted by a reset
+    if( FlashLogInit( &EepromFlashDriver ) != LMN_STATUS_OK )
+    {
+        assert_param( LMN_STATUS_ERROR );
     }
 
     // Lock the Flash Program Erase controller
@@ -86,69 +108,70 @@ void EepromMcuInit( void )
 /*!
  * \brief Indicates if an erasing operation is on going.
  *
+ * \remark The flash pages are erased synchronously.
+ *
  * \retval isEradingOnGoing Returns true is an erasing operation is on going.
  */
 bool EepromMcuIsErasingOnGoing( void )
 {
-    return ErasingOnGoing;
+    return false;
 }
 
-LmnStatus_t EepromMcuWriteBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+/*!
+ * \brief Clears a flash double word of the EEPROM emulation area having an ECC
+ *        error. The record holding it is then dropped by its CRC check.
+ *
+ * \remark This function is called by the NMI handler.
+ *
+ * \param [IN] address Address of the corrupted double word
+ * \retval status Returns true if the address belongs to the EEPROM emulation area
+ *                and has been cleared
+ */
+bool EepromMcuClearCorruptedFlashAddress( uint32_t address )
 {
-    LmnStatus_t status = LMN_STATUS_OK;
-    EE_Status eeStatus = EE_OK;
+    bool status = false;
 
-    // Unlock the Flash Program Erase controller
-    HAL_FLASH_Unlock( );
-
-    CRITICAL_SECTION_BEGIN( );
-    for( uint32_t i = 0; i < size; i++ )
+    if( ( address >= START_PAGE_ADDRESS ) && ( address <= END_EEPROM_ADDRESS ) )
     {
-        eeStatus |= EE_WriteVariable8bits( EepromVirtualAddress[addr + i], buffer[i] );
+        // Pages of the previous firmware versions, read by the migration
+        return EE_DeleteCorruptedFlashAddress( address ) == EE_OK;
     }
-    CRITICAL_SECTION_END( );
-
-    if( eeStatus != EE_OK )
+    if( ( address < EEPROM_FLASH_START_ADDRESS ) ||
+        ( address >= ( EEPROM_FLASH_START_ADDRESS + ( 2 * EEPROM_FLASH_BANK_SIZE ) ) ) )
     {
-        status = LMN_STATUS_ERROR;
+        return false;
     }
 
-    if( ( eeStatus & EE_STATUSMASK_CLEANUP ) == EE_STATUSMASK_CLEANUP )
-    {
-        ErasingOnGoing = 0;
-        eeStatus |= EE_CleanUp( );
-    }
-    if( ( eeStatus & EE_STATUSMASK_ERROR ) == EE_STATUSMASK_ERROR )
+    HAL_FLASH_Unlock( );
+    __HAL_FLASH_CLEAR_FLAG( FLASH_FLAG_ALL_ERRORS );
+    // A double word can always be programmed to 0
+    if( HAL_FLASH_Program( FLASH_TYPEPROGRAM_DOUBLEWORD, address & ~0x07UL, 0 ) == HAL_OK )
     {
-        status = LMN_STATUS_ERROR;
+        status = true;
     }
-
-    // Lock the Flash Program Erase controller
     HAL_FLASH_Lock( );
     return status;
 }
 
-LmnStatus_t EepromMcuReadBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+LmnStatus_t EepromMcuWriteBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
 {
-    LmnStatus_t status = LMN_STATUS_OK;
+    LmnStatus_t status;
 
     // Unlock the Flash Program Erase controller
     HAL_FLASH_Unlock( );
 
-    for( uint32_t i = 0; i < size; i++ )
-    {
-        if( EE_ReadVariable8bits( EepromVirtualAddress[addr + i], buffer + i ) != EE_OK )
-        {
-            status = LMN_STATUS_ERROR;
-            break;
-        }
-    }
+    status = FlashLogWrite( addr, buffer, size );
 
     // Lock the Flash Program Erase controller
     HAL_FLASH_Lock( );
     return status;
 }
 
+LmnStatus_t EepromMcuReadBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    return FlashLogRead( addr, buffer, size );
+}
+
 void EepromMcuSetDeviceAddr( uint8_t addr )
 {
     assert_param( LMN_STATUS_ERROR );
@@ -160,30 +183,126 @@ LmnStatus_t EepromMcuGetDeviceAddr( void )
     return 0;
 }
 
+static LmnStatus_t EepromFlashRead( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    // The flash is memory mapped
+    memcpy1( buffer, ( uint8_t* )( EEPROM_FLASH_START_ADDRESS + offset ), size );
+    return LMN_STATUS_OK;
+}
+
+static LmnStatus_t EepromFlashProgram( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    LmnStatus_t status = LMN_STATUS_OK;
+    uint64_t data;
+
+    __HAL_FLASH_CLEAR_FLAG( FLASH_FLAG_ALL_ERRORS );
+    for( uint16_t i = 0; i < size; i += sizeof( data ) )
+    {
+        memcpy1( ( uint8_t* )&data, buffer + i, sizeof( data ) );
+
+        CRITICAL_SECTION_BEGIN( );
+        if( HAL_FLASH_Program( FLASH_TYPEPROGRAM_DOUBLEWORD, EEPROM_FLASH_START_ADDRESS + offset + i, data ) != HAL_OK )
+        {
+            status = LMN_STATUS_ERROR;
+        }
+        CRITICAL_SECTION_END( );
+
+        if( status != LMN_STATUS_OK )
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+static LmnStatus_t EepromFlashEraseBank( uint32_t offset )
+{
+    FLASH_EraseInitTypeDef eraseInit;
+    uint32_t address = EEPROM_FLASH_START_ADDRESS + offset - FLASH_BASE;
+    uint32_t pageError = 0;
+
+    eraseInit.TypeErase = FLASH_TYPEERASE_PAGES;
+    eraseInit.Banks = ( address < FLASH_BANK_SIZE ) ? FLASH_BANK_1 : FLASH_BANK_2;
+    eraseInit.Page = ( address % FLASH_BANK_SIZE ) / FLASH_PAGE_SIZE;
+    eraseInit.NbPages = EEPROM_FLASH_BANK_SIZE / FLASH_PAGE_SIZE;
+
+    __HAL_FLASH_CLEAR_FLAG( FLASH_FLAG_ALL_ERRORS );
+    if( HAL_FLASHEx_Erase( &eraseInit, &pageError ) != HAL_OK )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    return LMN_STATUS_OK;
+}
+
 /*!
- * \brief  FLASH end of operation interrupt callback.
- * \param  ReturnValue: The value saved in this parameter depends on the ongoing procedure
- *                  Mass Erase: Bank number which has been requested to erase
- *                  Page Erase: Page which has been erased
- *                    (if 0xFFFFFFFF, it means that all the selected pages have been erased)
- *                  Program: Address which was selected for data program
- * \retval None
+ * \brief Reads the ST EEPROM_Emul variables of the previous firmware versions
+ *
+ * \retval status Returns LMN_STATUS_ERROR if none of their pages is in use
  */
-void HAL_FLASH_EndOfOperationCallback( uint32_t ReturnValue )
+static LmnStatus_t EepromEmulRead( uint16_t addr, uint8_t *buffer, uint16_t size )
 {
-    // Call CleanUp callback when all requested pages have been erased
-    if( ReturnValue == 0xFFFFFFFF )
+    if( IsEepromEmulInitialized == false )
     {
-        EE_EndOfCleanup_UserCallback( );
+        bool isUsed = false;
+
+        // The first element of the header of the pages in use is programmed
+        for( uint32_t page = START_PAGE_ADDRESS; page <= END_EEPROM_ADDRESS; page += FLASH_PAGE_SIZE )
+        {
+            isUsed |= *( uint64_t* )page == EE_PAGESTAT_RECEIVE;
+        }
+        if( isUsed == false )
+        {
+            return LMN_STATUS_ERROR;
+        }
+
+        // Set user List of Virtual Address variables: 0x0000 and 0xFFFF values are prohibited
+        for( uint16_t varValue = 0; varValue < NB_OF_VARIABLES; varValue++ )
+        {
+            EepromVirtualAddress[varValue] = varValue + 1;
+        }
+        if( EE_Init( EepromVirtualAddress, EE_CONDITIONAL_ERASE ) != EE_OK )
+        {
+            return LMN_STATUS_ERROR;
+        }
+        IsEepromEmulInitialized = true;
     }
+
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        switch( EE_ReadVariable8bits( EepromVirtualAddress[addr + i], buffer + i ) )
+        {
+            case EE_OK:
+                break;
+            case EE_NO_DATA:
+                // Never written
+                buffer[i] = 0xFF;
+                break;
+            default:
+                return LMN_STATUS_ERROR;
+        }
+    }
+    return LMN_STATUS_OK;
 }
 
 /*!
- * \brief  Clean Up end of operation interrupt callback.
- * \param  None
- * \retval None
+ * \brief Erases the pages of the ST EEPROM_Emul variables of the previous
+ *        firmware versions
  */
-void EE_EndOfCleanup_UserCallback( void )
+static LmnStatus_t EepromEmulErase( void )
 {
-    ErasingOnGoing = 0;
+    FLASH_EraseInitTypeDef eraseInit;
+    uint32_t address = START_PAGE_ADDRESS - FLASH_BASE;
+    uint32_t pageError = 0;
+
+    eraseInit.TypeErase = FLASH_TYPEERASE_PAGES;
+    eraseInit.Banks = ( address < FLASH_BANK_SIZE ) ? FLASH_BANK_1 : FLASH_BANK_2;
+    eraseInit.Page = ( address % FLASH_BANK_SIZE ) / FLASH_PAGE_SIZE;
+    eraseInit.NbPages = PAGES_NUMBER;
+
+    __HAL_FLASH_CLEAR_FLAG( FLASH_FLAG_ALL_ERRORS );
+    if( HAL_FLASHEx_Erase( &eraseInit, &pageError ) != HAL_OK )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    return LMN_STATUS_OK;
 }
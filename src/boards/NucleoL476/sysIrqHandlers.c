@@ -21,8 +21,20 @@
  * \author    Gregory Cristian ( Semtech )
  */
 #include <stdint.h>
+#include <stdbool.h>
 #include "stm32l4xx.h"
-#include "eeprom_emul.h"
+
+/*!
+ * \brief Clears a flash double word of the EEPROM emulation area having an ECC
+ *        error.
+ *
+ * \remark This function is defined in eeprom-board.c file
+ *
+ * \param [IN] address Address of the corrupted double word
+ * \retval status Returns true if the address belongs to the EEPROM emulation area
+ *                and has been cleared
+ */
+bool EepromMcuClearCorruptedFlashAddress( uint32_t address );
 
 /*!
  * \brief  This function handles NMI exception.
@@ -47,15 +59,12 @@ void NMI_Handler( void )
         }
 #endif
 
-        // Check if corrupted flash address is in eeprom emulation pages
-        if( ( corruptedflashaddress >= START_PAGE_ADDRESS ) || ( corruptedflashaddress <= END_EEPROM_ADDRESS ) )
+        // Clear the corrupted flash address if it is in eeprom emulation pages
+        if( EepromMcuClearCorruptedFlashAddress( corruptedflashaddress ) == true )
         {
-            /* Delete the corrupted flash address */
-            if( EE_DeleteCorruptedFlashAddress( corruptedflashaddress ) == EE_OK )
-            {
-                // Resume execution if deletion succeeds
-                return;
-            }
+            // Clear the ECC detection flag and resume execution
+            __HAL_FLASH_CLEAR_FLAG( FLASH_FLAG_ECCD );
+            return;
         }
     }
 
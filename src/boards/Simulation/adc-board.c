@@ -0,0 +1,33 @@
+/*!
+ * \file      adc-board.c
+ *
+ * \brief     Target board ADC driver implementation
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include "adc-board.h"
+
+void AdcMcuInit( Adc_t *obj, PinNames adcInput )
+{
+}
+
+void AdcMcuConfig( void )
+{
+}
+
+uint16_t AdcMcuReadChannel( Adc_t *obj, uint32_t channel )
+{
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*!
+ * \file      board-config.h
+ *
+ * \brief     Board configuration
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#ifndef __BOARD_CONFIG_H__
+#define __BOARD_CONFIG_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * Defines the time required for the TCXO to wakeup [ms].
+ */
+#define BOARD_TCXO_WAKEUP_TIME                      0
+
+/*!
+ * Board MCU pins definitions. The pins are not simulated.
+ */
+#define LED_1                                       PA_5
+#define LED_2                                       PA_6
+
+#define UART_TX                                     PA_2
+#define UART_RX                                     PA_3
+
+/*!
+ * Virtual EEPROM size
+ */
+#define EEPROM_SIZE                                 8192
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BOARD_CONFIG_H__
@@ -0,0 +1,144 @@
+/*!
+ * \file      board.c
+ *
+ * \brief     Target board general functions implementation
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "utilities.h"
+#include "gpio.h"
+#include "uart.h"
+#include "timer.h"
+#include "board-config.h"
+#include "rtc-board.h"
+#include "sim.h"
+#include "board.h"
+
+/*!
+ * Unique device identifier, used as DevEUI
+ */
+#ifndef SIM_DEVICE_ID
+#define SIM_DEVICE_ID                               0x0000000000000001
+#endif
+
+/*!
+ * Battery level reported to the network
+ */
+#define BATTERY_LORAWAN_MAX_LEVEL                   254
+
+/*!
+ * Battery voltage [mV]
+ */
+#define BATTERY_VOLTAGE                             3000
+
+/*!
+ * LED GPIO pins objects
+ */
+Gpio_t Led1;
+Gpio_t Led2;
+
+/*
+ * MCU objects
+ */
+Uart_t Uart2;
+
+/*!
+ * Flag to indicate if the MCU is Initialized
+ */
+static bool McuInitialized = false;
+
+void BoardCriticalSectionBegin( uint32_t *mask )
+{
+    // The events only run from BoardLowPowerHandler: nothing can preempt
+    *mask = 0;
+}
+
+void BoardCriticalSectionEnd( uint32_t *mask )
+{
+}
+
+void BoardInitPeriph( void )
+{
+
+}
+
+void BoardInitMcu( void )
+{
+    if( McuInitialized == false )
+    {
+        RtcInit( );
+
+        GpioInit( &Led1, LED_1, PIN_OUTPUT, PIN_PUSH_PULL, PIN_NO_PULL, 0 );
+        GpioInit( &Led2, LED_2, PIN_OUTPUT, PIN_PUSH_PULL, PIN_NO_PULL, 0 );
+
+        UartInit( &Uart2, UART_2, UART_TX, UART_RX );
+
+        McuInitialized = true;
+    }
+}
+
+void BoardResetMcu( void )
+{
+    printf( "\n###### Reset requested, simulation stopped ######\n" );
+    exit( EXIT_FAILURE );
+}
+
+void BoardDeInitMcu( void )
+{
+}
+
+uint32_t BoardGetRandomSeed( void )
+{
+    return SimRandom( );
+}
+
+void BoardGetUniqueId( uint8_t *id )
+{
+    uint64_t uniqueId = SIM_DEVICE_ID;
+
+    for( int8_t i = 7; i >= 0; i-- )
+    {
+        id[i] = uniqueId & 0xFF;
+        uniqueId >>= 8;
+    }
+}
+
+uint32_t BoardGetBatteryVoltage( void )
+{
+    return BATTERY_VOLTAGE;
+}
+
+uint8_t BoardGetBatteryLevel( void )
+{
+    return BATTERY_LORAWAN_MAX_LEVEL;
+}
+
+int16_t BoardGetTemperature( void )
+{
+    return 25 << 8;
+}
+
+uint8_t GetBoardPowerSource( void )
+{
+    return BATTERY_POWER;
+}
+
+void BoardLowPowerHandler( void )
+{
+    // Sleeps until the next event
+    SimSleep( );
+}
@@ -0,0 +1,27 @@
+/*!
+ * \file      delay-board.c
+ *
+ * \brief     Target board delay implementation
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include "sim.h"
+#include "delay-board.h"
+
+void DelayMsMcu( uint32_t ms )
+{
+    // The MCU is busy: the virtual time runs without processing the events
+    SimDelay( ( SimTime_t )ms * 1000 );
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file      eeprom-board.c
+ *
+ * \brief     Target board EEPROM driver implementation
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include "utilities.h"
+#include "board-config.h"
+#include "eeprom-board.h"
+#include "sim.h"
+
+/*!
+ * Virtual EEPROM, erased at start-up
+ */
+static uint8_t Eeprom[EEPROM_SIZE];
+
+/*!
+ * Set while the writes fail
+ */
+static bool IsWriteError = false;
+
+void SimEepromSetWriteError( bool isWriteError )
+{
+    IsWriteError = isWriteError;
+}
+
+LmnStatus_t EepromMcuWriteBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    if( ( ( ( uint32_t )addr + size ) > EEPROM_SIZE ) || ( IsWriteError == true ) )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memcpy1( &Eeprom[addr], buffer, size );
+    return LMN_STATUS_OK;
+}
+
+LmnStatus_t EepromMcuReadBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    if( ( ( uint32_t )addr + size ) > EEPROM_SIZE )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memcpy1( buffer, &Eeprom[addr], size );
+    return LMN_STATUS_OK;
+}
+
+void EepromMcuSetDeviceAddr( uint8_t addr )
+{
+}
+
+LmnStatus_t EepromMcuGetDeviceAddr( void )
+{
+    return LMN_STATUS_OK;
+}
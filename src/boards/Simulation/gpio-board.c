@@ -0,0 +1,57 @@
+/*!
+ * \file      gpio-board.c
+ *
+ * \brief     Target board GPIO driver implementation
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stddef.h>
+#include "gpio-board.h"
+
+void GpioMcuInit( Gpio_t *obj, PinNames pin, PinModes mode, PinConfigs config, PinTypes type, uint32_t value )
+{
+    obj->pin = pin;
+    obj->pull = type;
+    obj->port = NULL;
+}
+
+void GpioMcuSetContext( Gpio_t *obj, void* context )
+{
+    obj->Context = context;
+}
+
+void GpioMcuSetInterrupt( Gpio_t *obj, IrqModes irqMode, IrqPriorities irqPriority, GpioIrqHandler *irqHandler )
+{
+    // The pins never change: the interrupts never fire
+    obj->IrqHandler = irqHandler;
+}
+
+void GpioMcuRemoveInterrupt( Gpio_t *obj )
+{
+    obj->IrqHandler = NULL;
+}
+
+void GpioMcuWrite( Gpio_t *obj, uint32_t value )
+{
+}
+
+void GpioMcuToggle( Gpio_t *obj )
+{
+}
+
+uint32_t GpioMcuRead( Gpio_t *obj )
+{
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*!
+ * \file      rtc-board.c
+ *
+ * \brief     Target board RTC timer and low power modes management
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stddef.h>
+#include "utilities.h"
+#include "timer.h"
+#include "sim.h"
+#include "rtc-board.h"
+
+/*!
+ * The RTC counts the virtual time in milliseconds: 1 tick = 1 ms
+ */
+#define RTC_TICK_DURATION                           1000
+
+/*!
+ * Minimum alarm timeout [ticks]
+ */
+#define MIN_ALARM_DELAY                             1
+
+/*!
+ * Timer context
+ */
+static uint32_t RtcTimerContext = 0;
+
+/*!
+ * Alarm event
+ */
+static SimEvent_t AlarmEvent;
+
+/*!
+ * Backup registers
+ */
+static uint32_t RtcBkup[2] = { 0 };
+
+/*!
+ * \brief RTC alarm interrupt
+ */
+static void OnAlarmEvent( void* context )
+{
+    TimerIrqHandler( );
+}
+
+void RtcInit( void )
+{
+    SimEventInit( &AlarmEvent, OnAlarmEvent, NULL );
+    RtcSetTimerContext( );
+}
+
+uint32_t RtcSetTimerContext( void )
+{
+    RtcTimerContext = RtcGetTimerValue( );
+    return RtcTimerContext;
+}
+
+uint32_t RtcGetTimerContext( void )
+{
+    return RtcTimerContext;
+}
+
+uint32_t RtcGetMinimumTimeout( void )
+{
+    return MIN_ALARM_DELAY;
+}
+
+uint32_t RtcMs2Tick( TimerTime_t milliseconds )
+{
+    return milliseconds;
+}
+
+TimerTime_t RtcTick2Ms( uint32_t tick )
+{
+    return tick;
+}
+
+void RtcDelayMs( TimerTime_t milliseconds )
+{
+    SimDelay( ( SimTime_t )milliseconds * RTC_TICK_DURATION );
+}
+
+void RtcSetAlarm( uint32_t timeout )
+{
+    RtcStartAlarm( timeout );
+}
+
+void RtcStopAlarm( void )
+{
+    SimEventCancel( &AlarmEvent );
+}
+
+void RtcStartAlarm( uint32_t timeout )
+{
+    // The timeout is relative to the timer context
+    SimTime_t now = SimGetTime( );
+    int32_t delta = ( int32_t )( RtcTimerContext + timeout - RtcGetTimerValue( ) );
+
+    SimEventSchedule( &AlarmEvent, ( now - ( now % RTC_TICK_DURATION ) ) +
+                                   ( ( SimTime_t )MAX( delta, 0 ) * RTC_TICK_DURATION ) );
+}
+
+uint32_t RtcGetTimerValue( void )
+{
+    return ( uint32_t )( SimGetTime( ) / RTC_TICK_DURATION );
+}
+
+uint32_t RtcGetTimerElapsedTime( void )
+{
+    return RtcGetTimerValue( ) - RtcTimerContext;
+}
+
+uint32_t RtcGetCalendarTime( uint16_t *milliseconds )
+{
+    SimTime_t now = SimGetTime( );
+
+    *milliseconds = ( uint16_t )( ( now / 1000 ) % 1000 );
+    return ( uint32_t )( now / 1000000 );
+}
+
+void RtcBkupWrite( uint32_t data0, uint32_t data1 )
+{
+    RtcBkup[0] = data0;
+    RtcBkup[1] = data1;
+}
+
+void RtcBkupRead( uint32_t *data0, uint32_t *data1 )
+{
+    *data0 = RtcBkup[0];
+    *data1 = RtcBkup[1];
+}
+
+void RtcProcess( void )
+{
+}
+
+TimerTime_t RtcTempCompensation( TimerTime_t period, float temperature )
+{
+    // The virtual oscillator has no temperature drift
+    return period;
+}
@@ -0,0 +1,410 @@
+/*!
+ * \file      sim-channel.c
+ *
+ * \brief     Virtual LoRa radio channel of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <math.h>
+#include <stddef.h>
+#include "utilities.h"
+#include "sim-channel.h"
+
+/*!
+ * Frame on air
+ */
+typedef struct sSimChannelSlot
+{
+    /*!
+     * Set while the frame is on air
+     */
+    bool InUse;
+    /*!
+     * Frame
+     */
+    SimChannelFrame_t Frame;
+    /*!
+     * End of the transmission
+     */
+    SimEvent_t EndEvent;
+}SimChannelSlot_t;
+
+/*!
+ * Receiver state
+ */
+typedef struct sSimChannelListener
+{
+    /*!
+     * Receiver
+     */
+    const SimChannelReceiver_t* Receiver;
+    /*!
+     * Set while listening
+     */
+    bool IsListening;
+    /*!
+     * Start of the listening period
+     */
+    SimTime_t ListenStart;
+    /*!
+     * Listened radio settings
+     */
+    uint32_t Frequency;
+    uint8_t SpreadingFactor;
+    uint8_t Bandwidth;
+    bool IqInverted;
+    /*!
+     * Frame locked by each demodulator, NULL if none
+     */
+    SimChannelSlot_t* Locked[SIM_CHANNEL_MAX_DEMODULATORS];
+}SimChannelListener_t;
+
+/*!
+ * LoRa demodulation floor per spreading factor, from SF7 to SF12 [dB]
+ */
+static const int8_t DemodulationFloor[] = { -7, -10, -12, -15, -17, -20 };
+
+/*!
+ * LoRa bandwidths [Hz]
+ */
+static const uint32_t Bandwidths[] = { 125000, 250000, 500000 };
+
+/*!
+ * Channel parameters
+ */
+static const SimChannelParams_t* Params = NULL;
+
+/*!
+ * Frames on air
+ */
+static SimChannelSlot_t Slots[SIM_CHANNEL_MAX_FRAMES];
+
+/*!
+ * Receivers
+ */
+static SimChannelListener_t Listeners[SIM_CHANNEL_MAX_RECEIVERS];
+
+/*!
+ * Number of receivers
+ */
+static uint16_t NbListeners = 0;
+
+/*!
+ * Next interferer transmission
+ */
+static SimEvent_t InterfererEvent;
+
+/*!
+ * Statistics
+ */
+static SimChannelStats_t Stats;
+
+static SimTime_t GetSymbolTime( const SimChannelFrame_t* frame );
+static void Detect( SimChannelListener_t* listener, SimChannelSlot_t* slot );
+static void OnFrameEndEvent( void* context );
+static void OnInterfererEvent( void* context );
+
+/*!
+ * \brief Schedules the next interferer transmission
+ */
+static void ScheduleInterferer( void )
+{
+    double u = ( ( double )( SimRandom( ) >> 8 ) + 1.0 ) / 16777217.0;
+    double interval = -log( u ) * ( double )Params->InterfererInterval * 1e6;
+
+    SimEventSchedule( &InterfererEvent, SimGetTime( ) + ( SimTime_t )interval );
+}
+
+void SimChannelInit( const SimChannelParams_t* params )
+{
+    Params = params;
+    NbListeners = 0;
+    memset1( ( uint8_t* )&Stats, 0, sizeof( Stats ) );
+    for( uint8_t i = 0; i < SIM_CHANNEL_MAX_FRAMES; i++ )
+    {
+        Slots[i].InUse = false;
+        SimEventInit( &Slots[i].EndEvent, OnFrameEndEvent, &Slots[i] );
+    }
+
+    SimEventInit( &InterfererEvent, OnInterfererEvent, NULL );
+    if( ( Params->InterfererInterval != 0 ) && ( Params->NbInterfererFrequencies != 0 ) )
+    {
+        ScheduleInterferer( );
+    }
+}
+
+void SimChannelAddReceiver( const SimChannelReceiver_t* receiver )
+{
+    if( NbListeners >= SIM_CHANNEL_MAX_RECEIVERS )
+    {
+        return;
+    }
+    memset1( ( uint8_t* )&Listeners[NbListeners], 0, sizeof( SimChannelListener_t ) );
+    Listeners[NbListeners].Receiver = receiver;
+    NbListeners++;
+}
+
+void SimChannelListen( const SimChannelReceiver_t* receiver, bool enable, uint32_t frequency, uint8_t sf, uint8_t bandwidth, bool iqInverted )
+{
+    SimChannelListener_t* listener = NULL;
+
+    for( uint16_t i = 0; i < NbListeners; i++ )
+    {
+        if( Listeners[i].Receiver == receiver )
+        {
+            listener = &Listeners[i];
+            break;
+        }
+    }
+    if( listener == NULL )
+    {
+        return;
+    }
+    if( listener->IsListening == true )
+    {
+        Stats.RxTime[receiver->Node] += SimGetTime( ) - listener->ListenStart;
+    }
+    listener->ListenStart = SimGetTime( );
+    listener->IsListening = enable;
+    listener->Frequency = frequency;
+    listener->SpreadingFactor = sf;
+    listener->Bandwidth = bandwidth;
+    listener->IqInverted = iqInverted;
+    for( uint8_t i = 0; i < SIM_CHANNEL_MAX_DEMODULATORS; i++ )
+    {
+        listener->Locked[i] = NULL;
+    }
+    if( enable == false )
+    {
+        return;
+    }
+
+    // Frames whose preamble is still on air
+    for( uint8_t i = 0; i < SIM_CHANNEL_MAX_FRAMES; i++ )
+    {
+        SimChannelFrame_t* frame = &Slots[i].Frame;
+        SimTime_t detectionEnd = frame->Start +
+            ( ( frame->PreambleLen > SIM_CHANNEL_DETECTION_SYMBOLS ) ?
+              ( ( frame->PreambleLen - SIM_CHANNEL_DETECTION_SYMBOLS ) * GetSymbolTime( frame ) ) : 0 );
+
+        if( ( Slots[i].InUse == true ) && ( SimGetTime( ) <= detectionEnd ) )
+        {
+            Detect( listener, &Slots[i] );
+        }
+    }
+}
+
+/*!
+ * \brief Computes the LoRa symbol duration of a frame
+ *
+ * \retval duration Symbol duration [us]
+ */
+static SimTime_t GetSymbolTime( const SimChannelFrame_t* frame )
+{
+    return ( ( SimTime_t )1000000 << frame->SpreadingFactor ) / Bandwidths[frame->Bandwidth];
+}
+
+/*!
+ * \brief Detects a frame on air and locks the receiver on it
+ *
+ * \param [IN] listener Receiver state
+ * \param [IN] slot     Frame on air
+ */
+static void Detect( SimChannelListener_t* listener, SimChannelSlot_t* slot )
+{
+    uint8_t sfIndex = slot->Frame.SpreadingFactor - 7;
+    uint8_t nbDemodulators = MIN( MAX( listener->Receiver->NbDemodulators, 1 ), SIM_CHANNEL_MAX_DEMODULATORS );
+    uint8_t demodulator = 0;
+
+    // First free demodulator
+    while( ( demodulator < nbDemodulators ) && ( listener->Locked[demodulator] != NULL ) )
+    {
+        demodulator++;
+    }
+    if( ( listener->Receiver->Node == slot->Frame.Source ) || ( listener->IsListening == false ) ||
+        ( demodulator == nbDemodulators ) ||
+        ( ( listener->Frequency != 0 ) && ( listener->Frequency != slot->Frame.Frequency ) ) ||
+        ( ( listener->SpreadingFactor != 0 ) && ( listener->SpreadingFactor != slot->Frame.SpreadingFactor ) ) ||
+        ( listener->Bandwidth != slot->Frame.Bandwidth ) || ( listener->IqInverted != slot->Frame.IqInverted ) )
+    {
+        return;
+    }
+    if( ( sfIndex >= sizeof( DemodulationFloor ) ) ||
+        ( slot->Frame.Snr < DemodulationFloor[sfIndex] ) ||
+        ( ( SimRandom( ) % 1000 ) < Params->LossRate ) )
+    {
+        if( slot->Frame.Source != SIM_CHANNEL_NODE_INTERFERER )
+        {
+            Stats.NbLost++;
+        }
+        return;
+    }
+    if( listener->Receiver->OnFrameStart( listener->Receiver->Context, &slot->Frame ) == true )
+    {
+        listener->Locked[demodulator] = slot;
+    }
+}
+
+/*!
+ * \brief Checks if two frames use the same radio settings
+ */
+static bool IsSameSettings( const SimChannelFrame_t* a, const SimChannelFrame_t* b )
+{
+    return ( a->Frequency == b->Frequency ) && ( a->SpreadingFactor == b->SpreadingFactor ) &&
+           ( a->Bandwidth == b->Bandwidth ) && ( a->IqInverted == b->IqInverted );
+}
+
+bool SimChannelSend( const SimChannelFrame_t* frame, SimTime_t timeOnAir )
+{
+    SimChannelSlot_t* slot = NULL;
+
+    for( uint8_t i = 0; i < SIM_CHANNEL_MAX_FRAMES; i++ )
+    {
+        if( Slots[i].InUse == false )
+        {
+            slot = &Slots[i];
+            break;
+        }
+    }
+    if( slot == NULL )
+    {
+        return false;
+    }
+
+    slot->InUse = true;
+    slot->Frame = *frame;
+    slot->Frame.Start = SimGetTime( );
+    slot->Frame.End = slot->Frame.Start + timeOnAir;
+    slot->Frame.Snr = ( int8_t )SimRandomGauss( Params->SnrMean, Params->SnrStdDev );
+    slot->Frame.Rssi = Params->NoiseFloor + MAX( slot->Frame.Snr, 0 );
+    slot->Frame.IsCorrupted = false;
+    Stats.NbTx[frame->Source]++;
+    Stats.TxTime[frame->Source] += timeOnAir;
+
+    // Collisions with the frames on air
+    for( uint8_t i = 0; i < SIM_CHANNEL_MAX_FRAMES; i++ )
+    {
+        SimChannelFrame_t* other = &Slots[i].Frame;
+
+        if( ( Slots[i].InUse == false ) || ( &Slots[i] == slot ) || ( IsSameSettings( other, &slot->Frame ) == false ) )
+        {
+            continue;
+        }
+        if( ( slot->Frame.Snr - other->Snr ) < Params->CaptureMargin )
+        {
+            slot->Frame.IsCorrupted = true;
+        }
+        if( ( other->Snr - slot->Frame.Snr ) < Params->CaptureMargin )
+        {
+            other->IsCorrupted = true;
+        }
+    }
+
+    // Detection by the listening receivers
+    SimEventSchedule( &slot->EndEvent, slot->Frame.End );
+    for( uint16_t i = 0; i < NbListeners; i++ )
+    {
+        Detect( &Listeners[i], slot );
+    }
+    return true;
+}
+
+bool SimChannelIsBusy( uint32_t frequency )
+{
+    for( uint8_t i = 0; i < SIM_CHANNEL_MAX_FRAMES; i++ )
+    {
+        if( ( Slots[i].InUse == true ) && ( Slots[i].Frame.Frequency == frequency ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+SimTime_t SimChannelGetTimeOnAir( uint8_t sf, uint8_t bandwidth, uint16_t preamble, uint8_t size, bool crcOn )
+{
+    // Explicit header, coding rate 4/5
+    bool lowDrOptimize = ( ( bandwidth == 0 ) && ( sf >= 11 ) ) || ( ( bandwidth == 1 ) && ( sf == 12 ) );
+    int32_t numerator = ( 8 * size ) - ( 4 * sf ) + 28 + ( crcOn ? 16 : 0 );
+    int32_t denominator = 4 * ( sf - ( lowDrOptimize ? 2 : 0 ) );
+    int32_t nbPayloadSymbols = 8;
+
+    if( numerator > 0 )
+    {
+        nbPayloadSymbols += ( ( numerator + denominator - 1 ) / denominator ) * 5;
+    }
+
+    // Preamble + 4.25 symbols, in quarters of symbols
+    return ( ( ( SimTime_t )( ( preamble * 4 ) + 17 + ( nbPayloadSymbols * 4 ) ) << sf ) * 1000000 ) /
+           ( 4 * ( SimTime_t )Bandwidths[bandwidth] );
+}
+
+const SimChannelStats_t* SimChannelGetStats( void )
+{
+    return &Stats;
+}
+
+/*!
+ * \brief Ends the transmission of a frame and delivers it to the locked
+ *        receivers
+ */
+static void OnFrameEndEvent( void* context )
+{
+    SimChannelSlot_t* slot = ( SimChannelSlot_t* )context;
+    SimChannelFrame_t frame = slot->Frame;
+
+    slot->InUse = false;
+    for( uint16_t i = 0; i < NbListeners; i++ )
+    {
+        SimChannelListener_t* listener = &Listeners[i];
+
+        for( uint8_t j = 0; j < SIM_CHANNEL_MAX_DEMODULATORS; j++ )
+        {
+            if( listener->Locked[j] != slot )
+            {
+                continue;
+            }
+            listener->Locked[j] = NULL;
+            if( frame.IsCorrupted == true )
+            {
+                Stats.NbCollisions++;
+            }
+            else
+            {
+                Stats.NbRx++;
+            }
+            listener->Receiver->OnFrameEnd( listener->Receiver->Context, &frame );
+        }
+    }
+}
+
+/*!
+ * \brief Transmits an interferer frame
+ */
+static void OnInterfererEvent( void* context )
+{
+    SimChannelFrame_t frame;
+
+    frame.Source = SIM_CHANNEL_NODE_INTERFERER;
+    frame.Frequency = Params->InterfererFrequencies[SimRandom( ) % Params->NbInterfererFrequencies];
+    frame.SpreadingFactor = ( uint8_t )SimRandomRange( 7, 12 );
+    frame.Bandwidth = 0;
+    frame.IqInverted = false;
+    frame.PreambleLen = 8;
+    frame.Size = Params->InterfererSize;
+    memset1( frame.Payload, 0, frame.Size );
+
+    SimChannelSend( &frame, SimChannelGetTimeOnAir( frame.SpreadingFactor, frame.Bandwidth, frame.PreambleLen, frame.Size, true ) );
+    ScheduleInterferer( );
+}
@@ -0,0 +1,326 @@
+/*!
+ * \file      sim-channel.h
+ *
+ * \brief     Virtual LoRa radio channel of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The channel carries the LoRa frames between the device, the
+ *            network and a background interferer. For each frame and each
+ *            listening receiver:
+ *            - The frame is received by a receiver listening on the same
+ *              frequency, spreading factor, bandwidth and IQ polarity.
+ *            - The link SNR is drawn from a normal distribution. A frame below
+ *              the demodulation floor of its spreading factor or randomly lost
+ *              ( LossRate ) is not detected by the receiver.
+ *            - A receiver starting to listen during the preamble of a frame
+ *              still detects it, as long as SIM_CHANNEL_DETECTION_SYMBOLS
+ *              preamble symbols remain.
+ *            - A detected frame overlapped by another frame of the same
+ *              settings is only received when it is CaptureMargin stronger
+ *              than the other one. Otherwise the receiver gets a CRC error.
+ *            - A receiver demodulates as many frames at the same time as it
+ *              has demodulators. The frames detected while all of them are
+ *              busy are missed.
+ */
+#ifndef __SIM_CHANNEL_H__
+#define __SIM_CHANNEL_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim.h"
+
+/*!
+ * Maximum frame payload size
+ */
+#define SIM_CHANNEL_MAX_PAYLOAD                     255
+
+/*!
+ * Maximum number of frames on air at the same time
+ */
+#ifndef SIM_CHANNEL_MAX_FRAMES
+#define SIM_CHANNEL_MAX_FRAMES                      32
+#endif
+
+/*!
+ * Maximum number of receivers
+ */
+#ifndef SIM_CHANNEL_MAX_RECEIVERS
+#define SIM_CHANNEL_MAX_RECEIVERS                   64
+#endif
+
+/*!
+ * Maximum number of demodulators of a receiver
+ */
+#define SIM_CHANNEL_MAX_DEMODULATORS                8
+
+/*!
+ * Number of preamble symbols needed to detect a frame
+ */
+#define SIM_CHANNEL_DETECTION_SYMBOLS               4
+
+/*!
+ * Channel nodes
+ */
+typedef enum eSimChannelNode
+{
+    SIM_CHANNEL_NODE_DEVICE,
+    SIM_CHANNEL_NODE_NETWORK,
+    SIM_CHANNEL_NODE_INTERFERER,
+}SimChannelNode_t;
+
+/*!
+ * LoRa frame
+ */
+typedef struct sSimChannelFrame
+{
+    /*!
+     * Transmitting node
+     */
+    SimChannelNode_t Source;
+    /*!
+     * RF frequency [Hz]
+     */
+    uint32_t Frequency;
+    /*!
+     * Spreading factor [7:12]
+     */
+    uint8_t SpreadingFactor;
+    /*!
+     * Bandwidth index [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+     */
+    uint8_t Bandwidth;
+    /*!
+     * Set for the downlink IQ polarity
+     */
+    bool IqInverted;
+    /*!
+     * Preamble length [symbols]
+     */
+    uint16_t PreambleLen;
+    /*!
+     * Start of the transmission
+     */
+    SimTime_t Start;
+    /*!
+     * End of the transmission
+     */
+    SimTime_t End;
+    /*!
+     * Payload size
+     */
+    uint8_t Size;
+    /*!
+     * Payload
+     */
+    uint8_t Payload[SIM_CHANNEL_MAX_PAYLOAD];
+    /*!
+     * SNR at the receiver [dB]
+     */
+    int8_t Snr;
+    /*!
+     * RSSI at the receiver [dBm]
+     */
+    int16_t Rssi;
+    /*!
+     * Set when a colliding frame prevents the reception
+     */
+    bool IsCorrupted;
+}SimChannelFrame_t;
+
+/*!
+ * Receiver
+ */
+typedef struct sSimChannelReceiver
+{
+    /*!
+     * Receiving node
+     */
+    SimChannelNode_t Node;
+    /*!
+     * Number of frames demodulated at the same time [1: SIM_CHANNEL_MAX_DEMODULATORS]
+     */
+    uint8_t NbDemodulators;
+    /*!
+     * Argument of the callbacks
+     */
+    void* Context;
+    /*!
+     * Called when a matching frame is detected. A demodulator locks on it
+     * until its end. Returns false to ignore the frame.
+     */
+    bool ( *OnFrameStart )( void* context, const SimChannelFrame_t* frame );
+    /*!
+     * Called at the end of a locked frame. IsCorrupted is set when the frame
+     * was destroyed by a collision.
+     */
+    void ( *OnFrameEnd )( void* context, const SimChannelFrame_t* frame );
+}SimChannelReceiver_t;
+
+/*!
+ * Channel parameters
+ */
+typedef struct sSimChannelParams
+{
+    /*!
+     * Mean link SNR [dB]
+     */
+    int8_t SnrMean;
+    /*!
+     * Link SNR standard deviation [dB]
+     */
+    uint8_t SnrStdDev;
+    /*!
+     * Noise floor [dBm], RSSI = NoiseFloor + max( SNR, 0 )
+     */
+    int16_t NoiseFloor;
+    /*!
+     * Random frame loss rate [per mille]
+     */
+    uint16_t LossRate;
+    /*!
+     * Power difference needed to survive a collision [dB]
+     */
+    uint8_t CaptureMargin;
+    /*!
+     * Mean interval between the interferer frames [s]. 0 disables the
+     * interferer.
+     */
+    uint32_t InterfererInterval;
+    /*!
+     * Interferer payload size
+     */
+    uint8_t InterfererSize;
+    /*!
+     * Interferer frequencies [Hz], drawn at random for each frame
+     */
+    const uint32_t* InterfererFrequencies;
+    /*!
+     * Number of interferer frequencies
+     */
+    uint8_t NbInterfererFrequencies;
+}SimChannelParams_t;
+
+/*!
+ * Channel statistics
+ */
+typedef struct sSimChannelStats
+{
+    /*!
+     * Transmitted frames, per node
+     */
+    uint32_t NbTx[3];
+    /*!
+     * Transmissions time on air, per node [us]
+     */
+    SimTime_t TxTime[3];
+    /*!
+     * Listening time, per node [us]. The ongoing listening periods are not
+     * counted.
+     */
+    SimTime_t RxTime[3];
+    /*!
+     * Frames received without error
+     */
+    uint32_t NbRx;
+    /*!
+     * Frames lost below the demodulation floor or at random
+     */
+    uint32_t NbLost;
+    /*!
+     * Frames destroyed by a collision
+     */
+    uint32_t NbCollisions;
+}SimChannelStats_t;
+
+/*!
+ * \brief Initializes the channel
+ *
+ * \param [IN] params Channel parameters. The structure must stay valid while
+ *                    the channel is used. The link parameters are read for
+ *                    each frame, they may be changed during the simulation.
+ */
+void SimChannelInit( const SimChannelParams_t* params );
+
+/*!
+ * \brief Adds a receiver
+ *
+ * \param [IN] receiver Receiver. The structure must stay valid while the
+ *                      channel is used.
+ */
+void SimChannelAddReceiver( const SimChannelReceiver_t* receiver );
+
+/*!
+ * \brief Starts or stops listening. The frames being demodulated are dropped.
+ *
+ * \param [IN] receiver   Receiver
+ * \param [IN] enable     Set to listen
+ * \param [IN] frequency  RF frequency [Hz], 0 for all the frequencies
+ * \param [IN] sf         Spreading factor, 0 for all the spreading factors
+ * \param [IN] bandwidth  Bandwidth index
+ * \param [IN] iqInverted IQ polarity
+ */
+void SimChannelListen( const SimChannelReceiver_t* receiver, bool enable, uint32_t frequency, uint8_t sf, uint8_t bandwidth, bool iqInverted );
+
+/*!
+ * \brief Starts the transmission of a frame
+ *
+ * \param [IN] frame Frame. Source, radio settings, preamble length and payload
+ *                   must be set,
+ *                   Start is set to the current time.
+ * \param [IN] timeOnAir Frame time on air [us]
+ *
+ * \retval status Returns false when too many frames are on air
+ */
+bool SimChannelSend( const SimChannelFrame_t* frame, SimTime_t timeOnAir );
+
+/*!
+ * \brief Checks if a transmission is ongoing on a frequency
+ *
+ * \param [IN] frequency RF frequency [Hz]
+ *
+ * \retval status Returns true when the frequency is busy
+ */
+bool SimChannelIsBusy( uint32_t frequency );
+
+/*!
+ * \brief Computes the LoRa time on air
+ *
+ * \param [IN] sf         Spreading factor
+ * \param [IN] bandwidth  Bandwidth index
+ * \param [IN] preamble   Preamble length [symbols]
+ * \param [IN] size       Payload size
+ * \param [IN] crcOn      CRC presence
+ *
+ * \retval time Time on air [us]
+ */
+SimTime_t SimChannelGetTimeOnAir( uint8_t sf, uint8_t bandwidth, uint16_t preamble, uint8_t size, bool crcOn );
+
+/*!
+ * \brief Gets the channel statistics
+ *
+ * \retval stats Statistics
+ */
+const SimChannelStats_t* SimChannelGetStats( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_CHANNEL_H__
@@ -0,0 +1,772 @@
+/*!
+ * \file      sim-network.c
+ *
+ * \brief     LoRaWAN network server stub of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stddef.h>
+#include <string.h>
+#include "utilities.h"
+#include "aes.h"
+#include "cmac.h"
+#include "sim.h"
+#include "sim-channel.h"
+#include "sim-network.h"
+
+/*!
+ * LoRaWAN message types
+ */
+#define MHDR_JOIN_REQUEST                           0x00
+#define MHDR_JOIN_ACCEPT                            0x20
+#define MHDR_UNCONFIRMED_DATA_UP                    0x40
+#define MHDR_UNCONFIRMED_DATA_DOWN                  0x60
+#define MHDR_CONFIRMED_DATA_UP                      0x80
+
+/*!
+ * Frame control bits
+ */
+#define FCTRL_ADR                                   0x80
+#define FCTRL_ADR_ACK_REQ                           0x40
+#define FCTRL_ACK                                   0x20
+#define FCTRL_FOPTS_LEN_MASK                        0x0F
+
+/*!
+ * Maximum FOpts size
+ */
+#define LORAMAC_FOPTS_MAX_SIZE                      15
+
+/*!
+ * MAC commands identifiers
+ */
+#define CID_LINK_CHECK                              0x02
+#define CID_LINK_ADR                                0x03
+#define CID_DEV_STATUS                              0x06
+#define CID_DEVICE_TIME                             0x0D
+#define CID_PING_SLOT_INFO                          0x10
+
+/*!
+ * EU868 Class B beacon settings
+ */
+#define BEACON_FREQUENCY                            869525000
+#define BEACON_SPREADING_FACTOR                     9
+#define BEACON_PREAMBLE_LEN                         10
+#define BEACON_SIZE                                 17
+
+/*!
+ * Size of the device MAC commands payload, indexed by CID. -1 for the
+ * identifiers which can't be parsed.
+ */
+static const int8_t UplinkCommandSize[] =
+{
+    -1, 1, 0, 1, 0, 1, 2, 1, 0, 0, 1, 1, 0, 0, -1, 1, 1, 1, 0, 1,
+};
+
+/*!
+ * LoRa demodulation floor per spreading factor, from SF7 to SF12 [dB]
+ */
+static const int8_t DemodulationFloor[] = { -7, -10, -12, -15, -17, -20 };
+
+/*!
+ * Network parameters
+ */
+static const SimNetworkParams_t* Params = NULL;
+
+/*!
+ * Network state of a device
+ */
+typedef struct sSimNetworkDevice
+{
+    uint8_t DevEui[8];
+    uint32_t DevAddr;
+    bool IsJoined;
+    uint32_t JoinNonce;
+    uint8_t NwkSKey[16];
+    uint8_t AppSKey[16];
+    uint32_t FCntUp;
+    uint32_t FCntDown;
+    uint32_t NbUplinks;
+    /*!
+     * Network ADR state
+     */
+    int8_t AdrSnr[SIM_NETWORK_ADR_HISTORY];
+    uint8_t AdrNbSnr;
+    uint8_t TxPower;
+    /*!
+     * Pending downlink
+     */
+    SimChannelFrame_t Downlink;
+    /*!
+     * Downlink transmission event
+     */
+    SimEvent_t DownlinkEvent;
+}SimNetworkDevice_t;
+
+/*!
+ * Devices, in join order
+ */
+static SimNetworkDevice_t Devices[SIM_NETWORK_MAX_DEVICES];
+
+/*!
+ * Statistics
+ */
+static SimNetworkStats_t Stats;
+
+/*!
+ * Beacon frame
+ */
+static SimChannelFrame_t Beacon;
+
+/*!
+ * Next beacon transmission
+ */
+static SimEvent_t BeaconEvent;
+
+/*!
+ * GPS time of the next beacon [s]
+ */
+static uint32_t BeaconTime;
+
+static bool OnFrameStart( void* context, const SimChannelFrame_t* frame );
+static void OnFrameEnd( void* context, const SimChannelFrame_t* frame );
+static void OnDownlinkEvent( void* context );
+static void OnBeaconEvent( void* context );
+
+/*!
+ * Network receiver, a gateway demodulating 8 frames at the same time
+ */
+static const SimChannelReceiver_t Receiver =
+{
+    .Node = SIM_CHANNEL_NODE_NETWORK,
+    .NbDemodulators = 8,
+    .Context = NULL,
+    .OnFrameStart = OnFrameStart,
+    .OnFrameEnd = OnFrameEnd,
+};
+
+/*!
+ * \brief Computes a 4 bytes AES-CMAC MIC
+ */
+static uint32_t ComputeMic( const uint8_t* key, const uint8_t* b0, const uint8_t* buffer, uint16_t size )
+{
+    AES_CMAC_CTX ctx;
+    uint8_t digest[16];
+
+    AES_CMAC_Init( &ctx );
+    AES_CMAC_SetKey( &ctx, key );
+    if( b0 != NULL )
+    {
+        AES_CMAC_Update( &ctx, b0, 16 );
+    }
+    AES_CMAC_Update( &ctx, buffer, size );
+    AES_CMAC_Final( digest, &ctx );
+
+    return ( uint32_t )digest[0] | ( ( uint32_t )digest[1] << 8 ) | ( ( uint32_t )digest[2] << 16 ) |
+           ( ( uint32_t )digest[3] << 24 );
+}
+
+/*!
+ * \brief Builds the B0 or A block of a data frame
+ */
+static void BuildBlock( uint8_t* block, uint8_t id, uint8_t dir, uint32_t devAddr, uint32_t fCnt, uint8_t last )
+{
+    memset1( block, 0, 16 );
+    block[0] = id;
+    block[5] = dir;
+    block[6] = devAddr & 0xFF;
+    block[7] = ( devAddr >> 8 ) & 0xFF;
+    block[8] = ( devAddr >> 16 ) & 0xFF;
+    block[9] = ( devAddr >> 24 ) & 0xFF;
+    block[10] = fCnt & 0xFF;
+    block[11] = ( fCnt >> 8 ) & 0xFF;
+    block[12] = ( fCnt >> 16 ) & 0xFF;
+    block[13] = ( fCnt >> 24 ) & 0xFF;
+    block[15] = last;
+}
+
+/*!
+ * \brief Computes the MIC of a data frame
+ */
+static uint32_t ComputeDataMic( const SimNetworkDevice_t* device, const uint8_t* buffer, uint8_t size, uint8_t dir,
+                               uint32_t fCnt )
+{
+    uint8_t b0[16];
+
+    BuildBlock( b0, 0x49, dir, device->DevAddr, fCnt, size );
+    return ComputeMic( device->NwkSKey, b0, buffer, size );
+}
+
+/*!
+ * \brief Encrypts or decrypts a frame payload in place
+ */
+static void CryptPayload( const SimNetworkDevice_t* device, const uint8_t* key, uint8_t* buffer, uint8_t size,
+                          uint8_t dir, uint32_t fCnt )
+{
+    aes_context ctx;
+    uint8_t a[16];
+    uint8_t s[16];
+
+    aes_set_key( key, 16, &ctx );
+    for( uint8_t i = 0; i < size; i += 16 )
+    {
+        BuildBlock( a, 0x01, dir, device->DevAddr, fCnt, ( i / 16 ) + 1 );
+        aes_encrypt( a, s, &ctx );
+        for( uint8_t j = 0; ( j < 16 ) && ( ( i + j ) < size ); j++ )
+        {
+            buffer[i + j] ^= s[j];
+        }
+    }
+}
+
+/*!
+ * \brief Gets the GPS time of the network
+ *
+ * \param [IN] time Virtual time [us]
+ *
+ * \retval time GPS time [us]
+ */
+static uint64_t GetGpsTime( SimTime_t time )
+{
+    return ( ( uint64_t )Params->GpsTimeOffset * 1000000 ) + time +
+           ( uint64_t )( ( ( int64_t )time * Params->ClockDrift ) / 1000000 );
+}
+
+/*!
+ * \brief Gets the virtual time of a GPS time of the network
+ *
+ * \param [IN] gpsTime GPS time [us], after the start of the simulation
+ *
+ * \retval time Virtual time [us]
+ */
+static SimTime_t GetVirtualTime( uint64_t gpsTime )
+{
+    uint64_t elapsed = gpsTime - ( ( uint64_t )Params->GpsTimeOffset * 1000000 );
+
+    return ( elapsed * 1000000 ) / ( uint64_t )( 1000000 + Params->ClockDrift );
+}
+
+/*!
+ * \brief Computes the CRC of the beacon fields, CRC-16 CCITT with a 0
+ *        initial value
+ */
+static uint16_t ComputeBeaconCrc( const uint8_t* buffer, uint8_t size )
+{
+    uint16_t crc = 0;
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        crc ^= ( uint16_t )buffer[i] << 8;
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( ( crc & 0x8000 ) != 0 ) ? ( ( crc << 1 ) ^ 0x1021 ) : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Schedules the beacon of BeaconTime
+ */
+static void ScheduleBeacon( void )
+{
+    SimEventSchedule( &BeaconEvent, GetVirtualTime( ( uint64_t )BeaconTime * 1000000 ) );
+}
+
+/*!
+ * \brief Gets the uplink datarate from the spreading factor, EU868 layout
+ */
+static uint8_t GetDatarate( uint8_t sf )
+{
+    return 12 - sf;
+}
+
+/*!
+ * \brief Schedules a downlink in the RX1 window of an uplink
+ */
+static void ScheduleDownlink( SimNetworkDevice_t* device, const SimChannelFrame_t* uplink, uint8_t size,
+                              uint32_t delay )
+{
+    device->Downlink.Source = SIM_CHANNEL_NODE_NETWORK;
+    device->Downlink.Frequency = uplink->Frequency;
+    device->Downlink.SpreadingFactor = uplink->SpreadingFactor;
+    device->Downlink.Bandwidth = uplink->Bandwidth;
+    device->Downlink.IqInverted = true;
+    device->Downlink.PreambleLen = 8;
+    device->Downlink.Size = size;
+    SimEventSchedule( &device->DownlinkEvent, SimGetTime( ) + ( ( SimTime_t )delay * 1000000 ) );
+}
+
+/*!
+ * \brief Gets the device of a join request. Registers it on its first join
+ *
+ * \retval device Device, NULL when the device table is full
+ */
+static SimNetworkDevice_t* GetDeviceByEui( const uint8_t* devEui )
+{
+    for( uint16_t i = 0; i < Stats.NbDevices; i++ )
+    {
+        if( memcmp( Devices[i].DevEui, devEui, 8 ) == 0 )
+        {
+            return &Devices[i];
+        }
+    }
+    if( Stats.NbDevices >= SIM_NETWORK_MAX_DEVICES )
+    {
+        return NULL;
+    }
+
+    SimNetworkDevice_t* device = &Devices[Stats.NbDevices];
+
+    memcpy1( device->DevEui, devEui, 8 );
+    device->DevAddr = Params->DevAddr + Stats.NbDevices;
+    SimEventInit( &device->DownlinkEvent, OnDownlinkEvent, device );
+    Stats.NbDevices++;
+    return device;
+}
+
+/*!
+ * \brief Gets the joined device using an address
+ *
+ * \retval device Device, NULL if none
+ */
+static SimNetworkDevice_t* GetDeviceByAddr( uint32_t devAddr )
+{
+    for( uint16_t i = 0; i < Stats.NbDevices; i++ )
+    {
+        if( ( Devices[i].IsJoined == true ) && ( Devices[i].DevAddr == devAddr ) )
+        {
+            return &Devices[i];
+        }
+    }
+    return NULL;
+}
+
+/*!
+ * \brief Answers a join request
+ */
+static void ProcessJoinRequest( const SimChannelFrame_t* frame )
+{
+    SimNetworkDevice_t* device;
+    aes_context ctx;
+    uint8_t* buffer;
+    uint8_t size = 0;
+    uint16_t devNonce;
+    uint32_t mic;
+
+    if( frame->Size != 23 )
+    {
+        return;
+    }
+    mic = ( uint32_t )frame->Payload[19] | ( ( uint32_t )frame->Payload[20] << 8 ) |
+          ( ( uint32_t )frame->Payload[21] << 16 ) | ( ( uint32_t )frame->Payload[22] << 24 );
+    device = GetDeviceByEui( &frame->Payload[9] );
+    if( ( device == NULL ) || ( ComputeMic( Params->NwkKey, NULL, frame->Payload, 19 ) != mic ) )
+    {
+        Stats.NbRejected++;
+        return;
+    }
+    if( device->DownlinkEvent.IsScheduled == true )
+    {
+        // Still answering the previous request
+        return;
+    }
+    Stats.NbJoinRequests++;
+    devNonce = ( uint16_t )frame->Payload[17] | ( ( uint16_t )frame->Payload[18] << 8 );
+    device->JoinNonce++;
+
+    buffer = device->Downlink.Payload;
+    buffer[size++] = MHDR_JOIN_ACCEPT;
+    buffer[size++] = device->JoinNonce & 0xFF;
+    buffer[size++] = ( device->JoinNonce >> 8 ) & 0xFF;
+    buffer[size++] = ( device->JoinNonce >> 16 ) & 0xFF;
+    buffer[size++] = Params->NetId & 0xFF;
+    buffer[size++] = ( Params->NetId >> 8 ) & 0xFF;
+    buffer[size++] = ( Params->NetId >> 16 ) & 0xFF;
+    buffer[size++] = device->DevAddr & 0xFF;
+    buffer[size++] = ( device->DevAddr >> 8 ) & 0xFF;
+    buffer[size++] = ( device->DevAddr >> 16 ) & 0xFF;
+    buffer[size++] = ( device->DevAddr >> 24 ) & 0xFF;
+    // DLSettings: LoRaWAN 1.0.x, RX1DROffset 0, RX2 datarate 0
+    buffer[size++] = 0x00;
+    buffer[size++] = SIM_NETWORK_RECEIVE_DELAY1;
+    if( Params->CfList != NULL )
+    {
+        memcpy1( &buffer[size], Params->CfList, 16 );
+        size += 16;
+    }
+    mic = ComputeMic( Params->NwkKey, NULL, buffer, size );
+    buffer[size++] = mic & 0xFF;
+    buffer[size++] = ( mic >> 8 ) & 0xFF;
+    buffer[size++] = ( mic >> 16 ) & 0xFF;
+    buffer[size++] = ( mic >> 24 ) & 0xFF;
+
+    // The device decrypts the join accept with an AES encryption
+    aes_set_key( Params->NwkKey, 16, &ctx );
+    for( uint8_t i = 1; i < size; i += 16 )
+    {
+        uint8_t block[16];
+
+        aes_decrypt( &buffer[i], block, &ctx );
+        memcpy1( &buffer[i], block, 16 );
+    }
+
+    // Session keys, LoRaWAN 1.0.x
+    for( uint8_t i = 0; i < 2; i++ )
+    {
+        uint8_t block[16] = { 0 };
+
+        block[0] = i + 1;
+        block[1] = device->JoinNonce & 0xFF;
+        block[2] = ( device->JoinNonce >> 8 ) & 0xFF;
+        block[3] = ( device->JoinNonce >> 16 ) & 0xFF;
+        block[4] = Params->NetId & 0xFF;
+        block[5] = ( Params->NetId >> 8 ) & 0xFF;
+        block[6] = ( Params->NetId >> 16 ) & 0xFF;
+        block[7] = devNonce & 0xFF;
+        block[8] = ( devNonce >> 8 ) & 0xFF;
+        aes_encrypt( block, ( i == 0 ) ? device->NwkSKey : device->AppSKey, &ctx );
+    }
+    device->IsJoined = true;
+    device->FCntUp = 0;
+    device->FCntDown = 0;
+    device->NbUplinks = 0;
+    device->AdrNbSnr = 0;
+    device->TxPower = 0;
+
+    ScheduleDownlink( device, frame, size, SIM_NETWORK_JOIN_ACCEPT_DELAY1 );
+}
+
+/*!
+ * \brief Runs the network side ADR
+ *
+ * \retval size Size of the LinkADRReq written to buffer, 0 if none
+ */
+static uint8_t ProcessAdr( SimNetworkDevice_t* device, const SimChannelFrame_t* frame, uint8_t* buffer )
+{
+    int8_t snrMax = -128;
+    int8_t nbSteps;
+    uint8_t datarate = GetDatarate( frame->SpreadingFactor );
+    uint8_t txPower = device->TxPower;
+
+    if( device->AdrNbSnr < SIM_NETWORK_ADR_HISTORY )
+    {
+        device->AdrSnr[device->AdrNbSnr++] = frame->Snr;
+        if( device->AdrNbSnr < SIM_NETWORK_ADR_HISTORY )
+        {
+            return 0;
+        }
+    }
+    for( uint8_t i = 0; i < SIM_NETWORK_ADR_HISTORY; i++ )
+    {
+        snrMax = MAX( snrMax, device->AdrSnr[i] );
+    }
+    device->AdrNbSnr = 0;
+
+    nbSteps = ( snrMax - DemodulationFloor[frame->SpreadingFactor - 7] - SIM_NETWORK_ADR_MARGIN ) / 3;
+    while( ( nbSteps > 0 ) && ( datarate < Params->AdrMaxDatarate ) )
+    {
+        datarate++;
+        nbSteps--;
+    }
+    while( ( nbSteps > 0 ) && ( txPower < 7 ) )
+    {
+        txPower++;
+        nbSteps--;
+    }
+    while( ( nbSteps < 0 ) && ( txPower > 0 ) )
+    {
+        txPower--;
+        nbSteps++;
+    }
+    if( ( datarate == GetDatarate( frame->SpreadingFactor ) ) && ( txPower == device->TxPower ) )
+    {
+        return 0;
+    }
+    device->TxPower = txPower;
+    Stats.NbAdrRequests++;
+
+    buffer[0] = CID_LINK_ADR;
+    buffer[1] = ( datarate << 4 ) | txPower;
+    buffer[2] = Params->AdrChMask & 0xFF;
+    buffer[3] = ( Params->AdrChMask >> 8 ) & 0xFF;
+    // ChMaskCntl 0, NbTrans 1
+    buffer[4] = 0x01;
+    return 5;
+}
+
+/*!
+ * \brief Processes a data uplink and answers it when needed
+ */
+static void ProcessDataUplink( const SimChannelFrame_t* frame )
+{
+    const uint8_t* payload = frame->Payload;
+    SimNetworkDevice_t* device;
+    uint8_t fOpts[16];
+    uint8_t fOptsLen;
+    uint8_t answer[LORAMAC_FOPTS_MAX_SIZE];
+    uint8_t answerLen = 0;
+    bool isAckNeeded = ( payload[0] & 0xE0 ) == MHDR_CONFIRMED_DATA_UP;
+    bool isDownlinkNeeded = isAckNeeded;
+    uint32_t devAddr;
+    uint32_t fCnt;
+    uint32_t mic;
+    bool isRetransmission;
+
+    if( frame->Size < 12 )
+    {
+        return;
+    }
+    devAddr = ( uint32_t )payload[1] | ( ( uint32_t )payload[2] << 8 ) | ( ( uint32_t )payload[3] << 16 ) |
+              ( ( uint32_t )payload[4] << 24 );
+    fOptsLen = payload[5] & FCTRL_FOPTS_LEN_MASK;
+    device = GetDeviceByAddr( devAddr );
+    if( ( device == NULL ) || ( frame->Size < ( 12 + fOptsLen ) ) )
+    {
+        Stats.NbRejected++;
+        return;
+    }
+    if( device->DownlinkEvent.IsScheduled == true )
+    {
+        return;
+    }
+
+    // Frame counter, the 16 MSB are guessed from the previous uplink
+    fCnt = ( device->FCntUp & 0xFFFF0000 ) | ( ( uint32_t )payload[6] | ( ( uint32_t )payload[7] << 8 ) );
+    if( ( device->NbUplinks != 0 ) && ( fCnt < device->FCntUp ) )
+    {
+        fCnt += 0x10000;
+    }
+    mic = ( uint32_t )payload[frame->Size - 4] | ( ( uint32_t )payload[frame->Size - 3] << 8 ) |
+          ( ( uint32_t )payload[frame->Size - 2] << 16 ) | ( ( uint32_t )payload[frame->Size - 1] << 24 );
+    if( ComputeDataMic( device, payload, frame->Size - 4, 0, fCnt ) != mic )
+    {
+        Stats.NbRejected++;
+        return;
+    }
+    if( ( device->NbUplinks != 0 ) && ( fCnt > ( device->FCntUp + 1 ) ) )
+    {
+        Stats.NbFCntGaps++;
+    }
+    isRetransmission = ( device->NbUplinks != 0 ) && ( fCnt == device->FCntUp );
+    device->FCntUp = fCnt;
+    device->NbUplinks++;
+    Stats.NbUplinks++;
+    if( isAckNeeded == true )
+    {
+        Stats.NbConfirmedUplinks++;
+    }
+
+    // Application payload, forwarded once
+    if( ( Params->OnUplink != NULL ) && ( isRetransmission == false ) && ( frame->Size > ( 13 + fOptsLen ) ) &&
+        ( payload[8 + fOptsLen] != 0 ) )
+    {
+        uint8_t appPayload[SIM_CHANNEL_MAX_PAYLOAD];
+        uint8_t appSize = frame->Size - 13 - fOptsLen;
+
+        memcpy1( appPayload, &payload[9 + fOptsLen], appSize );
+        CryptPayload( device, device->AppSKey, appPayload, appSize, 0, fCnt );
+        Params->OnUplink( device->DevEui, payload[8 + fOptsLen], appPayload, appSize );
+    }
+
+    // MAC commands, in FOpts or in a port 0 payload
+    memcpy1( fOpts, &payload[8], fOptsLen );
+    if( ( fOptsLen == 0 ) && ( frame->Size > 13 ) && ( payload[8] == 0 ) )
+    {
+        fOptsLen = ( uint8_t )MIN( ( size_t )( frame->Size - 13 ), sizeof( fOpts ) );
+        memcpy1( fOpts, &payload[9], fOptsLen );
+        CryptPayload( device, device->NwkSKey, fOpts, fOptsLen, 0, fCnt );
+    }
+    for( uint8_t i = 0; i < fOptsLen; )
+    {
+        uint8_t cid = fOpts[i++];
+
+        if( ( cid >= sizeof( UplinkCommandSize ) ) || ( UplinkCommandSize[cid] < 0 ) )
+        {
+            break;
+        }
+        // Room for the longest answer and a LinkADRReq
+        if( ( answerLen + 6 + 5 ) > ( int )sizeof( answer ) )
+        {
+            break;
+        }
+        switch( cid )
+        {
+            case CID_LINK_CHECK:
+                answer[answerLen++] = CID_LINK_CHECK;
+                answer[answerLen++] = ( uint8_t )MAX( frame->Snr - DemodulationFloor[frame->SpreadingFactor - 7], 0 );
+                answer[answerLen++] = 1;
+                break;
+            case CID_DEVICE_TIME:
+            {
+                uint64_t time = GetGpsTime( SimGetTime( ) );
+                uint32_t seconds = ( uint32_t )( time / 1000000 );
+
+                answer[answerLen++] = CID_DEVICE_TIME;
+                answer[answerLen++] = seconds & 0xFF;
+                answer[answerLen++] = ( seconds >> 8 ) & 0xFF;
+                answer[answerLen++] = ( seconds >> 16 ) & 0xFF;
+                answer[answerLen++] = ( seconds >> 24 ) & 0xFF;
+                answer[answerLen++] = ( uint8_t )( ( ( time % 1000000 ) * 256 ) / 1000000 );
+                break;
+            }
+            case CID_PING_SLOT_INFO:
+                answer[answerLen++] = CID_PING_SLOT_INFO;
+                break;
+            case CID_DEV_STATUS:
+                if( ( i + 1 ) < fOptsLen )
+                {
+                    Stats.Battery = fOpts[i];
+                    Stats.Margin = ( int8_t )( fOpts[i + 1] << 2 ) >> 2;
+                }
+                break;
+            default:
+                break;
+        }
+        i += UplinkCommandSize[cid];
+        isDownlinkNeeded |= answerLen != 0;
+    }
+
+    if( ( Params->AdrEnabled == true ) && ( ( payload[5] & FCTRL_ADR ) != 0 ) )
+    {
+        answerLen += ProcessAdr( device, frame, &answer[answerLen] );
+    }
+    if( ( Params->DevStatusInterval != 0 ) && ( ( device->NbUplinks % Params->DevStatusInterval ) == 0 ) &&
+        ( answerLen < sizeof( answer ) ) )
+    {
+        answer[answerLen++] = CID_DEV_STATUS;
+    }
+    isDownlinkNeeded |= ( answerLen != 0 ) || ( ( payload[5] & FCTRL_ADR_ACK_REQ ) != 0 );
+    if( isDownlinkNeeded == false )
+    {
+        return;
+    }
+
+    // Unconfirmed downlink carrying the MAC commands in FOpts
+    uint8_t* buffer = device->Downlink.Payload;
+    uint8_t size = 0;
+
+    buffer[size++] = MHDR_UNCONFIRMED_DATA_DOWN;
+    buffer[size++] = device->DevAddr & 0xFF;
+    buffer[size++] = ( device->DevAddr >> 8 ) & 0xFF;
+    buffer[size++] = ( device->DevAddr >> 16 ) & 0xFF;
+    buffer[size++] = ( device->DevAddr >> 24 ) & 0xFF;
+    buffer[size++] = ( isAckNeeded ? FCTRL_ACK : 0 ) | ( Params->AdrEnabled ? FCTRL_ADR : 0 ) | answerLen;
+    buffer[size++] = device->FCntDown & 0xFF;
+    buffer[size++] = ( device->FCntDown >> 8 ) & 0xFF;
+    memcpy1( &buffer[size], answer, answerLen );
+    size += answerLen;
+    mic = ComputeDataMic( device, buffer, size, 1, device->FCntDown );
+    buffer[size++] = mic & 0xFF;
+    buffer[size++] = ( mic >> 8 ) & 0xFF;
+    buffer[size++] = ( mic >> 16 ) & 0xFF;
+    buffer[size++] = ( mic >> 24 ) & 0xFF;
+    device->FCntDown++;
+
+    ScheduleDownlink( device, frame, size, SIM_NETWORK_RECEIVE_DELAY1 );
+}
+
+void SimNetworkInit( const SimNetworkParams_t* params )
+{
+    Params = params;
+    memset1( ( uint8_t* )Devices, 0, sizeof( Devices ) );
+    memset1( ( uint8_t* )&Stats, 0, sizeof( Stats ) );
+
+    SimChannelAddReceiver( &Receiver );
+    // Frequency and spreading factor 0: the gateway listens to all the channels
+    SimChannelListen( &Receiver, true, 0, 0, 0, false );
+
+    SimEventInit( &BeaconEvent, OnBeaconEvent, NULL );
+    if( Params->BeaconEnabled == true )
+    {
+        // Start of the first beacon period after the start of the simulation
+        BeaconTime = ( ( Params->GpsTimeOffset / SIM_NETWORK_BEACON_INTERVAL ) + 1 ) * SIM_NETWORK_BEACON_INTERVAL;
+        ScheduleBeacon( );
+    }
+}
+
+const SimNetworkStats_t* SimNetworkGetStats( void )
+{
+    return &Stats;
+}
+
+static bool OnFrameStart( void* context, const SimChannelFrame_t* frame )
+{
+    // The interferer frames belong to another network
+    return frame->Source == SIM_CHANNEL_NODE_DEVICE;
+}
+
+static void OnFrameEnd( void* context, const SimChannelFrame_t* frame )
+{
+    if( ( frame->IsCorrupted == true ) || ( frame->Size == 0 ) )
+    {
+        return;
+    }
+    switch( frame->Payload[0] & 0xE0 )
+    {
+        case MHDR_JOIN_REQUEST:
+            ProcessJoinRequest( frame );
+            break;
+        case MHDR_UNCONFIRMED_DATA_UP:
+        case MHDR_CONFIRMED_DATA_UP:
+            ProcessDataUplink( frame );
+            break;
+        default:
+            break;
+    }
+}
+
+static void OnDownlinkEvent( void* context )
+{
+    SimChannelFrame_t* downlink = &( ( SimNetworkDevice_t* )context )->Downlink;
+
+    Stats.NbDownlinks++;
+    SimChannelSend( downlink, SimChannelGetTimeOnAir( downlink->SpreadingFactor, downlink->Bandwidth,
+                                                      downlink->PreambleLen, downlink->Size, false ) );
+}
+
+static void OnBeaconEvent( void* context )
+{
+    uint32_t seconds = BeaconTime;
+    uint8_t* buffer = Beacon.Payload;
+    uint16_t crc;
+
+    // Beacon frame: | RFU | Param | Time | CRC | GwSpecific | CRC |
+    memset1( buffer, 0, BEACON_SIZE );
+    buffer[2] = seconds & 0xFF;
+    buffer[3] = ( seconds >> 8 ) & 0xFF;
+    buffer[4] = ( seconds >> 16 ) & 0xFF;
+    buffer[5] = ( seconds >> 24 ) & 0xFF;
+    crc = ComputeBeaconCrc( buffer, 6 );
+    buffer[6] = crc & 0xFF;
+    buffer[7] = ( crc >> 8 ) & 0xFF;
+    crc = ComputeBeaconCrc( &buffer[8], 7 );
+    buffer[15] = crc & 0xFF;
+    buffer[16] = ( crc >> 8 ) & 0xFF;
+
+    Beacon.Source = SIM_CHANNEL_NODE_NETWORK;
+    Beacon.Frequency = BEACON_FREQUENCY;
+    Beacon.SpreadingFactor = BEACON_SPREADING_FACTOR;
+    Beacon.Bandwidth = 0;
+    Beacon.IqInverted = false;
+    Beacon.PreambleLen = BEACON_PREAMBLE_LEN;
+    Beacon.Size = BEACON_SIZE;
+    if( ( SimRandom( ) % 1000 ) >= Params->BeaconLossRate )
+    {
+        Stats.NbBeacons++;
+        SimChannelSend( &Beacon, SimChannelGetTimeOnAir( Beacon.SpreadingFactor, Beacon.Bandwidth,
+                                                         Beacon.PreambleLen, Beacon.Size, false ) );
+    }
+    BeaconTime += SIM_NETWORK_BEACON_INTERVAL;
+    ScheduleBeacon( );
+}
@@ -0,0 +1,221 @@
+/*!
+ * \file      sim-network.h
+ *
+ * \brief     LoRaWAN network server stub of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The stub serves up to SIM_NETWORK_MAX_DEVICES LoRaWAN 1.0.x
+ *            devices sharing the same NwkKey, on a region using the EU868
+ *            frame layout ( RX1 on the uplink frequency and spreading factor ):
+ *            - Registers a device on the first join request of its DevEUI
+ *              and assigns it the next device address.
+ *            - Answers the join requests with a join accept in RX1 after
+ *              JOIN_ACCEPT_DELAY1.
+ *            - Checks the uplinks MIC and answers in RX1 after RECEIVE_DELAY1
+ *              with an ACK, LinkCheckAns, DeviceTimeAns, PingSlotInfoAns,
+ *              DevStatusReq and a network side ADR LinkADRReq when needed.
+ *            - Decrypts the application payloads and forwards them to the
+ *              OnUplink callback, if any.
+ *            - Transmits the EU868 Class B beacons at the start of each
+ *              beacon period of the GPS time, when enabled.
+ *            The network time may drift from the virtual time, which the
+ *            device clock follows: this simulates the drift of the device
+ *            clock.
+ *            The gateway demodulates 8 frames at the same time. Its
+ *            transmissions are not limited: the downlinks of several devices
+ *            may be on air at the same time.
+ */
+#ifndef __SIM_NETWORK_H__
+#define __SIM_NETWORK_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * Maximum number of devices
+ */
+#ifndef SIM_NETWORK_MAX_DEVICES
+#define SIM_NETWORK_MAX_DEVICES                     16
+#endif
+
+/*!
+ * Join accept delay [s]
+ */
+#define SIM_NETWORK_JOIN_ACCEPT_DELAY1              5
+
+/*!
+ * RX1 delay [s], sent in the join accept
+ */
+#define SIM_NETWORK_RECEIVE_DELAY1                  1
+
+/*!
+ * Number of uplinks used by the network ADR
+ */
+#define SIM_NETWORK_ADR_HISTORY                     20
+
+/*!
+ * Network ADR installation margin [dB]
+ */
+#define SIM_NETWORK_ADR_MARGIN                      10
+
+/*!
+ * Class B beacon period [s]
+ */
+#define SIM_NETWORK_BEACON_INTERVAL                 128
+
+/*!
+ * Network parameters
+ */
+typedef struct sSimNetworkParams
+{
+    /*!
+     * Device root key
+     */
+    uint8_t NwkKey[16];
+    /*!
+     * Network identifier
+     */
+    uint32_t NetId;
+    /*!
+     * Device address assigned to the first device, the next devices get the
+     * next addresses
+     */
+    uint32_t DevAddr;
+    /*!
+     * Channel frequency list sent in the join accept, NULL for none
+     */
+    const uint8_t* CfList;
+    /*!
+     * Set to run the network side ADR
+     */
+    bool AdrEnabled;
+    /*!
+     * Highest datarate granted by the ADR
+     */
+    uint8_t AdrMaxDatarate;
+    /*!
+     * Channel mask sent in the ADR requests
+     */
+    uint16_t AdrChMask;
+    /*!
+     * Number of uplinks between two DevStatusReq, 0 to disable
+     */
+    uint16_t DevStatusInterval;
+    /*!
+     * GPS time at the start of the simulation [s]
+     */
+    uint32_t GpsTimeOffset;
+    /*!
+     * Drift of the network time from the virtual time [ppm]. The device
+     * clock drifts by the opposite amount.
+     */
+    int16_t ClockDrift;
+    /*!
+     * Set to transmit the Class B beacons
+     */
+    bool BeaconEnabled;
+    /*!
+     * Beacons randomly not transmitted [per mille]
+     */
+    uint16_t BeaconLossRate;
+    /*!
+     * Called with the decrypted application payload of each accepted uplink,
+     * NULL when not used
+     *
+     * \param [IN] devEui DevEUI of the device, 8 bytes
+     * \param [IN] port   Application port
+     * \param [IN] buffer Application payload
+     * \param [IN] size   Application payload size
+     */
+    void ( *OnUplink )( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size );
+}SimNetworkParams_t;
+
+/*!
+ * Network statistics
+ */
+typedef struct sSimNetworkStats
+{
+    /*!
+     * Registered devices
+     */
+    uint16_t NbDevices;
+    /*!
+     * Received join requests
+     */
+    uint32_t NbJoinRequests;
+    /*!
+     * Received data uplinks
+     */
+    uint32_t NbUplinks;
+    /*!
+     * Received confirmed data uplinks
+     */
+    uint32_t NbConfirmedUplinks;
+    /*!
+     * Join requests and uplinks rejected on a MIC or address mismatch, or
+     * when the device table is full
+     */
+    uint32_t NbRejected;
+    /*!
+     * Uplinks received with a frame counter gap
+     */
+    uint32_t NbFCntGaps;
+    /*!
+     * Sent downlinks, join accepts included
+     */
+    uint32_t NbDownlinks;
+    /*!
+     * Sent LinkADRReq
+     */
+    uint32_t NbAdrRequests;
+    /*!
+     * Sent beacons
+     */
+    uint32_t NbBeacons;
+    /*!
+     * Last received battery level
+     */
+    uint8_t Battery;
+    /*!
+     * Last received downlink margin [dB]
+     */
+    int8_t Margin;
+}SimNetworkStats_t;
+
+/*!
+ * \brief Initializes the network and starts listening on the channel
+ *
+ * \param [IN] params Network parameters. The structure must stay valid while
+ *                    the network is used.
+ */
+void SimNetworkInit( const SimNetworkParams_t* params );
+
+/*!
+ * \brief Gets the network statistics
+ *
+ * \retval stats Statistics
+ */
+const SimNetworkStats_t* SimNetworkGetStats( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_NETWORK_H__
@@ -0,0 +1,170 @@
+/*!
+ * \file      sim.c
+ *
+ * \brief     Discrete event simulation core of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stddef.h>
+#include "sim.h"
+
+/*!
+ * Virtual time
+ */
+static SimTime_t SimTime = 0;
+
+/*!
+ * End of the simulation
+ */
+static SimTime_t SimEndTime = 0;
+
+/*!
+ * Set while the simulation is running
+ */
+static bool IsSimRunning = false;
+
+/*!
+ * Scheduled events, sorted by expiry time
+ */
+static SimEvent_t* SimEventListHead = NULL;
+
+/*!
+ * Random generator state
+ */
+static uint32_t SimRandomState = 1;
+
+void SimInit( uint32_t seed, uint32_t duration )
+{
+    SimTime = 0;
+    SimEndTime = ( SimTime_t )duration * 1000000;
+    SimEventListHead = NULL;
+    SimRandomState = ( seed != 0 ) ? seed : 1;
+    IsSimRunning = true;
+}
+
+SimTime_t SimGetTime( void )
+{
+    return SimTime;
+}
+
+void SimEventInit( SimEvent_t* event, SimEventCallback_t callback, void* context )
+{
+    event->Time = 0;
+    event->Callback = callback;
+    event->Context = context;
+    event->IsScheduled = false;
+    event->Next = NULL;
+}
+
+void SimEventSchedule( SimEvent_t* event, SimTime_t time )
+{
+    SimEvent_t** cur = &SimEventListHead;
+
+    SimEventCancel( event );
+
+    event->Time = ( time < SimTime ) ? SimTime : time;
+    event->IsScheduled = true;
+
+    // Insert after the events expiring at the same time
+    while( ( *cur != NULL ) && ( ( *cur )->Time <= event->Time ) )
+    {
+        cur = &( *cur )->Next;
+    }
+    event->Next = *cur;
+    *cur = event;
+}
+
+void SimEventCancel( SimEvent_t* event )
+{
+    SimEvent_t** cur = &SimEventListHead;
+
+    if( event->IsScheduled == false )
+    {
+        return;
+    }
+    while( *cur != NULL )
+    {
+        if( *cur == event )
+        {
+            *cur = event->Next;
+            break;
+        }
+        cur = &( *cur )->Next;
+    }
+    event->IsScheduled = false;
+    event->Next = NULL;
+}
+
+void SimSleep( void )
+{
+    SimEvent_t* event = SimEventListHead;
+
+    if( ( event == NULL ) || ( event->Time > SimEndTime ) )
+    {
+        SimTime = SimEndTime;
+        IsSimRunning = false;
+        return;
+    }
+
+    SimEventListHead = event->Next;
+    event->IsScheduled = false;
+    event->Next = NULL;
+    if( event->Time > SimTime )
+    {
+        SimTime = event->Time;
+    }
+    event->Callback( event->Context );
+}
+
+void SimDelay( SimTime_t duration )
+{
+    SimTime += duration;
+}
+
+bool SimIsRunning( void )
+{
+    return IsSimRunning;
+}
+
+uint32_t SimRandom( void )
+{
+    // xorshift32
+    SimRandomState ^= SimRandomState << 13;
+    SimRandomState ^= SimRandomState >> 17;
+    SimRandomState ^= SimRandomState << 5;
+    return SimRandomState;
+}
+
+int32_t SimRandomRange( int32_t min, int32_t max )
+{
+    if( max <= min )
+    {
+        return min;
+    }
+    return min + ( int32_t )( SimRandom( ) % ( uint32_t )( max - min + 1 ) );
+}
+
+int32_t SimRandomGauss( int32_t mean, int32_t stdDev )
+{
+    // Irwin-Hall approximation: the sum of 12 uniform numbers in [0, 1[ has a
+    // variance of 1. Computed in 1/65536 units.
+    int64_t sum = 0;
+
+    for( uint8_t i = 0; i < 12; i++ )
+    {
+        sum += SimRandom( ) >> 16;
+    }
+    sum -= 6 * 65536;
+    return mean + ( int32_t )( ( sum * stdDev ) / 65536 );
+}
@@ -0,0 +1,173 @@
+/*!
+ * \file      sim.h
+ *
+ * \brief     Discrete event simulation core of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The simulation runs in virtual time. The time only advances when
+ *            the application enters the low power mode ( \ref SimSleep ) or
+ *            waits ( \ref SimDelay ). The events scheduled at the same time
+ *            are run in scheduling order, which makes the runs deterministic
+ *            for a given seed.
+ */
+#ifndef __SIM_H__
+#define __SIM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * Virtual time [us]
+ */
+typedef uint64_t SimTime_t;
+
+/*!
+ * Event callback
+ */
+typedef void ( *SimEventCallback_t )( void* context );
+
+/*!
+ * Event. The storage is owned by the caller.
+ */
+typedef struct sSimEvent
+{
+    /*!
+     * Expiry time
+     */
+    SimTime_t Time;
+    /*!
+     * Function called at expiry time
+     */
+    SimEventCallback_t Callback;
+    /*!
+     * Argument of the callback
+     */
+    void* Context;
+    /*!
+     * Set while the event is scheduled
+     */
+    bool IsScheduled;
+    /*!
+     * Next scheduled event
+     */
+    struct sSimEvent* Next;
+}SimEvent_t;
+
+/*!
+ * \brief Initializes the simulation
+ *
+ * \param [IN] seed     Seed of the random generator
+ * \param [IN] duration Duration of the simulation [s]
+ */
+void SimInit( uint32_t seed, uint32_t duration );
+
+/*!
+ * \brief Gets the virtual time
+ *
+ * \retval time Virtual time [us]
+ */
+SimTime_t SimGetTime( void );
+
+/*!
+ * \brief Initializes an event
+ *
+ * \param [IN] event    Event
+ * \param [IN] callback Function called at expiry time
+ * \param [IN] context  Argument of the callback
+ */
+void SimEventInit( SimEvent_t* event, SimEventCallback_t callback, void* context );
+
+/*!
+ * \brief Schedules an event. Reschedules it if it is already scheduled.
+ *
+ * \param [IN] event Event
+ * \param [IN] time  Expiry time [us]. A time in the past expires at once.
+ */
+void SimEventSchedule( SimEvent_t* event, SimTime_t time );
+
+/*!
+ * \brief Cancels an event
+ *
+ * \param [IN] event Event
+ */
+void SimEventCancel( SimEvent_t* event );
+
+/*!
+ * \brief Advances the virtual time to the next event and runs it. Ends the
+ *        simulation when no event is left before the end of the simulation.
+ */
+void SimSleep( void );
+
+/*!
+ * \brief Advances the virtual time without running the events. They are run
+ *        by the next \ref SimSleep.
+ *
+ * \param [IN] duration Duration [us]
+ */
+void SimDelay( SimTime_t duration );
+
+/*!
+ * \brief Checks if the simulation is running
+ *
+ * \retval status Returns false once the end of the simulation is reached
+ */
+bool SimIsRunning( void );
+
+/*!
+ * \brief Gets a random number
+ *
+ * \retval value 32 bits random number
+ */
+uint32_t SimRandom( void );
+
+/*!
+ * \brief Gets a random number within an interval
+ *
+ * \param [IN] min Minimum value
+ * \param [IN] max Maximum value
+ *
+ * \retval value Random number in [min, max]
+ */
+int32_t SimRandomRange( int32_t min, int32_t max );
+
+/*!
+ * \brief Gets a normally distributed random number
+ *
+ * \param [IN] mean   Mean
+ * \param [IN] stdDev Standard deviation
+ *
+ * \retval value Random number
+ */
+int32_t SimRandomGauss( int32_t mean, int32_t stdDev );
+
+/*!
+ * \brief Makes the virtual EEPROM writes fail or succeed
+ *
+ * \remark This function is defined in eeprom-board.c file
+ *
+ * \param [IN] isWriteError Set to true to make the writes fail
+ */
+void SimEepromSetWriteError( bool isWriteError );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_H__
@@ -0,0 +1,197 @@
+/*!
+ * \file      sim-test.c
+ *
+ * \brief     Common fixture of the Simulation board host tests running the
+ *            LmHandler application layer
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stdio.h>
+#include "utilities.h"
+#include "board.h"
+#include "timer.h"
+#include "sim.h"
+#include "sim-test.h"
+
+/*!
+ * Test fixture parameters
+ */
+static const SimTestParams_t* SimTestParams;
+
+/*!
+ * Seconds elapsed since the join, -1 before
+ */
+static int32_t Seconds = -1;
+
+static uint8_t AppDataBuffer[242];
+
+static volatile bool IsMacProcessPending = false;
+static volatile bool IsTickPending = false;
+
+/*!
+ * Scenario timer, one tick per second
+ */
+static TimerEvent_t TickTimer;
+
+static void OnMacProcessNotify( void );
+static void OnJoinRequest( LmHandlerJoinParams_t* params );
+
+static LmHandlerCallbacks_t LmHandlerCallbacks;
+
+static LmHandlerParams_t LmHandlerParams =
+{
+    .Region = LORAMAC_REGION_EU868,
+    .AdrEnable = false,
+    .IsTxConfirmed = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+    .TxDatarate = DR_0,
+    .PublicNetworkEnable = true,
+    .DutyCycleEnabled = false,
+    .DataBufferMaxSize = sizeof( AppDataBuffer ),
+    .DataBuffer = AppDataBuffer,
+    .PingSlotPeriodicity = 7,
+};
+
+static void OnTickTimerEvent( void* context )
+{
+    IsTickPending = true;
+    TimerStart( &TickTimer );
+}
+
+static void OnMacProcessNotify( void )
+{
+    IsMacProcessPending = true;
+}
+
+static void OnJoinRequest( LmHandlerJoinParams_t* params )
+{
+    if( params->Status == LORAMAC_HANDLER_ERROR )
+    {
+        LmHandlerJoin( );
+        return;
+    }
+    if( SimTestParams->OnJoined != NULL )
+    {
+        SimTestParams->OnJoined( );
+    }
+
+    TimerInit( &TickTimer, OnTickTimerEvent );
+    TimerSetValue( &TickTimer, 1000 );
+    TimerStart( &TickTimer );
+    IsTickPending = true;
+}
+
+bool SimTestInit( const SimTestParams_t* params )
+{
+    SimTestParams = params;
+    Seconds = -1;
+
+    if( params->Callbacks != NULL )
+    {
+        LmHandlerCallbacks = *params->Callbacks;
+    }
+    if( LmHandlerCallbacks.GetBatteryLevel == NULL )
+    {
+        LmHandlerCallbacks.GetBatteryLevel = BoardGetBatteryLevel;
+    }
+    if( LmHandlerCallbacks.GetRandomSeed == NULL )
+    {
+        LmHandlerCallbacks.GetRandomSeed = BoardGetRandomSeed;
+    }
+    LmHandlerCallbacks.OnMacProcess = OnMacProcessNotify;
+    LmHandlerCallbacks.OnJoinRequest = OnJoinRequest;
+
+    LmHandlerParams.AdrEnable = params->AdrEnable;
+    LmHandlerParams.DutyCycleEnabled = params->DutyCycleEnabled;
+
+    SimInit( params->Seed, params->Duration );
+    SimChannelInit( params->ChannelParams );
+    SimNetworkInit( params->NetworkParams );
+
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    if( LmHandlerInit( &LmHandlerCallbacks, &LmHandlerParams ) != LORAMAC_HANDLER_SUCCESS )
+    {
+        printf( "LoRaMac wasn't properly initialized\n" );
+        return false;
+    }
+    return true;
+}
+
+void SimTestRun( void )
+{
+    LmHandlerJoin( );
+
+    while( SimIsRunning( ) == true )
+    {
+        LmHandlerProcess( );
+
+        if( IsTickPending == true )
+        {
+            IsTickPending = false;
+            Seconds++;
+            if( SimTestParams->OnTick != NULL )
+            {
+                SimTestParams->OnTick( );
+            }
+        }
+        if( SimTestParams->OnLoop != NULL )
+        {
+            SimTestParams->OnLoop( );
+        }
+
+        CRITICAL_SECTION_BEGIN( );
+        if( IsMacProcessPending == true )
+        {
+            IsMacProcessPending = false;
+        }
+        else if( IsTickPending == false )
+        {
+            BoardLowPowerHandler( );
+        }
+        CRITICAL_SECTION_END( );
+    }
+}
+
+int32_t SimTestGetSeconds( void )
+{
+    return Seconds;
+}
+
+void SimTestSetDatarate( int8_t datarate )
+{
+    MibRequestConfirm_t mibReq;
+
+    LmHandlerParams.TxDatarate = datarate;
+    mibReq.Type = MIB_CHANNELS_DATARATE;
+    mibReq.Param.ChannelsDatarate = datarate;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+}
+
+LmHandlerErrorStatus_t SimTestSend( uint8_t port, uint8_t size )
+{
+    LmHandlerAppData_t appData =
+    {
+        .Buffer = AppDataBuffer,
+        .BufferSize = size,
+        .Port = port,
+    };
+
+    if( LmHandlerIsBusy( ) == true )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+    memset1( AppDataBuffer, ( uint8_t )Seconds, size );
+    return LmHandlerSend( &appData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+}
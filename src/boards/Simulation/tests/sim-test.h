@@ -0,0 +1,132 @@
+/*!
+ * \file      sim-test.h
+ *
+ * \brief     Common fixture of the Simulation board host tests running the
+ *            LmHandler application layer
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The fixture initializes the simulation, the virtual channel, the
+ *            network server stub and an EU868 LmHandler device. It joins and
+ *            runs the application main loop until the end of the simulation.
+ *            Once joined, the OnTick callback is called every second.
+ */
+#ifndef __SIM_TEST_H__
+#define __SIM_TEST_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "LmHandler.h"
+#include "sim-channel.h"
+#include "sim-network.h"
+
+/*!
+ * Test fixture parameters
+ */
+typedef struct sSimTestParams
+{
+    /*!
+     * Simulation random generator seed
+     */
+    uint32_t Seed;
+    /*!
+     * Simulation duration [s]
+     */
+    uint32_t Duration;
+    /*!
+     * Virtual radio channel parameters
+     */
+    const SimChannelParams_t* ChannelParams;
+    /*!
+     * Network server stub parameters
+     */
+    const SimNetworkParams_t* NetworkParams;
+    /*!
+     * Device side ADR
+     */
+    bool AdrEnable;
+    /*!
+     * Duty cycle restrictions
+     */
+    bool DutyCycleEnabled;
+    /*!
+     * Test LmHandler callbacks, may be NULL. OnMacProcess and OnJoinRequest
+     * are owned by the fixture, the battery level and the random seed
+     * default to the board ones.
+     */
+    LmHandlerCallbacks_t* Callbacks;
+    /*!
+     * Function called once the device has joined, may be NULL
+     */
+    void ( *OnJoined )( void );
+    /*!
+     * Function called every second once the device has joined, may be NULL
+     */
+    void ( *OnTick )( void );
+    /*!
+     * Function called on each main loop iteration, may be NULL
+     */
+    void ( *OnLoop )( void );
+}SimTestParams_t;
+
+/*!
+ * \brief Initializes the simulation, the board and the LmHandler
+ *
+ * \param [IN] params Test fixture parameters. Must stay valid while the test runs
+ *
+ * \retval status Returns true if the LmHandler has been initialized
+ */
+bool SimTestInit( const SimTestParams_t* params );
+
+/*!
+ * \brief Joins and runs the main loop until the end of the simulation
+ */
+void SimTestRun( void );
+
+/*!
+ * \brief Gets the seconds elapsed since the join
+ *
+ * \retval seconds Seconds elapsed since the join, -1 before
+ */
+int32_t SimTestGetSeconds( void );
+
+/*!
+ * \brief Sets the uplinks datarate
+ *
+ * \param [IN] datarate Datarate
+ */
+void SimTestSetDatarate( int8_t datarate );
+
+/*!
+ * \brief Sends an unconfirmed uplink filled with the current second, if the
+ *        LmHandler is not busy
+ *
+ * \param [IN] port Application port
+ * \param [IN] size Payload size
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if the uplink has been
+ *                sent else \ref LORAMAC_HANDLER_ERROR
+ */
+LmHandlerErrorStatus_t SimTestSend( uint8_t port, uint8_t size );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_TEST_H__
@@ -0,0 +1,332 @@
+/*!
+ * \file      test-adr-link-trace.c
+ *
+ * \brief     Replay of a link trace with the device side ADR strategy over
+ *            the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The device sends unconfirmed uplinks with ADR to the network
+ *            server stub, which runs its own ADR and sends DevStatusReq. The
+ *            virtual channel replays a link trace: a good link, a 4 hours
+ *            outage during which the ADR back-off lowers the datarate down to
+ *            DR0, then the good link again.
+ *
+ *            With the LoRaMacAdrStrategyLinkMargin strategy the device must
+ *            be back to its datarate before the outage within
+ *            TEST_MAX_RECOVERY_TIME of the link recovery. Run with the
+ *            "baseline" argument the device has no strategy and waits for
+ *            the network ADR.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "LmHandler.h"
+#include "LoRaMacAdr.h"
+#include "sim-test.h"
+
+/*!
+ * Simulation random generator seed
+ */
+#ifndef SIM_SEED
+#define SIM_SEED                                    1
+#endif
+
+/*!
+ * Simulation duration [s]
+ */
+#ifndef SIM_DURATION
+#define SIM_DURATION                                36000
+#endif
+
+/*!
+ * Application port
+ */
+#define APP_PORT                                    2
+
+/*!
+ * Application payload size
+ */
+#define APP_PAYLOAD_SIZE                            20
+
+/*!
+ * Uplinks interval [s]
+ */
+#define APP_TX_INTERVAL                             30
+
+/*!
+ * Maximum time for the device side ADR to restore the datarate after the
+ * link recovery [s]
+ */
+#define TEST_MAX_RECOVERY_TIME                      120
+
+/*!
+ * Link trace step
+ */
+typedef struct sLinkTraceStep
+{
+    /*!
+     * Start of the step [s]
+     */
+    uint32_t Start;
+    /*!
+     * Mean link SNR [dB]
+     */
+    int8_t SnrMean;
+    /*!
+     * Frame loss rate [per mille]
+     */
+    uint16_t LossRate;
+    /*!
+     * Step name
+     */
+    const char* Name;
+}LinkTraceStep_t;
+
+/*!
+ * Link trace, a 4 hours outage. The recovery doesn't coincide with the end
+ * of a network ADR history window
+ */
+static const LinkTraceStep_t LinkTrace[] =
+{
+    { .Start = 0,     .SnrMean = 5, .LossRate = 0,    .Name = "Good link" },
+    { .Start = 7000,  .SnrMean = 5, .LossRate = 1000, .Name = "Outage" },
+    { .Start = 21600, .SnrMean = 5, .LossRate = 0,    .Name = "Recovered link" },
+};
+
+#define LINK_TRACE_NB_STEPS                         ( uint8_t )( sizeof( LinkTrace ) / sizeof( LinkTrace[0] ) )
+
+/*!
+ * Statistics of a link trace step
+ */
+typedef struct sLinkTraceStats
+{
+    /*!
+     * Device transmissions
+     */
+    uint32_t NbTx;
+    /*!
+     * Device transmissions time on air [ms]
+     */
+    uint32_t TxTime;
+    /*!
+     * Uplinks received by the network
+     */
+    uint32_t NbRx;
+    /*!
+     * Uplinks sent at each datarate
+     */
+    uint32_t NbTxDatarate[DR_5 + 1];
+}LinkTraceStats_t;
+
+static LinkTraceStats_t Stats[LINK_TRACE_NB_STEPS];
+
+/*!
+ * Current link trace step
+ */
+static uint8_t TraceStep = 0;
+
+/*!
+ * Datarate at the start of the outage, -1 before
+ */
+static int8_t DatarateBeforeOutage = -1;
+
+/*!
+ * Time from the link recovery to the first uplink at DatarateBeforeOutage,
+ * -1 if not recovered [s]
+ */
+static int32_t RecoveryTime = -1;
+
+/*!
+ * Datarate of the last uplink
+ */
+static int8_t LastDatarate = DR_0;
+
+/*!
+ * Trace step of the device activity accounting
+ */
+static uint8_t StatsStep = 0;
+
+/*!
+ * Device transmissions and time on air at the start of StatsStep
+ */
+static uint32_t StepNbTx = 0;
+static SimTime_t StepTxTime = 0;
+
+static void OnTxData( LmHandlerTxParams_t* params );
+
+static LmHandlerCallbacks_t LmHandlerCallbacks =
+{
+    .OnTxData = OnTxData,
+};
+
+static void OnUplink( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size );
+
+/*!
+ * Virtual radio channel parameters, updated by the link trace
+ */
+static SimChannelParams_t SimChannelParams =
+{
+    .SnrMean = 5,
+    .SnrStdDev = 2,
+    .NoiseFloor = -117,
+    .LossRate = 0,
+    .CaptureMargin = 6,
+    .InterfererInterval = 0,
+};
+
+/*!
+ * Network server stub parameters. The NwkKey is the se-identity.h default one.
+ */
+static const SimNetworkParams_t SimNetworkParams =
+{
+    .NwkKey = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C },
+    .NetId = 0x000013,
+    .DevAddr = 0x26011234,
+    .CfList = NULL,
+    .AdrEnabled = true,
+    .AdrMaxDatarate = DR_5,
+    .AdrChMask = 0x0007,
+    .DevStatusInterval = 10,
+    .GpsTimeOffset = 1300000000,
+    .OnUplink = OnUplink,
+};
+
+/*!
+ * \brief   Applies the link trace step of the current second
+ */
+static void LinkTraceProcess( void )
+{
+    if( ( ( TraceStep + 1 ) < LINK_TRACE_NB_STEPS ) && ( ( uint32_t )SimTestGetSeconds( ) >= LinkTrace[TraceStep + 1].Start ) )
+    {
+        TraceStep++;
+        if( TraceStep == 1 )
+        {
+            DatarateBeforeOutage = LastDatarate;
+        }
+    }
+    SimChannelParams.SnrMean = LinkTrace[TraceStep].SnrMean;
+    SimChannelParams.LossRate = LinkTrace[TraceStep].LossRate;
+}
+
+/*!
+ * \brief   Applies the link trace and sends the periodic uplinks
+ */
+static void ScenarioProcess( void )
+{
+    LinkTraceProcess( );
+    if( ( SimTestGetSeconds( ) % APP_TX_INTERVAL ) == 0 )
+    {
+        SimTestSend( APP_PORT, APP_PAYLOAD_SIZE );
+    }
+}
+
+/*!
+ * \brief   Accounts the device activity of the trace steps
+ */
+static void StatsProcess( void )
+{
+    const SimChannelStats_t* channelStats = SimChannelGetStats( );
+
+    Stats[StatsStep].NbTx = channelStats->NbTx[SIM_CHANNEL_NODE_DEVICE] - StepNbTx;
+    Stats[StatsStep].TxTime = ( uint32_t )( ( channelStats->TxTime[SIM_CHANNEL_NODE_DEVICE] - StepTxTime ) / 1000 );
+    if( StatsStep != TraceStep )
+    {
+        StepNbTx = channelStats->NbTx[SIM_CHANNEL_NODE_DEVICE];
+        StepTxTime = channelStats->TxTime[SIM_CHANNEL_NODE_DEVICE];
+        StatsStep = TraceStep;
+    }
+}
+
+static void OnTxData( LmHandlerTxParams_t* params )
+{
+    if( ( params->IsMcpsConfirm == 0 ) || ( params->Datarate > DR_5 ) )
+    {
+        return;
+    }
+    LastDatarate = params->Datarate;
+    Stats[TraceStep].NbTxDatarate[params->Datarate]++;
+
+    if( ( TraceStep == ( LINK_TRACE_NB_STEPS - 1 ) ) && ( RecoveryTime < 0 ) &&
+        ( params->Datarate >= DatarateBeforeOutage ) )
+    {
+        RecoveryTime = SimTestGetSeconds( ) - LinkTrace[TraceStep].Start;
+    }
+}
+
+static void OnUplink( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size )
+{
+    if( port == APP_PORT )
+    {
+        Stats[TraceStep].NbRx++;
+    }
+}
+
+int main( int argc, char* argv[] )
+{
+    bool isBaseline = ( argc > 1 ) && ( strcmp( argv[1], "baseline" ) == 0 );
+    const SimTestParams_t simTestParams =
+    {
+        .Seed = SIM_SEED,
+        .Duration = SIM_DURATION,
+        .ChannelParams = &SimChannelParams,
+        .NetworkParams = &SimNetworkParams,
+        .AdrEnable = true,
+        .DutyCycleEnabled = true,
+        .Callbacks = &LmHandlerCallbacks,
+        .OnJoined = NULL,
+        .OnTick = ScenarioProcess,
+        .OnLoop = StatsProcess,
+    };
+    bool isPassed;
+
+    if( SimTestInit( &simTestParams ) == false )
+    {
+        return 1;
+    }
+    if( isBaseline == false )
+    {
+        MibRequestConfirm_t mibReq;
+
+        mibReq.Type = MIB_ADR_STRATEGY;
+        mibReq.Param.AdrStrategy = &LoRaMacAdrStrategyLinkMargin;
+        LoRaMacMibSetRequestConfirm( &mibReq );
+    }
+    SimTestRun( );
+    StatsProcess( );
+
+    printf( "\n###### ===== ADR link trace: %u s, seed %u, %s ==== ######\n", SIM_DURATION, SIM_SEED,
+            ( isBaseline == true ) ? "no device strategy" : "link margin strategy" );
+    for( uint8_t i = 0; i < LINK_TRACE_NB_STEPS; i++ )
+    {
+        uint32_t end = ( ( i + 1 ) < LINK_TRACE_NB_STEPS ) ? LinkTrace[i + 1].Start : SIM_DURATION;
+
+        printf( "%-15s: %5lu s, TX %4lu, TX time %7lu ms, received %4lu, DR0-5 uplinks %lu/%lu/%lu/%lu/%lu/%lu\n",
+                LinkTrace[i].Name, ( unsigned long )( end - LinkTrace[i].Start ), ( unsigned long )Stats[i].NbTx,
+                ( unsigned long )Stats[i].TxTime, ( unsigned long )Stats[i].NbRx,
+                ( unsigned long )Stats[i].NbTxDatarate[0], ( unsigned long )Stats[i].NbTxDatarate[1],
+                ( unsigned long )Stats[i].NbTxDatarate[2], ( unsigned long )Stats[i].NbTxDatarate[3],
+                ( unsigned long )Stats[i].NbTxDatarate[4], ( unsigned long )Stats[i].NbTxDatarate[5] );
+    }
+    printf( "Recovery       : DR%d before the outage, restored after %ld s\n", DatarateBeforeOutage, ( long )RecoveryTime );
+
+    // The outage must have lowered the datarate
+    isPassed = ( DatarateBeforeOutage > DR_0 ) && ( Stats[1].NbTxDatarate[DR_0] > 0 ) && ( RecoveryTime >= 0 );
+    if( isBaseline == false )
+    {
+        isPassed &= RecoveryTime <= TEST_MAX_RECOVERY_TIME;
+    }
+    printf( "%s\n", ( isPassed == true ) ? "PASSED" : "FAILED" );
+    return ( isPassed == true ) ? 0 : 1;
+}
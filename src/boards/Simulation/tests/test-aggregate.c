@@ -0,0 +1,269 @@
+/*!
+ * \file      test-aggregate.c
+ *
+ * \brief     Round trip of the LmHandler uplink aggregation over the
+ *            Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The device aggregates records with LmHandlerAggregate. The
+ *            network server stub forwards the decrypted uplinks, which are
+ *            split with LmHandlerAggregateUnpack and compared to the records.
+ *
+ *            The scenario, in seconds after the join:
+ *            - 0: a 100 bytes record is aggregated at DR5.
+ *            - 5: the datarate decreases to DR0 before the record deadline.
+ *              The record must be kept.
+ *            - 60: the datarate increases to DR5, the record is sent.
+ *            - 70: the datarate decreases to DR0. A record larger than the
+ *              DR0 maximum payload must be rejected. Records of 1 to 49
+ *              bytes are then aggregated every 3 seconds.
+ *
+ *            The test passes when every accepted record is received once, in
+ *            order and unchanged.
+ */
+#include <stdio.h>
+#include "utilities.h"
+#include "LmHandler.h"
+#include "sim-test.h"
+
+/*!
+ * Simulation random generator seed
+ */
+#ifndef SIM_SEED
+#define SIM_SEED                                    1
+#endif
+
+/*!
+ * Simulation duration [s]
+ */
+#ifndef SIM_DURATION
+#define SIM_DURATION                                1800
+#endif
+
+/*!
+ * Application port of the aggregated uplinks
+ */
+#define APP_PORT                                    10
+
+/*!
+ * Maximum time a record waits for its uplink [ms]
+ */
+#define APP_RECORD_DEADLINE                         20000
+
+/*!
+ * Number of small records aggregated at DR0
+ */
+#define APP_NB_RECORDS                              150
+
+/*!
+ * Maximum number of records
+ */
+#define APP_MAX_RECORDS                             ( APP_NB_RECORDS + 1 )
+
+/*!
+ * Sizes of the aggregated records
+ */
+static uint8_t RecordSizes[APP_MAX_RECORDS];
+
+/*!
+ * Number of aggregated records
+ */
+static uint16_t NbRecords = 0;
+
+/*!
+ * Number of received records and of mismatches
+ */
+static uint16_t NbRxRecords = 0;
+static uint16_t NbErrors = 0;
+
+/*!
+ * Set when the record larger than the DR0 maximum payload has been rejected
+ */
+static bool IsOversizeRejected = false;
+
+static void OnUplink( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size );
+
+/*!
+ * Virtual radio channel parameters, a lossless link
+ */
+static const SimChannelParams_t SimChannelParams =
+{
+    .SnrMean = 5,
+    .SnrStdDev = 0,
+    .NoiseFloor = -117,
+    .LossRate = 0,
+    .CaptureMargin = 6,
+    .InterfererInterval = 0,
+};
+
+/*!
+ * Network server stub parameters. The NwkKey is the se-identity.h default one.
+ */
+static const SimNetworkParams_t SimNetworkParams =
+{
+    .NwkKey = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C },
+    .NetId = 0x000013,
+    .DevAddr = 0x26011234,
+    .CfList = NULL,
+    .AdrEnabled = false,
+    .DevStatusInterval = 0,
+    .GpsTimeOffset = 1300000000,
+    .OnUplink = OnUplink,
+};
+
+/*!
+ * \brief   Gets a byte of a record
+ *
+ * \param   [IN] record Record index
+ * \param   [IN] index  Byte index
+ */
+static uint8_t GetRecordByte( uint16_t record, uint8_t index )
+{
+    return ( uint8_t )( ( record * 31 ) + index );
+}
+
+/*!
+ * \brief   Aggregates the next record
+ *
+ * \param   [IN] size     Record size
+ * \param   [IN] isUrgent Sends the uplink right away
+ *
+ * \retval  status Aggregation status
+ */
+static LmHandlerErrorStatus_t AggregateRecord( uint8_t size, bool isUrgent )
+{
+    uint8_t buffer[242];
+    LmHandlerAppData_t appData =
+    {
+        .Buffer = buffer,
+        .BufferSize = size,
+        .Port = APP_PORT,
+    };
+    LmHandlerErrorStatus_t status;
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        buffer[i] = GetRecordByte( NbRecords, i );
+    }
+    status = LmHandlerAggregate( &appData, APP_RECORD_DEADLINE, isUrgent );
+    if( ( status == LORAMAC_HANDLER_SUCCESS ) && ( NbRecords < APP_MAX_RECORDS ) )
+    {
+        RecordSizes[NbRecords++] = size;
+    }
+    return status;
+}
+
+/*!
+ * \brief   Runs the scenario step of the current second
+ */
+static void ScenarioProcess( void )
+{
+    int32_t seconds = SimTestGetSeconds( );
+    uint8_t buffer[51] = { 0 };
+    LmHandlerAppData_t appData =
+    {
+        .Buffer = buffer,
+        .BufferSize = sizeof( buffer ),
+        .Port = APP_PORT,
+    };
+
+    switch( seconds )
+    {
+        case 0:
+            SimTestSetDatarate( DR_5 );
+            AggregateRecord( 100, false );
+            break;
+        case 5:
+            SimTestSetDatarate( DR_0 );
+            break;
+        case 60:
+            SimTestSetDatarate( DR_5 );
+            break;
+        case 70:
+            SimTestSetDatarate( DR_0 );
+            // 1 + 51 bytes never fit the 51 bytes payload of DR0
+            IsOversizeRejected = LmHandlerAggregate( &appData, APP_RECORD_DEADLINE, false ) == LORAMAC_HANDLER_ERROR;
+            break;
+        default:
+            break;
+    }
+    if( ( seconds > 70 ) && ( ( seconds % 3 ) == 0 ) && ( NbRecords < APP_MAX_RECORDS ) )
+    {
+        AggregateRecord( 1 + ( ( NbRecords * 7 ) % 49 ), ( NbRecords % 10 ) == 0 );
+    }
+}
+
+static void OnUplink( const uint8_t* devEui, uint8_t port, const uint8_t* buffer, uint8_t size )
+{
+    LmHandlerAppData_t record;
+    uint8_t offset = 0;
+
+    if( port != APP_PORT )
+    {
+        return;
+    }
+    while( LmHandlerAggregateUnpack( ( uint8_t* )buffer, size, &offset, &record ) == true )
+    {
+        bool isEqual = ( NbRxRecords < NbRecords ) && ( record.BufferSize == RecordSizes[NbRxRecords] );
+
+        for( uint8_t i = 0; ( isEqual == true ) && ( i < record.BufferSize ); i++ )
+        {
+            isEqual = record.Buffer[i] == GetRecordByte( NbRxRecords, i );
+        }
+        if( isEqual == false )
+        {
+            printf( "Record %u: unexpected size %u\n", NbRxRecords, record.BufferSize );
+            NbErrors++;
+        }
+        NbRxRecords++;
+    }
+    if( offset != size )
+    {
+        printf( "Malformed uplink of %u bytes\n", size );
+        NbErrors++;
+    }
+}
+
+int main( void )
+{
+    const SimTestParams_t simTestParams =
+    {
+        .Seed = SIM_SEED,
+        .Duration = SIM_DURATION,
+        .ChannelParams = &SimChannelParams,
+        .NetworkParams = &SimNetworkParams,
+        .AdrEnable = false,
+        .DutyCycleEnabled = false,
+        .Callbacks = NULL,
+        .OnJoined = NULL,
+        .OnTick = ScenarioProcess,
+        .OnLoop = NULL,
+    };
+    bool isPassed;
+
+    if( SimTestInit( &simTestParams ) == false )
+    {
+        return 1;
+    }
+    SimTestRun( );
+
+    isPassed = ( IsOversizeRejected == true ) && ( NbRecords == APP_MAX_RECORDS ) &&
+               ( NbRxRecords == NbRecords ) && ( NbErrors == 0 );
+    printf( "\n###### ===== Aggregation: %u s, seed %u ==== ######\n", SIM_DURATION, SIM_SEED );
+    printf( "Records  : aggregated %u, received %u, errors %u, oversize record rejected %s\n", NbRecords,
+            NbRxRecords, NbErrors, ( IsOversizeRejected == true ) ? "yes" : "no" );
+    printf( "%s\n", ( isPassed == true ) ? "PASSED" : "FAILED" );
+    return ( isPassed == true ) ? 0 : 1;
+}
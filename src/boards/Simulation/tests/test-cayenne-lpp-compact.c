@@ -0,0 +1,269 @@
+/*!
+ * \file      test-cayenne-lpp-compact.c
+ *
+ * \brief     Round trip of the compact Cayenne LPP encoder and decoder
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    Random walks of sensor values are encoded in payloads of the
+ *            AS923 dwell time limit and decoded back. The test also checks
+ *            the rejection of the values which do not fit their channel, of
+ *            the invalid schemas and of the truncated payloads.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+#include "CayenneLpp.h"
+#include "CayenneLppCompact.h"
+
+/*!
+ * Number of encoded payloads
+ */
+#define TEST_NB_PAYLOADS                            2000
+
+/*!
+ * Payload size, AS923 DR3 with the dwell time limit
+ */
+#define TEST_PAYLOAD_SIZE                           53
+
+/*!
+ * Channels schema of the test
+ */
+static const CayenneLppCompactChannel_t Schema[] =
+{
+    { .Channel = 0, .Type = LPP_DIGITAL_INPUT, .NbValues = 1, .Bits = 2, .IsDelta = false },
+    { .Channel = 1, .Type = LPP_TEMPERATURE, .NbValues = 1, .Bits = 16, .IsDelta = true },
+    { .Channel = 2, .Type = LPP_ACCELEROMETER, .NbValues = 3, .Bits = 16, .IsDelta = true },
+    { .Channel = 3, .Type = LPP_GPS, .NbValues = 3, .Bits = 24, .IsDelta = true },
+    { .Channel = 4, .Type = LPP_LUMINOSITY, .NbValues = 1, .Bits = 32, .IsDelta = true },
+};
+
+#define SCHEMA_NB_CHANNELS                          ( sizeof( Schema ) / sizeof( Schema[0] ) )
+#define SCHEMA_NB_VALUES                            9
+
+/*!
+ * Cayenne LPP size of a sample of the schema
+ */
+#define SCHEMA_LPP_SIZE                             ( LPP_DIGITAL_INPUT_SIZE + LPP_TEMPERATURE_SIZE + \
+                                                      LPP_ACCELEROMETER_SIZE + LPP_GPS_SIZE + \
+                                                      LPP_LUMINOSITY_SIZE )
+
+static uint16_t NbErrors = 0;
+
+/*!
+ * \brief   Checks a condition and counts the failures
+ */
+static void Check( bool condition, const char* msg )
+{
+    if( condition == false )
+    {
+        printf( "Check failed: %s\n", msg );
+        NbErrors++;
+    }
+}
+
+/*!
+ * \brief   Gets the next value of a random walk
+ *
+ * \param   [IN] value Previous value
+ * \param   [IN] step  Maximum step
+ * \param   [IN] bits  Width of the value
+ */
+static int32_t RandomWalk( int32_t value, int32_t step, uint8_t bits )
+{
+    int32_t max = ( bits < 32 ) ? ( int32_t )( ( 1UL << ( bits - 1 ) ) - 1 ) : INT32_MAX;
+    int64_t next = ( int64_t )value + ( rand( ) % ( 2 * step + 1 ) ) - step;
+
+    // Occasional jumps over the whole range
+    if( ( rand( ) % 50 ) == 0 )
+    {
+        next = ( ( int64_t )rand( ) << 1 ) - RAND_MAX;
+    }
+    if( next > max )
+    {
+        next = max;
+    }
+    if( next < ( -( int64_t )max - 1 ) )
+    {
+        next = -( int64_t )max - 1;
+    }
+    return ( int32_t )next;
+}
+
+/*!
+ * \brief   Gets the next sample of the schema
+ */
+static void GetNextSample( int32_t* values )
+{
+    static const int32_t steps[SCHEMA_NB_VALUES] = { 1, 5, 100, 100, 100, 20, 20, 50, 1000 };
+    uint8_t index = 0;
+
+    for( uint8_t i = 0; i < SCHEMA_NB_CHANNELS; i++ )
+    {
+        for( uint8_t j = 0; j < Schema[i].NbValues; j++, index++ )
+        {
+            values[index] = ( i == 0 ) ? ( rand( ) % 2 ) : RandomWalk( values[index], steps[index], Schema[i].Bits );
+        }
+    }
+}
+
+/*!
+ * \brief   Encodes and decodes the random walks
+ */
+static void TestRoundTrip( void )
+{
+    static int32_t samples[UINT8_MAX][SCHEMA_NB_VALUES];
+    int32_t values[SCHEMA_NB_VALUES] = { 0 };
+    uint8_t buffer[TEST_PAYLOAD_SIZE];
+    uint32_t nbSamples = 0;
+    uint32_t nbBytes = 0;
+    CayenneLppCompact_t encoder;
+    CayenneLppCompact_t decoder;
+
+    Check( CayenneLppCompactInit( &encoder, Schema, SCHEMA_NB_CHANNELS, buffer, sizeof( buffer ) ) == true, "init" );
+    for( uint16_t payload = 0; payload < TEST_NB_PAYLOADS; payload++ )
+    {
+        uint8_t nbPayloadSamples = 0;
+        uint8_t size = 0;
+
+        CayenneLppCompactReset( &encoder );
+        while( nbPayloadSamples < UINT8_MAX )
+        {
+            uint8_t sampleSize;
+
+            GetNextSample( values );
+            sampleSize = CayenneLppCompactAddSample( &encoder, values );
+            if( sampleSize == 0 )
+            {
+                break;
+            }
+            memcpy1( ( uint8_t* )samples[nbPayloadSamples++], ( uint8_t* )values, sizeof( values ) );
+            size = sampleSize;
+        }
+        Check( size == CayenneLppCompactGetSize( &encoder ), "payload size" );
+
+        if( CayenneLppCompactDecodeInit( &decoder, Schema, SCHEMA_NB_CHANNELS, buffer, size ) == false )
+        {
+            Check( false, "decode init" );
+            continue;
+        }
+        for( uint8_t i = 0; i < nbPayloadSamples; i++ )
+        {
+            int32_t decoded[SCHEMA_NB_VALUES];
+
+            if( CayenneLppCompactGetSample( &decoder, decoded ) == false )
+            {
+                Check( false, "missing sample" );
+                break;
+            }
+            Check( memcmp( decoded, samples[i], sizeof( decoded ) ) == 0, "sample values" );
+        }
+        Check( CayenneLppCompactGetSample( &decoder, values ) == false, "extra sample" );
+        nbSamples += nbPayloadSamples;
+        nbBytes += size;
+    }
+    Check( nbSamples > TEST_NB_PAYLOADS, "samples per payload" );
+    printf( "Round trip : %lu samples in %u payloads, %lu.%02lu bytes per sample, Cayenne LPP %u bytes\n",
+            ( unsigned long )nbSamples, TEST_NB_PAYLOADS, ( unsigned long )( nbBytes / nbSamples ),
+            ( unsigned long )( ( nbBytes * 100 / nbSamples ) % 100 ), SCHEMA_LPP_SIZE );
+}
+
+/*!
+ * \brief   Checks the values which do not fit their channel width
+ */
+static void TestOutOfRange( void )
+{
+    int32_t values[SCHEMA_NB_VALUES] = { 1, -400, 1000, -1000, 0, 100, -100, 10, 123456 };
+    int32_t decoded[SCHEMA_NB_VALUES];
+    uint8_t buffer[51];
+    CayenneLppCompact_t ctx;
+    uint8_t size;
+
+    CayenneLppCompactInit( &ctx, Schema, SCHEMA_NB_CHANNELS, buffer, sizeof( buffer ) );
+    size = CayenneLppCompactAddSample( &ctx, values );
+    Check( size != 0, "valid sample" );
+
+    // 2 does not fit the 2 bits signed digital input
+    values[0] = 2;
+    Check( CayenneLppCompactAddSample( &ctx, values ) == 0, "out of range rejected" );
+    Check( CayenneLppCompactGetSize( &ctx ) == size, "rejected sample dropped" );
+
+    // The previous values are restored after a rejected sample
+    values[0] = -2;
+    values[1] = -390;
+    Check( CayenneLppCompactAddSample( &ctx, values ) != 0, "sample after rejection" );
+
+    CayenneLppCompactDecodeInit( &ctx, Schema, SCHEMA_NB_CHANNELS, buffer, CayenneLppCompactGetSize( &ctx ) );
+    Check( CayenneLppCompactGetSample( &ctx, decoded ) == true, "first sample" );
+    Check( CayenneLppCompactGetSample( &ctx, decoded ) == true, "second sample" );
+    Check( memcmp( decoded, values, sizeof( values ) ) == 0, "values after rejection" );
+}
+
+/*!
+ * \brief   Checks the invalid schemas and the truncated payloads
+ */
+static void TestMalformed( void )
+{
+    static const CayenneLppCompactChannel_t noBits[] =
+    {
+        { .Channel = 0, .Type = LPP_TEMPERATURE, .NbValues = 1, .Bits = 0, .IsDelta = false },
+    };
+    static const CayenneLppCompactChannel_t tooWide[] =
+    {
+        { .Channel = 0, .Type = LPP_TEMPERATURE, .NbValues = 1, .Bits = 33, .IsDelta = false },
+    };
+    static const CayenneLppCompactChannel_t tooManyValues[] =
+    {
+        { .Channel = 0, .Type = LPP_GPS, .NbValues = CAYENNE_LPP_COMPACT_MAX_VALUES, .Bits = 24, .IsDelta = true },
+        { .Channel = 1, .Type = LPP_TEMPERATURE, .NbValues = 1, .Bits = 16, .IsDelta = true },
+    };
+    int32_t values[SCHEMA_NB_VALUES] = { 0 };
+    uint8_t buffer[51];
+    uint8_t nbSamples = 0;
+    CayenneLppCompact_t ctx;
+    uint8_t size;
+
+    Check( CayenneLppCompactInit( &ctx, noBits, 1, buffer, sizeof( buffer ) ) == false, "0 bits schema" );
+    Check( CayenneLppCompactInit( &ctx, tooWide, 1, buffer, sizeof( buffer ) ) == false, "33 bits schema" );
+    Check( CayenneLppCompactInit( &ctx, tooManyValues, 2, buffer, sizeof( buffer ) ) == false, "values schema" );
+    Check( CayenneLppCompactInit( &ctx, Schema, SCHEMA_NB_CHANNELS, buffer, 0 ) == false, "empty buffer" );
+
+    CayenneLppCompactInit( &ctx, Schema, SCHEMA_NB_CHANNELS, buffer, sizeof( buffer ) );
+    while( CayenneLppCompactAddSample( &ctx, values ) != 0 )
+    {
+        GetNextSample( values );
+    }
+    size = CayenneLppCompactGetSize( &ctx );
+
+    // The decoder stops at the end of a truncated payload
+    CayenneLppCompactDecodeInit( &ctx, Schema, SCHEMA_NB_CHANNELS, buffer, size / 2 );
+    while( CayenneLppCompactGetSample( &ctx, values ) == true )
+    {
+        nbSamples++;
+    }
+    Check( ( nbSamples > 0 ) && ( nbSamples < buffer[0] ), "truncated payload" );
+}
+
+int main( void )
+{
+    srand( 1 );
+
+    TestRoundTrip( );
+    TestOutOfRange( );
+    TestMalformed( );
+
+    printf( "%s\n", ( NbErrors == 0 ) ? "PASSED" : "FAILED" );
+    return ( NbErrors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+/*!
+ * \file      test-classb-beacon.c
+ *
+ * \brief     Class B beacon tracking with an injected clock drift and beacon
+ *            losses over the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The device joins, switches to Class B and sends an unconfirmed
+ *            uplink every APP_TX_INTERVAL. The network server stub transmits
+ *            the beacons on a time drifting from the device clock and skips
+ *            some of them at random. The arguments are the drift [ppm], the
+ *            beacon loss rate [per mille] and the maximum RX-on time per hour
+ *            [ms], by default 0, 0 and TEST_MAX_RX_TIME.
+ *
+ *            The test prints the device RX-on time of each hour and passes
+ *            when the device is in Class B at the end, received the
+ *            transmitted beacons and kept its mean RX-on time per hour in
+ *            Class B below the maximum.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "utilities.h"
+#include "LmHandler.h"
+#include "sim.h"
+#include "sim-test.h"
+
+/*!
+ * Simulation random generator seed
+ */
+#ifndef SIM_SEED
+#define SIM_SEED                                    1
+#endif
+
+/*!
+ * Simulation duration [s]
+ */
+#ifndef SIM_DURATION
+#define SIM_DURATION                                ( 6 * 3600 )
+#endif
+
+/*!
+ * Application port
+ */
+#define APP_PORT                                    2
+
+/*!
+ * Application payload size
+ */
+#define APP_PAYLOAD_SIZE                            10
+
+/*!
+ * Uplinks interval [s]
+ */
+#define APP_TX_INTERVAL                             600
+
+/*!
+ * Default maximum mean device RX-on time per hour in Class B [ms]
+ */
+#define TEST_MAX_RX_TIME                            10000
+
+/*!
+ * Maximum number of transmitted beacons missed in Class B
+ */
+#define TEST_MAX_MISSED_BEACONS                     2
+
+/*!
+ * Number of simulated hours
+ */
+#define NB_HOURS                                    ( ( SIM_DURATION + 3599 ) / 3600 )
+
+/*!
+ * Device RX-on time of each hour [us]
+ */
+static SimTime_t RxTime[NB_HOURS];
+
+/*!
+ * Set for the hours spent in Class B from their start
+ */
+static bool IsClassBHour[NB_HOURS];
+
+/*!
+ * Beacon status counters
+ */
+static uint32_t NbBeaconsRx = 0;
+static uint32_t NbBeaconsNotRx = 0;
+static uint32_t NbBeaconsLost = 0;
+
+/*!
+ * Beacons transmitted while the device was in Class B
+ */
+static uint32_t NbBeaconsClassB = 0;
+
+/*!
+ * Time of the first switch to Class B, -1 before [s]
+ */
+static int32_t ClassBTime = -1;
+
+/*!
+ * Current device class
+ */
+static DeviceClass_t DeviceClass = CLASS_A;
+
+/*!
+ * Beacons transmitted by the network at the last check
+ */
+static uint32_t NbBeacons = 0;
+
+/*!
+ * Device RX-on time at the start of the current hour [us]
+ */
+static SimTime_t HourRxTime = 0;
+
+/*!
+ * Current hour
+ */
+static uint16_t Hour = 0;
+
+static void OnClassChange( DeviceClass_t deviceClass );
+static void OnBeaconStatusChange( LoRaMacHandlerBeaconParams_t* params );
+
+static LmHandlerCallbacks_t LmHandlerCallbacks =
+{
+    .OnClassChange = OnClassChange,
+    .OnBeaconStatusChange = OnBeaconStatusChange,
+};
+
+/*!
+ * Virtual radio channel parameters
+ */
+static const SimChannelParams_t SimChannelParams =
+{
+    .SnrMean = 5,
+    .SnrStdDev = 2,
+    .NoiseFloor = -117,
+    .LossRate = 0,
+    .CaptureMargin = 6,
+    .InterfererInterval = 0,
+};
+
+/*!
+ * Network server stub parameters. The NwkKey is the se-identity.h default
+ * one. The drift and the beacon loss rate are set from the arguments.
+ */
+static SimNetworkParams_t SimNetworkParams =
+{
+    .NwkKey = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C },
+    .NetId = 0x000013,
+    .DevAddr = 0x26011234,
+    .CfList = NULL,
+    .AdrEnabled = true,
+    .AdrMaxDatarate = DR_5,
+    .AdrChMask = 0x0007,
+    .DevStatusInterval = 0,
+    .GpsTimeOffset = 1300000000,
+    .ClockDrift = 0,
+    .BeaconEnabled = true,
+    .BeaconLossRate = 0,
+    .OnUplink = NULL,
+};
+
+/*!
+ * \brief   Sends the periodic uplinks
+ */
+static void UplinkProcess( void )
+{
+    if( ( SimTestGetSeconds( ) % APP_TX_INTERVAL ) == 0 )
+    {
+        SimTestSend( APP_PORT, APP_PAYLOAD_SIZE );
+    }
+}
+
+/*!
+ * \brief   Accounts the beacons transmitted in Class B and the device RX-on
+ *          time of each hour
+ */
+static void StatsProcess( void )
+{
+    const SimChannelStats_t* channelStats = SimChannelGetStats( );
+    const SimNetworkStats_t* networkStats = SimNetworkGetStats( );
+
+    // Beacons transmitted in Class B
+    if( networkStats->NbBeacons != NbBeacons )
+    {
+        if( DeviceClass == CLASS_B )
+        {
+            NbBeaconsClassB += networkStats->NbBeacons - NbBeacons;
+        }
+        NbBeacons = networkStats->NbBeacons;
+    }
+
+    // Device RX-on time of the hour
+    if( ( SimGetTime( ) / 3600000000 ) > Hour )
+    {
+        RxTime[Hour] = channelStats->RxTime[SIM_CHANNEL_NODE_DEVICE] - HourRxTime;
+        HourRxTime = channelStats->RxTime[SIM_CHANNEL_NODE_DEVICE];
+        if( ++Hour < NB_HOURS )
+        {
+            IsClassBHour[Hour] = DeviceClass == CLASS_B;
+        }
+    }
+}
+
+static void OnJoined( void )
+{
+    LmHandlerRequestClass( CLASS_B );
+}
+
+static void OnClassChange( DeviceClass_t deviceClass )
+{
+    DeviceClass = deviceClass;
+    if( ( deviceClass == CLASS_B ) && ( ClassBTime < 0 ) )
+    {
+        ClassBTime = MAX( SimTestGetSeconds( ), 0 );
+    }
+}
+
+static void OnBeaconStatusChange( LoRaMacHandlerBeaconParams_t* params )
+{
+    switch( params->State )
+    {
+        case LORAMAC_HANDLER_BEACON_RX:
+            NbBeaconsRx++;
+            break;
+        case LORAMAC_HANDLER_BEACON_NRX:
+            NbBeaconsNotRx++;
+            break;
+        case LORAMAC_HANDLER_BEACON_LOST:
+            NbBeaconsLost++;
+            // Back to Class B as soon as a beacon is acquired again
+            LmHandlerRequestClass( CLASS_B );
+            break;
+        default:
+            break;
+    }
+}
+
+int main( int argc, char* argv[] )
+{
+    const SimChannelStats_t* channelStats = SimChannelGetStats( );
+    const SimNetworkStats_t* networkStats = SimNetworkGetStats( );
+    const SimTestParams_t simTestParams =
+    {
+        .Seed = SIM_SEED,
+        .Duration = SIM_DURATION,
+        .ChannelParams = &SimChannelParams,
+        .NetworkParams = &SimNetworkParams,
+        .AdrEnable = true,
+        .DutyCycleEnabled = true,
+        .Callbacks = &LmHandlerCallbacks,
+        .OnJoined = OnJoined,
+        .OnTick = UplinkProcess,
+        .OnLoop = StatsProcess,
+    };
+    SimTime_t classBRxTime = 0;
+    uint16_t nbClassBHours = 0;
+    uint32_t maxRxTime = TEST_MAX_RX_TIME;
+    bool isPassed;
+
+    if( argc > 1 )
+    {
+        SimNetworkParams.ClockDrift = ( int16_t )atoi( argv[1] );
+    }
+    if( argc > 2 )
+    {
+        SimNetworkParams.BeaconLossRate = ( uint16_t )atoi( argv[2] );
+    }
+    if( argc > 3 )
+    {
+        maxRxTime = ( uint32_t )atoi( argv[3] );
+    }
+
+    if( SimTestInit( &simTestParams ) == false )
+    {
+        return 1;
+    }
+    SimTestRun( );
+
+    if( Hour < NB_HOURS )
+    {
+        RxTime[Hour] = channelStats->RxTime[SIM_CHANNEL_NODE_DEVICE] - HourRxTime;
+    }
+
+    printf( "\n###### ===== Class B beacons: %u s, seed %u, drift %d ppm, beacon loss %u/1000 ==== ######\n",
+            SIM_DURATION, SIM_SEED, SimNetworkParams.ClockDrift, SimNetworkParams.BeaconLossRate );
+    for( uint16_t i = 0; i < NB_HOURS; i++ )
+    {
+        printf( "Hour %2u        : RX-on %6lu ms%s\n", i, ( unsigned long )( RxTime[i] / 1000 ),
+                ( IsClassBHour[i] == true ) ? ", class B" : "" );
+        // The last hour is usually incomplete
+        if( ( IsClassBHour[i] == true ) && ( ( i + 1 ) < NB_HOURS ) )
+        {
+            classBRxTime += RxTime[i];
+            nbClassBHours++;
+        }
+    }
+    printf( "Class B        : from %ld s, RX-on %lu ms per hour\n", ( long )ClassBTime,
+            ( unsigned long )( ( nbClassBHours != 0 ) ? ( classBRxTime / nbClassBHours / 1000 ) : 0 ) );
+    printf( "Beacons        : transmitted %lu, in class B %lu, received %lu, missed %lu, lost %lu\n",
+            ( unsigned long )networkStats->NbBeacons, ( unsigned long )NbBeaconsClassB, ( unsigned long )NbBeaconsRx,
+            ( unsigned long )NbBeaconsNotRx, ( unsigned long )NbBeaconsLost );
+
+    isPassed = ( DeviceClass == CLASS_B ) && ( nbClassBHours != 0 ) &&
+               ( ( NbBeaconsRx + TEST_MAX_MISSED_BEACONS ) >= NbBeaconsClassB ) &&
+               ( ( classBRxTime / nbClassBHours ) <= ( ( SimTime_t )maxRxTime * 1000 ) );
+    printf( "%s\n", ( isPassed == true ) ? "PASSED" : "FAILED" );
+    return ( isPassed == true ) ? 0 : 1;
+}
@@ -0,0 +1,606 @@
+/*!
+ * \file      test-flash-log.c
+ *
+ * \brief     Power cuts and write amplification of the record based flash
+ *            EEPROM emulation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The flash log runs over a simulated NOR flash, for the program
+ *            units 1, 2, 4 and 8. The simulated flash checks the alignment
+ *            and the bounds of every access and that only erased program
+ *            units are programmed.
+ *
+ *            Power cuts stop the flash operations at a random program unit
+ *            or erase page, which is left partially programmed or erased.
+ *            After each power cut the log is initialized again, possibly with
+ *            another power cut, and the EEPROM content must hold either the
+ *            data before or after the interrupted write.
+ *
+ *            The benchmark stores the LoRaMac NVM groups as NvmDataMgmtStore
+ *            does and reports the flash bytes programmed per EEPROM byte
+ *            written and the bank erasures.
+ *
+ *            The migration cuts the power at each step of the import of a
+ *            previous EEPROM emulation. The index overflow test writes more
+ *            overlapping ranges than the RAM index holds.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "utilities.h"
+#include "flash-log.h"
+#include "LoRaMac.h"
+
+/*!
+ * Simulated flash size, both banks
+ */
+#define SIM_FLASH_SIZE                              ( 2 * 16384 )
+
+/*!
+ * Number of power cuts per program unit
+ */
+#define TEST_NB_POWER_CUTS                          2000
+
+/*!
+ * Number of simulated uplinks of the benchmark
+ */
+#define TEST_NB_UPLINKS                             20000
+
+/*!
+ * Maximum EEPROM size used by the tests
+ */
+#define TEST_EEPROM_SIZE                            sizeof( LoRaMacNvmData_t )
+
+/*!
+ * Size of the previous EEPROM emulation
+ */
+#define TEST_LEGACY_SIZE                            512
+
+/*!
+ * Number of random writes of the index overflow test
+ */
+#define TEST_NB_RANGES_WRITES                       3000
+
+/*!
+ * Location of a group of the emulated EEPROM
+ */
+typedef struct TestGroup_s
+{
+    uint16_t Addr;
+    uint16_t Size;
+}TestGroup_t;
+
+/*!
+ * Simulated flash
+ */
+static uint8_t SimFlash[SIM_FLASH_SIZE];
+
+/*!
+ * Simulated flash erase page size
+ */
+static uint32_t SimPageSize;
+
+/*!
+ * Number of program units or erase pages processed before the power cut,
+ * -1 if no power cut is scheduled
+ */
+static int32_t SimPowerCutCountdown = -1;
+
+/*!
+ * Set once the power is cut, the flash operations then fail
+ */
+static bool SimIsPowerCut = false;
+
+/*!
+ * Flash statistics
+ */
+static uint32_t SimBytesProgrammed = 0;
+static uint32_t SimViolations = 0;
+
+/*!
+ * Simulated previous EEPROM emulation
+ */
+static uint8_t SimLegacy[TEST_LEGACY_SIZE];
+
+/*!
+ * Set while the previous EEPROM emulation holds some content
+ */
+static bool SimIsLegacyPresent = false;
+
+static LmnStatus_t SimFlashRead( uint32_t offset, uint8_t *buffer, uint16_t size );
+static LmnStatus_t SimFlashProgram( uint32_t offset, uint8_t *buffer, uint16_t size );
+static LmnStatus_t SimFlashEraseBank( uint32_t offset );
+static LmnStatus_t SimLegacyRead( uint16_t addr, uint8_t *buffer, uint16_t size );
+static LmnStatus_t SimLegacyErase( void );
+
+static FlashLogDriver_t SimFlashDriver =
+{
+    .Read = SimFlashRead,
+    .Program = SimFlashProgram,
+    .EraseBank = SimFlashEraseBank,
+    .LegacySize = TEST_LEGACY_SIZE,
+    .ReadLegacy = SimLegacyRead,
+    .EraseLegacy = SimLegacyErase,
+};
+
+/*!
+ * Reference content of the emulated EEPROM
+ */
+static uint8_t Eeprom[TEST_EEPROM_SIZE];
+
+static uint16_t NbErrors = 0;
+
+/*!
+ * \brief   Checks a condition and counts the failures
+ */
+static void Check( bool condition, const char* msg )
+{
+    if( condition == false )
+    {
+        if( NbErrors < 10 )
+        {
+            printf( "Check failed: %s\n", msg );
+        }
+        NbErrors++;
+    }
+}
+
+/*!
+ * \brief   Records a flash usage violation of the log
+ */
+static void Violation( const char* msg, uint32_t offset, uint16_t size )
+{
+    if( SimViolations < 10 )
+    {
+        printf( "Flash violation: %s, offset %lu, size %u\n", msg, ( unsigned long )offset, size );
+    }
+    SimViolations++;
+}
+
+/*!
+ * \brief   Counts a flash operation step
+ *
+ * \retval  isPowerCut Returns true if the power is cut during this step
+ */
+static bool SimFlashStep( void )
+{
+    if( SimPowerCutCountdown < 0 )
+    {
+        return false;
+    }
+    if( SimPowerCutCountdown-- == 0 )
+    {
+        SimIsPowerCut = true;
+        return true;
+    }
+    return false;
+}
+
+static LmnStatus_t SimFlashRead( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    if( ( offset + size ) > ( 2 * SimFlashDriver.BankSize ) )
+    {
+        Violation( "read out of the log area", offset, size );
+        return LMN_STATUS_ERROR;
+    }
+    if( SimIsPowerCut == true )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memcpy( buffer, &SimFlash[offset], size );
+    return LMN_STATUS_OK;
+}
+
+static LmnStatus_t SimFlashProgram( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    uint8_t unit = SimFlashDriver.ProgramUnit;
+
+    if( ( ( offset % unit ) != 0 ) || ( ( size % unit ) != 0 ) )
+    {
+        Violation( "unaligned program", offset, size );
+        return LMN_STATUS_ERROR;
+    }
+    if( ( offset + size ) > ( 2 * SimFlashDriver.BankSize ) )
+    {
+        Violation( "program out of the log area", offset, size );
+        return LMN_STATUS_ERROR;
+    }
+    if( SimIsPowerCut == true )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    for( uint16_t i = 0; i < size; i += unit )
+    {
+        for( uint8_t j = 0; j < unit; j++ )
+        {
+            if( SimFlash[offset + i + j] != 0xFF )
+            {
+                Violation( "program of a non erased unit", offset + i, unit );
+                break;
+            }
+        }
+        if( SimFlashStep( ) == true )
+        {
+            // The unit is left partially programmed
+            for( uint8_t j = 0; j < unit; j++ )
+            {
+                SimFlash[offset + i + j] &= buffer[i + j] | ( uint8_t )rand( );
+            }
+            return LMN_STATUS_ERROR;
+        }
+        for( uint8_t j = 0; j < unit; j++ )
+        {
+            SimFlash[offset + i + j] &= buffer[i + j];
+        }
+        SimBytesProgrammed += unit;
+    }
+    return LMN_STATUS_OK;
+}
+
+static LmnStatus_t SimFlashEraseBank( uint32_t offset )
+{
+    if( ( ( offset % SimFlashDriver.BankSize ) != 0 ) || ( offset >= ( 2 * SimFlashDriver.BankSize ) ) )
+    {
+        Violation( "erase of an invalid bank", offset, 0 );
+        return LMN_STATUS_ERROR;
+    }
+    if( SimIsPowerCut == true )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    for( uint32_t page = offset; page < ( offset + SimFlashDriver.BankSize ); page += SimPageSize )
+    {
+        if( SimFlashStep( ) == true )
+        {
+            // The page holds garbage
+            for( uint32_t i = 0; i < SimPageSize; i++ )
+            {
+                SimFlash[page + i] = ( ( rand( ) % 2 ) == 0 ) ? 0xFF : ( uint8_t )rand( );
+            }
+            return LMN_STATUS_ERROR;
+        }
+        memset( &SimFlash[page], 0xFF, SimPageSize );
+    }
+    return LMN_STATUS_OK;
+}
+
+static LmnStatus_t SimLegacyRead( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    if( ( addr + size ) > TEST_LEGACY_SIZE )
+    {
+        Violation( "read out of the previous EEPROM emulation", addr, size );
+        return LMN_STATUS_ERROR;
+    }
+    if( ( SimIsPowerCut == true ) || ( SimIsLegacyPresent == false ) )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memcpy( buffer, &SimLegacy[addr], size );
+    return LMN_STATUS_OK;
+}
+
+static LmnStatus_t SimLegacyErase( void )
+{
+    if( SimIsPowerCut == true )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    if( SimFlashStep( ) == true )
+    {
+        // The previous EEPROM emulation holds garbage
+        for( uint16_t i = 0; i < TEST_LEGACY_SIZE; i++ )
+        {
+            SimLegacy[i] = ( ( rand( ) % 2 ) == 0 ) ? 0xFF : ( uint8_t )rand( );
+        }
+        return LMN_STATUS_ERROR;
+    }
+    memset( SimLegacy, 0xFF, sizeof( SimLegacy ) );
+    SimIsLegacyPresent = false;
+    return LMN_STATUS_OK;
+}
+
+/*!
+ * \brief   Sets up a blank simulated flash
+ */
+static void SimFlashInit( uint32_t bankSize, uint32_t pageSize, uint8_t programUnit )
+{
+    SimFlashDriver.BankSize = bankSize;
+    SimFlashDriver.ProgramUnit = programUnit;
+    SimPageSize = pageSize;
+    SimPowerCutCountdown = -1;
+    SimIsPowerCut = false;
+    SimBytesProgrammed = 0;
+    SimIsLegacyPresent = false;
+    memset( SimFlash, 0xFF, sizeof( SimFlash ) );
+    memset( Eeprom, 0xFF, sizeof( Eeprom ) );
+}
+
+/*!
+ * \brief   Checks the whole EEPROM content against the reference
+ */
+static void CheckEeprom( uint16_t size, const char* msg )
+{
+    static uint8_t buffer[TEST_EEPROM_SIZE];
+
+    Check( FlashLogRead( 0, buffer, size ) == LMN_STATUS_OK, msg );
+    Check( memcmp( buffer, Eeprom, size ) == 0, msg );
+}
+
+/*!
+ * \brief   Changes a few bytes of a group, or all of them
+ */
+static void ChangeGroup( const TestGroup_t* group, uint8_t* data )
+{
+    memcpy( data, &Eeprom[group->Addr], group->Size );
+    if( ( rand( ) % 8 ) == 0 )
+    {
+        for( uint16_t i = 0; i < group->Size; i++ )
+        {
+            data[i] = ( uint8_t )rand( );
+        }
+        return;
+    }
+    for( uint8_t i = 1 + ( rand( ) % 4 ); i > 0; i-- )
+    {
+        data[rand( ) % group->Size] = ( uint8_t )rand( );
+    }
+}
+
+/*!
+ * \brief   Cuts the power at random steps of the writes and of the
+ *          initializations
+ */
+static void TestPowerCuts( uint8_t programUnit )
+{
+    static const TestGroup_t groups[] =
+    {
+        { .Addr = 0, .Size = 24 },
+        { .Addr = 24, .Size = 61 },
+        { .Addr = 85, .Size = 203 },
+        { .Addr = 288, .Size = 37 },
+        { .Addr = 325, .Size = 150 },
+        { .Addr = 475, .Size = 37 },
+    };
+    static uint8_t data[TEST_EEPROM_SIZE];
+    static uint8_t previous[TEST_EEPROM_SIZE];
+    const uint16_t eepromSize = 512;
+    uint32_t nbOld = 0;
+    uint32_t nbNew = 0;
+    uint32_t nbInitCuts = 0;
+
+    SimFlashInit( 2048, 512, programUnit );
+    Check( FlashLogInit( &SimFlashDriver ) == LMN_STATUS_OK, "format" );
+
+    for( uint32_t cut = 0; cut < TEST_NB_POWER_CUTS; cut++ )
+    {
+        const TestGroup_t* group = NULL;
+        LmnStatus_t status;
+
+        SimPowerCutCountdown = rand( ) % 1500;
+        while( SimIsPowerCut == false )
+        {
+            group = &groups[rand( ) % ( sizeof( groups ) / sizeof( groups[0] ) )];
+            ChangeGroup( group, data );
+            memcpy( previous, &Eeprom[group->Addr], group->Size );
+            status = FlashLogWrite( group->Addr, data, group->Size );
+            if( SimIsPowerCut == false )
+            {
+                Check( status == LMN_STATUS_OK, "write" );
+                memcpy( &Eeprom[group->Addr], data, group->Size );
+            }
+        }
+
+        // Restart, the initialization may be cut as well
+        do
+        {
+            SimIsPowerCut = false;
+            SimPowerCutCountdown = ( ( rand( ) % 4 ) == 0 ) ? ( rand( ) % 100 ) : -1;
+            status = FlashLogInit( &SimFlashDriver );
+            nbInitCuts += ( SimIsPowerCut == true ) ? 1 : 0;
+        } while( SimIsPowerCut == true );
+        SimPowerCutCountdown = -1;
+        Check( status == LMN_STATUS_OK, "init after a power cut" );
+
+        // The interrupted write is either fully done or not done
+        FlashLogRead( group->Addr, &Eeprom[group->Addr], group->Size );
+        if( memcmp( &Eeprom[group->Addr], data, group->Size ) == 0 )
+        {
+            nbNew++;
+        }
+        else
+        {
+            Check( memcmp( &Eeprom[group->Addr], previous, group->Size ) == 0, "interrupted write" );
+            nbOld++;
+        }
+        CheckEeprom( eepromSize, "content after a power cut" );
+    }
+    printf( "Power cuts : unit %u, %u cuts ( %lu during the initialization ), interrupted writes old %lu new %lu\n",
+            programUnit, TEST_NB_POWER_CUTS, ( unsigned long )nbInitCuts, ( unsigned long )nbOld,
+            ( unsigned long )nbNew );
+}
+
+/*!
+ * \brief   Stores the LoRaMac NVM groups as NvmDataMgmtStore does and
+ *          measures the flash usage
+ */
+static void TestWriteAmplification( uint8_t programUnit )
+{
+    static const TestGroup_t groups[] =
+    {
+        { offsetof( LoRaMacNvmData_t, Crypto ), sizeof( LoRaMacCryptoNvmData_t ) },
+        { offsetof( LoRaMacNvmData_t, MacGroup1 ), sizeof( LoRaMacNvmDataGroup1_t ) },
+        { offsetof( LoRaMacNvmData_t, MacGroup2 ), sizeof( LoRaMacNvmDataGroup2_t ) },
+        { offsetof( LoRaMacNvmData_t, SecureElement ), sizeof( SecureElementNvmData_t ) },
+        { offsetof( LoRaMacNvmData_t, RegionGroup1 ), sizeof( RegionNvmDataGroup1_t ) },
+        { offsetof( LoRaMacNvmData_t, RegionGroup2 ), sizeof( RegionNvmDataGroup2_t ) },
+        { offsetof( LoRaMacNvmData_t, ClassB ), sizeof( LoRaMacClassBNvmData_t ) },
+    };
+    static uint8_t data[TEST_EEPROM_SIZE];
+    uint32_t bytesWritten = 0;
+    uint32_t formatErasures;
+
+    // NucleoL476 layout
+    SimFlashInit( 16384, 2048, programUnit );
+    Check( FlashLogInit( &SimFlashDriver ) == LMN_STATUS_OK, "format" );
+    formatErasures = FlashLogGetEraseCount( );
+
+    // Initial storage of all the groups after the join
+    for( uint8_t i = 0; i < ( sizeof( groups ) / sizeof( groups[0] ) ); i++ )
+    {
+        ChangeGroup( &groups[i], data );
+        Check( FlashLogWrite( groups[i].Addr, data, groups[i].Size ) == LMN_STATUS_OK, "write" );
+        memcpy( &Eeprom[groups[i].Addr], data, groups[i].Size );
+        bytesWritten += groups[i].Size;
+    }
+
+    for( uint32_t uplink = 0; uplink < TEST_NB_UPLINKS; uplink++ )
+    {
+        // Frame counters and MAC timings change on every uplink, the MAC
+        // parameters on a few of them
+        uint8_t nbGroups = ( ( uplink % 50 ) == 0 ) ? 3 : 2;
+
+        for( uint8_t i = 0; i < nbGroups; i++ )
+        {
+            const TestGroup_t* group = &groups[( i < 2 ) ? i : 2];
+
+            ChangeGroup( group, data );
+            Check( FlashLogWrite( group->Addr, data, group->Size ) == LMN_STATUS_OK, "write" );
+            memcpy( &Eeprom[group->Addr], data, group->Size );
+            bytesWritten += group->Size;
+        }
+    }
+    CheckEeprom( TEST_EEPROM_SIZE, "content after the benchmark" );
+
+    printf( "Benchmark  : unit %u, %lu bytes programmed per 100 bytes written, %lu bank erasures per 1000 uplinks\n",
+            programUnit, ( unsigned long )( ( uint64_t )SimBytesProgrammed * 100 / bytesWritten ),
+            ( unsigned long )( ( FlashLogGetEraseCount( ) - formatErasures ) * 1000 / TEST_NB_UPLINKS ) );
+    // One 8 bytes element per EEPROM byte with the previous emulation
+    Check( ( SimBytesProgrammed / bytesWritten ) < 8, "write amplification" );
+}
+
+/*!
+ * \brief   Imports a previous EEPROM emulation with a power cut at each step
+ *          of the initialization
+ */
+static void TestMigration( uint8_t programUnit )
+{
+    static uint8_t legacy[TEST_LEGACY_SIZE];
+    uint32_t nbSteps = 0;
+    bool isPowerCut = true;
+
+    // Some blank chunks are not imported
+    for( uint16_t i = 0; i < TEST_LEGACY_SIZE; i++ )
+    {
+        legacy[i] = ( ( i >= 128 ) && ( i < 256 ) ) ? 0xFF : ( uint8_t )rand( );
+    }
+
+    for( int32_t cut = 0; isPowerCut == true; cut++ )
+    {
+        LmnStatus_t status;
+
+        SimFlashInit( 2048, 512, programUnit );
+        memcpy( SimLegacy, legacy, sizeof( legacy ) );
+        memcpy( Eeprom, legacy, sizeof( legacy ) );
+        SimIsLegacyPresent = true;
+
+        SimPowerCutCountdown = cut;
+        FlashLogInit( &SimFlashDriver );
+        isPowerCut = SimIsPowerCut;
+
+        // Restart, the initialization may be cut as well
+        do
+        {
+            SimIsPowerCut = false;
+            SimPowerCutCountdown = ( ( rand( ) % 4 ) == 0 ) ? ( rand( ) % 100 ) : -1;
+            status = FlashLogInit( &SimFlashDriver );
+        } while( SimIsPowerCut == true );
+        SimPowerCutCountdown = -1;
+        Check( status == LMN_STATUS_OK, "init after a migration power cut" );
+        CheckEeprom( TEST_LEGACY_SIZE, "content after the migration" );
+
+        // The content is imported once
+        Check( FlashLogInit( &SimFlashDriver ) == LMN_STATUS_OK, "init after the migration" );
+        Check( FlashLogGetEraseCount( ) == 0, "single migration" );
+        CheckEeprom( TEST_LEGACY_SIZE, "content after the migration" );
+        nbSteps++;
+    }
+    Check( SimIsLegacyPresent == false, "erasure of the previous EEPROM emulation" );
+
+    // The imported records are kept by the compactions
+    for( uint16_t i = 0; i < 200; i++ )
+    {
+        uint16_t addr = ( rand( ) % ( TEST_LEGACY_SIZE / 32 ) ) * 32;
+
+        Eeprom[addr + ( rand( ) % 32 )] = ( uint8_t )rand( );
+        Check( FlashLogWrite( addr, &Eeprom[addr], 32 ) == LMN_STATUS_OK, "write after the migration" );
+    }
+    Check( FlashLogGetEraseCount( ) > 0, "compaction after the migration" );
+    CheckEeprom( TEST_LEGACY_SIZE, "content after the migration" );
+
+    printf( "Migration  : unit %u, %lu steps\n", programUnit, ( unsigned long )nbSteps );
+}
+
+/*!
+ * \brief   Writes more overlapping ranges than the RAM index holds
+ */
+static void TestIndexOverflow( uint8_t programUnit )
+{
+    const uint16_t eepromSize = 512;
+
+    // Partially overwritten records are kept, the bank must hold them all
+    SimFlashInit( 16384, 2048, programUnit );
+    Check( FlashLogInit( &SimFlashDriver ) == LMN_STATUS_OK, "format" );
+
+    for( uint32_t i = 0; i < TEST_NB_RANGES_WRITES; i++ )
+    {
+        // Narrow ranges first, then wider ones which overwrite them
+        uint16_t size = 1 + ( rand( ) % ( ( i < ( TEST_NB_RANGES_WRITES / 2 ) ) ? 4 : 64 ) );
+        uint16_t addr = rand( ) % ( eepromSize - size );
+
+        for( uint16_t j = 0; j < size; j++ )
+        {
+            Eeprom[addr + j] = ( uint8_t )rand( );
+        }
+        Check( FlashLogWrite( addr, &Eeprom[addr], size ) == LMN_STATUS_OK, "write" );
+        if( ( i % 100 ) == 0 )
+        {
+            CheckEeprom( eepromSize, "content of the ranges" );
+            Check( FlashLogInit( &SimFlashDriver ) == LMN_STATUS_OK, "init" );
+            CheckEeprom( eepromSize, "content of the ranges after the initialization" );
+        }
+    }
+    CheckEeprom( eepromSize, "content of the ranges" );
+    Check( FlashLogGetEraseCount( ) > 0, "compaction of the ranges" );
+}
+
+int main( void )
+{
+    static const uint8_t units[] = { 1, 2, 4, 8 };
+
+    srand( 1 );
+    printf( "NVM groups : %u bytes\n", ( unsigned )TEST_EEPROM_SIZE );
+    for( uint8_t i = 0; i < sizeof( units ); i++ )
+    {
+        TestPowerCuts( units[i] );
+        TestWriteAmplification( units[i] );
+        TestMigration( units[i] );
+        TestIndexOverflow( units[i] );
+    }
+
+    Check( SimViolations == 0, "flash usage" );
+    printf( "%s\n", ( NbErrors == 0 ) ? "PASSED" : "FAILED" );
+    return ( NbErrors == 0 ) ? 0 : 1;
+}
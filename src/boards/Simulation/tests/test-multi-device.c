@@ -0,0 +1,415 @@
+/*!
+ * \file      test-multi-device.c
+ *
+ * \brief     Several LoRaMac instances sharing the virtual channel of the
+ *            Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    Each device runs its own LoRaMac instance and virtual radio. All
+ *            the devices start together and join the network stub at the
+ *            same time ( join storm ), then send periodic unconfirmed uplinks.
+ *            The simulation is single threaded: the main loop selects each
+ *            instance in turn to run its LoRaMacProcess.
+ *
+ *            The test passes when every device joined with its own device
+ *            address and the network received uplinks from every device.
+ */
+#include <stdio.h>
+#include "utilities.h"
+#include "board.h"
+#include "timer.h"
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "LoRaMacInstance.h"
+#include "sim.h"
+#include "sim-channel.h"
+#include "sim-network.h"
+
+/*!
+ * Number of simulated devices
+ */
+#ifndef SIM_NB_DEVICES
+#define SIM_NB_DEVICES                              8
+#endif
+
+#if ( SIM_NB_DEVICES > LORAMAC_NB_INSTANCES ) || ( SIM_NB_DEVICES > SIM_NETWORK_MAX_DEVICES )
+#error "SIM_NB_DEVICES exceeds the number of LoRaMac instances or of network devices"
+#endif
+
+/*!
+ * Simulation random generator seed
+ */
+#ifndef SIM_SEED
+#define SIM_SEED                                    1
+#endif
+
+/*!
+ * Simulation duration [s]
+ */
+#ifndef SIM_DURATION
+#define SIM_DURATION                                1800
+#endif
+
+/*!
+ * Uplink period [ms]
+ */
+#define APP_TX_DUTYCYCLE                            60000
+
+/*!
+ * Random delay added to the uplink period and to the join retries [ms]
+ */
+#define APP_TX_DUTYCYCLE_RND                        5000
+
+/*!
+ * Application port of the uplinks
+ */
+#define APP_PORT                                    2
+
+/*!
+ * Simulated device
+ */
+typedef struct sDevice
+{
+    /*!
+     * LoRaMac instance of the device
+     */
+    uint16_t InstanceId;
+    /*!
+     * Set by the LoRaMac when its process must run
+     */
+    volatile bool IsMacProcessPending;
+    /*!
+     * Set by the application timer when a request is due
+     */
+    volatile bool IsTxPending;
+    /*!
+     * Set once the device joined
+     */
+    bool IsJoined;
+    /*!
+     * Application timer, joins then uplinks
+     */
+    TimerEvent_t TxTimer;
+    /*!
+     * Statistics
+     */
+    uint32_t NbJoinRequests;
+    uint32_t NbUplinks;
+    uint32_t DevAddr;
+}Device_t;
+
+/*!
+ * Simulated devices
+ */
+static Device_t Devices[SIM_NB_DEVICES];
+
+/*!
+ * EU868 default channels frequencies, used by the interferer
+ */
+static const uint32_t InterfererFrequencies[] = { 868100000, 868300000, 868500000 };
+
+/*!
+ * Virtual radio channel parameters
+ */
+static const SimChannelParams_t SimChannelParams =
+{
+    .SnrMean = 0,
+    .SnrStdDev = 3,
+    .NoiseFloor = -117,
+    .LossRate = 1,
+    .CaptureMargin = 6,
+    .InterfererInterval = 0,
+    .InterfererSize = 20,
+    .InterfererFrequencies = InterfererFrequencies,
+    .NbInterfererFrequencies = 3,
+};
+
+/*!
+ * EU868 channel frequency list: 867.1, 867.3, 867.5, 867.7 and 867.9 MHz
+ */
+static const uint8_t SimCfList[16] =
+{
+    0x18, 0x4F, 0x84, 0xE8, 0x56, 0x84, 0xB8, 0x5E, 0x84, 0x88, 0x66, 0x84, 0x58, 0x6E, 0x84, 0x00,
+};
+
+/*!
+ * Network server stub parameters. The NwkKey is the se-identity.h default one.
+ */
+static const SimNetworkParams_t SimNetworkParams =
+{
+    .NwkKey = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C },
+    .NetId = 0x000013,
+    .DevAddr = 0x26011234,
+    .CfList = SimCfList,
+    .AdrEnabled = true,
+    .AdrMaxDatarate = DR_5,
+    .AdrChMask = 0x00FF,
+    .DevStatusInterval = 0,
+    .GpsTimeOffset = 1300000000,
+};
+
+/*!
+ * \brief   Gets the device of the selected LoRaMac instance
+ */
+static Device_t* GetDevice( void )
+{
+    return &Devices[LoRaMacInstanceGetId( )];
+}
+
+/*!
+ * \brief   Restarts the application timer of a device
+ *
+ * \param   [IN] device Device
+ * \param   [IN] period Mean timer period [ms]
+ */
+static void StartTxTimer( Device_t* device, uint32_t period )
+{
+    TimerSetValue( &device->TxTimer, period + randr( 0, APP_TX_DUTYCYCLE_RND ) );
+    TimerStart( &device->TxTimer );
+}
+
+static void OnTxTimerEvent( void* context )
+{
+    ( ( Device_t* )context )->IsTxPending = true;
+}
+
+static void OnMacProcessNotify( void )
+{
+    // Raised from the radio and timer events, with the instance selected
+    GetDevice( )->IsMacProcessPending = true;
+}
+
+static void McpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    if( mcpsConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK )
+    {
+        GetDevice( )->NbUplinks++;
+    }
+}
+
+static void McpsIndication( McpsIndication_t* mcpsIndication )
+{
+}
+
+static void MlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+    Device_t* device = GetDevice( );
+    MibRequestConfirm_t mibReq;
+
+    if( mlmeConfirm->MlmeRequest != MLME_JOIN )
+    {
+        return;
+    }
+    if( mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK )
+    {
+        mibReq.Type = MIB_DEV_ADDR;
+        LoRaMacMibGetRequestConfirm( &mibReq );
+        device->DevAddr = mibReq.Param.DevAddr;
+        device->IsJoined = true;
+        StartTxTimer( device, APP_TX_DUTYCYCLE );
+    }
+    else
+    {
+        StartTxTimer( device, 0 );
+    }
+}
+
+static void MlmeIndication( MlmeIndication_t* mlmeIndication )
+{
+}
+
+static LoRaMacPrimitives_t Primitives =
+{
+    .MacMcpsConfirm = McpsConfirm,
+    .MacMcpsIndication = McpsIndication,
+    .MacMlmeConfirm = MlmeConfirm,
+    .MacMlmeIndication = MlmeIndication,
+};
+
+static LoRaMacCallback_t Callbacks =
+{
+    .GetBatteryLevel = BoardGetBatteryLevel,
+    .GetTemperatureLevel = NULL,
+    .NvmDataChange = NULL,
+    .MacProcessNotify = OnMacProcessNotify,
+};
+
+/*!
+ * \brief   Initializes the LoRaMac instance of a device. The instance must be
+ *          selected.
+ *
+ * \param   [IN] device Device
+ *
+ * \retval  status True when the instance is running
+ */
+static bool InitDevice( Device_t* device )
+{
+    MibRequestConfirm_t mibReq;
+    uint8_t devEui[8] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    if( LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 ) != LORAMAC_STATUS_OK )
+    {
+        return false;
+    }
+
+    devEui[7] = ( uint8_t )( device->InstanceId + 1 );
+    mibReq.Type = MIB_DEV_EUI;
+    mibReq.Param.DevEui = devEui;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+
+    mibReq.Type = MIB_PUBLIC_NETWORK;
+    mibReq.Param.EnablePublicNetwork = true;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+
+    mibReq.Type = MIB_ADR;
+    mibReq.Param.AdrEnable = true;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+
+    mibReq.Type = MIB_SYSTEM_MAX_RX_ERROR;
+    mibReq.Param.SystemMaxRxError = 20;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+
+    LoRaMacTestSetDutyCycleOn( true );
+
+    TimerInit( &device->TxTimer, OnTxTimerEvent );
+    TimerSetContext( &device->TxTimer, device );
+
+    return LoRaMacStart( ) == LORAMAC_STATUS_OK;
+}
+
+/*!
+ * \brief   Sends the join request or the next uplink of a device. The instance
+ *          must be selected.
+ *
+ * \param   [IN] device Device
+ */
+static void SendDevice( Device_t* device )
+{
+    static uint8_t buffer[] = { 0x01, 0x67, 0x00, 0xE1 };
+    MlmeReq_t mlmeReq;
+    McpsReq_t mcpsReq;
+
+    if( device->IsJoined == false )
+    {
+        mlmeReq.Type = MLME_JOIN;
+        mlmeReq.Req.Join.Datarate = DR_0;
+        mlmeReq.Req.Join.NetworkActivation = ACTIVATION_TYPE_OTAA;
+        if( LoRaMacMlmeRequest( &mlmeReq ) == LORAMAC_STATUS_OK )
+        {
+            device->NbJoinRequests++;
+        }
+        else
+        {
+            // Busy or duty cycle restricted, the confirm will not come
+            StartTxTimer( device, mlmeReq.ReqReturn.DutyCycleWaitTime );
+        }
+        return;
+    }
+
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = APP_PORT;
+    mcpsReq.Req.Unconfirmed.fBuffer = buffer;
+    mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( buffer );
+    mcpsReq.Req.Unconfirmed.Datarate = DR_0;
+    LoRaMacMcpsRequest( &mcpsReq );
+    StartTxTimer( device, APP_TX_DUTYCYCLE );
+}
+
+int main( void )
+{
+    const SimNetworkStats_t* networkStats;
+    bool isPassed = true;
+
+    SimInit( SIM_SEED, SIM_DURATION );
+    SimChannelInit( &SimChannelParams );
+    SimNetworkInit( &SimNetworkParams );
+
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    for( uint16_t i = 0; i < SIM_NB_DEVICES; i++ )
+    {
+        Devices[i].InstanceId = i;
+        LoRaMacInstanceSelect( i );
+        if( InitDevice( &Devices[i] ) == false )
+        {
+            printf( "Device %u: LoRaMac wasn't properly initialized\n", i );
+            return 1;
+        }
+        // Join storm: all the devices join at once
+        Devices[i].IsTxPending = true;
+    }
+
+    while( SimIsRunning( ) == true )
+    {
+        bool isIdle = true;
+
+        for( uint16_t i = 0; i < SIM_NB_DEVICES; i++ )
+        {
+            Device_t* device = &Devices[i];
+
+            LoRaMacInstanceSelect( device->InstanceId );
+            device->IsMacProcessPending = false;
+            LoRaMacProcess( );
+            if( device->IsTxPending == true )
+            {
+                device->IsTxPending = false;
+                SendDevice( device );
+            }
+        }
+        for( uint16_t i = 0; i < SIM_NB_DEVICES; i++ )
+        {
+            if( ( Devices[i].IsMacProcessPending == true ) || ( Devices[i].IsTxPending == true ) )
+            {
+                isIdle = false;
+            }
+        }
+        if( isIdle == true )
+        {
+            // The devices wake up through events
+            BoardLowPowerHandler( );
+        }
+    }
+
+    networkStats = SimNetworkGetStats( );
+    printf( "\n###### ===== Multi device: %u devices, %u s, seed %u ==== ######\n",
+            SIM_NB_DEVICES, SIM_DURATION, SIM_SEED );
+    for( uint16_t i = 0; i < SIM_NB_DEVICES; i++ )
+    {
+        printf( "Device %2u: DevAddr %08lX, join requests %lu, uplinks %lu\n", i,
+                ( unsigned long )Devices[i].DevAddr, ( unsigned long )Devices[i].NbJoinRequests,
+                ( unsigned long )Devices[i].NbUplinks );
+        if( ( Devices[i].IsJoined == false ) || ( Devices[i].NbUplinks == 0 ) )
+        {
+            isPassed = false;
+        }
+        for( uint16_t j = 0; j < i; j++ )
+        {
+            if( Devices[j].DevAddr == Devices[i].DevAddr )
+            {
+                isPassed = false;
+            }
+        }
+    }
+    printf( "Network  : devices %u, join requests %u, uplinks %u, rejected %u\n",
+            ( unsigned )networkStats->NbDevices, ( unsigned )networkStats->NbJoinRequests,
+            ( unsigned )networkStats->NbUplinks, ( unsigned )networkStats->NbRejected );
+    if( ( networkStats->NbDevices != SIM_NB_DEVICES ) || ( networkStats->NbUplinks < SIM_NB_DEVICES ) )
+    {
+        isPassed = false;
+    }
+    printf( "%s\n", ( isPassed == true ) ? "PASSED" : "FAILED" );
+    return ( isPassed == true ) ? 0 : 1;
+}
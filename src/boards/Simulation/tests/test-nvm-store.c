@@ -0,0 +1,206 @@
+/*!
+ * \file      test-nvm-store.c
+ *
+ * \brief     Split NVM context store of the LmHandler with EEPROM write
+ *            errors over the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The test is built with NVM_DATA_MGMT_ASYNC_STORE_ENABLED set to 1.
+ *            The device joins and sends an unconfirmed uplink every
+ *            APP_TX_INTERVAL. The virtual EEPROM writes fail from
+ *            TEST_ERROR_START to TEST_ERROR_END.
+ *
+ *            The test passes when OnNvmDataChange reports the stores before,
+ *            during and after the write errors, with a size of 0 during the
+ *            errors, and when the EEPROM finally holds the crypto context of
+ *            the MAC.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "nvmm.h"
+#include "LmHandler.h"
+#include "NvmDataMgmt.h"
+#include "sim.h"
+#include "sim-test.h"
+
+/*!
+ * Simulation random generator seed
+ */
+#ifndef SIM_SEED
+#define SIM_SEED                                    1
+#endif
+
+/*!
+ * Simulation duration [s]
+ */
+#ifndef SIM_DURATION
+#define SIM_DURATION                                1800
+#endif
+
+/*!
+ * Application port
+ */
+#define APP_PORT                                    2
+
+/*!
+ * Application payload size
+ */
+#define APP_PAYLOAD_SIZE                            10
+
+/*!
+ * Uplinks interval [s]
+ */
+#define APP_TX_INTERVAL                             60
+
+/*!
+ * Start and end of the EEPROM write errors, after the join [s]
+ */
+#define TEST_ERROR_START                            600
+#define TEST_ERROR_END                              900
+
+/*!
+ * Store notifications before, during and after the write errors
+ */
+static uint16_t NbStores[3];
+
+/*!
+ * Store notifications reporting 0 bytes before, during and after the write
+ * errors
+ */
+static uint16_t NbEmptyStores[3];
+
+static void OnNvmDataChange( LmHandlerNvmContextStates_t state, uint16_t size );
+
+static LmHandlerCallbacks_t LmHandlerCallbacks =
+{
+    .OnNvmDataChange = OnNvmDataChange,
+};
+
+/*!
+ * Virtual radio channel parameters, a lossless link
+ */
+static const SimChannelParams_t SimChannelParams =
+{
+    .SnrMean = 5,
+    .SnrStdDev = 0,
+    .NoiseFloor = -117,
+    .LossRate = 0,
+    .CaptureMargin = 6,
+    .InterfererInterval = 0,
+};
+
+/*!
+ * Network server stub parameters. The NwkKey is the se-identity.h default one.
+ */
+static const SimNetworkParams_t SimNetworkParams =
+{
+    .NwkKey = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C },
+    .NetId = 0x000013,
+    .DevAddr = 0x26011234,
+    .CfList = NULL,
+    .AdrEnabled = false,
+    .DevStatusInterval = 0,
+    .GpsTimeOffset = 1300000000,
+    .OnUplink = NULL,
+};
+
+/*!
+ * \brief   Gets the phase of the scenario
+ *
+ * \retval  phase 0 before, 1 during and 2 after the write errors
+ */
+static uint8_t GetPhase( void )
+{
+    int32_t seconds = SimTestGetSeconds( );
+
+    if( seconds < TEST_ERROR_START )
+    {
+        return 0;
+    }
+    return ( seconds < TEST_ERROR_END ) ? 1 : 2;
+}
+
+/*!
+ * \brief   Sends the periodic uplinks and injects the write errors
+ */
+static void ScenarioProcess( void )
+{
+    int32_t seconds = SimTestGetSeconds( );
+
+    SimEepromSetWriteError( GetPhase( ) == 1 );
+    if( ( seconds % APP_TX_INTERVAL ) == 0 )
+    {
+        SimTestSend( APP_PORT, APP_PAYLOAD_SIZE );
+    }
+}
+
+static void OnNvmDataChange( LmHandlerNvmContextStates_t state, uint16_t size )
+{
+    if( state == LORAMAC_HANDLER_NVM_STORE )
+    {
+        NbStores[GetPhase( )]++;
+        NbEmptyStores[GetPhase( )] += ( size == 0 ) ? 1 : 0;
+    }
+}
+
+int main( void )
+{
+    static LoRaMacCryptoNvmData_t crypto;
+    const SimTestParams_t simTestParams =
+    {
+        .Seed = SIM_SEED,
+        .Duration = SIM_DURATION,
+        .ChannelParams = &SimChannelParams,
+        .NetworkParams = &SimNetworkParams,
+        .AdrEnable = false,
+        .DutyCycleEnabled = false,
+        .Callbacks = &LmHandlerCallbacks,
+        .OnJoined = NULL,
+        .OnTick = ScenarioProcess,
+        .OnLoop = NULL,
+    };
+    MibRequestConfirm_t mibReq;
+    bool isStored;
+    bool isPassed;
+
+    if( SimTestInit( &simTestParams ) == false )
+    {
+        return 1;
+    }
+    SimTestRun( );
+
+    // Completes the store in progress
+    while( NvmDataMgmtIsStorePending( ) == true )
+    {
+        LmHandlerProcess( );
+    }
+    mibReq.Type = MIB_NVM_CTXS;
+    LoRaMacMibGetRequestConfirm( &mibReq );
+    isStored = ( NvmmRead( ( uint8_t* )&crypto, sizeof( crypto ), 0 ) == sizeof( crypto ) ) &&
+               ( memcmp( &crypto, &mibReq.Param.Contexts->Crypto, sizeof( crypto ) ) == 0 );
+
+    printf( "\n###### ===== NVM split store: %u s, seed %u, write errors from %u s to %u s ==== ######\n",
+            SIM_DURATION, SIM_SEED, TEST_ERROR_START, TEST_ERROR_END );
+    printf( "Stores         : before %u, during %u ( empty %u ), after %u ( empty %u )\n",
+            NbStores[0], NbStores[1], NbEmptyStores[1], NbStores[2], NbEmptyStores[2] );
+    printf( "Crypto context : %s\n", ( isStored == true ) ? "stored" : "not stored" );
+
+    isPassed = ( NbStores[0] > 0 ) && ( NbEmptyStores[0] == 0 ) &&
+               ( NbStores[1] > 0 ) && ( NbEmptyStores[1] == NbStores[1] ) &&
+               ( NbStores[2] > 0 ) && ( NbEmptyStores[2] == 0 ) && ( isStored == true );
+    printf( "%s\n", ( isPassed == true ) ? "PASSED" : "FAILED" );
+    return ( isPassed == true ) ? 0 : 1;
+}
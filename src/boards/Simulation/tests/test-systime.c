@@ -0,0 +1,279 @@
+/*!
+ * \file      test-systime.c
+ *
+ * \brief     Drift compensation of the system time over a stub RTC
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The stub RTC runs at a given frequency error from the true time.
+ *            The system time is synchronized on the true time, either precise
+ *            as DeviceTimeAns with a few milliseconds of jitter, or 1 second
+ *            quantized as AppTimeAns. Each scenario starts from the drift
+ *            estimate of the previous one:
+ *            - MCU clock 150 ppm fast, precise synchronizations every hour.
+ *              The errors are stepped.
+ *            - MCU clock 80 ppm slow, precise synchronizations every 10
+ *              minutes.
+ *            - MCU clock 5 ppm fast, precise synchronizations every 30
+ *              minutes. The errors end up slewed.
+ *            - MCU clock 100 ppm fast, AppTimeAns every hour for 20 days.
+ *            - MCU clock 50 ppm slow, a coarse step of 2 seconds 60 seconds
+ *              before a precise synchronization.
+ *
+ *            The test passes when the drift estimates converge and the time
+ *            errors measured before the last synchronizations stay small.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "utilities.h"
+#include "rtc-board.h"
+#include "systime.h"
+
+/*!
+ * True time origin, seconds since UNIX epoch origin
+ */
+#define TEST_EPOCH                                  1300000000
+
+/*!
+ * RTC calendar time at the test start [ms]
+ */
+#define TEST_RTC_ORIGIN                             1000000
+
+/*!
+ * Jitter of the precise reference times [ms]
+ */
+#define TEST_JITTER                                 2
+
+/*!
+ * Accuracy of the AppTimeAns time correction [ms]
+ */
+#define TEST_COARSE_ACCURACY                        1000
+
+/*!
+ * Frequency error of the MCU clock [ppb]. Positive when the MCU clock is fast
+ */
+static int32_t ClockPpb = 0;
+
+/*!
+ * True time elapsed since the test start [ms]
+ */
+static int64_t TrueTimeMs = 0;
+
+/*!
+ * RTC calendar time [ns]
+ */
+static int64_t RtcTimeNs = ( int64_t )TEST_RTC_ORIGIN * 1000000;
+
+/*!
+ * RTC backup registers
+ */
+static uint32_t RtcBkup[2] = { 0 };
+
+static uint16_t NbErrors = 0;
+
+/*
+ * Stub RTC and critical sections
+ */
+
+uint32_t RtcGetCalendarTime( uint16_t *milliseconds )
+{
+    int64_t ms = RtcTimeNs / 1000000;
+
+    *milliseconds = ( uint16_t )( ms % 1000 );
+    return ( uint32_t )( ms / 1000 );
+}
+
+void RtcBkupWrite( uint32_t data0, uint32_t data1 )
+{
+    RtcBkup[0] = data0;
+    RtcBkup[1] = data1;
+}
+
+void RtcBkupRead( uint32_t *data0, uint32_t *data1 )
+{
+    *data0 = RtcBkup[0];
+    *data1 = RtcBkup[1];
+}
+
+void BoardCriticalSectionBegin( uint32_t *mask )
+{
+    *mask = 0;
+}
+
+void BoardCriticalSectionEnd( uint32_t *mask )
+{
+}
+
+/*!
+ * \brief   Checks a condition and counts the failures
+ */
+static void Check( bool condition, const char* msg )
+{
+    if( condition == false )
+    {
+        printf( "Check failed: %s\n", msg );
+        NbErrors++;
+    }
+}
+
+/*!
+ * \brief   Advances the true time and the RTC
+ *
+ * \param   [IN] ms True time duration [ms]
+ */
+static void Advance( int64_t ms )
+{
+    TrueTimeMs += ms;
+    RtcTimeNs += ( ms * 1000000 ) + ( ( ms * ClockPpb ) / 1000 );
+}
+
+/*!
+ * \brief   Gets the true time
+ *
+ * \param   [IN] offsetMs Offset added to the true time [ms]
+ */
+static SysTime_t GetTrueTime( int64_t offsetMs )
+{
+    int64_t ms = TrueTimeMs + offsetMs;
+
+    return ( SysTime_t ){ .Seconds = TEST_EPOCH + ( uint32_t )( ms / 1000 ), .SubSeconds = ( int16_t )( ms % 1000 ) };
+}
+
+/*!
+ * \brief   Gets the error of the system time
+ *
+ * \retval  error System time minus true time [ms]
+ */
+static int64_t GetTimeError( void )
+{
+    SysTime_t diff = SysTimeSub( SysTimeGet( ), GetTrueTime( 0 ) );
+
+    return ( ( int64_t )( int32_t )diff.Seconds * 1000 ) + diff.SubSeconds;
+}
+
+/*!
+ * \brief   Gets the error of the drift estimate
+ *
+ * \retval  error Drift compensation error [ppb]
+ */
+static int32_t GetDriftError( void )
+{
+    return SysTimeGetDrift( ) + ClockPpb;
+}
+
+/*!
+ * \brief   Synchronizes the system time as AppTimeAns does
+ *
+ * \remark  The device sends its time and the network answers the correction,
+ *          both in whole seconds.
+ */
+static void SyncCoarse( void )
+{
+    SysTime_t curTime = SysTimeGet( );
+    int32_t correction = ( int32_t )( GetTrueTime( 0 ).Seconds - curTime.Seconds );
+
+    curTime.Seconds += correction;
+    SysTimeSyncCoarse( curTime, TEST_COARSE_ACCURACY );
+}
+
+/*!
+ * \brief   Runs periodic synchronizations
+ *
+ * \param   [IN] name        Scenario name
+ * \param   [IN] clockPpb    Frequency error of the MCU clock [ppb]
+ * \param   [IN] interval    Synchronization interval [s]
+ * \param   [IN] nbSyncs     Number of synchronizations
+ * \param   [IN] isCoarse    Synchronizes as AppTimeAns when set
+ * \param   [IN] maxDrift    Maximum final drift estimate error [ppb]
+ * \param   [IN] maxError    Maximum time error before the last quarter of the
+ *                           synchronizations [ms]
+ */
+static void TestPeriodicSync( const char* name, int32_t clockPpb, uint32_t interval, uint16_t nbSyncs,
+                              bool isCoarse, int32_t maxDrift, int64_t maxError )
+{
+    int64_t lastError = 0;
+    int64_t worstError = 0;
+
+    ClockPpb = clockPpb;
+    for( uint16_t i = 0; i < nbSyncs; i++ )
+    {
+        int64_t error;
+
+        Advance( ( int64_t )interval * 1000 );
+        error = GetTimeError( );
+        if( i >= ( nbSyncs - ( nbSyncs / 4 ) ) )
+        {
+            worstError = MAX( worstError, ( error >= 0 ) ? error : -error );
+        }
+        lastError = error;
+
+        if( isCoarse == true )
+        {
+            SyncCoarse( );
+        }
+        else
+        {
+            SysTimeSync( GetTrueTime( ( rand( ) % ( 2 * TEST_JITTER + 1 ) ) - TEST_JITTER ) );
+        }
+    }
+    printf( "%-26s: drift error %6ld ppb, last error %5ld ms, worst error %5ld ms\n", name,
+            ( long )GetDriftError( ), ( long )lastError, ( long )worstError );
+    Check( ( GetDriftError( ) <= maxDrift ) && ( GetDriftError( ) >= -maxDrift ), "drift estimate" );
+    Check( worstError <= maxError, "time error" );
+}
+
+/*!
+ * \brief   Checks that a coarse step between precise synchronizations
+ *          doesn't corrupt the drift estimate
+ */
+static void TestCoarseStep( void )
+{
+    int32_t drift;
+    int64_t error;
+
+    ClockPpb = -50000;
+    for( uint8_t i = 0; i < 24; i++ )
+    {
+        Advance( 3600000 );
+        SysTimeSync( GetTrueTime( 0 ) );
+    }
+    drift = SysTimeGetDrift( );
+
+    // The coarse reference time is 2 seconds ahead, beyond its accuracy
+    Advance( 3540000 );
+    SysTimeSyncCoarse( SysTimeAdd( SysTimeGet( ), ( SysTime_t ){ .Seconds = 2, .SubSeconds = 0 } ), TEST_COARSE_ACCURACY );
+    Advance( 60000 );
+    error = GetTimeError( );
+    SysTimeSync( GetTrueTime( 0 ) );
+
+    printf( "%-26s: drift change %6ld ppb, error after step %5ld ms, after sync %ld ms\n", "Coarse step",
+            ( long )( SysTimeGetDrift( ) - drift ), ( long )error, ( long )GetTimeError( ) );
+    Check( ( ( SysTimeGetDrift( ) - drift ) <= 1000 ) && ( ( SysTimeGetDrift( ) - drift ) >= -1000 ), "drift after step" );
+    Check( ( error > 1900 ) && ( error < 2100 ), "coarse step" );
+    Check( ( GetTimeError( ) <= 1 ) && ( GetTimeError( ) >= -1 ), "time after step" );
+}
+
+int main( void )
+{
+    srand( 1 );
+
+    TestPeriodicSync( "150 ppm fast, 1 h, precise", 150000, 3600, 48, false, 2000, 10 );
+    TestPeriodicSync( "80 ppm slow, 10 min, precise", -80000, 600, 144, false, 5000, 6 );
+    TestPeriodicSync( "5 ppm fast, 30 min, precise", 5000, 1800, 96, false, 2000, 6 );
+    TestPeriodicSync( "100 ppm fast, 1 h, coarse", 100000, 3600, 480, true, 20000, 1000 );
+    TestCoarseStep( );
+
+    printf( "%s\n", ( NbErrors == 0 ) ? "PASSED" : "FAILED" );
+    return ( NbErrors == 0 ) ? 0 : 1;
+}
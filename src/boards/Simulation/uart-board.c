@@ -0,0 +1,61 @@
+/*!
+ * \file      uart-board.c
+ *
+ * \brief     Target board UART driver implementation
+ *
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stdio.h>
+#include "uart-board.h"
+
+/*
+ * The UART output is written to the standard output. No input is received.
+ */
+
+void UartMcuInit( Uart_t *obj, UartId_t uartId, PinNames tx, PinNames rx )
+{
+    obj->UartId = uartId;
+}
+
+void UartMcuConfig( Uart_t *obj, UartMode_t mode, uint32_t baudrate, WordLength_t wordLength, StopBits_t stopBits, Parity_t parity, FlowCtrl_t flowCtrl )
+{
+}
+
+void UartMcuDeInit( Uart_t *obj )
+{
+}
+
+uint8_t UartMcuPutChar( Uart_t *obj, uint8_t data )
+{
+    putchar( data );
+    return 0; // OK
+}
+
+uint8_t UartMcuGetChar( Uart_t *obj, uint8_t *data )
+{
+    return 1; // Busy
+}
+
+uint8_t UartMcuPutBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size )
+{
+    fwrite( buffer, 1, size, stdout );
+    return 0; // OK
+}
+
+uint8_t UartMcuGetBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size, uint16_t *nbReadBytes )
+{
+    *nbReadBytes = 0;
+    return 1; // Busy
+}
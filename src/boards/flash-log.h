@@ -0,0 +1,149 @@
+/*!
+ * \file      flash-log.h
+ *
+ * \brief     Record oriented EEPROM emulation for flash only targets
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The log uses two banks of BankSize bytes. Only one bank is active
+ *            at a time. Each EEPROM write appends one record to the active
+ *            bank:
+ *            - Header: address ( 2 bytes ), size ( 2 bytes ), CRC32 of the
+ *              address, size and data ( 4 bytes )
+ *            - Data, padded with 0xFF up to the program unit
+ *
+ *            A write of a whole NVM group therefore costs one record instead
+ *            of one log entry per byte. Reads return the data of the latest
+ *            records covering the requested range, the records having a
+ *            wrong CRC are skipped. Never written bytes read as 0xFF.
+ *
+ *            The CRC of each record is checked once, when the log is scanned
+ *            at initialization. A RAM index of FLASH_LOG_INDEX_SIZE entries
+ *            then locates the records which are not overwritten, the reads
+ *            and the compaction do not scan the log. Above that number of
+ *            records the log is scanned again. A record altered after the
+ *            initialization is caught by the CRC of its NVM group and
+ *            dropped at the next initialization.
+ *
+ *            When the active bank is full, the records which are not
+ *            overwritten by a later record are copied to the other bank.
+ *            The bank header, written last, validates the copy. Only then is
+ *            the previous bank erased. Records having a wrong CRC, e.g. after
+ *            a power cut, are dropped by the copy done at initialization.
+ *
+ *            When neither bank is valid, the content of the previous EEPROM
+ *            emulation, if any, is imported while formatting the log. It is
+ *            erased once the bank header validated the import.
+ */
+#ifndef __FLASH_LOG_H__
+#define __FLASH_LOG_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include "utilities.h"
+
+/*!
+ * Flash access functions of the board
+ *
+ * \remark Offsets are relative to the start of the log area, which holds both
+ *         banks. Bank 0 starts at offset 0, bank 1 at offset BankSize.
+ */
+typedef struct FlashLogDriver_s
+{
+    /*!
+     * Size of a bank. Must be a multiple of the erase page size
+     */
+    uint32_t BankSize;
+    /*!
+     * Program unit. Must be 1, 2, 4 or 8
+     */
+    uint8_t ProgramUnit;
+    /*!
+     * Reads size bytes at offset
+     */
+    LmnStatus_t ( *Read )( uint32_t offset, uint8_t *buffer, uint16_t size );
+    /*!
+     * Programs size bytes at offset. offset and size are multiples of ProgramUnit
+     */
+    LmnStatus_t ( *Program )( uint32_t offset, uint8_t *buffer, uint16_t size );
+    /*!
+     * Erases the bank starting at offset
+     */
+    LmnStatus_t ( *EraseBank )( uint32_t offset );
+    /*!
+     * Size of the previous EEPROM emulation, 0 if none
+     */
+    uint16_t LegacySize;
+    /*!
+     * Reads size bytes of the previous EEPROM emulation at addr. Returns
+     * LMN_STATUS_ERROR if it holds no content. May be NULL
+     */
+    LmnStatus_t ( *ReadLegacy )( uint16_t addr, uint8_t *buffer, uint16_t size );
+    /*!
+     * Erases the previous EEPROM emulation. May be NULL
+     */
+    LmnStatus_t ( *EraseLegacy )( void );
+}FlashLogDriver_t;
+
+/*!
+ * Initializes the log
+ *
+ * \remark Selects the last valid bank, formats the log and imports the
+ *         previous EEPROM emulation if there is none, indexes the records and
+ *         drops the ones corrupted by a power cut.
+ *
+ * \param[IN] driver Flash access functions. The structure must stay valid
+ *                   while the log is used.
+ * \retval status [LMN_STATUS_OK, LMN_STATUS_ERROR]
+ */
+LmnStatus_t FlashLogInit( const FlashLogDriver_t *driver );
+
+/*!
+ * Writes the given buffer to the emulated EEPROM at the specified address.
+ *
+ * \remark Nothing is written if the EEPROM already holds the given data.
+ *
+ * \param[IN] addr EEPROM address to write to
+ * \param[IN] buffer Pointer to the buffer to be written.
+ * \param[IN] size Size of the buffer to be written.
+ * \retval status [LMN_STATUS_OK, LMN_STATUS_ERROR]
+ */
+LmnStatus_t FlashLogWrite( uint16_t addr, uint8_t *buffer, uint16_t size );
+
+/*!
+ * Reads the emulated EEPROM at the specified address to the given buffer.
+ *
+ * \param[IN] addr EEPROM address to read from
+ * \param[OUT] buffer Pointer to the buffer to be written with read data.
+ * \param[IN] size Size of the buffer to be read.
+ * \retval status [LMN_STATUS_OK, LMN_STATUS_ERROR]
+ */
+LmnStatus_t FlashLogRead( uint16_t addr, uint8_t *buffer, uint16_t size );
+
+/*!
+ * Gets the number of bank erasures since \ref FlashLogInit
+ *
+ * \retval count Number of bank erasures
+ */
+uint32_t FlashLogGetEraseCount( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FLASH_LOG_H__
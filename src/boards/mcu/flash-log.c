@@ -0,0 +1,742 @@
+/*!
+ * \file      flash-log.c
+ *
+ * \brief     Record oriented EEPROM emulation for flash only targets
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "utilities.h"
+#include "flash-log.h"
+
+/*!
+ * Marks a formatted bank
+ */
+#define FLASH_LOG_BANK_MAGIC                        0x474F4C46
+
+/*!
+ * Bank header size: magic ( 4 bytes ), sequence number ( 4 bytes )
+ */
+#define FLASH_LOG_BANK_HEADER_SIZE                  8
+
+/*!
+ * Record header size
+ */
+#define FLASH_LOG_RECORD_HEADER_SIZE                8
+
+/*!
+ * Size of the buffer used to copy and compare the records data.
+ * Must be a multiple of 8.
+ */
+#define FLASH_LOG_CHUNK_SIZE                        32
+
+/*!
+ * Size of the records holding the imported content of the previous EEPROM
+ * emulation
+ */
+#define FLASH_LOG_IMPORT_CHUNK_SIZE                 64
+
+/*!
+ * Maximum number of records of the RAM index
+ */
+#ifndef FLASH_LOG_INDEX_SIZE
+#define FLASH_LOG_INDEX_SIZE                        32
+#endif
+
+/*!
+ * Record header
+ */
+typedef struct FlashLogRecordHeader_s
+{
+    /*!
+     * EEPROM address of the data
+     */
+    uint16_t Addr;
+    /*!
+     * Data size
+     */
+    uint16_t Size;
+    /*!
+     * CRC32 of the address, the size and the data
+     */
+    uint32_t Crc;
+}FlashLogRecordHeader_t;
+
+/*!
+ * Record of the RAM index
+ */
+typedef struct FlashLogIndexEntry_s
+{
+    /*!
+     * EEPROM address of the data
+     */
+    uint16_t Addr;
+    /*!
+     * Data size
+     */
+    uint16_t Size;
+    /*!
+     * Offset of the record in the active bank
+     */
+    uint32_t Offset;
+}FlashLogIndexEntry_t;
+
+/*!
+ * Flash access functions
+ */
+static const FlashLogDriver_t *Driver = NULL;
+
+/*!
+ * Offset of the active bank
+ */
+static uint32_t ActiveBank = 0;
+
+/*!
+ * Sequence number of the active bank
+ */
+static uint32_t Sequence = 0;
+
+/*!
+ * Offset of the next record in the active bank
+ */
+static uint32_t WriteOffset = 0;
+
+/*!
+ * Number of bank erasures
+ */
+static uint32_t EraseCount = 0;
+
+/*!
+ * Valid records of the active bank which are not fully overwritten by a later
+ * record, in log order
+ */
+static FlashLogIndexEntry_t Index[FLASH_LOG_INDEX_SIZE];
+
+/*!
+ * Number of records in the index
+ */
+static uint8_t IndexCnt = 0;
+
+/*!
+ * Set to false when the index overflowed. The reads and the compaction then
+ * scan the whole log.
+ */
+static bool IsIndexComplete = true;
+
+/*!
+ * Computes the flash size used by a record
+ *
+ * \param[IN] size Data size
+ * \retval length Record size, header included
+ */
+static uint32_t GetRecordLength( uint16_t size )
+{
+    uint32_t unit = Driver->ProgramUnit;
+
+    return FLASH_LOG_RECORD_HEADER_SIZE + ( ( size + unit - 1 ) & ~( unit - 1 ) );
+}
+
+/*!
+ * Checks if a record header is erased, i.e. marks the end of the log
+ */
+static bool IsHeaderErased( FlashLogRecordHeader_t *header )
+{
+    return ( header->Addr == 0xFFFF ) && ( header->Size == 0xFFFF ) && ( header->Crc == 0xFFFFFFFF );
+}
+
+/*!
+ * Computes the CRC of a record stored in flash
+ *
+ * \param[IN] offset Record offset
+ * \param[IN] header Record header
+ * \retval isValid Returns true if the CRC matches the header
+ */
+static bool IsRecordValid( uint32_t offset, FlashLogRecordHeader_t *header )
+{
+    uint8_t chunk[FLASH_LOG_CHUNK_SIZE];
+    uint32_t crc = Crc32Init( );
+
+    crc = Crc32Update( crc, ( uint8_t* )&header->Addr, sizeof( header->Addr ) );
+    crc = Crc32Update( crc, ( uint8_t* )&header->Size, sizeof( header->Size ) );
+    for( uint16_t i = 0; i < header->Size; i += FLASH_LOG_CHUNK_SIZE )
+    {
+        uint16_t size = MIN( header->Size - i, FLASH_LOG_CHUNK_SIZE );
+
+        if( Driver->Read( offset + FLASH_LOG_RECORD_HEADER_SIZE + i, chunk, size ) != LMN_STATUS_OK )
+        {
+            return false;
+        }
+        crc = Crc32Update( crc, chunk, size );
+    }
+    return Crc32Finalize( crc ) == header->Crc;
+}
+
+/*!
+ * Checks if a record is fully overwritten by one of the next valid records
+ *
+ * \param[IN] header Record header
+ * \param[IN] offset Offset of the next record
+ * \param[IN] end    Offset of the end of the log, at most the end of the bank
+ */
+static bool IsRecordOverwritten( FlashLogRecordHeader_t *header, uint32_t offset, uint32_t end )
+{
+    FlashLogRecordHeader_t next;
+
+    while( ( offset + FLASH_LOG_RECORD_HEADER_SIZE ) <= end )
+    {
+        if( ( Driver->Read( offset, ( uint8_t* )&next, sizeof( next ) ) != LMN_STATUS_OK ) ||
+            ( IsHeaderErased( &next ) == true ) ||
+            ( ( offset + GetRecordLength( next.Size ) ) > end ) )
+        {
+            // End of the log, or a garbage size after a power cut
+            break;
+        }
+        if( ( next.Addr <= header->Addr ) &&
+            ( ( ( uint32_t )next.Addr + next.Size ) >= ( ( uint32_t )header->Addr + header->Size ) ) &&
+            ( IsRecordValid( offset, &next ) == true ) )
+        {
+            return true;
+        }
+        offset += GetRecordLength( next.Size );
+    }
+    return false;
+}
+
+/*!
+ * Empties the index
+ */
+static void IndexReset( void )
+{
+    IndexCnt = 0;
+    IsIndexComplete = true;
+}
+
+/*!
+ * Appends a valid record to the index and drops the records it fully
+ * overwrites
+ *
+ * \param[IN] header Record header
+ * \param[IN] offset Offset of the record in the active bank
+ */
+static void IndexAdd( FlashLogRecordHeader_t *header, uint32_t offset )
+{
+    uint8_t cnt = 0;
+
+    for( uint8_t i = 0; i < IndexCnt; i++ )
+    {
+        if( ( header->Addr > Index[i].Addr ) ||
+            ( ( ( uint32_t )header->Addr + header->Size ) < ( ( uint32_t )Index[i].Addr + Index[i].Size ) ) )
+        {
+            Index[cnt++] = Index[i];
+        }
+    }
+    IndexCnt = cnt;
+
+    if( IndexCnt >= FLASH_LOG_INDEX_SIZE )
+    {
+        IsIndexComplete = false;
+        return;
+    }
+    Index[IndexCnt].Addr = header->Addr;
+    Index[IndexCnt].Size = header->Size;
+    Index[IndexCnt].Offset = offset;
+    IndexCnt++;
+}
+
+/*!
+ * Finds the end of the log of the active bank and indexes its valid records
+ *
+ * \param[OUT] isCorrupted Set to true if the bank holds invalid records
+ * \retval offset Offset of the end of the log in the active bank
+ */
+static uint32_t FindEnd( bool *isCorrupted )
+{
+    FlashLogRecordHeader_t header;
+    uint32_t offset = FLASH_LOG_BANK_HEADER_SIZE;
+
+    *isCorrupted = false;
+    IndexReset( );
+    while( ( offset + FLASH_LOG_RECORD_HEADER_SIZE ) <= Driver->BankSize )
+    {
+        if( Driver->Read( ActiveBank + offset, ( uint8_t* )&header, sizeof( header ) ) != LMN_STATUS_OK )
+        {
+            *isCorrupted = true;
+            break;
+        }
+        if( IsHeaderErased( &header ) == true )
+        {
+            return offset;
+        }
+        if( ( offset + GetRecordLength( header.Size ) ) > Driver->BankSize )
+        {
+            // The size is garbage, the next records can't be located
+            *isCorrupted = true;
+            break;
+        }
+        if( IsRecordValid( ActiveBank + offset, &header ) == true )
+        {
+            IndexAdd( &header, offset );
+        }
+        else
+        {
+            *isCorrupted = true;
+        }
+        offset += GetRecordLength( header.Size );
+    }
+    // No room left
+    return Driver->BankSize;
+}
+
+/*!
+ * Writes a bank header
+ */
+static LmnStatus_t WriteBankHeader( uint32_t bank, uint32_t sequence )
+{
+    uint32_t header[2] = { FLASH_LOG_BANK_MAGIC, sequence };
+
+    return Driver->Program( bank, ( uint8_t* )header, sizeof( header ) );
+}
+
+/*!
+ * Copies a record
+ *
+ * \param[IN] src    Offset of the record
+ * \param[IN] dst    Offset of the copy
+ * \param[IN] length Record size, header included
+ */
+static LmnStatus_t CopyRecord( uint32_t src, uint32_t dst, uint32_t length )
+{
+    uint8_t chunk[FLASH_LOG_CHUNK_SIZE];
+
+    for( uint32_t i = 0; i < length; i += FLASH_LOG_CHUNK_SIZE )
+    {
+        uint16_t size = MIN( length - i, FLASH_LOG_CHUNK_SIZE );
+
+        if( ( Driver->Read( src + i, chunk, size ) != LMN_STATUS_OK ) ||
+            ( Driver->Program( dst + i, chunk, size ) != LMN_STATUS_OK ) )
+        {
+            return LMN_STATUS_ERROR;
+        }
+    }
+    return LMN_STATUS_OK;
+}
+
+/*!
+ * Copies the records of the index to the other bank
+ *
+ * \param[IN] dstBank Offset of the other bank
+ * \retval offset Offset of the end of the log in the other bank, 0 on error
+ */
+static uint32_t CompactIndex( uint32_t dstBank )
+{
+    uint32_t dstOffset = FLASH_LOG_BANK_HEADER_SIZE;
+
+    for( uint8_t i = 0; i < IndexCnt; i++ )
+    {
+        uint32_t length = GetRecordLength( Index[i].Size );
+
+        if( CopyRecord( ActiveBank + Index[i].Offset, dstBank + dstOffset, length ) != LMN_STATUS_OK )
+        {
+            return 0;
+        }
+        dstOffset += length;
+    }
+    return dstOffset;
+}
+
+/*!
+ * Copies the valid and not overwritten records to the other bank by scanning
+ * the whole log and indexes the copies
+ *
+ * \param[IN] dstBank Offset of the other bank
+ * \retval offset Offset of the end of the log in the other bank, 0 on error
+ */
+static uint32_t CompactScan( uint32_t dstBank )
+{
+    FlashLogRecordHeader_t header;
+    uint32_t dstOffset = FLASH_LOG_BANK_HEADER_SIZE;
+    uint32_t offset = FLASH_LOG_BANK_HEADER_SIZE;
+    uint32_t end = ActiveBank + WriteOffset;
+
+    IndexReset( );
+    while( ( offset + FLASH_LOG_RECORD_HEADER_SIZE ) <= WriteOffset )
+    {
+        uint32_t src = ActiveBank + offset;
+        uint32_t length;
+
+        if( ( Driver->Read( src, ( uint8_t* )&header, sizeof( header ) ) != LMN_STATUS_OK ) ||
+            ( IsHeaderErased( &header ) == true ) )
+        {
+            break;
+        }
+        length = GetRecordLength( header.Size );
+        if( ( offset + length ) > WriteOffset )
+        {
+            break;
+        }
+        if( ( IsRecordValid( src, &header ) == true ) &&
+            ( IsRecordOverwritten( &header, src + length, end ) == false ) )
+        {
+            if( CopyRecord( src, dstBank + dstOffset, length ) != LMN_STATUS_OK )
+            {
+                return 0;
+            }
+            IndexAdd( &header, dstOffset );
+            dstOffset += length;
+        }
+        offset += length;
+    }
+    return dstOffset;
+}
+
+/*!
+ * Copies the valid and not overwritten records to the other bank, which
+ * becomes the active bank
+ */
+static LmnStatus_t Compact( void )
+{
+    uint32_t dstBank = ( ActiveBank == 0 ) ? Driver->BankSize : 0;
+    bool isIndexed = IsIndexComplete;
+    uint32_t dstOffset;
+
+    EraseCount++;
+    if( Driver->EraseBank( dstBank ) != LMN_STATUS_OK )
+    {
+        return LMN_STATUS_ERROR;
+    }
+
+    dstOffset = ( isIndexed == true ) ? CompactIndex( dstBank ) : CompactScan( dstBank );
+
+    // The bank header validates the copy
+    if( ( dstOffset == 0 ) || ( WriteBankHeader( dstBank, Sequence + 1 ) != LMN_STATUS_OK ) )
+    {
+        // The index may describe the copy, the active bank is read by scanning
+        IsIndexComplete &= isIndexed;
+        return LMN_STATUS_ERROR;
+    }
+    EraseCount++;
+    Driver->EraseBank( ActiveBank );
+
+    ActiveBank = dstBank;
+    Sequence++;
+    WriteOffset = dstOffset;
+
+    if( isIndexed == true )
+    {
+        // The records are copied in index order
+        dstOffset = FLASH_LOG_BANK_HEADER_SIZE;
+        for( uint8_t i = 0; i < IndexCnt; i++ )
+        {
+            Index[i].Offset = dstOffset;
+            dstOffset += GetRecordLength( Index[i].Size );
+        }
+    }
+    return LMN_STATUS_OK;
+}
+
+/*!
+ * Appends a record to the active bank, which must have room for it
+ *
+ * \param[IN] addr   EEPROM address of the data
+ * \param[IN] buffer Data
+ * \param[IN] size   Data size
+ */
+static LmnStatus_t AppendRecord( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    FlashLogRecordHeader_t header;
+    uint8_t tail[8];
+    uint32_t offset;
+    uint16_t alignedSize;
+
+    header.Addr = addr;
+    header.Size = size;
+    header.Crc = Crc32Init( );
+    header.Crc = Crc32Update( header.Crc, ( uint8_t* )&header.Addr, sizeof( header.Addr ) );
+    header.Crc = Crc32Update( header.Crc, ( uint8_t* )&header.Size, sizeof( header.Size ) );
+    header.Crc = Crc32Finalize( Crc32Update( header.Crc, buffer, size ) );
+
+    offset = WriteOffset;
+    alignedSize = size & ~( Driver->ProgramUnit - 1 );
+    memset1( tail, 0xFF, sizeof( tail ) );
+    memcpy1( tail, buffer + alignedSize, size - alignedSize );
+
+    // The record is appended even if a step fails, its CRC is then wrong
+    WriteOffset += GetRecordLength( size );
+    if( ( Driver->Program( ActiveBank + offset, ( uint8_t* )&header, sizeof( header ) ) != LMN_STATUS_OK ) ||
+        ( ( alignedSize > 0 ) &&
+          ( Driver->Program( ActiveBank + offset + FLASH_LOG_RECORD_HEADER_SIZE, buffer, alignedSize ) != LMN_STATUS_OK ) ) ||
+        ( ( alignedSize < size ) &&
+          ( Driver->Program( ActiveBank + offset + FLASH_LOG_RECORD_HEADER_SIZE + alignedSize, tail, Driver->ProgramUnit ) != LMN_STATUS_OK ) ) )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    IndexAdd( &header, offset );
+    return LMN_STATUS_OK;
+}
+
+/*!
+ * Imports the content of the previous EEPROM emulation into the empty active
+ * bank. Blank chunks are skipped.
+ *
+ * \param[OUT] isImported Set to true if the previous EEPROM emulation holds
+ *                        some content
+ */
+static LmnStatus_t Import( bool *isImported )
+{
+    uint8_t chunk[FLASH_LOG_IMPORT_CHUNK_SIZE];
+
+    *isImported = false;
+    if( Driver->ReadLegacy == NULL )
+    {
+        return LMN_STATUS_OK;
+    }
+
+    for( uint32_t addr = 0; addr < Driver->LegacySize; addr += FLASH_LOG_IMPORT_CHUNK_SIZE )
+    {
+        uint16_t size = MIN( Driver->LegacySize - addr, FLASH_LOG_IMPORT_CHUNK_SIZE );
+        bool isBlank = true;
+
+        if( Driver->ReadLegacy( addr, chunk, size ) != LMN_STATUS_OK )
+        {
+            // Nothing to import if the first read fails
+            return ( addr == 0 ) ? LMN_STATUS_OK : LMN_STATUS_ERROR;
+        }
+        *isImported = true;
+        for( uint16_t i = 0; i < size; i++ )
+        {
+            isBlank &= chunk[i] == 0xFF;
+        }
+        if( isBlank == true )
+        {
+            continue;
+        }
+        if( ( ( WriteOffset + GetRecordLength( size ) ) > Driver->BankSize ) ||
+            ( AppendRecord( addr, chunk, size ) != LMN_STATUS_OK ) )
+        {
+            return LMN_STATUS_ERROR;
+        }
+    }
+    return LMN_STATUS_OK;
+}
+
+/*!
+ * Checks if the EEPROM already holds the given data
+ */
+static bool IsUnchanged( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    uint8_t chunk[FLASH_LOG_CHUNK_SIZE];
+
+    for( uint16_t i = 0; i < size; i += FLASH_LOG_CHUNK_SIZE )
+    {
+        uint16_t chunkSize = MIN( size - i, FLASH_LOG_CHUNK_SIZE );
+
+        if( FlashLogRead( addr + i, chunk, chunkSize ) != LMN_STATUS_OK )
+        {
+            return false;
+        }
+        for( uint16_t j = 0; j < chunkSize; j++ )
+        {
+            if( chunk[j] != buffer[i + j] )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+LmnStatus_t FlashLogInit( const FlashLogDriver_t *driver )
+{
+    uint32_t header0[2] = { 0 };
+    uint32_t header1[2] = { 0 };
+    bool isValid0 = false;
+    bool isValid1 = false;
+    bool isCorrupted = false;
+
+    if( ( driver == NULL ) || ( driver->Read == NULL ) || ( driver->Program == NULL ) ||
+        ( driver->EraseBank == NULL ) || ( driver->ProgramUnit == 0 ) || ( driver->ProgramUnit > 8 ) ||
+        ( ( driver->ProgramUnit & ( driver->ProgramUnit - 1 ) ) != 0 ) )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    Driver = driver;
+    EraseCount = 0;
+    IndexReset( );
+
+    if( Driver->Read( 0, ( uint8_t* )header0, sizeof( header0 ) ) == LMN_STATUS_OK )
+    {
+        isValid0 = header0[0] == FLASH_LOG_BANK_MAGIC;
+    }
+    if( Driver->Read( Driver->BankSize, ( uint8_t* )header1, sizeof( header1 ) ) == LMN_STATUS_OK )
+    {
+        isValid1 = header1[0] == FLASH_LOG_BANK_MAGIC;
+    }
+
+    if( ( isValid0 == false ) && ( isValid1 == false ) )
+    {
+        bool isImported = false;
+
+        // Blank or unknown content, format the log. The bank header validates
+        // the imported content, the import restarts after a power cut.
+        ActiveBank = 0;
+        Sequence = 1;
+        WriteOffset = FLASH_LOG_BANK_HEADER_SIZE;
+        EraseCount++;
+        if( ( Driver->EraseBank( ActiveBank ) != LMN_STATUS_OK ) ||
+            ( Import( &isImported ) != LMN_STATUS_OK ) ||
+            ( WriteBankHeader( ActiveBank, Sequence ) != LMN_STATUS_OK ) )
+        {
+            return LMN_STATUS_ERROR;
+        }
+        if( ( isImported == true ) && ( Driver->EraseLegacy != NULL ) )
+        {
+            Driver->EraseLegacy( );
+        }
+        return LMN_STATUS_OK;
+    }
+
+    // Both banks are valid if a power cut occurred before the erasure of the
+    // previous bank. The latest bank holds a complete copy.
+    if( ( isValid1 == true ) &&
+        ( ( isValid0 == false ) || ( ( int32_t )( header1[1] - header0[1] ) > 0 ) ) )
+    {
+        ActiveBank = Driver->BankSize;
+        Sequence = header1[1];
+    }
+    else
+    {
+        ActiveBank = 0;
+        Sequence = header0[1];
+    }
+
+    WriteOffset = FindEnd( &isCorrupted );
+    if( isCorrupted == true )
+    {
+        return Compact( );
+    }
+    return LMN_STATUS_OK;
+}
+
+LmnStatus_t FlashLogWrite( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    uint32_t length;
+
+    if( ( Driver == NULL ) || ( buffer == NULL ) || ( size == 0 ) ||
+        ( ( ( uint32_t )addr + size ) > UINT16_MAX ) )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    if( IsUnchanged( addr, buffer, size ) == true )
+    {
+        return LMN_STATUS_OK;
+    }
+
+    length = GetRecordLength( size );
+    if( ( WriteOffset + length ) > Driver->BankSize )
+    {
+        if( ( Compact( ) != LMN_STATUS_OK ) || ( ( WriteOffset + length ) > Driver->BankSize ) )
+        {
+            return LMN_STATUS_ERROR;
+        }
+    }
+
+    if( AppendRecord( addr, buffer, size ) != LMN_STATUS_OK )
+    {
+        // Drop the invalid record
+        Compact( );
+        return LMN_STATUS_ERROR;
+    }
+    return LMN_STATUS_OK;
+}
+
+/*!
+ * Reads the data of a record overlapping the given EEPROM range
+ *
+ * \param[IN] recordAddr   EEPROM address of the record data
+ * \param[IN] recordSize   Record data size
+ * \param[IN] recordOffset Offset of the record in the active bank
+ * \param[IN] addr         EEPROM address of the read data
+ * \param[OUT] buffer      Read data
+ * \param[IN] size         Read data size
+ */
+static LmnStatus_t ReadRecord( uint16_t recordAddr, uint16_t recordSize, uint32_t recordOffset,
+                               uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    uint32_t recordStart = MAX( recordAddr, addr );
+    uint32_t recordEnd = MIN( ( uint32_t )recordAddr + recordSize, ( uint32_t )addr + size );
+
+    if( recordStart >= recordEnd )
+    {
+        return LMN_STATUS_OK;
+    }
+    return Driver->Read( ActiveBank + recordOffset + FLASH_LOG_RECORD_HEADER_SIZE + ( recordStart - recordAddr ),
+                         buffer + ( recordStart - addr ), recordEnd - recordStart );
+}
+
+LmnStatus_t FlashLogRead( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    FlashLogRecordHeader_t header;
+    uint32_t offset = FLASH_LOG_BANK_HEADER_SIZE;
+    uint32_t end = ( uint32_t )addr + size;
+
+    if( ( Driver == NULL ) || ( buffer == NULL ) )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memset1( buffer, 0xFF, size );
+
+    // Later records overwrite the earlier ones
+    if( IsIndexComplete == true )
+    {
+        // The index holds the valid records only, their CRC was checked once
+        for( uint8_t i = 0; i < IndexCnt; i++ )
+        {
+            if( ReadRecord( Index[i].Addr, Index[i].Size, Index[i].Offset, addr, buffer, size ) != LMN_STATUS_OK )
+            {
+                return LMN_STATUS_ERROR;
+            }
+        }
+        return LMN_STATUS_OK;
+    }
+    while( ( offset + FLASH_LOG_RECORD_HEADER_SIZE ) <= WriteOffset )
+    {
+        if( Driver->Read( ActiveBank + offset, ( uint8_t* )&header, sizeof( header ) ) != LMN_STATUS_OK )
+        {
+            return LMN_STATUS_ERROR;
+        }
+        if( ( IsHeaderErased( &header ) == true ) || ( ( offset + GetRecordLength( header.Size ) ) > WriteOffset ) )
+        {
+            break;
+        }
+        // Records altered since they were written are skipped, the earlier
+        // data is returned instead
+        if( ( header.Addr < end ) && ( ( ( uint32_t )header.Addr + header.Size ) > addr ) &&
+            ( IsRecordValid( ActiveBank + offset, &header ) == true ) )
+        {
+            if( ReadRecord( header.Addr, header.Size, offset, addr, buffer, size ) != LMN_STATUS_OK )
+            {
+                return LMN_STATUS_ERROR;
+            }
+        }
+        offset += GetRecordLength( header.Size );
+    }
+    return LMN_STATUS_OK;
+}
+
+uint32_t FlashLogGetEraseCount( void )
+{
+    return EraseCount;
+}
@@ -30,9 +30,14 @@
  *
  * \author    Johannes Bruder ( STACKFORCE )
  */
+#include <stddef.h>
+
 #include "utilities.h"
 #include "region/Region.h"
 #include "LoRaMacClassB.h"
+#include "LoRaMacTrace.h"
+#include "LoRaMacEnergy.h"
+#include "LoRaMacInstance.h"
 #include "LoRaMacCrypto.h"
 #include "secure-element.h"
 #include "LoRaMacTest.h"
@@ -83,6 +88,46 @@
  */
 #define ABP_JOIN_PENDING_DELAY_MS                   10
 
+/*!
+ * Margin added to the learned RX timing error [ms]. Covers the resolution of
+ * the timer and of the time on air computation.
+ */
+#define ADAPTIVE_RX_ERROR_MARGIN                    2
+
+/*!
+ * Decay of the learned RX timing error towards smaller measurements, as a
+ * power of two. The estimate moves by 1/8 of the difference per downlink.
+ */
+#define ADAPTIVE_RX_ERROR_DECAY_SHIFT               3
+
+/*!
+ * Class C downlinks preamble length [symbols]
+ */
+#define RXC_DUTY_CYCLE_PREAMBLE_SYMBOLS             8
+
+/*!
+ * Class C low-power listening reception period [symbols]. Minimum time the
+ * radio needs to detect a preamble.
+ */
+#define RXC_DUTY_CYCLE_RX_SYMBOLS                   2
+
+/*!
+ * MIB attribute can be read
+ */
+#define MIB_ACCESS_GET                              0x01
+
+/*!
+ * MIB attribute can be written
+ */
+#define MIB_ACCESS_SET                              0x02
+
+/*!
+ * Describes a MIB attribute directly mapped on the non-volatile data field
+ * \a member
+ */
+#define MIB_NVM_ATTRIBUTE( member, access )         { offsetof( LoRaMacNvmData_t, member ), \
+                                                      sizeof( ( ( LoRaMacNvmData_t* )0 )->member ), access }
+
 /*!
  * LoRaMac internal states
  */
@@ -108,6 +153,96 @@ typedef enum eLoRaMacRequestHandling
     LORAMAC_REQUEST_HANDLING_ON = !LORAMAC_REQUEST_HANDLING_OFF
 }LoRaMacRequestHandling_t;
 
+/*!
+ * Describes the secured uplink held in PktBuffer
+ */
+typedef struct sLoRaMacTxFrameCache
+{
+    /*!
+     * Set to true, if PktBuffer holds the secured PHY payload of TxMsg
+     */
+    bool Valid;
+    /*!
+     * Uplink frame counter used to secure the frame
+     */
+    uint32_t FCntUp;
+    /*!
+     * Datarate used to compute the MIC (LoRaWAN 1.1.x B1 block)
+     */
+    uint8_t Datarate;
+    /*!
+     * Channel used to compute the MIC (LoRaWAN 1.1.x B1 block)
+     */
+    uint8_t Channel;
+    /*!
+     * ACK bit of the secured frame
+     */
+    uint8_t Ack;
+}LoRaMacTxFrameCache_t;
+
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+/*!
+ * Queued MCPS-Request
+ */
+typedef struct sMcpsQueueItem
+{
+    /*!
+     * MCPS-Request. The payload buffer is set to Buffer on transmission
+     */
+    McpsReq_t Request;
+    /*!
+     * Copy of the application payload
+     */
+    uint8_t Buffer[LORAMAC_MCPS_QUEUE_MAX_PAYLOAD];
+    /*!
+     * Priority of the request
+     */
+    uint8_t Priority;
+    /*!
+     * Time the request has been queued
+     */
+    TimerTime_t QueuedTime;
+    /*!
+     * Maximum time the request waits in the queue. 0 for no limit
+     */
+    uint32_t Lifetime;
+}McpsQueueItem_t;
+#endif
+
+/*!
+ * MIB attribute mapped on a non-volatile data field
+ */
+typedef struct sMibNvmAttribute
+{
+    /*!
+     * Offset of the field in the non-volatile data
+     */
+    uint16_t Offset;
+    /*!
+     * Size of the field
+     */
+    uint8_t Size;
+    /*!
+     * Access rights. 0 when the attribute is not mapped
+     */
+    uint8_t Access;
+}MibNvmAttribute_t;
+
+/*!
+ * MIB attribute setting a key
+ */
+typedef struct sMibKey
+{
+    /*!
+     * MIB attribute
+     */
+    Mib_t Type;
+    /*!
+     * Key identifier
+     */
+    KeyIdentifier_t KeyID;
+}MibKey_t;
+
 typedef struct sLoRaMacCtx
 {
     /*
@@ -123,6 +258,10 @@ typedef struct sLoRaMacCtx
     */
     LoRaMacMessage_t TxMsg;
     /*!
+    * Secured uplink cache. Allows retransmissions to reuse PktBuffer
+    */
+    LoRaMacTxFrameCache_t TxFrameCache;
+    /*!
     * Buffer containing the data received by the application.
     */
     uint8_t AppData[LORAMAC_PHY_MAXPAYLOAD];
@@ -131,7 +270,8 @@ typedef struct sLoRaMacCtx
     */
     uint8_t AppDataSize;
     /*
-    * Buffer containing the upper layer data.
+    * Buffer containing the upper layer data received while the radio keeps
+    * receiving ( Class B and Class C ).
     */
     uint8_t RxPayload[LORAMAC_PHY_MAXPAYLOAD];
     SysTime_t LastTxSysTime;
@@ -266,16 +406,42 @@ typedef struct sLoRaMacCtx
      * Buffer containing the MAC layer commands
      */
     uint8_t MacCommandsBuffer[LORA_MAC_COMMAND_MAX_LENGTH];
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+    /*
+     * MCPS-Request queue, sorted by decreasing priority
+     */
+    McpsQueueItem_t McpsQueue[LORAMAC_MCPS_QUEUE_LEN];
+    /*
+     * Number of requests in the MCPS-Request queue
+     */
+    uint8_t McpsQueueCnt;
+    /*
+     * Timer retrying the MCPS-Request queue once the duty cycle allows it
+     */
+    TimerEvent_t McpsQueueTimer;
+#endif
+    /*
+     * Device side ADR strategy
+     */
+    const LoRaMacAdrStrategy_t* AdrStrategy;
+    /*
+     * Last datarate granted by a LinkADRReq, -1 if none
+     */
+    int8_t AdrGrantedDatarate;
+    /*
+     * Last TX power granted by a LinkADRReq, -1 if none
+     */
+    int8_t AdrGrantedTxPower;
 }LoRaMacCtx_t;
 
 /*
  * Module context.
  */
-static LoRaMacCtx_t MacCtx;
+static LoRaMacCtx_t LORAMAC_INSTANCE_STATE( MacCtx );
 
-static LoRaMacNvmData_t Nvm;
+static LoRaMacNvmData_t LORAMAC_INSTANCE_STATE( Nvm );
 
-static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
+static Band_t LORAMAC_INSTANCE_STATE( RegionBands )[REGION_NVM_MAX_NB_BANDS];
 
 /*!
  * Defines the LoRaMac radio events status
@@ -297,7 +463,16 @@ typedef union uLoRaMacRadioEvents
 /*!
  * LoRaMac radio events status
  */
-LoRaMacRadioEvents_t LoRaMacRadioEvents = { .Value = 0 };
+LoRaMacRadioEvents_t LORAMAC_INSTANCE_STATE( LoRaMacRadioEvents );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define MacCtx                                      LORAMAC_INSTANCE( MacCtx )
+#define Nvm                                         LORAMAC_INSTANCE( Nvm )
+#define RegionBands                                 LORAMAC_INSTANCE( RegionBands )
+#define LoRaMacRadioEvents                          LORAMAC_INSTANCE( LoRaMacRadioEvents )
+#define TxDoneParams                                LORAMAC_INSTANCE( TxDoneParams )
+#define RxDoneParams                                LORAMAC_INSTANCE( RxDoneParams )
+#endif
 
 /*!
  * \brief Function to be executed on Radio Tx Done event
@@ -361,11 +536,23 @@ static void OnRejoin1CycleTimerEvent( void* context );
  */
 static void OnForceRejoinReqCycleTimerEvent( void* context );
 
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+/*!
+ * \brief Function executed on MCPS-Request queue timer event
+ */
+static void OnMcpsQueueTimerEvent( void* context );
+#endif
+
 /*!
  * \brief Function executed on AckTimeout timer event
  */
 static void OnRetransmitTimeoutTimerEvent( void* context );
 
+/*!
+ * \brief Function executed on AbpJoinPendingTimer timer event
+ */
+static void OnAbpJoinPendingTimerEvent( void *context );
+
 /*!
  * Computes next 32 bit downlink counter value and determines the frame counter ID.
  *
@@ -468,6 +655,27 @@ LoRaMacStatus_t PrepareFrame( LoRaMacHeader_t* macHdr, LoRaMacFrameCtrl_t* fCtrl
  */
 static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx );
 
+/*!
+ * \brief Gets the timing error used to size the RX1 and RX2 windows
+ *
+ * \retval Timing error [ms]. SystemMaxRxError or, in adaptive mode, the
+ *         learned timing error when smaller.
+ */
+static uint32_t GetRxError( void );
+
+/*!
+ * \brief Updates the learned RX timing error with the arrival time of the
+ *        frame received in a class A window
+ *
+ * \param [IN] size Size of the received frame
+ */
+static void UpdateRxErrorEstimate( uint16_t size );
+
+/*!
+ * \brief Widens the learned RX timing error after a missed downlink
+ */
+static void WidenRxErrorEstimate( void );
+
 /*
  * \brief Secures the current processed frame ( TxMsg )
  * \param[IN]     txDr      Data rate used for the transmission
@@ -550,6 +758,15 @@ static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig );
  */
 static void OpenContinuousRxCWindow( void );
 
+/*!
+ * \brief Starts the Class C low-power listening on the current RxC configuration
+ *
+ * \param [IN] datarate RxC datarate
+ *
+ * \retval [true: low-power listening started, false: continuous reception is required]
+ */
+static bool StartRxCDutyCycle( int8_t datarate );
+
 /*!
  * \brief   Returns a pointer to the internal contexts structure.
  *
@@ -684,6 +901,13 @@ static void LoRaMacHandleMlmeRequest( void );
  */
 static void LoRaMacHandleMcpsRequest( void );
 
+/*!
+ * \brief Notifies a link quality event to the device side ADR strategy
+ *
+ * \param [IN] linkQuality Link quality event. The region is filled in.
+ */
+static void NotifyAdrLinkQuality( LoRaMacAdrLinkQuality_t* linkQuality );
+
 /*!
  * \brief This function handles callback events for requests
  */
@@ -694,6 +918,35 @@ static void LoRaMacHandleRequestEvents( void );
  */
 static void LoRaMacHandleIndicationEvents( void );
 
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+/*!
+ * \brief Sends the next queued MCPS-Request, if the MAC is idle
+ */
+static void LoRaMacHandleMcpsQueue( void );
+
+/*!
+ * \brief Gets the application payload fields of a MCPS-Request
+ *
+ * \param [IN] request MCPS-Request
+ *
+ * \param [OUT] buffer Payload buffer field of the request
+ *
+ * \param [OUT] bufferSize Payload size field of the request
+ *
+ * \retval True, if the request type is valid
+ */
+static bool GetMcpsRequestPayload( McpsReq_t* request, void*** buffer, uint16_t** bufferSize );
+
+/*!
+ * \brief Removes the head of the MCPS-Request queue. Notifies the
+ *        application with a MCPS-Confirm, if status is not
+ *        LORAMAC_EVENT_INFO_STATUS_OK.
+ *
+ * \param [IN] status Status of the removed request
+ */
+static void McpsQueueRemoveHead( LoRaMacEventInfoStatus_t status );
+#endif
+
 /*!
  * \brief This function handles events for re-join procedure
  */
@@ -706,6 +959,44 @@ static void LoRaMacHandleRejoinEvents( void );
  */
 static void LoRaMacHandleNvm( LoRaMacNvmData_t* nvmData );
 
+/*!
+ * \brief Gets the descriptor of a MIB attribute mapped on a non-volatile data field
+ *
+ * \param [IN] type MIB attribute
+ *
+ * \param [IN] access Requested access rights
+ *
+ * \retval Attribute descriptor, NULL if the attribute is not mapped or lacks the access rights
+ */
+static const MibNvmAttribute_t* GetMibNvmAttribute( Mib_t type, uint8_t access );
+
+/*!
+ * \brief Gets the descriptor of a MIB attribute setting a key
+ *
+ * \param [IN] type MIB attribute
+ *
+ * \retval Key descriptor, NULL if the attribute doesn't set a key
+ */
+static const MibKey_t* GetMibKey( Mib_t type );
+
+/*!
+ * \brief Verifies a MIB set request without applying it
+ *
+ * \param [IN] mibSet MIB set request
+ *
+ * \retval Status of the operation
+ */
+static LoRaMacStatus_t VerifyMibSet( MibRequestConfirm_t* mibSet );
+
+/*!
+ * \brief Applies a verified MIB set request
+ *
+ * \param [IN] mibSet MIB set request
+ *
+ * \retval Status of the operation
+ */
+static LoRaMacStatus_t SetMibRequest( MibRequestConfirm_t* mibSet );
+
 /*!
  * \brief This function verifies if the response timeout has been elapsed. If
  *        this is the case, the status of Nvm.MacGroup1.SrvAckRequested will be
@@ -727,7 +1018,8 @@ static bool LoRaMacHandleResponseTimeout( TimerTime_t timeoutInMs, TimerTime_t s
 struct
 {
     TimerTime_t CurTime;
-}TxDoneParams;
+    uint32_t CurTicks;
+}LORAMAC_INSTANCE_STATE( TxDoneParams );
 
 /*!
  * Structure used to store the radio Rx event data
@@ -739,12 +1031,33 @@ struct
     uint16_t Size;
     int16_t Rssi;
     int8_t Snr;
-}RxDoneParams;
+}LORAMAC_INSTANCE_STATE( RxDoneParams );
+
+/*!
+ * \brief Gets the time of the radio IRQ which notified the current event
+ *
+ * \remark Radios notifying the events from the main loop provide the time of
+ *         the DIO IRQ. The other radios notify the events from the DIO IRQ.
+ *
+ * \retval ticks Time of the radio IRQ [RTC ticks]
+ */
+static uint32_t GetRadioEventTicks( void )
+{
+    if( Radio.GetIrqTimestamp != NULL )
+    {
+        return Radio.GetIrqTimestamp( );
+    }
+    return TimerGetCurrentTicks( );
+}
 
 static void OnRadioTxDone( void )
 {
-    TxDoneParams.CurTime = TimerGetCurrentTime( );
-    MacCtx.LastTxSysTime = SysTimeGet( );
+    TxDoneParams.CurTicks = GetRadioEventTicks( );
+    TxDoneParams.CurTime = TimerTicks2Time( TxDoneParams.CurTicks );
+
+    // Remove the radio IRQ processing latency from the system time
+    TimerTime_t latency = TimerTicks2Time( TimerGetCurrentTicks( ) - TxDoneParams.CurTicks );
+    MacCtx.LastTxSysTime = SysTimeSub( SysTimeGet( ), ( SysTime_t ){ .Seconds = latency / 1000, .SubSeconds = latency % 1000 } );
 
     LoRaMacRadioEvents.Events.TxDone = 1;
 
@@ -753,7 +1066,7 @@ static void OnRadioTxDone( void )
 
 static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
 {
-    RxDoneParams.LastRxDone = TimerGetCurrentTime( );
+    RxDoneParams.LastRxDone = TimerTicks2Time( GetRadioEventTicks( ) );
     RxDoneParams.Payload = payload;
     RxDoneParams.Size = size;
     RxDoneParams.Rssi = rssi;
@@ -809,9 +1122,11 @@ static void ProcessRadioTxDone( void )
         Radio.Sleep( );
     }
 
+    LORAMAC_ENERGY_ADD_TX( Nvm.MacGroup1.ChannelsTxPower, MacCtx.TxTimeOnAir );
+
     // Setup timers
     CRITICAL_SECTION_BEGIN( );
-    uint32_t offset = TimerGetCurrentTime( ) - TxDoneParams.CurTime;
+    uint32_t offset = TimerTicks2Time( TimerGetCurrentTicks( ) - TxDoneParams.CurTicks );
     TimerSetValue( &MacCtx.RxWindowTimer1, MacCtx.RxWindow1Delay - offset );
     TimerStart( &MacCtx.RxWindowTimer1 );
     TimerSetValue( &MacCtx.RxWindowTimer2, MacCtx.RxWindow2Delay - offset );
@@ -887,8 +1202,10 @@ static void ProcessRadioRxDone( void )
     FCntIdentifier_t fCntID;
     uint8_t macCmdPayload[2] = { 0 };
     Mlme_t joinType = MLME_JOIN;
+    LoRaMacAdrLinkQuality_t linkQuality;
 
     LoRaMacRadioEvents.Events.RxProcessPending = 0;
+    LORAMAC_ENERGY_RX_STOP( RxDoneParams.LastRxDone );
 
     MacCtx.McpsConfirm.AckReceived = false;
     MacCtx.McpsIndication.Rssi = rssi;
@@ -906,6 +1223,7 @@ static void ProcessRadioRxDone( void )
     MacCtx.McpsIndication.DevAddress = 0;
     MacCtx.McpsIndication.DeviceTimeAnsReceived = false;
     MacCtx.McpsIndication.ResponseTimeout = 0;
+    MacCtx.McpsIndication.RxDoneTime = RxDoneParams.LastRxDone;
 
     Radio.Sleep( );
 
@@ -977,6 +1295,7 @@ static void ProcessRadioRxDone( void )
                 PrepareRxDoneAbort( );
                 return;
             }
+            LORAMAC_ENERGY_ADD_SE_OP( );
             macCryptoStatus = LoRaMacCryptoHandleJoinAccept( JOIN_REQ, SecureElementGetJoinEui( ), &macMsgJoinAccept );
 
             if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
@@ -1067,6 +1386,10 @@ static void ProcessRadioRxDone( void )
 
                 Nvm.MacGroup2.NetworkActivation = ACTIVATION_TYPE_OTAA;
 
+                // The link quality of the previous session doesn't apply anymore
+                linkQuality.Event = LORAMAC_ADR_LINK_JOIN;
+                NotifyAdrLinkQuality( &linkQuality );
+
                 // Add a RekeyInd MAC command to confirm the security key update.
                 if( Nvm.MacGroup2.Version.Fields.Minor >= 1 )
                 {
@@ -1081,6 +1404,8 @@ static void ProcessRadioRxDone( void )
                     LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, joinType );
                 }
 
+                UpdateRxErrorEstimate( size );
+
                 // Rejoin handling
                 if( Nvm.MacGroup2.IsRejoinAcceptPending == true )
                 {
@@ -1124,8 +1449,20 @@ static void ProcessRadioRxDone( void )
             }
             macMsgData.Buffer = payload;
             macMsgData.BufSize = size;
-            macMsgData.FRMPayload = MacCtx.RxPayload;
-            macMsgData.FRMPayloadSize = LORAMAC_PHY_MAXPAYLOAD;
+            if( Nvm.MacGroup2.DeviceClass == CLASS_A )
+            {
+                // The radio is idle until the next uplink: the frame payload
+                // is decrypted in place inside the radio buffer.
+                macMsgData.FRMPayload = NULL;
+                macMsgData.FRMPayloadSize = 0;
+            }
+            else
+            {
+                // The radio keeps receiving and may overwrite its buffer
+                // before the indication is delivered.
+                macMsgData.FRMPayload = MacCtx.RxPayload;
+                macMsgData.FRMPayloadSize = LORAMAC_PHY_MAXPAYLOAD;
+            }
 
             if( LORAMAC_PARSER_SUCCESS != LoRaMacParserData( &macMsgData ) )
             {
@@ -1228,7 +1565,10 @@ static void ProcessRadioRxDone( void )
                 }
             }
 
+            LORAMAC_ENERGY_ADD_SE_OP( );
+            LORAMAC_TRACE_BEGIN( traceStart );
             macCryptoStatus = LoRaMacCryptoUnsecureMessage( addrID, address, fCntID, downLinkCounter, &macMsgData );
+            LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_UNSECURE_MESSAGE, traceStart );
             if( macCryptoStatus != LORAMAC_CRYPTO_SUCCESS )
             {
                 if( macCryptoStatus == LORAMAC_CRYPTO_FAIL_ADDRESS )
@@ -1261,6 +1601,15 @@ static void ProcessRadioRxDone( void )
             {
                 Nvm.MacGroup1.AdrAckCounter = 0;
                 Nvm.MacGroup2.DownlinkReceived = true;
+
+                if( multicast == 0 )
+                {
+                    linkQuality.Event = LORAMAC_ADR_LINK_DOWNLINK;
+                    linkQuality.Datarate = MacCtx.McpsIndication.RxDatarate;
+                    linkQuality.Snr = snr;
+                    linkQuality.Rssi = rssi;
+                    NotifyAdrLinkQuality( &linkQuality );
+                }
             }
 
             // MCPS Indication and ack requested handling
@@ -1393,17 +1742,25 @@ static void ProcessRadioRxDone( void )
                 MacCtx.McpsIndication.RxData = false;
             }
 
+            UpdateRxErrorEstimate( size );
+
             // Provide always an indication, skip the callback to the user application,
             // in case of a confirmed downlink retransmission.
             MacCtx.MacFlags.Bits.McpsInd = 1;
 
             break;
         case FRAME_TYPE_PROPRIETARY:
-            memcpy1( MacCtx.RxPayload, &payload[pktHeaderLen], size - pktHeaderLen );
-
             MacCtx.McpsIndication.McpsIndication = MCPS_PROPRIETARY;
             MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_OK;
-            MacCtx.McpsIndication.Buffer = MacCtx.RxPayload;
+            if( Nvm.MacGroup2.DeviceClass == CLASS_A )
+            {
+                MacCtx.McpsIndication.Buffer = &payload[pktHeaderLen];
+            }
+            else
+            {
+                memcpy1( MacCtx.RxPayload, &payload[pktHeaderLen], size - pktHeaderLen );
+                MacCtx.McpsIndication.Buffer = MacCtx.RxPayload;
+            }
             MacCtx.McpsIndication.BufferSize = size - pktHeaderLen;
 
             MacCtx.MacFlags.Bits.McpsInd = 1;
@@ -1506,6 +1863,12 @@ static void HandleRadioRxErrorTimeout( LoRaMacEventInfoStatus_t rx1EventInfoStat
             {
                 MacCtx.McpsConfirm.Status = rx2EventInfoStatus;
             }
+            if( ( rx2EventInfoStatus == LORAMAC_EVENT_INFO_STATUS_RX2_TIMEOUT ) &&
+                ( ( MacCtx.NodeAckRequested == true ) || ( MacCtx.TxMsg.Type != LORAMAC_MSG_TYPE_DATA ) ) )
+            {
+                // An expected downlink was not received in any window
+                WidenRxErrorEstimate( );
+            }
             LoRaMacConfirmQueueSetStatusCmn( rx2EventInfoStatus );
             MacCtx.MacFlags.Bits.MacDone = 1;
         }
@@ -1516,11 +1879,13 @@ static void HandleRadioRxErrorTimeout( LoRaMacEventInfoStatus_t rx1EventInfoStat
 
 static void ProcessRadioRxError( void )
 {
+    LORAMAC_ENERGY_RX_STOP( TimerGetCurrentTime( ) );
     HandleRadioRxErrorTimeout( LORAMAC_EVENT_INFO_STATUS_RX1_ERROR, LORAMAC_EVENT_INFO_STATUS_RX2_ERROR );
 }
 
 static void ProcessRadioRxTimeout( void )
 {
+    LORAMAC_ENERGY_RX_STOP( TimerGetCurrentTime( ) );
     HandleRadioRxErrorTimeout( LORAMAC_EVENT_INFO_STATUS_RX1_TIMEOUT, LORAMAC_EVENT_INFO_STATUS_RX2_TIMEOUT );
 }
 
@@ -1541,7 +1906,9 @@ static void LoRaMacHandleIrqEvents( void )
         }
         if( events.Events.RxDone == 1 )
         {
+            LORAMAC_TRACE_BEGIN( traceStart );
             ProcessRadioRxDone( );
+            LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_PROCESS_RADIO_RX_DONE, traceStart );
         }
         if( events.Events.TxTimeout == 1 )
         {
@@ -1682,6 +2049,119 @@ static void LoRaMacHandleRejoinEvents( void )
     }
 }
 
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+static bool GetMcpsRequestPayload( McpsReq_t* request, void*** buffer, uint16_t** bufferSize )
+{
+    switch( request->Type )
+    {
+        case MCPS_UNCONFIRMED:
+        {
+            *buffer = &request->Req.Unconfirmed.fBuffer;
+            *bufferSize = &request->Req.Unconfirmed.fBufferSize;
+            return true;
+        }
+        case MCPS_CONFIRMED:
+        {
+            *buffer = &request->Req.Confirmed.fBuffer;
+            *bufferSize = &request->Req.Confirmed.fBufferSize;
+            return true;
+        }
+        case MCPS_PROPRIETARY:
+        {
+            *buffer = &request->Req.Proprietary.fBuffer;
+            *bufferSize = &request->Req.Proprietary.fBufferSize;
+            return true;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+static void McpsQueueRemoveHead( LoRaMacEventInfoStatus_t status )
+{
+    McpsConfirm_t mcpsConfirm;
+
+    memset1( ( uint8_t* ) &mcpsConfirm, 0, sizeof( mcpsConfirm ) );
+    mcpsConfirm.McpsRequest = MacCtx.McpsQueue[0].Request.Type;
+    mcpsConfirm.Status = status;
+    mcpsConfirm.Datarate = Nvm.MacGroup1.ChannelsDatarate;
+
+    MacCtx.McpsQueueCnt--;
+    for( uint8_t i = 0; i < MacCtx.McpsQueueCnt; i++ )
+    {
+        MacCtx.McpsQueue[i] = MacCtx.McpsQueue[i + 1];
+    }
+
+    // The queue is consistent before the callback, which may queue new requests.
+    // The caller only drops requests while no uplink is in flight and the
+    // confirm of the uplinks, held by MacCtx.McpsConfirm, is left untouched.
+    if( status != LORAMAC_EVENT_INFO_STATUS_OK )
+    {
+        MacCtx.MacPrimitives->MacMcpsConfirm( &mcpsConfirm );
+    }
+}
+
+static void LoRaMacHandleMcpsQueue( void )
+{
+    while( MacCtx.McpsQueueCnt > 0 )
+    {
+        McpsQueueItem_t* item = &MacCtx.McpsQueue[0];
+        void** buffer;
+        uint16_t* bufferSize;
+        LoRaMacStatus_t status;
+
+        if( ( MacCtx.MacState == LORAMAC_STOPPED ) || ( LoRaMacIsBusy( ) == true ) ||
+            ( TimerIsStarted( &MacCtx.McpsQueueTimer ) == true ) )
+        {
+            return;
+        }
+
+        if( ( item->Lifetime != 0 ) && ( TimerGetElapsedTime( item->QueuedTime ) > item->Lifetime ) )
+        {
+            McpsQueueRemoveHead( LORAMAC_EVENT_INFO_STATUS_TX_EXPIRED );
+            continue;
+        }
+
+        // Items are moved inside the queue. Point the request to the payload copy of its current slot.
+        GetMcpsRequestPayload( &item->Request, &buffer, &bufferSize );
+        *buffer = item->Buffer;
+
+        status = LoRaMacMcpsRequest( &item->Request );
+        switch( status )
+        {
+            case LORAMAC_STATUS_OK:
+            {
+                // The payload has been copied by the MAC. The request is confirmed by the MCPS-Confirm of the uplink.
+                McpsQueueRemoveHead( LORAMAC_EVENT_INFO_STATUS_OK );
+                return;
+            }
+            case LORAMAC_STATUS_DUTYCYCLE_RESTRICTED:
+            {
+                // Retry when the duty cycle allows it
+                TimerSetValue( &MacCtx.McpsQueueTimer, item->Request.ReqReturn.DutyCycleWaitTime );
+                TimerStart( &MacCtx.McpsQueueTimer );
+                return;
+            }
+            case LORAMAC_STATUS_BUSY:
+            case LORAMAC_STATUS_BUSY_BEACON_RESERVED_TIME:
+            case LORAMAC_STATUS_BUSY_PING_SLOT_WINDOW_TIME:
+            case LORAMAC_STATUS_BUSY_UPLINK_COLLISION:
+            {
+                // Retry on the next MAC processing
+                return;
+            }
+            default:
+            {
+                McpsQueueRemoveHead( LORAMAC_EVENT_INFO_STATUS_ERROR );
+                break;
+            }
+        }
+    }
+}
+#endif
+
 static void LoRaMacHandleMcpsRequest( void )
 {
     // Handle MCPS uplinks
@@ -1712,6 +2192,17 @@ static void LoRaMacHandleMcpsRequest( void )
             TimerStop( &MacCtx.TxDelayedTimer );
             MacCtx.MacState &= ~LORAMAC_TX_DELAYED;
             StopRetransmission( );
+
+            if( MacCtx.McpsConfirm.McpsRequest == MCPS_CONFIRMED )
+            {
+                LoRaMacAdrLinkQuality_t linkQuality;
+
+                linkQuality.Event = LORAMAC_ADR_LINK_ACK;
+                linkQuality.Datarate = MacCtx.McpsConfirm.Datarate;
+                linkQuality.TxPower = MacCtx.McpsConfirm.TxPower;
+                linkQuality.AckReceived = MacCtx.McpsConfirm.AckReceived;
+                NotifyAdrLinkQuality( &linkQuality );
+            }
         }
         else if( waitForRetransmission == false )
         {// Arrange further retransmission
@@ -1724,6 +2215,15 @@ static void LoRaMacHandleMcpsRequest( void )
     }
 }
 
+static void NotifyAdrLinkQuality( LoRaMacAdrLinkQuality_t* linkQuality )
+{
+    if( ( MacCtx.AdrStrategy != NULL ) && ( MacCtx.AdrStrategy->OnLinkQuality != NULL ) )
+    {
+        linkQuality->Region = Nvm.MacGroup2.Region;
+        MacCtx.AdrStrategy->OnLinkQuality( linkQuality );
+    }
+}
+
 static void LoRaMacHandleMlmeRequest( void )
 {
     // Handle join request
@@ -1898,6 +2398,9 @@ void LoRaMacProcess( void )
     }
     LoRaMacHandleIndicationEvents( );
     LoRaMacHandleRejoinEvents( );
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+    LoRaMacHandleMcpsQueue( );
+#endif
 
     if( MacCtx.RxSlot == RX_SLOT_WIN_CLASS_C )
     {
@@ -1906,12 +2409,16 @@ void LoRaMacProcess( void )
     if( MacCtx.MacFlags.Bits.NvmHandle == 1 )
     {
         MacCtx.MacFlags.Bits.NvmHandle = 0;
+        LORAMAC_TRACE_BEGIN( traceStart );
         LoRaMacHandleNvm( &Nvm );
+        LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_HANDLE_NVM, traceStart );
     }
 }
 
 static void OnTxDelayedTimerEvent( void* context )
 {
+    LoRaMacStatus_t status = LORAMAC_STATUS_OK;
+
     TimerStop( &MacCtx.TxDelayedTimer );
     MacCtx.MacState &= ~LORAMAC_TX_DELAYED;
 
@@ -1923,7 +2430,11 @@ static void OnTxDelayedTimerEvent( void* context )
     }
 
     // Schedule frame, allow delayed frame transmissions
-    switch( ScheduleTx( true ) )
+    LORAMAC_TRACE_BEGIN( traceStart );
+    status = ScheduleTx( true );
+    LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_SCHEDULE_TX, traceStart );
+
+    switch( status )
     {
         case LORAMAC_STATUS_OK:
         case LORAMAC_STATUS_DUTYCYCLE_RESTRICTED:
@@ -2208,9 +2719,17 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
             {
                 if( LoRaMacConfirmQueueIsCmdActive( MLME_LINK_CHECK ) == true )
                 {
+                    LoRaMacAdrLinkQuality_t linkQuality;
+
                     LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_LINK_CHECK );
                     MacCtx.MlmeConfirm.DemodMargin = payload[macIndex++];
                     MacCtx.MlmeConfirm.NbGateways = payload[macIndex++];
+
+                    linkQuality.Event = LORAMAC_ADR_LINK_CHECK;
+                    linkQuality.Datarate = MacCtx.McpsConfirm.Datarate;
+                    linkQuality.TxPower = MacCtx.McpsConfirm.TxPower;
+                    linkQuality.Margin = MacCtx.MlmeConfirm.DemodMargin;
+                    NotifyAdrLinkQuality( &linkQuality );
                 }
                 break;
             }
@@ -2274,6 +2793,12 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                             Nvm.MacGroup1.ChannelsDatarate = linkAdrDatarate;
                             Nvm.MacGroup1.ChannelsTxPower = linkAdrTxPower;
                             Nvm.MacGroup2.MacParams.ChannelsNbTrans = linkAdrNbRep;
+
+                            if( Nvm.MacGroup2.AdrCtrlOn == true )
+                            {
+                                MacCtx.AdrGrantedDatarate = linkAdrDatarate;
+                                MacCtx.AdrGrantedTxPower = linkAdrTxPower;
+                            }
                         }
 
                         // Add the answers to the buffer
@@ -2586,8 +3111,8 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                     sysTimeCurrent = SysTimeGet( );
                     sysTime = SysTimeAdd( sysTimeCurrent, SysTimeSub( sysTime, MacCtx.LastTxSysTime ) );
 
-                    // Apply the new system time.
-                    SysTimeSet( sysTime );
+                    // Apply the new system time. Successive answers track the clock drift.
+                    SysTimeSync( sysTime );
                     LoRaMacClassBDeviceTimeAns( );
                     MacCtx.McpsIndication.DeviceTimeAnsReceived = true;
                 }
@@ -2722,6 +3247,9 @@ LoRaMacStatus_t Send( LoRaMacHeader_t* macHdr, uint8_t fPort, void* fBuffer, uin
     adrNext.NbTrans = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
     adrNext.UplinkDwellTime =  Nvm.MacGroup2.MacParams.UplinkDwellTime;
     adrNext.Region = Nvm.MacGroup2.Region;
+    adrNext.GrantedDatarate = MacCtx.AdrGrantedDatarate;
+    adrNext.GrantedTxPower = MacCtx.AdrGrantedTxPower;
+    adrNext.Strategy = MacCtx.AdrStrategy;
 
     fCtrl.Bits.AdrAckReq = LoRaMacAdrCalcNext( &adrNext, &Nvm.MacGroup1.ChannelsDatarate,
                                                &Nvm.MacGroup1.ChannelsTxPower,
@@ -2734,7 +3262,9 @@ LoRaMacStatus_t Send( LoRaMacHeader_t* macHdr, uint8_t fPort, void* fBuffer, uin
     if( ( status == LORAMAC_STATUS_OK ) || ( status == LORAMAC_STATUS_SKIPPED_APP_DATA ) )
     {
         // Schedule frame, do not allow delayed transmissions
+        LORAMAC_TRACE_BEGIN( traceStart );
         status = ScheduleTx( false );
+        LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_SCHEDULE_TX, traceStart );
     }
 
     // Post processing
@@ -2766,6 +3296,8 @@ LoRaMacStatus_t SendReJoinReq( JoinReqIdentifier_t joinReqType )
     macHdr.Value = 0;
     bool allowDelayedTx = true;
 
+    MacCtx.TxFrameCache.Valid = false;
+
     // Setup join/rejoin message
     switch( joinReqType )
     {
@@ -2850,7 +3382,9 @@ LoRaMacStatus_t SendReJoinReq( JoinReqIdentifier_t joinReqType )
     }
 
     // Schedule frame
+    LORAMAC_TRACE_BEGIN( traceStart );
     status = ScheduleTx( allowDelayedTx );
+    LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_SCHEDULE_TX, traceStart );
     return status;
 }
 
@@ -2875,6 +3409,91 @@ static LoRaMacStatus_t CheckForClassBCollision( void )
     return LORAMAC_STATUS_OK;
 }
 
+static uint32_t GetRxError( void )
+{
+    uint32_t rxError = Nvm.MacGroup2.MacParams.SystemMaxRxError;
+
+    if( ( Nvm.MacGroup2.AdaptiveRxErrorOn == true ) && ( Nvm.MacGroup1.RxErrorEstimate != 0 ) )
+    {
+        rxError = MIN( rxError, ( ( Nvm.MacGroup1.RxErrorEstimate + 999 ) / 1000 ) + ADAPTIVE_RX_ERROR_MARGIN );
+    }
+    return rxError;
+}
+
+static void UpdateRxErrorEstimate( uint16_t size )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    uint32_t spreadingFactor = 0;
+    uint32_t bandwidth = 0;
+    uint32_t rxDelay = 0;
+    uint32_t rxErrorInUs = 0;
+    int32_t rxError = 0;
+
+    if( Nvm.MacGroup2.AdaptiveRxErrorOn == false )
+    {
+        return;
+    }
+
+    // Expected start of the downlink preamble
+    if( MacCtx.McpsIndication.RxSlot == RX_SLOT_WIN_1 )
+    {
+        rxDelay = ( MacCtx.TxMsg.Type == LORAMAC_MSG_TYPE_DATA ) ? Nvm.MacGroup2.MacParams.ReceiveDelay1 :
+                                                                   Nvm.MacGroup2.MacParams.JoinAcceptDelay1;
+    }
+    else if( MacCtx.McpsIndication.RxSlot == RX_SLOT_WIN_2 )
+    {
+        rxDelay = ( MacCtx.TxMsg.Type == LORAMAC_MSG_TYPE_DATA ) ? Nvm.MacGroup2.MacParams.ReceiveDelay2 :
+                                                                   Nvm.MacGroup2.MacParams.JoinAcceptDelay2;
+    }
+    else
+    {
+        // Only class A windows have a known downlink start time
+        return;
+    }
+
+    getPhy.Attribute = PHY_SF_FROM_DR;
+    getPhy.Datarate = MacCtx.McpsIndication.RxDatarate;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    spreadingFactor = phyParam.Value;
+
+    if( ( spreadingFactor < 5 ) || ( spreadingFactor > 12 ) )
+    {
+        // Not a LoRa datarate
+        return;
+    }
+
+    getPhy.Attribute = PHY_BW_FROM_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    bandwidth = phyParam.Value;
+
+    // Downlinks use 8 preamble symbols, an explicit header and no payload CRC
+    rxError = ( int32_t )( RxDoneParams.LastRxDone - Nvm.MacGroup1.LastTxDoneTime - rxDelay -
+                           Radio.TimeOnAir( MODEM_LORA, bandwidth, spreadingFactor, 1, 8, false, size, false ) );
+    rxErrorInUs = ( uint32_t )( ( rxError < 0 ) ? -rxError : rxError ) * 1000;
+
+    if( rxErrorInUs >= Nvm.MacGroup1.RxErrorEstimate )
+    {
+        Nvm.MacGroup1.RxErrorEstimate = rxErrorInUs;
+    }
+    else
+    {
+        Nvm.MacGroup1.RxErrorEstimate -= ( Nvm.MacGroup1.RxErrorEstimate - rxErrorInUs ) >> ADAPTIVE_RX_ERROR_DECAY_SHIFT;
+    }
+    // Zero means no measurement available
+    Nvm.MacGroup1.RxErrorEstimate = MAX( Nvm.MacGroup1.RxErrorEstimate, 1 );
+}
+
+static void WidenRxErrorEstimate( void )
+{
+    if( ( Nvm.MacGroup2.AdaptiveRxErrorOn == false ) || ( Nvm.MacGroup1.RxErrorEstimate == 0 ) )
+    {
+        return;
+    }
+    Nvm.MacGroup1.RxErrorEstimate = MIN( ( Nvm.MacGroup1.RxErrorEstimate * 2 ) + 1000,
+                                         Nvm.MacGroup2.MacParams.SystemMaxRxError * 1000 );
+}
+
 static void ComputeRxWindowParameters( void )
 {
     // Compute Rx1 windows parameters
@@ -2884,13 +3503,13 @@ static void ComputeRxWindowParameters( void )
                                                           Nvm.MacGroup1.ChannelsDatarate,
                                                           Nvm.MacGroup2.MacParams.Rx1DrOffset ),
                                      Nvm.MacGroup2.MacParams.MinRxSymbols,
-                                     Nvm.MacGroup2.MacParams.SystemMaxRxError,
+                                     GetRxError( ),
                                      &MacCtx.RxWindow1Config );
     // Compute Rx2 windows parameters
     RegionComputeRxWindowParameters( Nvm.MacGroup2.Region,
                                      Nvm.MacGroup2.MacParams.Rx2Channel.Datarate,
                                      Nvm.MacGroup2.MacParams.MinRxSymbols,
-                                     Nvm.MacGroup2.MacParams.SystemMaxRxError,
+                                     GetRxError( ),
                                      &MacCtx.RxWindow2Config );
 
     // Default setup, in case the device joined
@@ -2969,6 +3588,63 @@ static LoRaMacStatus_t SerializeTxFrame( void )
     return LORAMAC_STATUS_OK;
 }
 
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+/*!
+ * \brief Selects the energy ledger entry of the frame to be sent
+ */
+static void SelectEnergyLedgerEntry( void )
+{
+    switch( MacCtx.TxMsg.Type )
+    {
+        case LORAMAC_MSG_TYPE_JOIN_REQUEST:
+        case LORAMAC_MSG_TYPE_RE_JOIN_1:
+        case LORAMAC_MSG_TYPE_RE_JOIN_0_2:
+            LoRaMacEnergySelect( 0, LORAMAC_ENERGY_MSG_JOIN );
+            break;
+        case LORAMAC_MSG_TYPE_DATA:
+            LoRaMacEnergySelect( ( MacCtx.TxMsg.Message.Data.FRMPayloadSize > 0 ) ? MacCtx.TxMsg.Message.Data.FPort : 0,
+                                 ( MacCtx.TxMsg.Message.Data.MHDR.Bits.MType == FRAME_TYPE_DATA_CONFIRMED_UP ) ?
+                                 LORAMAC_ENERGY_MSG_CONFIRMED : LORAMAC_ENERGY_MSG_UNCONFIRMED );
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+ * \brief Gets the listen before talk carrier sense time spent so far
+ *
+ * \retval time Carrier sense time [ms]. 0 if the region doesn't perform
+ *              listen before talk
+ */
+static TimerTime_t GetLbtCarrierSenseTime( void )
+{
+    TimerTime_t time = 0;
+#if defined( REGION_KR920 ) || defined( REGION_AS923 )
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    LbtChannelStats_t* stats;
+    uint8_t nbChannels;
+
+    getPhy.Attribute = PHY_LBT_CHANNEL_STATS;
+    stats = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy ).LbtChannelStats;
+    if( stats == NULL )
+    {
+        return 0;
+    }
+    getPhy.Attribute = PHY_MAX_NB_CHANNELS;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    nbChannels = phyParam.Value;
+
+    for( uint8_t i = 0; i < nbChannels; i++ )
+    {
+        time += stats[i].NbCarrierSense * Nvm.RegionGroup2.CarrierSenseTime;
+    }
+#endif
+    return time;
+}
+#endif
+
 static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
 {
     LoRaMacStatus_t status = LORAMAC_STATUS_PARAMETER_INVALID;
@@ -2984,11 +3660,15 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     // Update back-off
     CalculateBackOff( );
 
-    // Serialize frame
-    status = SerializeTxFrame( );
-    if( status != LORAMAC_STATUS_OK )
+    // Serialize frame. Retransmissions of a secured uplink keep the
+    // PHY payload already stored in PktBuffer.
+    if( MacCtx.TxFrameCache.Valid == false )
     {
-        return status;
+        status = SerializeTxFrame( );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            return status;
+        }
     }
 
     nextChan.AggrTimeOff = Nvm.MacGroup1.AggregatedTimeOff;
@@ -3007,8 +3687,16 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
         nextChan.Joined = false;
     }
 
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+    SelectEnergyLedgerEntry( );
+    TimerTime_t lbtTime = GetLbtCarrierSenseTime( );
+#endif
+
     // Select channel
+    LORAMAC_TRACE_BEGIN( traceStart );
     status = RegionNextChannel( Nvm.MacGroup2.Region, &nextChan, &MacCtx.Channel, &MacCtx.DutyCycleWaitTime, &Nvm.MacGroup1.AggregatedTimeOff );
+    LORAMAC_TRACE_END( LORAMAC_TRACE_SITE_NEXT_CHANNEL, traceStart );
+    LORAMAC_ENERGY_ADD_LBT( GetLbtCarrierSenseTime( ) - lbtTime );
 
     if( status != LORAMAC_STATUS_OK )
     {
@@ -3053,10 +3741,13 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh )
 {
     LoRaMacCryptoStatus_t macCryptoStatus = LORAMAC_CRYPTO_ERROR;
     uint32_t fCntUp = 0;
+    uint8_t cacheDr = txDr;
+    uint8_t cacheCh = txCh;
 
     switch( MacCtx.TxMsg.Type )
     {
         case LORAMAC_MSG_TYPE_JOIN_REQUEST:
+            LORAMAC_ENERGY_ADD_SE_OP( );
             macCryptoStatus = LoRaMacCryptoPrepareJoinRequest( &MacCtx.TxMsg.Message.JoinReq );
             if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
             {
@@ -3065,6 +3756,7 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh )
             MacCtx.PktBufferLen = MacCtx.TxMsg.Message.JoinReq.BufSize;
             break;
         case LORAMAC_MSG_TYPE_RE_JOIN_1:
+            LORAMAC_ENERGY_ADD_SE_OP( );
             macCryptoStatus = LoRaMacCryptoPrepareReJoinType1( &MacCtx.TxMsg.Message.ReJoin1 );
             if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
             {
@@ -3073,6 +3765,7 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh )
             MacCtx.PktBufferLen = MacCtx.TxMsg.Message.ReJoin1.BufSize;
             break;
         case LORAMAC_MSG_TYPE_RE_JOIN_0_2:
+            LORAMAC_ENERGY_ADD_SE_OP( );
             macCryptoStatus = LoRaMacCryptoPrepareReJoinType0or2( &MacCtx.TxMsg.Message.ReJoin0or2 );
             if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
             {
@@ -3092,12 +3785,38 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh )
                 fCntUp -= 1;
             }
 
+            if( Nvm.MacGroup2.Version.Fields.Minor == 0 )
+            {
+                // LoRaWAN 1.0.x MIC does not depend on the datarate and the channel
+                cacheDr = 0;
+                cacheCh = 0;
+            }
+
+            if( ( MacCtx.TxFrameCache.Valid == true ) &&
+                ( MacCtx.TxFrameCache.FCntUp == fCntUp ) &&
+                ( MacCtx.TxFrameCache.Datarate == cacheDr ) &&
+                ( MacCtx.TxFrameCache.Channel == cacheCh ) &&
+                ( MacCtx.TxFrameCache.Ack == MacCtx.TxMsg.Message.Data.FHDR.FCtrl.Bits.Ack ) )
+            {
+                // PktBuffer already holds the secured frame
+                MacCtx.PktBufferLen = MacCtx.TxMsg.Message.Data.BufSize;
+                break;
+            }
+
+            LORAMAC_ENERGY_ADD_SE_OP( );
             macCryptoStatus = LoRaMacCryptoSecureMessage( fCntUp, txDr, txCh, &MacCtx.TxMsg.Message.Data );
             if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
             {
+                MacCtx.TxFrameCache.Valid = false;
                 return LORAMAC_STATUS_CRYPTO_ERROR;
             }
             MacCtx.PktBufferLen = MacCtx.TxMsg.Message.Data.BufSize;
+
+            MacCtx.TxFrameCache.Valid = true;
+            MacCtx.TxFrameCache.FCntUp = fCntUp;
+            MacCtx.TxFrameCache.Datarate = cacheDr;
+            MacCtx.TxFrameCache.Channel = cacheCh;
+            MacCtx.TxFrameCache.Ack = MacCtx.TxMsg.Message.Data.FHDR.FCtrl.Bits.Ack;
             break;
         case LORAMAC_MSG_TYPE_JOIN_ACCEPT:
         case LORAMAC_MSG_TYPE_UNDEF:
@@ -3152,10 +3871,13 @@ static void ResetMacParameters( bool isRejoin )
 
     // ADR counter
     Nvm.MacGroup1.AdrAckCounter = 0;
+    MacCtx.AdrGrantedDatarate = -1;
+    MacCtx.AdrGrantedTxPower = -1;
 
     MacCtx.ChannelsNbTransCounter = 0;
     MacCtx.RetransmitTimeoutRetry = false;
     MacCtx.ResponseTimeoutStartTime = 0;
+    MacCtx.TxFrameCache.Valid = false;
 
     Nvm.MacGroup2.MaxDCycle = 0;
     Nvm.MacGroup2.AggregatedDCycle = 1;
@@ -3265,6 +3987,10 @@ static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig )
     {
         Radio.Rx( Nvm.MacGroup2.MacParams.MaxRxWindow );
         MacCtx.RxSlot = rxConfig->RxSlot;
+        if( rxConfig->RxContinuous == false )
+        {
+            LORAMAC_ENERGY_RX_START( TimerGetCurrentTime( ) );
+        }
     }
 }
 
@@ -3286,14 +4012,68 @@ static void OpenContinuousRxCWindow( void )
     // Thus, there is no need to set the radio in standby mode.
     if( RegionRxConfig( Nvm.MacGroup2.Region, &MacCtx.RxWindowCConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
     {
-        Radio.Rx( 0 ); // Continuous mode
+        if( StartRxCDutyCycle( MacCtx.McpsIndication.RxDatarate ) == false )
+        {
+            Radio.Rx( 0 ); // Continuous mode
+        }
         MacCtx.RxSlot = MacCtx.RxWindowCConfig.RxSlot;
     }
 }
 
+static bool StartRxCDutyCycle( int8_t datarate )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    uint32_t spreadingFactor = 0;
+    uint32_t bandwidth = 0;
+    uint32_t symbolTime = 0;
+    uint32_t rxTime = 0;
+    uint32_t preambleTime = 0;
+    uint32_t wakeupTime = 0;
+
+    if( ( Nvm.MacGroup2.RxCDutyCycleOn == false ) || ( Radio.SetRxDutyCycle == NULL ) )
+    {
+        return false;
+    }
+
+    getPhy.Attribute = PHY_SF_FROM_DR;
+    getPhy.Datarate = datarate;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    spreadingFactor = phyParam.Value;
+
+    if( ( spreadingFactor < 5 ) || ( spreadingFactor > 12 ) )
+    {
+        // Not a LoRa datarate
+        return false;
+    }
+
+    getPhy.Attribute = PHY_BW_FROM_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    bandwidth = phyParam.Value;
+
+    // Symbol time [us]. Bandwidth 0: 125 kHz, 1: 250 kHz, 2: 500 kHz
+    symbolTime = ( ( uint32_t )1 << spreadingFactor ) * 1000 / ( 125 << bandwidth );
+    rxTime = RXC_DUTY_CYCLE_RX_SYMBOLS * symbolTime;
+    preambleTime = RXC_DUTY_CYCLE_PREAMBLE_SYMBOLS * symbolTime;
+    wakeupTime = Radio.GetWakeupTime( ) * 1000;
+
+    // The preamble must span the sleep period and the reception periods
+    // around it, including the radio wakeup.
+    if( preambleTime <= ( ( 2 * rxTime ) + wakeupTime ) )
+    {
+        return false;
+    }
+
+    // Radio periods are expressed in 15.625 us steps
+    Radio.SetRxDutyCycle( ( rxTime * 64 ) / 1000,
+                          ( ( preambleTime - ( 2 * rxTime ) - wakeupTime ) * 64 ) / 1000 );
+    return true;
+}
+
 LoRaMacStatus_t PrepareFrame( LoRaMacHeader_t* macHdr, LoRaMacFrameCtrl_t* fCtrl, uint8_t fPort, void* fBuffer, uint16_t fBufferSize )
 {
     MacCtx.PktBufferLen = 0;
+    MacCtx.TxFrameCache.Valid = false;
     MacCtx.NodeAckRequested = false;
     uint32_t fCntUp = 0;
     size_t macCmdsSize = 0;
@@ -3777,6 +4557,9 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     // Confirm queue reset
     LoRaMacConfirmQueueInit( primitives );
 
+    // Trace time base and statistics reset
+    LORAMAC_TRACE_INIT( );
+
     // Initialize the module context with zeros
     memset1( ( uint8_t* ) &Nvm, 0x00, sizeof( LoRaMacNvmData_t ) );
     memset1( ( uint8_t* ) &MacCtx, 0x00, sizeof( LoRaMacCtx_t ) );
@@ -3897,13 +4680,17 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     Nvm.MacGroup1.AggregatedTimeOff = 0;
 
     // Initialize timers
-    TimerInit( &MacCtx.TxDelayedTimer, OnTxDelayedTimerEvent );
-    TimerInit( &MacCtx.RxWindowTimer1, OnRxWindow1TimerEvent );
-    TimerInit( &MacCtx.RxWindowTimer2, OnRxWindow2TimerEvent );
-    TimerInit( &MacCtx.RetransmitTimeoutTimer, OnRetransmitTimeoutTimerEvent );
-    TimerInit( &MacCtx.Rejoin0CycleTimer, OnRejoin0CycleTimerEvent );
-    TimerInit( &MacCtx.Rejoin1CycleTimer, OnRejoin1CycleTimerEvent );
-    TimerInit( &MacCtx.ForceRejoinReqCycleTimer, OnForceRejoinReqCycleTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.TxDelayedTimer, OnTxDelayedTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.RxWindowTimer1, OnRxWindow1TimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.RxWindowTimer2, OnRxWindow2TimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.RetransmitTimeoutTimer, OnRetransmitTimeoutTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.Rejoin0CycleTimer, OnRejoin0CycleTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.Rejoin1CycleTimer, OnRejoin1CycleTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.ForceRejoinReqCycleTimer, OnForceRejoinReqCycleTimerEvent );
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.McpsQueueTimer, OnMcpsQueueTimerEvent );
+#endif
+    LORAMAC_INSTANCE_TIMER_INIT( &MacCtx.AbpJoinPendingTimer, OnAbpJoinPendingTimerEvent );
 
     // Store the current initialization time
     Nvm.MacGroup2.InitializationTime = SysTimeGetMcuTime( );
@@ -4004,6 +4791,9 @@ LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
     adrNext.NbTrans = MacCtx.ChannelsNbTransCounter;
     adrNext.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
     adrNext.Region = Nvm.MacGroup2.Region;
+    adrNext.GrantedDatarate = MacCtx.AdrGrantedDatarate;
+    adrNext.GrantedTxPower = MacCtx.AdrGrantedTxPower;
+    adrNext.Strategy = MacCtx.AdrStrategy;
 
     // We call the function for information purposes only. We don't want to
     // apply the datarate, the tx power and the ADR ack counter.
@@ -4038,29 +4828,118 @@ LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
     }
 }
 
+/*!
+ * MIB attributes directly mapped on a non-volatile data field
+ */
+static const MibNvmAttribute_t MibNvmAttributes[] =
+{
+    [MIB_DEVICE_CLASS]               = MIB_NVM_ATTRIBUTE( MacGroup2.DeviceClass, MIB_ACCESS_GET ),
+    [MIB_NETWORK_ACTIVATION]         = MIB_NVM_ATTRIBUTE( MacGroup2.NetworkActivation, MIB_ACCESS_GET ),
+    [MIB_ADR]                        = MIB_NVM_ATTRIBUTE( MacGroup2.AdrCtrlOn, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_NET_ID]                     = MIB_NVM_ATTRIBUTE( MacGroup2.NetID, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_DEV_ADDR]                   = MIB_NVM_ATTRIBUTE( MacGroup2.DevAddr, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_PUBLIC_NETWORK]             = MIB_NVM_ATTRIBUTE( MacGroup2.PublicNetwork, MIB_ACCESS_GET ),
+    [MIB_RX2_CHANNEL]                = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.Rx2Channel, MIB_ACCESS_GET ),
+    [MIB_RX2_DEFAULT_CHANNEL]        = MIB_NVM_ATTRIBUTE( MacGroup2.MacParamsDefaults.Rx2Channel, MIB_ACCESS_GET ),
+    [MIB_RXC_CHANNEL]                = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.RxCChannel, MIB_ACCESS_GET ),
+    [MIB_RXC_DEFAULT_CHANNEL]        = MIB_NVM_ATTRIBUTE( MacGroup2.MacParamsDefaults.RxCChannel, MIB_ACCESS_GET ),
+    [MIB_CHANNELS_NB_TRANS]          = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.ChannelsNbTrans, MIB_ACCESS_GET ),
+    [MIB_MAX_RX_WINDOW_DURATION]     = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.MaxRxWindow, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_RECEIVE_DELAY_1]            = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.ReceiveDelay1, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_RECEIVE_DELAY_2]            = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.ReceiveDelay2, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_JOIN_ACCEPT_DELAY_1]        = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.JoinAcceptDelay1, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_JOIN_ACCEPT_DELAY_2]        = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.JoinAcceptDelay2, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_CHANNELS_DEFAULT_DATARATE]  = MIB_NVM_ATTRIBUTE( MacGroup2.ChannelsDatarateDefault, MIB_ACCESS_GET ),
+    [MIB_CHANNELS_DATARATE]          = MIB_NVM_ATTRIBUTE( MacGroup1.ChannelsDatarate, MIB_ACCESS_GET ),
+    [MIB_CHANNELS_DEFAULT_TX_POWER]  = MIB_NVM_ATTRIBUTE( MacGroup2.ChannelsTxPowerDefault, MIB_ACCESS_GET ),
+    [MIB_CHANNELS_TX_POWER]          = MIB_NVM_ATTRIBUTE( MacGroup1.ChannelsTxPower, MIB_ACCESS_GET ),
+    [MIB_SYSTEM_MAX_RX_ERROR]        = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.SystemMaxRxError, MIB_ACCESS_GET ),
+    [MIB_MIN_RX_SYMBOLS]             = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.MinRxSymbols, MIB_ACCESS_GET ),
+    [MIB_ANTENNA_GAIN]               = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.AntennaGain, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_DEFAULT_ANTENNA_GAIN]       = MIB_NVM_ATTRIBUTE( MacGroup2.MacParamsDefaults.AntennaGain, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_IS_CERT_FPORT_ON]           = MIB_NVM_ATTRIBUTE( MacGroup2.IsCertPortOn, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_REJOIN_0_CYCLE]             = MIB_NVM_ATTRIBUTE( MacGroup2.Rejoin0CycleInSec, MIB_ACCESS_GET ),
+    [MIB_REJOIN_1_CYCLE]             = MIB_NVM_ATTRIBUTE( MacGroup2.Rejoin1CycleInSec, MIB_ACCESS_GET ),
+    [MIB_ADR_ACK_LIMIT]              = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.AdrAckLimit, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_ADR_ACK_DELAY]              = MIB_NVM_ATTRIBUTE( MacGroup2.MacParams.AdrAckDelay, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_ADR_ACK_DEFAULT_LIMIT]      = MIB_NVM_ATTRIBUTE( MacGroup2.MacParamsDefaults.AdrAckLimit, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_ADR_ACK_DEFAULT_DELAY]      = MIB_NVM_ATTRIBUTE( MacGroup2.MacParamsDefaults.AdrAckDelay, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_ADAPTIVE_RX_ERROR]          = MIB_NVM_ATTRIBUTE( MacGroup2.AdaptiveRxErrorOn, MIB_ACCESS_GET | MIB_ACCESS_SET ),
+    [MIB_RX_ERROR_ESTIMATE]          = MIB_NVM_ATTRIBUTE( MacGroup1.RxErrorEstimate, MIB_ACCESS_GET ),
+    [MIB_RXC_DUTY_CYCLE]             = MIB_NVM_ATTRIBUTE( MacGroup2.RxCDutyCycleOn, MIB_ACCESS_GET )
+};
+
+/*!
+ * MIB attributes setting a key
+ */
+static const MibKey_t MibKeys[] =
+{
+    { MIB_APP_KEY,          APP_KEY },
+    { MIB_NWK_KEY,          NWK_KEY },
+    { MIB_J_S_INT_KEY,      J_S_INT_KEY },
+    { MIB_J_S_ENC_KEY,      J_S_ENC_KEY },
+    { MIB_F_NWK_S_INT_KEY,  F_NWK_S_INT_KEY },
+    { MIB_S_NWK_S_INT_KEY,  S_NWK_S_INT_KEY },
+    { MIB_NWK_S_ENC_KEY,    NWK_S_ENC_KEY },
+    { MIB_APP_S_KEY,        APP_S_KEY },
+    { MIB_MC_KE_KEY,        MC_KE_KEY },
+    { MIB_MC_KEY_0,         MC_KEY_0 },
+    { MIB_MC_APP_S_KEY_0,   MC_APP_S_KEY_0 },
+    { MIB_MC_NWK_S_KEY_0,   MC_NWK_S_KEY_0 },
+    { MIB_MC_KEY_1,         MC_KEY_1 },
+    { MIB_MC_APP_S_KEY_1,   MC_APP_S_KEY_1 },
+    { MIB_MC_NWK_S_KEY_1,   MC_NWK_S_KEY_1 },
+    { MIB_MC_KEY_2,         MC_KEY_2 },
+    { MIB_MC_APP_S_KEY_2,   MC_APP_S_KEY_2 },
+    { MIB_MC_NWK_S_KEY_2,   MC_NWK_S_KEY_2 },
+    { MIB_MC_KEY_3,         MC_KEY_3 },
+    { MIB_MC_APP_S_KEY_3,   MC_APP_S_KEY_3 },
+    { MIB_MC_NWK_S_KEY_3,   MC_NWK_S_KEY_3 }
+};
+
+static const MibNvmAttribute_t* GetMibNvmAttribute( Mib_t type, uint8_t access )
+{
+    if( ( type < ( sizeof( MibNvmAttributes ) / sizeof( MibNvmAttributes[0] ) ) ) &&
+        ( ( MibNvmAttributes[type].Access & access ) == access ) )
+    {
+        return &MibNvmAttributes[type];
+    }
+    return NULL;
+}
+
+static const MibKey_t* GetMibKey( Mib_t type )
+{
+    for( uint8_t i = 0; i < ( sizeof( MibKeys ) / sizeof( MibKeys[0] ) ); i++ )
+    {
+        if( MibKeys[i].Type == type )
+        {
+            return &MibKeys[i];
+        }
+    }
+    return NULL;
+}
+
 LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
 {
     LoRaMacStatus_t status = LORAMAC_STATUS_OK;
     GetPhyParams_t getPhy;
     PhyParam_t phyParam;
+    const MibNvmAttribute_t* nvmAttribute = NULL;
 
     if( mibGet == NULL )
     {
         return LORAMAC_STATUS_PARAMETER_INVALID;
     }
 
+    nvmAttribute = GetMibNvmAttribute( mibGet->Type, MIB_ACCESS_GET );
+    if( nvmAttribute != NULL )
+    {
+        memcpy1( ( uint8_t* )&mibGet->Param, ( uint8_t* )&Nvm + nvmAttribute->Offset, nvmAttribute->Size );
+        return LORAMAC_STATUS_OK;
+    }
+
     switch( mibGet->Type )
     {
-        case MIB_DEVICE_CLASS:
-        {
-            mibGet->Param.Class = Nvm.MacGroup2.DeviceClass;
-            break;
-        }
-        case MIB_NETWORK_ACTIVATION:
-        {
-            mibGet->Param.NetworkActivation = Nvm.MacGroup2.NetworkActivation;
-            break;
-        }
         case MIB_DEV_EUI:
         {
             mibGet->Param.DevEui = SecureElementGetDevEui( );
@@ -4076,26 +4955,6 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
             mibGet->Param.SePin = SecureElementGetPin( );
             break;
         }
-        case MIB_ADR:
-        {
-            mibGet->Param.AdrEnable = Nvm.MacGroup2.AdrCtrlOn;
-            break;
-        }
-        case MIB_NET_ID:
-        {
-            mibGet->Param.NetID = Nvm.MacGroup2.NetID;
-            break;
-        }
-        case MIB_DEV_ADDR:
-        {
-            mibGet->Param.DevAddr = Nvm.MacGroup2.DevAddr;
-            break;
-        }
-        case MIB_PUBLIC_NETWORK:
-        {
-            mibGet->Param.EnablePublicNetwork = Nvm.MacGroup2.PublicNetwork;
-            break;
-        }
         case MIB_CHANNELS:
         {
             getPhy.Attribute = PHY_CHANNELS;
@@ -4104,26 +4963,6 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
             mibGet->Param.ChannelList = phyParam.Channels;
             break;
         }
-        case MIB_RX2_CHANNEL:
-        {
-            mibGet->Param.Rx2Channel = Nvm.MacGroup2.MacParams.Rx2Channel;
-            break;
-        }
-        case MIB_RX2_DEFAULT_CHANNEL:
-        {
-            mibGet->Param.Rx2Channel = Nvm.MacGroup2.MacParamsDefaults.Rx2Channel;
-            break;
-        }
-        case MIB_RXC_CHANNEL:
-        {
-            mibGet->Param.RxCChannel = Nvm.MacGroup2.MacParams.RxCChannel;
-            break;
-        }
-        case MIB_RXC_DEFAULT_CHANNEL:
-        {
-            mibGet->Param.RxCChannel = Nvm.MacGroup2.MacParamsDefaults.RxCChannel;
-            break;
-        }
         case MIB_CHANNELS_DEFAULT_MASK:
         {
             getPhy.Attribute = PHY_CHANNELS_DEFAULT_MASK;
@@ -4140,555 +4979,282 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
             mibGet->Param.ChannelsMask = phyParam.ChannelsMask;
             break;
         }
-        case MIB_CHANNELS_NB_TRANS:
-        {
-            mibGet->Param.ChannelsNbTrans = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
-            break;
-        }
-        case MIB_MAX_RX_WINDOW_DURATION:
+        case MIB_CHANNELS_MIN_TX_DATARATE:
         {
-            mibGet->Param.MaxRxWindow = Nvm.MacGroup2.MacParams.MaxRxWindow;
+            getPhy.Attribute = PHY_MIN_TX_DR;
+            getPhy.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+            phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+
+            mibGet->Param.ChannelsMinTxDatarate = phyParam.Value;
             break;
         }
-        case MIB_RECEIVE_DELAY_1:
+        case MIB_NVM_CTXS:
         {
-            mibGet->Param.ReceiveDelay1 = Nvm.MacGroup2.MacParams.ReceiveDelay1;
+            mibGet->Param.Contexts = GetNvmData( );
             break;
         }
-        case MIB_RECEIVE_DELAY_2:
+        case MIB_LORAWAN_VERSION:
         {
-            mibGet->Param.ReceiveDelay2 = Nvm.MacGroup2.MacParams.ReceiveDelay2;
+            mibGet->Param.LrWanVersion.LoRaWan = Nvm.MacGroup2.Version;
+            mibGet->Param.LrWanVersion.LoRaWanRegion = RegionGetVersion( );
             break;
         }
-        case MIB_JOIN_ACCEPT_DELAY_1:
+        case MIB_RSSI_FREE_THRESHOLD:
         {
-            mibGet->Param.JoinAcceptDelay1 = Nvm.MacGroup2.MacParams.JoinAcceptDelay1;
+#if defined(REGION_KR920) || defined(REGION_AS923)
+            if( Nvm.MacGroup2.Region != LORAMAC_REGION_AS923 && Nvm.MacGroup2.Region != LORAMAC_REGION_KR920 )
+            {
+                status = LORAMAC_STATUS_ERROR;
+            }
+            else
+            {
+                mibGet->Param.RssiFreeThreshold = Nvm.RegionGroup2.RssiFreeThreshold;
+            }
+#else
+            status = LORAMAC_STATUS_ERROR;
+#endif
             break;
         }
-        case MIB_JOIN_ACCEPT_DELAY_2:
+        case MIB_CARRIER_SENSE_TIME:
         {
-            mibGet->Param.JoinAcceptDelay2 = Nvm.MacGroup2.MacParams.JoinAcceptDelay2;
+#if defined(REGION_KR920) || defined(REGION_AS923)
+            if( Nvm.MacGroup2.Region != LORAMAC_REGION_AS923 && Nvm.MacGroup2.Region != LORAMAC_REGION_KR920 )
+            {
+                status = LORAMAC_STATUS_ERROR;
+            }
+            else
+            {
+                mibGet->Param.CarrierSenseTime = Nvm.RegionGroup2.CarrierSenseTime;
+            }
+#else
+            status = LORAMAC_STATUS_ERROR;
+#endif
             break;
         }
-        case MIB_CHANNELS_MIN_TX_DATARATE:
+        case MIB_LBT_CHANNEL_STATS:
         {
-            getPhy.Attribute = PHY_MIN_TX_DR;
-            getPhy.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+            getPhy.Attribute = PHY_LBT_CHANNEL_STATS;
             phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
 
-            mibGet->Param.ChannelsMinTxDatarate = phyParam.Value;
-            break;
-        }
-        case MIB_CHANNELS_DEFAULT_DATARATE:
-        {
-            mibGet->Param.ChannelsDefaultDatarate = Nvm.MacGroup2.ChannelsDatarateDefault;
+            mibGet->Param.LbtChannelStats = phyParam.LbtChannelStats;
             break;
         }
-        case MIB_CHANNELS_DATARATE:
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+        case MIB_ENERGY_LEDGER:
         {
-            mibGet->Param.ChannelsDatarate = Nvm.MacGroup1.ChannelsDatarate;
+            mibGet->Param.EnergyLedger = LoRaMacEnergyGetLedger( );
             break;
         }
-        case MIB_CHANNELS_DEFAULT_TX_POWER:
+        case MIB_ENERGY_MODEL:
         {
-            mibGet->Param.ChannelsDefaultTxPower = Nvm.MacGroup2.ChannelsTxPowerDefault;
+            mibGet->Param.EnergyModel = LoRaMacEnergyGetModel( );
             break;
         }
-        case MIB_CHANNELS_TX_POWER:
+#endif
+        case MIB_ADR_STRATEGY:
         {
-            mibGet->Param.ChannelsTxPower = Nvm.MacGroup1.ChannelsTxPower;
+            mibGet->Param.AdrStrategy = MacCtx.AdrStrategy;
             break;
         }
-        case MIB_SYSTEM_MAX_RX_ERROR:
+        default:
         {
-            mibGet->Param.SystemMaxRxError = Nvm.MacGroup2.MacParams.SystemMaxRxError;
-            break;
-        }
-        case MIB_MIN_RX_SYMBOLS:
-        {
-            mibGet->Param.MinRxSymbols = Nvm.MacGroup2.MacParams.MinRxSymbols;
-            break;
-        }
-        case MIB_ANTENNA_GAIN:
-        {
-            mibGet->Param.AntennaGain = Nvm.MacGroup2.MacParams.AntennaGain;
-            break;
-        }
-        case MIB_NVM_CTXS:
-        {
-            mibGet->Param.Contexts = GetNvmData( );
-            break;
-        }
-        case MIB_DEFAULT_ANTENNA_GAIN:
-        {
-            mibGet->Param.DefaultAntennaGain = Nvm.MacGroup2.MacParamsDefaults.AntennaGain;
-            break;
-        }
-        case MIB_LORAWAN_VERSION:
-        {
-            mibGet->Param.LrWanVersion.LoRaWan = Nvm.MacGroup2.Version;
-            mibGet->Param.LrWanVersion.LoRaWanRegion = RegionGetVersion( );
-            break;
-        }
-        case MIB_IS_CERT_FPORT_ON:
-        {
-            mibGet->Param.IsCertPortOn = Nvm.MacGroup2.IsCertPortOn;
-            break;
-        }
-        case MIB_REJOIN_0_CYCLE:
-        {
-            mibGet->Param.Rejoin0CycleInSec = Nvm.MacGroup2.Rejoin0CycleInSec;
-            break;
-        }
-        case MIB_REJOIN_1_CYCLE:
-        {
-            mibGet->Param.Rejoin1CycleInSec = Nvm.MacGroup2.Rejoin1CycleInSec;
-            break;
-        }
-        case MIB_ADR_ACK_LIMIT:
-        {
-            mibGet->Param.AdrAckLimit = Nvm.MacGroup2.MacParams.AdrAckLimit;
-            break;
-        }
-        case MIB_ADR_ACK_DELAY:
-        {
-            mibGet->Param.AdrAckDelay = Nvm.MacGroup2.MacParams.AdrAckDelay;
-            break;
-        }
-        case MIB_ADR_ACK_DEFAULT_LIMIT:
-        {
-            mibGet->Param.AdrAckLimit = Nvm.MacGroup2.MacParamsDefaults.AdrAckLimit;
-            break;
-        }
-        case MIB_ADR_ACK_DEFAULT_DELAY:
-        {
-            mibGet->Param.AdrAckDelay = Nvm.MacGroup2.MacParamsDefaults.AdrAckDelay;
-            break;
-        }
-        case MIB_RSSI_FREE_THRESHOLD:
-        {
-#if defined(REGION_KR920) || defined(REGION_AS923)
-            if( Nvm.MacGroup2.Region != LORAMAC_REGION_AS923 && Nvm.MacGroup2.Region != LORAMAC_REGION_KR920 )
-            {
-                status = LORAMAC_STATUS_ERROR;
-            }
-            else
-            {
-                mibGet->Param.RssiFreeThreshold = Nvm.RegionGroup2.RssiFreeThreshold;
-            }
-#else
-            status = LORAMAC_STATUS_ERROR;
-#endif
-            break;
-        }
-        case MIB_CARRIER_SENSE_TIME:
-        {
-#if defined(REGION_KR920) || defined(REGION_AS923)
-            if( Nvm.MacGroup2.Region != LORAMAC_REGION_AS923 && Nvm.MacGroup2.Region != LORAMAC_REGION_KR920 )
-            {
-                status = LORAMAC_STATUS_ERROR;
-            }
-            else
-            {
-                mibGet->Param.CarrierSenseTime = Nvm.RegionGroup2.CarrierSenseTime;
-            }
-#else
-            status = LORAMAC_STATUS_ERROR;
-#endif
-            break;
-        }
-        default:
-        {
-            status = LoRaMacClassBMibGetRequestConfirm( mibGet );
+            status = LoRaMacClassBMibGetRequestConfirm( mibGet );
             break;
         }
     }
     return status;
 }
 
-LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
+static LoRaMacStatus_t VerifyMibSet( MibRequestConfirm_t* mibSet )
 {
-    LoRaMacStatus_t status = LORAMAC_STATUS_OK;
-    ChanMaskSetParams_t chanMaskSet;
     VerifyParams_t verify;
-
-    if( mibSet == NULL )
-    {
-        return LORAMAC_STATUS_PARAMETER_INVALID;
-    }
-    if( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) == LORAMAC_TX_RUNNING )
-    {
-        return LORAMAC_STATUS_BUSY;
-    }
+    uint32_t cycleTime = 0;
 
     switch( mibSet->Type )
     {
-        case MIB_DEVICE_CLASS:
-        {
-            status = SwitchClass( mibSet->Param.Class );
-            break;
-        }
         case MIB_NETWORK_ACTIVATION:
         {
-            if( mibSet->Param.NetworkActivation != ACTIVATION_TYPE_OTAA  )
-            {
-                Nvm.MacGroup2.NetworkActivation = mibSet->Param.NetworkActivation;
-            }
-            else
+            if( mibSet->Param.NetworkActivation == ACTIVATION_TYPE_OTAA  )
             {   // Do not allow to set ACTIVATION_TYPE_OTAA since the MAC will set it automatically after a successful join process.
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_DEV_EUI:
-        {
-            if( SecureElementSetDevEui( mibSet->Param.DevEui ) != SECURE_ELEMENT_SUCCESS )
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_JOIN_EUI:
-        {
-            if( SecureElementSetJoinEui( mibSet->Param.JoinEui ) != SECURE_ELEMENT_SUCCESS )
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_SE_PIN:
-        {
-            if( SecureElementSetPin( mibSet->Param.SePin ) != SECURE_ELEMENT_SUCCESS )
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_ADR:
-        {
-            Nvm.MacGroup2.AdrCtrlOn = mibSet->Param.AdrEnable;
-            break;
-        }
-        case MIB_NET_ID:
-        {
-            Nvm.MacGroup2.NetID = mibSet->Param.NetID;
-            break;
-        }
-        case MIB_DEV_ADDR:
-        {
-            Nvm.MacGroup2.DevAddr = mibSet->Param.DevAddr;
-            break;
-        }
-        case MIB_APP_KEY:
-        {
-            if( mibSet->Param.AppKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( APP_KEY, mibSet->Param.AppKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_NWK_KEY:
-        {
-            if( mibSet->Param.NwkKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( NWK_KEY, mibSet->Param.NwkKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_J_S_INT_KEY:
-        {
-            if( mibSet->Param.JSIntKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( J_S_INT_KEY, mibSet->Param.JSIntKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_J_S_ENC_KEY:
+        case MIB_RX2_CHANNEL:
+        case MIB_RX2_DEFAULT_CHANNEL:
+        case MIB_RXC_CHANNEL:
+        case MIB_RXC_DEFAULT_CHANNEL:
         {
-            if( mibSet->Param.JSEncKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( J_S_ENC_KEY, mibSet->Param.JSEncKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            // All the RX channels parameters share the same location
+            verify.DatarateParams.Datarate = mibSet->Param.Rx2Channel.Datarate;
+            verify.DatarateParams.DownlinkDwellTime = Nvm.MacGroup2.MacParams.DownlinkDwellTime;
+
+            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_RX_DR ) == false )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_F_NWK_S_INT_KEY:
+        case MIB_CHANNELS_NB_TRANS:
         {
-            if( mibSet->Param.FNwkSIntKey != NULL )
+            if( ( mibSet->Param.ChannelsNbTrans < 1 ) ||
+                ( mibSet->Param.ChannelsNbTrans > 15 ) )
             {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( F_NWK_S_INT_KEY, mibSet->Param.FNwkSIntKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_S_NWK_S_INT_KEY:
+        case MIB_CHANNELS_DEFAULT_DATARATE:
         {
-            if( mibSet->Param.SNwkSIntKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( S_NWK_S_INT_KEY, mibSet->Param.SNwkSIntKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            verify.DatarateParams.Datarate = mibSet->Param.ChannelsDefaultDatarate;
+
+            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_DEF_TX_DR ) == false )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_NWK_S_ENC_KEY:
+        case MIB_CHANNELS_DATARATE:
         {
-            if( mibSet->Param.NwkSEncKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( NWK_S_ENC_KEY, mibSet->Param.NwkSEncKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            verify.DatarateParams.Datarate = mibSet->Param.ChannelsDatarate;
+            verify.DatarateParams.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+
+            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_TX_DR ) == false )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_APP_S_KEY:
+        case MIB_CHANNELS_DEFAULT_TX_POWER:
         {
-            if( mibSet->Param.AppSKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( APP_S_KEY, mibSet->Param.AppSKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            verify.TxPower = mibSet->Param.ChannelsDefaultTxPower;
+
+            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_DEF_TX_POWER ) == false )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_KE_KEY:
+        case MIB_CHANNELS_TX_POWER:
         {
-            if( mibSet->Param.McKEKey != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_KE_KEY, mibSet->Param.McKEKey ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            verify.TxPower = mibSet->Param.ChannelsTxPower;
+
+            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_TX_POWER ) == false )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_KEY_0:
+        case MIB_SYSTEM_MAX_RX_ERROR:
         {
-            if( mibSet->Param.McKey0 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_KEY_0, mibSet->Param.McKey0 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+            if( mibSet->Param.SystemMaxRxError > 500 )
+            { // Only apply the new value if in range 0..500 ms else keep current value.
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_APP_S_KEY_0:
+        case MIB_NVM_CTXS:
         {
-            if( mibSet->Param.McAppSKey0 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_APP_S_KEY_0, mibSet->Param.McAppSKey0 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            if( mibSet->Param.Contexts == 0 )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_NWK_S_KEY_0:
+        case MIB_ABP_LORAWAN_VERSION:
         {
-            if( mibSet->Param.McNwkSKey0 != NULL )
+            if( mibSet->Param.AbpLrWanVersion.Fields.Minor > 1 )
             {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_NWK_S_KEY_0, mibSet->Param.McNwkSKey0 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_KEY_1:
+        case MIB_REJOIN_0_CYCLE:
+        case MIB_REJOIN_1_CYCLE:
         {
-            if( mibSet->Param.McKey1 != NULL )
+            // Both rejoin cycles share the same location
+            if( ( ConvertRejoinCycleTime( mibSet->Param.Rejoin0CycleInSec, &cycleTime ) == false ) ||
+                ( Nvm.MacGroup2.NetworkActivation != ACTIVATION_TYPE_OTAA ) )
             {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_KEY_1, mibSet->Param.McKey1 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_APP_S_KEY_1:
+#if !defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+        case MIB_ENERGY_LEDGER:
+        case MIB_ENERGY_MODEL:
         {
-            if( mibSet->Param.McAppSKey1 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_APP_S_KEY_1, mibSet->Param.McAppSKey1 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
+            return LORAMAC_STATUS_SERVICE_UNKNOWN;
         }
-        case MIB_MC_NWK_S_KEY_1:
+#endif
+        default:
         {
-            if( mibSet->Param.McNwkSKey1 != NULL )
+            if( ( GetMibKey( mibSet->Type ) != NULL ) && ( mibSet->Param.AppKey == NULL ) )
             {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_NWK_S_KEY_1, mibSet->Param.McNwkSKey1 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_KEY_2:
+    }
+    return LORAMAC_STATUS_OK;
+}
+
+static LoRaMacStatus_t SetMibRequest( MibRequestConfirm_t* mibSet )
+{
+    LoRaMacStatus_t status = LORAMAC_STATUS_OK;
+    ChanMaskSetParams_t chanMaskSet;
+    const MibNvmAttribute_t* nvmAttribute = NULL;
+    const MibKey_t* key = NULL;
+
+    nvmAttribute = GetMibNvmAttribute( mibSet->Type, MIB_ACCESS_SET );
+    if( nvmAttribute != NULL )
+    {
+        memcpy1( ( uint8_t* )&Nvm + nvmAttribute->Offset, ( uint8_t* )&mibSet->Param, nvmAttribute->Size );
+        return LORAMAC_STATUS_OK;
+    }
+
+    key = GetMibKey( mibSet->Type );
+    if( key != NULL )
+    {
+        // All the keys parameters are pointers sharing the same location
+        if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( key->KeyID, mibSet->Param.AppKey ) )
         {
-            if( mibSet->Param.McKey2 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_KEY_2, mibSet->Param.McKey2 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
+            return LORAMAC_STATUS_CRYPTO_ERROR;
         }
-        case MIB_MC_APP_S_KEY_2:
+        return LORAMAC_STATUS_OK;
+    }
+
+    switch( mibSet->Type )
+    {
+        case MIB_DEVICE_CLASS:
         {
-            if( mibSet->Param.McAppSKey2 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_APP_S_KEY_2, mibSet->Param.McAppSKey2 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            status = SwitchClass( mibSet->Param.Class );
             break;
         }
-        case MIB_MC_NWK_S_KEY_2:
+        case MIB_NETWORK_ACTIVATION:
         {
-            if( mibSet->Param.McNwkSKey2 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_NWK_S_KEY_2, mibSet->Param.McNwkSKey2 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.NetworkActivation = mibSet->Param.NetworkActivation;
             break;
         }
-        case MIB_MC_KEY_3:
+        case MIB_DEV_EUI:
         {
-            if( mibSet->Param.McKey3 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_KEY_3, mibSet->Param.McKey3 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            if( SecureElementSetDevEui( mibSet->Param.DevEui ) != SECURE_ELEMENT_SUCCESS )
             {
                 status = LORAMAC_STATUS_PARAMETER_INVALID;
             }
             break;
         }
-        case MIB_MC_APP_S_KEY_3:
+        case MIB_JOIN_EUI:
         {
-            if( mibSet->Param.McAppSKey3 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_APP_S_KEY_3, mibSet->Param.McAppSKey3 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            if( SecureElementSetJoinEui( mibSet->Param.JoinEui ) != SECURE_ELEMENT_SUCCESS )
             {
                 status = LORAMAC_STATUS_PARAMETER_INVALID;
             }
-            break;
-        }
-        case MIB_MC_NWK_S_KEY_3:
-        {
-            if( mibSet->Param.McNwkSKey3 != NULL )
-            {
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_NWK_S_KEY_3, mibSet->Param.McNwkSKey3 ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            break;
+        }
+        case MIB_SE_PIN:
+        {
+            if( SecureElementSetPin( mibSet->Param.SePin ) != SECURE_ELEMENT_SUCCESS )
             {
                 status = LORAMAC_STATUS_PARAMETER_INVALID;
             }
@@ -4702,73 +5268,33 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         }
         case MIB_RX2_CHANNEL:
         {
-            verify.DatarateParams.Datarate = mibSet->Param.Rx2Channel.Datarate;
-            verify.DatarateParams.DownlinkDwellTime = Nvm.MacGroup2.MacParams.DownlinkDwellTime;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_RX_DR ) == true )
-            {
-                Nvm.MacGroup2.MacParams.Rx2Channel = mibSet->Param.Rx2Channel;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.MacParams.Rx2Channel = mibSet->Param.Rx2Channel;
             break;
         }
         case MIB_RX2_DEFAULT_CHANNEL:
         {
-            verify.DatarateParams.Datarate = mibSet->Param.Rx2Channel.Datarate;
-            verify.DatarateParams.DownlinkDwellTime = Nvm.MacGroup2.MacParams.DownlinkDwellTime;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_RX_DR ) == true )
-            {
-                Nvm.MacGroup2.MacParamsDefaults.Rx2Channel = mibSet->Param.Rx2DefaultChannel;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.MacParamsDefaults.Rx2Channel = mibSet->Param.Rx2DefaultChannel;
             break;
         }
         case MIB_RXC_CHANNEL:
         {
-            verify.DatarateParams.Datarate = mibSet->Param.RxCChannel.Datarate;
-            verify.DatarateParams.DownlinkDwellTime = Nvm.MacGroup2.MacParams.DownlinkDwellTime;
+            Nvm.MacGroup2.MacParams.RxCChannel = mibSet->Param.RxCChannel;
 
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_RX_DR ) == true )
+            if( ( Nvm.MacGroup2.DeviceClass == CLASS_C ) && ( Nvm.MacGroup2.NetworkActivation != ACTIVATION_TYPE_NONE ) )
             {
-                Nvm.MacGroup2.MacParams.RxCChannel = mibSet->Param.RxCChannel;
-
-                if( ( Nvm.MacGroup2.DeviceClass == CLASS_C ) && ( Nvm.MacGroup2.NetworkActivation != ACTIVATION_TYPE_NONE ) )
-                {
-                    // We can only compute the RX window parameters directly, if we are already
-                    // in class c mode and joined. We cannot setup an RX window in case of any other
-                    // class type.
-                    // Set the radio into sleep mode in case we are still in RX mode
-                    Radio.Sleep( );
+                // We can only compute the RX window parameters directly, if we are already
+                // in class c mode and joined. We cannot setup an RX window in case of any other
+                // class type.
+                // Set the radio into sleep mode in case we are still in RX mode
+                Radio.Sleep( );
 
-                    OpenContinuousRxCWindow( );
-                }
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                OpenContinuousRxCWindow( );
             }
             break;
         }
         case MIB_RXC_DEFAULT_CHANNEL:
         {
-            verify.DatarateParams.Datarate = mibSet->Param.RxCChannel.Datarate;
-            verify.DatarateParams.DownlinkDwellTime = Nvm.MacGroup2.MacParams.DownlinkDwellTime;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_RX_DR ) == true )
-            {
-                Nvm.MacGroup2.MacParamsDefaults.RxCChannel = mibSet->Param.RxCDefaultChannel;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.MacParamsDefaults.RxCChannel = mibSet->Param.RxCDefaultChannel;
             break;
         }
         case MIB_CHANNELS_DEFAULT_MASK:
@@ -4795,109 +5321,32 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         }
         case MIB_CHANNELS_NB_TRANS:
         {
-            if( ( mibSet->Param.ChannelsNbTrans >= 1 ) &&
-                ( mibSet->Param.ChannelsNbTrans <= 15 ) )
-            {
-                Nvm.MacGroup2.MacParams.ChannelsNbTrans = mibSet->Param.ChannelsNbTrans;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_MAX_RX_WINDOW_DURATION:
-        {
-            Nvm.MacGroup2.MacParams.MaxRxWindow = mibSet->Param.MaxRxWindow;
-            break;
-        }
-        case MIB_RECEIVE_DELAY_1:
-        {
-            Nvm.MacGroup2.MacParams.ReceiveDelay1 = mibSet->Param.ReceiveDelay1;
-            break;
-        }
-        case MIB_RECEIVE_DELAY_2:
-        {
-            Nvm.MacGroup2.MacParams.ReceiveDelay2 = mibSet->Param.ReceiveDelay2;
-            break;
-        }
-        case MIB_JOIN_ACCEPT_DELAY_1:
-        {
-            Nvm.MacGroup2.MacParams.JoinAcceptDelay1 = mibSet->Param.JoinAcceptDelay1;
-            break;
-        }
-        case MIB_JOIN_ACCEPT_DELAY_2:
-        {
-            Nvm.MacGroup2.MacParams.JoinAcceptDelay2 = mibSet->Param.JoinAcceptDelay2;
+            Nvm.MacGroup2.MacParams.ChannelsNbTrans = mibSet->Param.ChannelsNbTrans;
             break;
         }
         case MIB_CHANNELS_DEFAULT_DATARATE:
         {
-            verify.DatarateParams.Datarate = mibSet->Param.ChannelsDefaultDatarate;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_DEF_TX_DR ) == true )
-            {
-                Nvm.MacGroup2.ChannelsDatarateDefault = verify.DatarateParams.Datarate;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.ChannelsDatarateDefault = mibSet->Param.ChannelsDefaultDatarate;
             break;
         }
         case MIB_CHANNELS_DATARATE:
         {
-            verify.DatarateParams.Datarate = mibSet->Param.ChannelsDatarate;
-            verify.DatarateParams.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_TX_DR ) == true )
-            {
-                Nvm.MacGroup1.ChannelsDatarate = verify.DatarateParams.Datarate;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup1.ChannelsDatarate = mibSet->Param.ChannelsDatarate;
             break;
         }
         case MIB_CHANNELS_DEFAULT_TX_POWER:
         {
-            verify.TxPower = mibSet->Param.ChannelsDefaultTxPower;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_DEF_TX_POWER ) == true )
-            {
-                Nvm.MacGroup2.ChannelsTxPowerDefault = verify.TxPower;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.ChannelsTxPowerDefault = mibSet->Param.ChannelsDefaultTxPower;
             break;
         }
         case MIB_CHANNELS_TX_POWER:
         {
-            verify.TxPower = mibSet->Param.ChannelsTxPower;
-
-            if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_TX_POWER ) == true )
-            {
-                Nvm.MacGroup1.ChannelsTxPower = verify.TxPower;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup1.ChannelsTxPower = mibSet->Param.ChannelsTxPower;
             break;
         }
         case MIB_SYSTEM_MAX_RX_ERROR:
         {
-            if( mibSet->Param.SystemMaxRxError <= 500 )
-            { // Only apply the new value if in range 0..500 ms else keep current value.
-                Nvm.MacGroup2.MacParams.SystemMaxRxError = Nvm.MacGroup2.MacParamsDefaults.SystemMaxRxError = mibSet->Param.SystemMaxRxError;
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            Nvm.MacGroup2.MacParams.SystemMaxRxError = Nvm.MacGroup2.MacParamsDefaults.SystemMaxRxError = mibSet->Param.SystemMaxRxError;
             break;
         }
         case MIB_MIN_RX_SYMBOLS:
@@ -4905,104 +5354,43 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             Nvm.MacGroup2.MacParams.MinRxSymbols = Nvm.MacGroup2.MacParamsDefaults.MinRxSymbols = mibSet->Param.MinRxSymbols;
             break;
         }
-        case MIB_ANTENNA_GAIN:
-        {
-            Nvm.MacGroup2.MacParams.AntennaGain = mibSet->Param.AntennaGain;
-            break;
-        }
-        case MIB_DEFAULT_ANTENNA_GAIN:
-        {
-            Nvm.MacGroup2.MacParamsDefaults.AntennaGain = mibSet->Param.DefaultAntennaGain;
-            break;
-        }
         case MIB_NVM_CTXS:
         {
-            if( mibSet->Param.Contexts != 0 )
-            {
-                status = RestoreNvmData( mibSet->Param.Contexts );
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            status = RestoreNvmData( mibSet->Param.Contexts );
             break;
         }
         case MIB_ABP_LORAWAN_VERSION:
         {
-            if( mibSet->Param.AbpLrWanVersion.Fields.Minor <= 1 )
-            {
-                Nvm.MacGroup2.Version = mibSet->Param.AbpLrWanVersion;
+            Nvm.MacGroup2.Version = mibSet->Param.AbpLrWanVersion;
 
-                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetLrWanVersion( mibSet->Param.AbpLrWanVersion ) )
-                {
-                    return LORAMAC_STATUS_CRYPTO_ERROR;
-                }
-            }
-            else
+            if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetLrWanVersion( mibSet->Param.AbpLrWanVersion ) )
             {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                return LORAMAC_STATUS_CRYPTO_ERROR;
             }
             break;
         }
-        case MIB_IS_CERT_FPORT_ON:
-        {
-            Nvm.MacGroup2.IsCertPortOn = mibSet->Param.IsCertPortOn;
-            break;
-        }
         case MIB_REJOIN_0_CYCLE:
         {
             uint32_t cycleTime = 0;
-            if( ( ConvertRejoinCycleTime( mibSet->Param.Rejoin0CycleInSec, &cycleTime ) == true ) &&
-                ( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_OTAA ) )
-            {
-                Nvm.MacGroup2.Rejoin0CycleInSec = mibSet->Param.Rejoin0CycleInSec;
-                MacCtx.Rejoin0CycleTime = cycleTime;
-                TimerStop( &MacCtx.Rejoin0CycleTimer );
-                TimerSetValue( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
-                TimerStart( &MacCtx.Rejoin0CycleTimer );
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
+            ConvertRejoinCycleTime( mibSet->Param.Rejoin0CycleInSec, &cycleTime );
+
+            Nvm.MacGroup2.Rejoin0CycleInSec = mibSet->Param.Rejoin0CycleInSec;
+            MacCtx.Rejoin0CycleTime = cycleTime;
+            TimerStop( &MacCtx.Rejoin0CycleTimer );
+            TimerSetValue( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
+            TimerStart( &MacCtx.Rejoin0CycleTimer );
             break;
         }
         case MIB_REJOIN_1_CYCLE:
         {
             uint32_t cycleTime = 0;
-            if( ( ConvertRejoinCycleTime( mibSet->Param.Rejoin1CycleInSec, &cycleTime ) == true ) &&
-                ( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_OTAA ) )
-            {
-                Nvm.MacGroup2.Rejoin1CycleInSec = mibSet->Param.Rejoin1CycleInSec;
-                MacCtx.Rejoin0CycleTime = cycleTime;
-                TimerStop( &MacCtx.Rejoin1CycleTimer );
-                TimerSetValue( &MacCtx.Rejoin1CycleTimer, MacCtx.Rejoin1CycleTime );
-                TimerStart( &MacCtx.Rejoin1CycleTimer );
-            }
-            else
-            {
-                status = LORAMAC_STATUS_PARAMETER_INVALID;
-            }
-            break;
-        }
-        case MIB_ADR_ACK_LIMIT:
-        {
-            Nvm.MacGroup2.MacParams.AdrAckLimit = mibSet->Param.AdrAckLimit;
-            break;
-        }
-        case MIB_ADR_ACK_DELAY:
-        {
-            Nvm.MacGroup2.MacParams.AdrAckDelay = mibSet->Param.AdrAckDelay;
-            break;
-        }
-        case MIB_ADR_ACK_DEFAULT_LIMIT:
-        {
-            Nvm.MacGroup2.MacParamsDefaults.AdrAckLimit = mibSet->Param.AdrAckLimit;
-            break;
-        }
-        case MIB_ADR_ACK_DEFAULT_DELAY:
-        {
-            Nvm.MacGroup2.MacParamsDefaults.AdrAckDelay = mibSet->Param.AdrAckDelay;
+            ConvertRejoinCycleTime( mibSet->Param.Rejoin1CycleInSec, &cycleTime );
+
+            Nvm.MacGroup2.Rejoin1CycleInSec = mibSet->Param.Rejoin1CycleInSec;
+            MacCtx.Rejoin0CycleTime = cycleTime;
+            TimerStop( &MacCtx.Rejoin1CycleTimer );
+            TimerSetValue( &MacCtx.Rejoin1CycleTimer, MacCtx.Rejoin1CycleTime );
+            TimerStart( &MacCtx.Rejoin1CycleTimer );
             break;
         }
         case MIB_RSSI_FREE_THRESHOLD:
@@ -5037,6 +5425,37 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
 #endif
             break;
         }
+        case MIB_RXC_DUTY_CYCLE:
+        {
+            Nvm.MacGroup2.RxCDutyCycleOn = mibSet->Param.RxCDutyCycle;
+
+            if( ( Nvm.MacGroup2.DeviceClass == CLASS_C ) && ( MacCtx.RxSlot == RX_SLOT_WIN_CLASS_C ) )
+            {
+                // Restart the Class C listening in the requested mode
+                Radio.Sleep( );
+
+                OpenContinuousRxCWindow( );
+            }
+            break;
+        }
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+        case MIB_ENERGY_LEDGER:
+        {
+            // Any value resets the ledger
+            LoRaMacEnergyReset( );
+            break;
+        }
+        case MIB_ENERGY_MODEL:
+        {
+            LoRaMacEnergySetModel( mibSet->Param.EnergyModel );
+            break;
+        }
+#endif
+        case MIB_ADR_STRATEGY:
+        {
+            MacCtx.AdrStrategy = mibSet->Param.AdrStrategy;
+            break;
+        }
         default:
         {
             status = LoRaMacMibClassBSetRequestConfirm( mibSet );
@@ -5044,7 +5463,48 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         }
     }
 
-    if( status == LORAMAC_STATUS_OK )
+    return status;
+}
+
+LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
+{
+    return LoRaMacMibSetMany( mibSet, 1 );
+}
+
+LoRaMacStatus_t LoRaMacMibSetMany( MibRequestConfirm_t* mibSet, uint8_t nbMibSets )
+{
+    LoRaMacStatus_t status = LORAMAC_STATUS_OK;
+    uint8_t nbApplied = 0;
+
+    if( ( mibSet == NULL ) || ( nbMibSets == 0 ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    if( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) == LORAMAC_TX_RUNNING )
+    {
+        return LORAMAC_STATUS_BUSY;
+    }
+
+    // Verify all the attributes before applying any of them
+    for( uint8_t i = 0; i < nbMibSets; i++ )
+    {
+        status = VerifyMibSet( &mibSet[i] );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            return status;
+        }
+    }
+
+    for( ; nbApplied < nbMibSets; nbApplied++ )
+    {
+        status = SetMibRequest( &mibSet[nbApplied] );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            break;
+        }
+    }
+
+    if( nbApplied > 0 )
     {
         // Handle NVM potential changes
         MacCtx.MacFlags.Bits.NvmHandle = 1;
@@ -5259,14 +5719,6 @@ static void OnAbpJoinPendingTimerEvent( void *context )
  */
 static void AbpJoinPendingStart( void )
 {
-    static bool initialized = false;
-
-    if( initialized == false )
-    {
-        initialized = true;
-        TimerInit( &MacCtx.AbpJoinPendingTimer, OnAbpJoinPendingTimerEvent );
-    }
-
     MacCtx.MacState |= LORAMAC_ABP_JOIN_PENDING;
 
     TimerStop( &MacCtx.AbpJoinPendingTimer );
@@ -5614,6 +6066,79 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest )
     return status;
 }
 
+LoRaMacStatus_t LoRaMacMcpsQueueRequest( McpsReq_t* mcpsRequest, uint8_t priority, uint32_t lifetime )
+{
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+    McpsQueueItem_t* item;
+    void** buffer;
+    uint16_t* bufferSize;
+    uint8_t index;
+
+    if( mcpsRequest == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    mcpsRequest->ReqReturn.DutyCycleWaitTime = 0;
+
+    if( GetMcpsRequestPayload( mcpsRequest, &buffer, &bufferSize ) == false )
+    {
+        return LORAMAC_STATUS_SERVICE_UNKNOWN;
+    }
+    if( ( *buffer == NULL ) && ( *bufferSize > 0 ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    if( *bufferSize > LORAMAC_MCPS_QUEUE_MAX_PAYLOAD )
+    {
+        return LORAMAC_STATUS_LENGTH_ERROR;
+    }
+    if( MacCtx.McpsQueueCnt >= LORAMAC_MCPS_QUEUE_LEN )
+    {
+        return LORAMAC_STATUS_BUSY;
+    }
+
+    // Insert after the requests of higher or equal priority
+    index = MacCtx.McpsQueueCnt;
+    while( ( index > 0 ) && ( MacCtx.McpsQueue[index - 1].Priority < priority ) )
+    {
+        MacCtx.McpsQueue[index] = MacCtx.McpsQueue[index - 1];
+        index--;
+    }
+
+    item = &MacCtx.McpsQueue[index];
+    item->Request = *mcpsRequest;
+    if( *bufferSize > 0 )
+    {
+        memcpy1( item->Buffer, ( uint8_t* ) *buffer, *bufferSize );
+    }
+    item->Priority = priority;
+    item->QueuedTime = TimerGetCurrentTime( );
+    item->Lifetime = lifetime;
+    MacCtx.McpsQueueCnt++;
+
+    // Send right away, if the MAC is idle
+    OnMacProcessNotify( );
+    return LORAMAC_STATUS_OK;
+#else
+    // The queue is compiled out, it is always full
+    if( mcpsRequest == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    mcpsRequest->ReqReturn.DutyCycleWaitTime = 0;
+    return LORAMAC_STATUS_BUSY;
+#endif
+}
+
+uint8_t LoRaMacMcpsQueueGetCnt( void )
+{
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+    return MacCtx.McpsQueueCnt;
+#else
+    return 0;
+#endif
+}
+
 static bool ConvertRejoinCycleTime( uint32_t rejoinCycleTime, uint32_t* timeInMiliSec )
 {
     // Our timer implementation do not allow longer times than 4294967295 ms
@@ -5680,6 +6205,15 @@ static void OnForceRejoinReqCycleTimerEvent( void* context )
     OnMacProcessNotify( );
 }
 
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+static void OnMcpsQueueTimerEvent( void* context )
+{
+    TimerStop( &MacCtx.McpsQueueTimer );
+
+    OnMacProcessNotify( );
+}
+#endif
+
 void LoRaMacTestSetDutyCycleOn( bool enable )
 {
     VerifyParams_t verify;
@@ -5703,6 +6237,9 @@ LoRaMacStatus_t LoRaMacDeInitialization( void )
         TimerStop( &MacCtx.TxDelayedTimer );
         TimerStop( &MacCtx.RxWindowTimer1 );
         TimerStop( &MacCtx.RxWindowTimer2 );
+#if( LORAMAC_MCPS_QUEUE_LEN > 0 )
+        TimerStop( &MacCtx.McpsQueueTimer );
+#endif
 
         // Take care about class B
         LoRaMacClassBHaltBeaconing( );
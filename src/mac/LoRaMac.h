@@ -82,6 +82,7 @@ extern "C"
 #include "LoRaMacCryptoNvm.h"
 #include "secure-element-nvm.h"
 #include "LoRaMacClassBNvm.h"
+#include "LoRaMacEnergy.h"
 
 /*!
  * LoRaWAN version definition.
@@ -123,6 +124,20 @@ extern "C"
  */
 #define LORA_MAC_COMMAND_MAX_LENGTH                 128
 
+/*!
+ * LoRaMac MCPS-Request queue length. 0 compiles the queue out.
+ */
+#ifndef LORAMAC_MCPS_QUEUE_LEN
+#define LORAMAC_MCPS_QUEUE_LEN                      0
+#endif
+
+/*!
+ * Maximum application payload size of a queued MCPS-Request
+ */
+#ifndef LORAMAC_MCPS_QUEUE_MAX_PAYLOAD
+#define LORAMAC_MCPS_QUEUE_MAX_PAYLOAD              242
+#endif
+
 
 /*!
  * Bitmap value
@@ -480,6 +495,10 @@ typedef enum eLoRaMacEventInfoStatus
      * ToDo
      */
     LORAMAC_EVENT_INFO_STATUS_BEACON_NOT_FOUND,
+    /*!
+     * A queued MCPS-Request expired before the MAC could send it
+     */
+    LORAMAC_EVENT_INFO_STATUS_TX_EXPIRED,
 }LoRaMacEventInfoStatus_t;
 
 /*!
@@ -617,6 +636,10 @@ typedef struct sLoRaMacNvmDataGroup1
      * received a RekeyConf.
      */
     uint16_t RekeyIndUplinksCounter;
+    /*!
+     * Learned RX timing error [us]. 0 while no downlink has been measured.
+     */
+    uint32_t RxErrorEstimate;
     /*!
      * CRC32 value of the MacGroup1 data structure.
      */
@@ -692,6 +715,14 @@ typedef struct sLoRaMacNvmDataGroup2
      * Enables/disable FPort 224 processing (certification port)
      */
     bool IsCertPortOn;
+    /*
+     * Enables/disables the adaptive RX window sizing
+     */
+    bool AdaptiveRxErrorOn;
+    /*
+     * Enables/disables the Class C low-power listening
+     */
+    bool RxCDutyCycleOn;
     /*
      * Aggregated duty cycle management
      */
@@ -1034,6 +1065,14 @@ typedef struct sMcpsIndication
     uint8_t IsUplinkTxPending;
     /*!
      * Pointer to the received data stream
+     *
+     * \remark In Class A the data is decrypted in place and points inside the
+     *         radio driver reception buffer. In Class B and Class C the radio
+     *         keeps receiving and the data is copied to a MAC layer buffer.
+     *         In both cases it is lent to the upper layer for the duration of
+     *         the \ref LoRaMacPrimitives_t.MacMcpsIndication callback only.
+     *         The upper layer may modify it in place but must copy it if the
+     *         data is needed once the callback returns.
      */
     uint8_t* Buffer;
     /*!
@@ -1078,6 +1117,11 @@ typedef struct sMcpsIndication
      * cases this variable is 0.
      */
     TimerTime_t ResponseTimeout;
+    /*!
+     * End of the reception, captured by the radio IRQ. Same time base as
+     * \ref TimerGetCurrentTime.
+     */
+    TimerTime_t RxDoneTime;
 }McpsIndication_t;
 
 /*!
@@ -1467,6 +1511,13 @@ typedef struct sMlmeIndication
  * \ref MIB_ADR_ACK_DEFAULT_DELAY                | YES | YES
  * \ref MIB_RSSI_FREE_THRESHOLD                  | YES | YES
  * \ref MIB_CARRIER_SENSE_TIME                   | YES | YES
+ * \ref MIB_ADAPTIVE_RX_ERROR                    | YES | YES
+ * \ref MIB_RX_ERROR_ESTIMATE                    | YES | NO
+ * \ref MIB_RXC_DUTY_CYCLE                       | YES | YES
+ * \ref MIB_LBT_CHANNEL_STATS                    | YES | NO
+ * \ref MIB_ENERGY_LEDGER                        | YES | YES
+ * \ref MIB_ENERGY_MODEL                         | YES | YES
+ * \ref MIB_ADR_STRATEGY                         | YES | YES
  *
  * The following table provides links to the function implementations of the
  * related MIB primitives:
@@ -1918,7 +1969,45 @@ typedef enum eMib
      /*!
       * Carrier sense time value (KR920 and AS923 only)
       */
-     MIB_CARRIER_SENSE_TIME
+     MIB_CARRIER_SENSE_TIME,
+     /*!
+      * Adaptive RX window sizing. When enabled, the RX1 and RX2 windows are
+      * sized from the timing error learned from the received downlinks,
+      * bounded by MIB_SYSTEM_MAX_RX_ERROR. The learned error is widened
+      * after each missed downlink.
+      */
+     MIB_ADAPTIVE_RX_ERROR,
+     /*!
+      * Learned RX timing error in microseconds. 0 while no downlink has been
+      * measured.
+      */
+     MIB_RX_ERROR_ESTIMATE,
+     /*!
+      * Class C low-power listening. When enabled, the RxC window duty cycles
+      * the radio reception using sleep periods shorter than the downlink
+      * preamble. Falls back to continuous reception when the radio driver
+      * doesn't support it or when the RxC datarate preamble is too short.
+      */
+     MIB_RXC_DUTY_CYCLE,
+     /*!
+      * Listen before talk channels occupancy statistics (KR920 and AS923
+      * LBT channel plans only)
+      */
+     MIB_LBT_CHANNEL_STATS,
+     /*!
+      * Energy and airtime ledger. MIB-Set resets the ledger, whatever the
+      * given value. Requires LORAMAC_ENERGY_LEDGER_ENABLED.
+      */
+     MIB_ENERGY_LEDGER,
+     /*!
+      * Energy model used to estimate the charge of the ledger entries.
+      * Requires LORAMAC_ENERGY_LEDGER_ENABLED.
+      */
+     MIB_ENERGY_MODEL,
+     /*!
+      * Device side ADR strategy, see LoRaMacAdr.h
+      */
+     MIB_ADR_STRATEGY
 }Mib_t;
 
 /*!
@@ -2389,6 +2478,50 @@ typedef union uMibParam
      * Related MIB type: \ref MIB_CARRIER_SENSE_TIME
      */
     uint32_t CarrierSenseTime;
+    /*!
+     * Adaptive RX window sizing
+     *
+     * Related MIB type: \ref MIB_ADAPTIVE_RX_ERROR
+     */
+    bool AdaptiveRxError;
+    /*!
+     * Learned RX timing error [us]
+     *
+     * Related MIB type: \ref MIB_RX_ERROR_ESTIMATE
+     */
+    uint32_t RxErrorEstimate;
+    /*!
+     * Class C low-power listening
+     *
+     * Related MIB type: \ref MIB_RXC_DUTY_CYCLE
+     */
+    bool RxCDutyCycle;
+    /*!
+     * Listen before talk channels occupancy statistics, indexed by channel.
+     * NULL when the region doesn't perform listen before talk.
+     *
+     * Related MIB type: \ref MIB_LBT_CHANNEL_STATS
+     */
+    LbtChannelStats_t* LbtChannelStats;
+    /*!
+     * Energy and airtime ledger
+     *
+     * Related MIB type: \ref MIB_ENERGY_LEDGER
+     */
+    const LoRaMacEnergyLedger_t* EnergyLedger;
+    /*!
+     * Energy model. The structure must stay valid while it is used.
+     *
+     * Related MIB type: \ref MIB_ENERGY_MODEL
+     */
+    const LoRaMacEnergyModel_t* EnergyModel;
+    /*!
+     * Device side ADR strategy, NULL disables it. The structure must stay
+     * valid while it is used.
+     *
+     * Related MIB type: \ref MIB_ADR_STRATEGY
+     */
+    const struct sLoRaMacAdrStrategy* AdrStrategy;
 }MibParam_t;
 
 /*!
@@ -2842,6 +2975,43 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet );
  */
 LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet );
 
+/*!
+ * \brief   LoRaMAC MIB-Set of several attributes
+ *
+ * \details Verifies all the requests before applying any of them. The
+ *          requests are then applied in order within the call and the NVM
+ *          data change is signaled once.
+ *
+ *          The requests are verified against the MAC state prior to the call.
+ *          A request which can only fail while being applied ( e.g. class
+ *          switch, secure element access ) stops the processing. The requests
+ *          preceding it remain applied.
+ *
+ * \code
+ * MibRequestConfirm_t mibReq[2];
+ * mibReq[0].Type = MIB_ADR;
+ * mibReq[0].Param.AdrEnable = true;
+ * mibReq[1].Type = MIB_CHANNELS_DATARATE;
+ * mibReq[1].Param.ChannelsDatarate = DR_0;
+ *
+ * if( LoRaMacMibSetMany( mibReq, 2 ) == LORAMAC_STATUS_OK )
+ * {
+ *   // LoRaMAC updated the parameters
+ * }
+ * \endcode
+ *
+ * \param   [IN] mibSet - MIB-SET-Requests to perform. Refer to \ref MibRequestConfirm_t.
+ *
+ * \param   [IN] nbMibSets - Number of requests.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_BUSY,
+ *          \ref LORAMAC_STATUS_SERVICE_UNKNOWN,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacMibSetMany( MibRequestConfirm_t* mibSet, uint8_t nbMibSets );
+
 /*!
  * \brief   LoRaMAC MLME-Request
  *
@@ -2909,6 +3079,48 @@ LoRaMacStatus_t LoRaMacMlmeRequest( MlmeReq_t* mlmeRequest );
  */
 LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest );
 
+/*!
+ * \brief   LoRaMAC MCPS-Request queuing
+ *
+ * \details Queues a MCPS-Request. The MAC sends the queued requests as soon
+ *          as it is idle and the duty cycle allows it. Higher priorities are
+ *          sent first, requests of a same priority are sent in queuing order.
+ *          The payload is copied, the application buffer can be reused right
+ *          after the call.
+ *
+ *          Every queued request ends with a MCPS-Confirm event. Requests which
+ *          expired before their transmission are confirmed with the status
+ *          \ref LORAMAC_EVENT_INFO_STATUS_TX_EXPIRED. Requests rejected by
+ *          \ref LoRaMacMcpsRequest are confirmed with the status
+ *          \ref LORAMAC_EVENT_INFO_STATUS_ERROR. These confirms are only
+ *          delivered from \ref LoRaMacProcess while no uplink is in flight.
+ *
+ *          When LORAMAC_MCPS_QUEUE_LEN is 0 the queue is compiled out and the
+ *          requests are rejected with \ref LORAMAC_STATUS_BUSY.
+ *
+ * \param   [IN] mcpsRequest - MCPS-Request to queue. Refer to \ref McpsReq_t.
+ *
+ * \param   [IN] priority - Priority of the request. Higher values are sent first.
+ *
+ * \param   [IN] lifetime - Maximum time the request waits in the queue [ms].
+ *                         0 for no limit.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_BUSY,
+ *          \ref LORAMAC_STATUS_SERVICE_UNKNOWN,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_LENGTH_ERROR,
+ */
+LoRaMacStatus_t LoRaMacMcpsQueueRequest( McpsReq_t* mcpsRequest, uint8_t priority, uint32_t lifetime );
+
+/*!
+ * \brief   Gets the number of queued MCPS-Requests
+ *
+ * \retval  Number of requests waiting in the queue
+ */
+uint8_t LoRaMacMcpsQueueGetCnt( void );
+
 /*!
  * \brief   LoRaMAC deinitialization
  *
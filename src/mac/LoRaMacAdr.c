@@ -33,6 +33,262 @@
 
 #include "region/Region.h"
 #include "LoRaMacAdr.h"
+#include "LoRaMacInstance.h"
+
+/*!
+ * Demodulation floor of a datarate with an unknown or non LoRa modulation
+ */
+#define LINK_MARGIN_FLOOR_UNKNOWN                   INT16_MAX
+
+/*!
+ * SNR history of the link margin strategy [0.1 dB], normalized to an uplink
+ * at TX power 0 in a 125 kHz channel
+ */
+static int16_t LORAMAC_INSTANCE_STATE( LinkMarginSnr )[LORAMAC_ADR_LINK_MARGIN_HISTORY];
+
+/*!
+ * Number of valid entries in LinkMarginSnr
+ */
+static uint8_t LORAMAC_INSTANCE_STATE( LinkMarginNbSnr );
+
+/*!
+ * Next entry of LinkMarginSnr to be written
+ */
+static uint8_t LORAMAC_INSTANCE_STATE( LinkMarginSnrIndex );
+
+/*!
+ * Results of the last 8 confirmed uplinks, bit set for a missed
+ * acknowledgement, LSB is the latest
+ */
+static uint8_t LORAMAC_INSTANCE_STATE( LinkMarginAckFailures );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define LinkMarginSnr                               LORAMAC_INSTANCE( LinkMarginSnr )
+#define LinkMarginNbSnr                             LORAMAC_INSTANCE( LinkMarginNbSnr )
+#define LinkMarginSnrIndex                          LORAMAC_INSTANCE( LinkMarginSnrIndex )
+#define LinkMarginAckFailures                       LORAMAC_INSTANCE( LinkMarginAckFailures )
+#endif
+
+/*!
+ * \brief Gets the noise difference between the channel of a datarate and a
+ *        125 kHz channel
+ *
+ * \param [IN] region Region
+ *
+ * \param [IN] datarate Datarate
+ *
+ * \retval Noise difference [0.1 dB]. Wider channels take 3 dB more noise per
+ *         doubling.
+ */
+static int16_t LinkMarginGetBandwidthOffset( LoRaMacRegion_t region, int8_t datarate )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+
+    getPhy.Attribute = PHY_BW_FROM_DR;
+    getPhy.Datarate = datarate;
+    phyParam = RegionGetPhyParam( region, &getPhy );
+    if( phyParam.Value == 250000 )
+    {
+        return 30;
+    }
+    else if( phyParam.Value == 500000 )
+    {
+        return 60;
+    }
+    return 0;
+}
+
+/*!
+ * \brief Gets the demodulation floor of a datarate
+ *
+ * \param [IN] region Region
+ *
+ * \param [IN] datarate Datarate
+ *
+ * \retval SNR demodulation floor in a 125 kHz channel [0.1 dB],
+ *         LINK_MARGIN_FLOOR_UNKNOWN if the datarate isn't a LoRa datarate
+ */
+static int16_t LinkMarginGetFloor( LoRaMacRegion_t region, int8_t datarate )
+{
+    // SF7 to SF12 demodulation floors [0.1 dB]
+    static const int16_t floors[] = { -75, -100, -125, -150, -175, -200 };
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    int16_t floor;
+
+    getPhy.Attribute = PHY_SF_FROM_DR;
+    getPhy.Datarate = datarate;
+    phyParam = RegionGetPhyParam( region, &getPhy );
+    if( ( phyParam.Value < 7 ) || ( phyParam.Value > 12 ) )
+    {
+        return LINK_MARGIN_FLOOR_UNKNOWN;
+    }
+    floor = floors[phyParam.Value - 7];
+
+    // The floor applies to the SNR measured in the datarate channel
+    return floor + LinkMarginGetBandwidthOffset( region, datarate );
+}
+
+/*!
+ * \brief Adds a SNR to the history
+ *
+ * \param [IN] snr SNR normalized to an uplink at TX power 0 in a 125 kHz
+ *                 channel [0.1 dB]
+ */
+static void LinkMarginAddSnr( int16_t snr )
+{
+    LinkMarginSnr[LinkMarginSnrIndex] = snr;
+    LinkMarginSnrIndex = ( LinkMarginSnrIndex + 1 ) % LORAMAC_ADR_LINK_MARGIN_HISTORY;
+    if( LinkMarginNbSnr < LORAMAC_ADR_LINK_MARGIN_HISTORY )
+    {
+        LinkMarginNbSnr++;
+    }
+}
+
+static void LinkMarginOnLinkQuality( const LoRaMacAdrLinkQuality_t* linkQuality )
+{
+    int16_t floor;
+
+    switch( linkQuality->Event )
+    {
+        case LORAMAC_ADR_LINK_DOWNLINK:
+        {
+            // The link budget is assumed symmetric. The downlink SNR is
+            // measured in the downlink channel.
+            LinkMarginAddSnr( ( linkQuality->Snr * 10 ) +
+                              LinkMarginGetBandwidthOffset( linkQuality->Region, linkQuality->Datarate ) );
+            break;
+        }
+        case LORAMAC_ADR_LINK_CHECK:
+        {
+            floor = LinkMarginGetFloor( linkQuality->Region, linkQuality->Datarate );
+            if( floor != LINK_MARGIN_FLOOR_UNKNOWN )
+            {
+                LinkMarginAddSnr( floor + ( linkQuality->Margin * 10 ) +
+                                  ( linkQuality->TxPower * LORAMAC_ADR_LINK_MARGIN_TX_POWER_STEP * 10 ) );
+            }
+            break;
+        }
+        case LORAMAC_ADR_LINK_ACK:
+        {
+            LinkMarginAckFailures <<= 1;
+            if( linkQuality->AckReceived == false )
+            {
+                LinkMarginAckFailures |= 1;
+                // Wait for fresh samples
+                LinkMarginNbSnr = 0;
+            }
+            break;
+        }
+        case LORAMAC_ADR_LINK_JOIN:
+        {
+            LoRaMacAdrStrategyLinkMarginReset( );
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+static void LinkMarginCalcNext( const CalcNextAdrParams_t* adrNext, int8_t* drOut, int8_t* txPowOut )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    VerifyParams_t verify;
+    int8_t maxDatarate = INT8_MAX;
+    int8_t maxTxPower;
+    int8_t datarate;
+    int8_t txPower;
+    int16_t snr;
+    int16_t floor;
+    uint8_t nbAckFailures = 0;
+
+    for( uint8_t i = 0; i < 8; i++ )
+    {
+        nbAckFailures += ( LinkMarginAckFailures >> i ) & 0x01;
+    }
+    if( ( LinkMarginNbSnr < LORAMAC_ADR_LINK_MARGIN_MIN_SAMPLES ) ||
+        ( nbAckFailures > LORAMAC_ADR_LINK_MARGIN_MAX_ACK_FAILURES ) ||
+        ( ( LinkMarginAckFailures & 0x01 ) != 0 ) ||
+        ( adrNext->AdrAckCounter >= adrNext->AdrAckLimit ) )
+    {
+        return;
+    }
+
+    // Limits, the regions verify the datarates
+    getPhy.Attribute = PHY_MAX_TX_POWER;
+    phyParam = RegionGetPhyParam( adrNext->Region, &getPhy );
+    maxTxPower = phyParam.Value;
+    if( adrNext->AdrEnabled == true )
+    {
+        if( ( adrNext->GrantedDatarate < 0 ) || ( adrNext->GrantedTxPower < 0 ) )
+        {
+            // The network didn't run ADR yet
+            return;
+        }
+        maxDatarate = adrNext->GrantedDatarate;
+        maxTxPower = MIN( maxTxPower, adrNext->GrantedTxPower );
+    }
+
+    snr = LinkMarginSnr[0];
+    for( uint8_t i = 1; i < LinkMarginNbSnr; i++ )
+    {
+        snr = MAX( snr, LinkMarginSnr[i] );
+    }
+    snr -= LORAMAC_ADR_LINK_MARGIN_INSTALLATION * 10;
+
+    // Fastest datarate above the demodulation floor
+    datarate = *drOut;
+    floor = LinkMarginGetFloor( adrNext->Region, datarate );
+    if( ( floor == LINK_MARGIN_FLOOR_UNKNOWN ) || ( snr < floor ) )
+    {
+        return;
+    }
+    while( datarate < maxDatarate )
+    {
+        int16_t nextFloor = LinkMarginGetFloor( adrNext->Region, datarate + 1 );
+
+        verify.DatarateParams.Datarate = datarate + 1;
+        verify.DatarateParams.UplinkDwellTime = adrNext->UplinkDwellTime;
+        if( ( RegionVerify( adrNext->Region, &verify, PHY_TX_DR ) == false ) ||
+            ( nextFloor == LINK_MARGIN_FLOOR_UNKNOWN ) || ( snr < nextFloor ) )
+        {
+            break;
+        }
+        datarate++;
+        floor = nextFloor;
+    }
+
+    // Lowest TX power with the remaining margin
+    txPower = ( snr - floor ) / ( LORAMAC_ADR_LINK_MARGIN_TX_POWER_STEP * 10 );
+    txPower = MIN( txPower, maxTxPower );
+
+    if( datarate > *drOut )
+    {
+        *drOut = datarate;
+        *txPowOut = txPower;
+    }
+    else if( txPower > *txPowOut )
+    {
+        *txPowOut = txPower;
+    }
+}
+
+const LoRaMacAdrStrategy_t LoRaMacAdrStrategyLinkMargin =
+{
+    LinkMarginOnLinkQuality,
+    LinkMarginCalcNext
+};
+
+void LoRaMacAdrStrategyLinkMarginReset( void )
+{
+    LinkMarginNbSnr = 0;
+    LinkMarginSnrIndex = 0;
+    LinkMarginAckFailures = 0;
+}
 
 bool LoRaMacAdrCalcNext( CalcNextAdrParams_t* adrNext, int8_t* drOut, int8_t* txPowOut,
                          uint8_t* nbTransOut, uint32_t* adrAckCounter )
@@ -102,6 +358,11 @@ bool LoRaMacAdrCalcNext( CalcNextAdrParams_t* adrNext, int8_t* drOut, int8_t* tx
         }
     }
 
+    if( ( adrNext->Strategy != NULL ) && ( adrNext->Strategy->CalcNext != NULL ) )
+    {
+        adrNext->Strategy->CalcNext( adrNext, &datarate, &txPower );
+    }
+
     *drOut = datarate;
     *txPowOut = txPower;
     *nbTransOut = nbTrans;
@@ -42,8 +42,106 @@ extern "C"
 {
 #endif
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "LoRaMac.h"
+
 /*! \} defgroup LORAMACADR */
 
+/*!
+ * Number of link quality samples kept by \ref LoRaMacAdrStrategyLinkMargin
+ */
+#define LORAMAC_ADR_LINK_MARGIN_HISTORY             8
+
+/*!
+ * Minimum number of link quality samples required by
+ * \ref LoRaMacAdrStrategyLinkMargin to change the datarate or the TX power
+ */
+#define LORAMAC_ADR_LINK_MARGIN_MIN_SAMPLES         3
+
+/*!
+ * Installation margin kept by \ref LoRaMacAdrStrategyLinkMargin [dB]
+ */
+#ifndef LORAMAC_ADR_LINK_MARGIN_INSTALLATION
+#define LORAMAC_ADR_LINK_MARGIN_INSTALLATION        10
+#endif
+
+/*!
+ * TX power index step assumed by \ref LoRaMacAdrStrategyLinkMargin [dB]
+ */
+#define LORAMAC_ADR_LINK_MARGIN_TX_POWER_STEP       2
+
+/*!
+ * Maximum number of missed acknowledgements, in the last 8 confirmed
+ * uplinks, for \ref LoRaMacAdrStrategyLinkMargin to change the datarate or
+ * the TX power
+ */
+#define LORAMAC_ADR_LINK_MARGIN_MAX_ACK_FAILURES    1
+
+/*!
+ * Link quality event types
+ */
+typedef enum eLoRaMacAdrLinkEvent
+{
+    /*!
+     * Unicast downlink received in a RX window
+     */
+    LORAMAC_ADR_LINK_DOWNLINK,
+    /*!
+     * LinkCheckAns received
+     */
+    LORAMAC_ADR_LINK_CHECK,
+    /*!
+     * End of a confirmed uplink
+     */
+    LORAMAC_ADR_LINK_ACK,
+    /*!
+     * Join accept received, the link quality history is obsolete
+     */
+    LORAMAC_ADR_LINK_JOIN
+}LoRaMacAdrLinkEvent_t;
+
+/*!
+ * Link quality event
+ */
+typedef struct sLoRaMacAdrLinkQuality
+{
+    /*!
+     * Event type
+     */
+    LoRaMacAdrLinkEvent_t Event;
+    /*!
+     * Region
+     */
+    LoRaMacRegion_t Region;
+    /*!
+     * LORAMAC_ADR_LINK_DOWNLINK: downlink datarate.
+     * LORAMAC_ADR_LINK_CHECK and LORAMAC_ADR_LINK_ACK: uplink datarate.
+     */
+    int8_t Datarate;
+    /*!
+     * LORAMAC_ADR_LINK_CHECK and LORAMAC_ADR_LINK_ACK: uplink TX power.
+     */
+    int8_t TxPower;
+    /*!
+     * LORAMAC_ADR_LINK_DOWNLINK: downlink SNR, measured in the downlink
+     * channel bandwidth [dB]
+     */
+    int8_t Snr;
+    /*!
+     * LORAMAC_ADR_LINK_DOWNLINK: downlink RSSI [dBm]
+     */
+    int16_t Rssi;
+    /*!
+     * LORAMAC_ADR_LINK_CHECK: uplink demodulation margin [dB]
+     */
+    uint8_t Margin;
+    /*!
+     * LORAMAC_ADR_LINK_ACK: set to true, if the uplink has been acknowledged
+     */
+    bool AckReceived;
+}LoRaMacAdrLinkQuality_t;
+
 /*
  * Parameter structure for the function CalcNextAdr.
  */
@@ -89,8 +187,77 @@ typedef struct sCalcNextAdrParams
      * Region
      */
     LoRaMacRegion_t Region;
+    /*!
+     * Last datarate granted by a LinkADRReq, -1 if none
+     */
+    int8_t GrantedDatarate;
+    /*!
+     * Last TX power granted by a LinkADRReq, -1 if none
+     */
+    int8_t GrantedTxPower;
+    /*!
+     * Device side ADR strategy, NULL if none
+     */
+    const struct sLoRaMacAdrStrategy* Strategy;
 }CalcNextAdrParams_t;
 
+/*!
+ * Device side ADR strategy
+ *
+ * \remark The strategy runs after the ADR back-off of \ref LoRaMacAdrCalcNext.
+ *         It must stay within the network granted limits when ADR is enabled.
+ */
+typedef struct sLoRaMacAdrStrategy
+{
+    /*!
+     * \brief Notifies a link quality event. May be NULL.
+     *
+     * \param [IN] linkQuality Link quality event
+     */
+    void ( *OnLinkQuality )( const LoRaMacAdrLinkQuality_t* linkQuality );
+    /*!
+     * \brief Proposes the datarate and the TX power of the next uplink. Must
+     *        not change the strategy state, as it is also called for
+     *        information purposes only.
+     *
+     * \param [IN] adrNext Parameters of \ref LoRaMacAdrCalcNext
+     *
+     * \param [IN/OUT] drOut Datarate calculated by the ADR back-off
+     *
+     * \param [IN/OUT] txPowOut TX power calculated by the ADR back-off
+     */
+    void ( *CalcNext )( const CalcNextAdrParams_t* adrNext, int8_t* drOut, int8_t* txPowOut );
+}LoRaMacAdrStrategy_t;
+
+/*!
+ * \brief Built-in device side ADR strategy.
+ *
+ * \details The strategy keeps the best SNR of the last
+ *          LORAMAC_ADR_LINK_MARGIN_HISTORY downlinks and LinkCheckAns, the
+ *          latter converted back to an equivalent SNR. It then selects the
+ *          fastest datarate, and then the lowest TX power, keeping
+ *          LORAMAC_ADR_LINK_MARGIN_INSTALLATION above the demodulation floor.
+ *
+ *          The link budget is assumed symmetric: a downlink SNR is taken as
+ *          the SNR of an uplink at TX power 0, after normalization to a
+ *          125 kHz channel.
+ *
+ *          The strategy never proposes a slower datarate, nor a higher TX
+ *          power at the same datarate. It is limited by the last LinkADRReq
+ *          values when ADR is enabled, or by the region limits otherwise.
+ *          It does nothing while the ADR acknowledgement is requested, or
+ *          after missed acknowledgements. A missed acknowledgement clears
+ *          the SNR history, a join clears the whole state.
+ */
+extern const LoRaMacAdrStrategy_t LoRaMacAdrStrategyLinkMargin;
+
+/*!
+ * \brief Clears the history of \ref LoRaMacAdrStrategyLinkMargin
+ *
+ * \remark Called by the strategy on LORAMAC_ADR_LINK_JOIN
+ */
+void LoRaMacAdrStrategyLinkMarginReset( void );
+
 /*!
  * \brief Calculates the next datarate to set, when ADR is on or off.
  *
@@ -104,6 +271,8 @@ typedef struct sCalcNextAdrParams
  * | 128...159   | Set data rate to default (if already default, do nothing) |
  * | >=160       | Set NbTrans to 1, re-enable default channels              |
  *
+ * The device side ADR strategy, if any, is applied afterwards.
+ *
  * \param [IN] adrNext Pointer to the function parameters.
  *
  * \param [OUT] drOut The calculated datarate for the next TX.
@@ -26,11 +26,76 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #include "LoRaMacClassBConfig.h"
 #include "LoRaMacCrypto.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacInstance.h"
 #include "radio.h"
 #include "region/Region.h"
 
 #ifdef LORAMAC_CLASSB_ENABLED
 
+/*!
+ * Maximum number of downlink channels held by the beacon plan. Channel
+ * plans with more channels query the region on each downlink.
+ */
+#define CLASSB_PLAN_MAX_CHANNELS                    8
+
+/*!
+ * Downlink channels of the beacons or of the ping slots
+ */
+typedef struct sClassBDownlinkPlan
+{
+    /*!
+    * Number of channels of the hopping sequence
+    */
+    uint8_t NbChannels;
+    /*!
+    * Channel index offset of the hopping sequence
+    */
+    uint8_t Offset;
+    /*!
+    * Frequencies of the hopping sequence channels
+    */
+    uint32_t Frequencies[CLASSB_PLAN_MAX_CHANNELS];
+}ClassBDownlinkPlan_t;
+
+/*!
+ * Region parameters of the beacon and ping slot receptions. Computed once
+ * per beacon acquisition instead of once per beacon period.
+ */
+typedef struct sClassBBeaconPlan
+{
+    /*!
+    * Set to true, if the plan has been computed
+    */
+    bool Valid;
+    /*!
+    * Beacon channels
+    */
+    ClassBDownlinkPlan_t Beacon;
+    /*!
+    * Ping slot channels
+    */
+    ClassBDownlinkPlan_t PingSlot;
+    /*!
+    * Beacon datarate
+    */
+    int8_t BeaconDatarate;
+    /*!
+    * Set to true, if RxConfig holds the beacon window parameters
+    */
+    bool RxConfigValid;
+    /*!
+    * Maximum rx error used to compute RxConfig
+    */
+    uint32_t MaxRxError;
+    /*!
+    * Minimum rx symbols used to compute RxConfig
+    */
+    uint8_t MinRxSymbols;
+    /*!
+    * Beacon window parameters
+    */
+    RxConfigParams_t RxConfig;
+}ClassBBeaconPlan_t;
 
 /*
  * LoRaMac Class B Context structure
@@ -78,6 +143,18 @@ typedef struct sLoRaMacClassBCtx
     * in class b operation.
     */
     LoRaMacClassBParams_t LoRaMacClassBParams;
+    /*!
+    * Beacon and ping slot reception plan
+    */
+    ClassBBeaconPlan_t BeaconPlan;
+    /*!
+    * Reception parameters of the next ping slot
+    */
+    RxConfigParams_t PingSlotRxConfig;
+    /*!
+    * Reception parameters of the next multicast slot
+    */
+    RxConfigParams_t MulticastSlotRxConfig;
 } LoRaMacClassBCtx_t;
 
 /*!
@@ -94,12 +171,12 @@ typedef union uLoRaMacClassBEvents
     }Events;
 }LoRaMacClassBEvents_t;
 
-LoRaMacClassBEvents_t LoRaMacClassBEvents = { .Value = 0 };
+LoRaMacClassBEvents_t LORAMAC_INSTANCE_STATE( LoRaMacClassBEvents );
 
 /*
  * Module context.
  */
-static LoRaMacClassBCtx_t Ctx;
+static LoRaMacClassBCtx_t LORAMAC_INSTANCE_STATE( Ctx );
 
 /*
  * Beacon transmit time precision in milliseconds.
@@ -109,11 +186,56 @@ static LoRaMacClassBCtx_t Ctx;
  */
 static const uint8_t BeaconPrecTimeValue[4] = { 0, 1, 1, 1 };
 
+/*
+ * CRC-16 CCITT lookup table, polynomial 0x1021.
+ */
+static const uint16_t BeaconCrcTable[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
 /*!
  * Data structure which holds the parameters which needs to be stored
  * in the NVM.
  */
-static LoRaMacClassBNvmData_t* ClassBNvm;
+static LoRaMacClassBNvmData_t* LORAMAC_INSTANCE_STATE( ClassBNvm );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define LoRaMacClassBEvents                         LORAMAC_INSTANCE( LoRaMacClassBEvents )
+#define Ctx                                         LORAMAC_INSTANCE( Ctx )
+#define ClassBNvm                                   LORAMAC_INSTANCE( ClassBNvm )
+#endif
 
 /*!
  * Computes the Ping Offset
@@ -234,6 +356,97 @@ static uint32_t CalcDownlinkChannelAndFrequency( uint32_t devAddr, TimerTime_t b
     return CalcDownlinkFrequency( channel, isBeacon );
 }
 
+/*!
+ * \brief Computes the downlink channels of the beacons or of the ping slots.
+ *
+ * \param [OUT] plan Downlink channels
+ *
+ * \param [IN] isBeacon Set to true, if the function shall
+ *                      compute the beacon channels.
+ */
+static void ComputeDownlinkPlan( ClassBDownlinkPlan_t* plan, bool isBeacon )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+
+    getPhy.Attribute = ( isBeacon == true ) ? PHY_BEACON_NB_CHANNELS : PHY_PING_SLOT_NB_CHANNELS;
+    phyParam = RegionGetPhyParam( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &getPhy );
+    plan->NbChannels = ( uint8_t ) phyParam.Value;
+    plan->Offset = 0;
+
+    if( plan->NbChannels > 1 )
+    {
+        getPhy.Attribute = PHY_BEACON_CHANNEL_OFFSET;
+        phyParam = RegionGetPhyParam( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &getPhy );
+        plan->Offset = ( uint8_t ) phyParam.Value;
+    }
+
+    for( uint8_t i = 0; i < MIN( MAX( plan->NbChannels, 1 ), CLASSB_PLAN_MAX_CHANNELS ); i++ )
+    {
+        plan->Frequencies[i] = CalcDownlinkFrequency( ( plan->NbChannels > 1 ) ? plan->Offset + i : 0, isBeacon );
+    }
+}
+
+/*!
+ * \brief Computes the beacon plan, if it is not valid.
+ */
+static void UpdateBeaconPlan( void )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+
+    if( Ctx.BeaconPlan.Valid == true )
+    {
+        return;
+    }
+
+    ComputeDownlinkPlan( &Ctx.BeaconPlan.Beacon, true );
+    ComputeDownlinkPlan( &Ctx.BeaconPlan.PingSlot, false );
+
+    getPhy.Attribute = PHY_BEACON_CHANNEL_DR;
+    phyParam = RegionGetPhyParam( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &getPhy );
+    Ctx.BeaconPlan.BeaconDatarate = ( int8_t ) phyParam.Value;
+
+    Ctx.BeaconPlan.RxConfigValid = false;
+    Ctx.BeaconPlan.Valid = true;
+}
+
+/*!
+ * \brief Calculates the downlink frequency for the beacon and for
+ *        ping slot downlinks, using the beacon plan.
+ *
+ * \param [IN] devAddr The address of the device. Assign 0 if its a beacon.
+ *
+ * \param [IN] beaconTime The beacon time of the beacon.
+ *
+ * \param [IN] beaconInterval The beacon interval.
+ *
+ * \param [IN] isBeacon Set to true, if the function shall
+ *                      calculate the frequency for a beacon.
+ *
+ * \retval The downlink frequency
+ */
+static uint32_t GetDownlinkFrequency( uint32_t devAddr, TimerTime_t beaconTime,
+                                      TimerTime_t beaconInterval, bool isBeacon )
+{
+    ClassBDownlinkPlan_t* plan = ( isBeacon == true ) ? &Ctx.BeaconPlan.Beacon : &Ctx.BeaconPlan.PingSlot;
+    uint32_t channel = 0;
+
+    UpdateBeaconPlan( );
+
+    if( plan->NbChannels > CLASSB_PLAN_MAX_CHANNELS )
+    {
+        return CalcDownlinkChannelAndFrequency( devAddr, beaconTime, beaconInterval, isBeacon );
+    }
+
+    if( plan->NbChannels > 1 )
+    {
+        channel = devAddr + ( beaconTime / ( beaconInterval / 1000 ) );
+        channel = channel % plan->NbChannels;
+    }
+    return plan->Frequencies[channel];
+}
+
 /*!
  * \brief Calculates the correct frequency and opens up the beacon reception window. Please
  *        note that the variable WindowTimeout and WindowOffset will be updated according
@@ -247,8 +460,6 @@ static uint32_t CalcDownlinkChannelAndFrequency( uint32_t devAddr, TimerTime_t b
  */
 static void CalculateBeaconRxWindowConfig( RxConfigParams_t* rxConfig, uint16_t currentSymbolTimeout )
 {
-    GetPhyParams_t getPhy;
-    PhyParam_t phyParam;
     uint32_t maxRxError = 0;
 
     rxConfig->WindowTimeout = currentSymbolTimeout;
@@ -258,21 +469,29 @@ static void CalculateBeaconRxWindowConfig( RxConfigParams_t* rxConfig, uint16_t
     {
         // Apply the symbol timeout only if we have acquired the beacon
         // Otherwise, take the window enlargement into account
-        // Read beacon datarate
-        getPhy.Attribute = PHY_BEACON_CHANNEL_DR;
-        phyParam = RegionGetPhyParam( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &getPhy );
+        UpdateBeaconPlan( );
 
         // Compare and assign the maximum between the region specific rx error window time
         // and time precision received from beacon frame format.
         maxRxError = MAX( Ctx.LoRaMacClassBParams.LoRaMacParams->SystemMaxRxError,
                           ( uint32_t ) Ctx.BeaconCtx.BeaconTimePrecision.SubSeconds );
 
-        // Calculate downlink symbols
-        RegionComputeRxWindowParameters( *Ctx.LoRaMacClassBParams.LoRaMacRegion,
-                                        ( int8_t )phyParam.Value, // datarate
-                                        Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
-                                        maxRxError,
-                                        rxConfig );
+        // The window parameters only change with the rx error settings
+        if( ( Ctx.BeaconPlan.RxConfigValid == false ) ||
+            ( Ctx.BeaconPlan.MaxRxError != maxRxError ) ||
+            ( Ctx.BeaconPlan.MinRxSymbols != Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols ) )
+        {
+            // Calculate downlink symbols
+            RegionComputeRxWindowParameters( *Ctx.LoRaMacClassBParams.LoRaMacRegion,
+                                            Ctx.BeaconPlan.BeaconDatarate,
+                                            Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
+                                            maxRxError,
+                                            &Ctx.BeaconPlan.RxConfig );
+            Ctx.BeaconPlan.MaxRxError = maxRxError;
+            Ctx.BeaconPlan.MinRxSymbols = Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols;
+            Ctx.BeaconPlan.RxConfigValid = true;
+        }
+        *rxConfig = Ctx.BeaconPlan.RxConfig;
     }
 }
 
@@ -299,8 +518,8 @@ static void RxBeaconSetup( TimerTime_t rxTime, bool activateDefaultChannel, uint
     else
     {
         // This is the frequency according to the channel plan
-        frequency = CalcDownlinkChannelAndFrequency( 0, Ctx.BeaconCtx.BeaconTime.Seconds + ( CLASSB_BEACON_INTERVAL / 1000 ),
-                                                     CLASSB_BEACON_INTERVAL, true );
+        frequency = GetDownlinkFrequency( 0, Ctx.BeaconCtx.BeaconTime.Seconds + ( CLASSB_BEACON_INTERVAL / 1000 ),
+                                          CLASSB_BEACON_INTERVAL, true );
     }
 
     if( ClassBNvm->BeaconCtx.Ctrl.CustomFreq == 1 )
@@ -382,8 +601,7 @@ static bool CalcNextSlotTime( uint16_t slotOffset, uint16_t pingPeriod, uint16_t
  */
 static uint16_t BeaconCrc( uint8_t *buffer, uint16_t length )
 {
-    // The CRC calculation follows CCITT
-    const uint16_t polynom = 0x1021;
+    // The CRC calculation follows CCITT, refer to BeaconCrcTable
     // CRC initial value
     uint16_t crc = 0x0000;
 
@@ -394,11 +612,7 @@ static uint16_t BeaconCrc( uint8_t *buffer, uint16_t length )
 
     for( uint16_t i = 0; i < length; ++i )
     {
-        crc ^= ( uint16_t ) buffer[i] << 8;
-        for( uint16_t j = 0; j < 8; ++j )
-        {
-            crc = ( crc & 0x8000 ) ? ( crc << 1 ) ^ polynom : ( crc << 1 );
-        }
+        crc = ( crc << 8 ) ^ BeaconCrcTable[( ( crc >> 8 ) ^ buffer[i] ) & 0xFF];
     }
 
     return crc;
@@ -433,6 +647,7 @@ static void InitClassB( void )
     memset1( ( uint8_t* ) ClassBNvm, 0, sizeof( LoRaMacClassBNvmData_t ) );
     memset1( ( uint8_t* ) &Ctx.PingSlotCtx, 0, sizeof( PingSlotContext_t ) );
     memset1( ( uint8_t* ) &Ctx.BeaconCtx, 0, sizeof( BeaconContext_t ) );
+    Ctx.BeaconPlan.Valid = false;
 
     // Setup default temperature
     Ctx.BeaconCtx.Temperature = 25.0;
@@ -633,9 +848,9 @@ void LoRaMacClassBInit( LoRaMacClassBParams_t *classBParams, LoRaMacClassBCallba
     Ctx.LoRaMacClassBParams = *classBParams;
 
     // Initialize timers
-    TimerInit( &Ctx.BeaconTimer, LoRaMacClassBBeaconTimerEvent );
-    TimerInit( &Ctx.PingSlotTimer, LoRaMacClassBPingSlotTimerEvent );
-    TimerInit( &Ctx.MulticastSlotTimer, LoRaMacClassBMulticastSlotTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &Ctx.BeaconTimer, LoRaMacClassBBeaconTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &Ctx.PingSlotTimer, LoRaMacClassBPingSlotTimerEvent );
+    LORAMAC_INSTANCE_TIMER_INIT( &Ctx.MulticastSlotTimer, LoRaMacClassBMulticastSlotTimerEvent );
 
     InitClassB( );
 #endif // LORAMAC_CLASSB_ENABLED
@@ -743,6 +958,8 @@ static void LoRaMacClassBProcessBeacon( void )
             {
                 // Default symbol timeouts
                 ResetWindowTimeout( );
+                // Recompute the region parameters for the new acquisition
+                Ctx.BeaconPlan.Valid = false;
 
                 if( Ctx.BeaconCtx.Ctrl.BeaconDelaySet == 1 )
                 {
@@ -810,6 +1027,8 @@ static void LoRaMacClassBProcessBeacon( void )
             {
                 // Default symbol timeouts
                 ResetWindowTimeout( );
+                // Recompute the region parameters for the new acquisition
+                Ctx.BeaconPlan.Valid = false;
 
                 Ctx.BeaconCtx.Ctrl.AcquisitionPending = 1;
                 beaconEventTime = CLASSB_BEACON_INTERVAL;
@@ -982,7 +1201,6 @@ void LoRaMacClassBPingSlotTimerEvent( void* context )
 #ifdef LORAMAC_CLASSB_ENABLED
 static void LoRaMacClassBProcessPingSlot( void )
 {
-    static RxConfigParams_t pingSlotRxConfig;
     TimerTime_t pingSlotTime = 0;
     uint32_t maxRxError = 0;
     bool slotHasPriority = false;
@@ -1015,12 +1233,12 @@ static void LoRaMacClassBProcessPingSlot( void )
                                                      ClassBNvm->PingSlotCtx.Datarate,
                                                      Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
                                                      maxRxError,
-                                                     &pingSlotRxConfig );
-                    Ctx.PingSlotCtx.SymbolTimeout = pingSlotRxConfig.WindowTimeout;
+                                                     &Ctx.PingSlotRxConfig );
+                    Ctx.PingSlotCtx.SymbolTimeout = Ctx.PingSlotRxConfig.WindowTimeout;
 
-                    if( ( int32_t )pingSlotTime > pingSlotRxConfig.WindowOffset )
+                    if( ( int32_t )pingSlotTime > Ctx.PingSlotRxConfig.WindowOffset )
                     {// Apply the window offset
-                        pingSlotTime += pingSlotRxConfig.WindowOffset;
+                        pingSlotTime += Ctx.PingSlotRxConfig.WindowOffset;
                     }
                 }
                 if( pingSlotTime < CLASSB_BEACON_INTERVAL )
@@ -1047,8 +1265,8 @@ static void LoRaMacClassBProcessPingSlot( void )
             if( ClassBNvm->PingSlotCtx.Ctrl.CustomFreq == 0 )
             {
                 // Restore floor plan
-                frequency = CalcDownlinkChannelAndFrequency( *Ctx.LoRaMacClassBParams.LoRaMacDevAddr, Ctx.BeaconCtx.BeaconTime.Seconds,
-                                                             CLASSB_BEACON_INTERVAL, false );
+                frequency = GetDownlinkFrequency( *Ctx.LoRaMacClassBParams.LoRaMacDevAddr, Ctx.BeaconCtx.BeaconTime.Seconds,
+                                                  CLASSB_BEACON_INTERVAL, false );
             }
 
             if( Ctx.PingSlotCtx.NextMulticastChannel != NULL )
@@ -1073,16 +1291,16 @@ static void LoRaMacClassBProcessPingSlot( void )
 
                 LoRaMacClassBSetPingSlotState( PINGSLOT_STATE_RX );
 
-                pingSlotRxConfig.Datarate = ClassBNvm->PingSlotCtx.Datarate;
-                pingSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
-                pingSlotRxConfig.Frequency = frequency;
-                pingSlotRxConfig.RxContinuous = false;
-                pingSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_PING_SLOT;
-                pingSlotRxConfig.NetworkActivation = *Ctx.LoRaMacClassBParams.NetworkActivation;
+                Ctx.PingSlotRxConfig.Datarate = ClassBNvm->PingSlotCtx.Datarate;
+                Ctx.PingSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
+                Ctx.PingSlotRxConfig.Frequency = frequency;
+                Ctx.PingSlotRxConfig.RxContinuous = false;
+                Ctx.PingSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_PING_SLOT;
+                Ctx.PingSlotRxConfig.NetworkActivation = *Ctx.LoRaMacClassBParams.NetworkActivation;
 
-                RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &pingSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
+                RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &Ctx.PingSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
 
-                if( pingSlotRxConfig.RxContinuous == false )
+                if( Ctx.PingSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
                 }
@@ -1121,7 +1339,6 @@ void LoRaMacClassBMulticastSlotTimerEvent( void* context )
 #ifdef LORAMAC_CLASSB_ENABLED
 static void LoRaMacClassBProcessMulticastSlot( void )
 {
-    static RxConfigParams_t multicastSlotRxConfig;
     TimerTime_t multicastSlotTime = 0;
     TimerTime_t slotTime = 0;
     uint32_t maxRxError = 0;
@@ -1196,13 +1413,13 @@ static void LoRaMacClassBProcessMulticastSlot( void )
                                                     Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.RxParams.Params.ClassB.Datarate,
                                                     Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
                                                     maxRxError,
-                                                    &multicastSlotRxConfig );
-                    Ctx.PingSlotCtx.SymbolTimeout = multicastSlotRxConfig.WindowTimeout;
+                                                    &Ctx.MulticastSlotRxConfig );
+                    Ctx.PingSlotCtx.SymbolTimeout = Ctx.MulticastSlotRxConfig.WindowTimeout;
                 }
 
-                if( ( int32_t )multicastSlotTime > multicastSlotRxConfig.WindowOffset )
+                if( ( int32_t )multicastSlotTime > Ctx.MulticastSlotRxConfig.WindowOffset )
                 {// Apply the window offset
-                    multicastSlotTime += multicastSlotRxConfig.WindowOffset;
+                    multicastSlotTime += Ctx.MulticastSlotRxConfig.WindowOffset;
                 }
                 if( multicastSlotTime < CLASSB_BEACON_INTERVAL )
                 {
@@ -1240,8 +1457,8 @@ static void LoRaMacClassBProcessMulticastSlot( void )
             if( frequency == 0 )
             {
                 // Restore floor plan
-                frequency = CalcDownlinkChannelAndFrequency( Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.Address,
-                                                             Ctx.BeaconCtx.BeaconTime.Seconds, CLASSB_BEACON_INTERVAL, false );
+                frequency = GetDownlinkFrequency( Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.Address,
+                                                  Ctx.BeaconCtx.BeaconTime.Seconds, CLASSB_BEACON_INTERVAL, false );
             }
 
             // Verify, if the unicast has priority.
@@ -1263,16 +1480,16 @@ static void LoRaMacClassBProcessMulticastSlot( void )
 
                 LoRaMacClassBSetMulticastSlotState( PINGSLOT_STATE_RX );
 
-                multicastSlotRxConfig.Datarate = Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.RxParams.Params.ClassB.Datarate;
-                multicastSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
-                multicastSlotRxConfig.Frequency = frequency;
-                multicastSlotRxConfig.RxContinuous = false;
-                multicastSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_MULTICAST_SLOT;
-                multicastSlotRxConfig.NetworkActivation = *Ctx.LoRaMacClassBParams.NetworkActivation;
+                Ctx.MulticastSlotRxConfig.Datarate = Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.RxParams.Params.ClassB.Datarate;
+                Ctx.MulticastSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
+                Ctx.MulticastSlotRxConfig.Frequency = frequency;
+                Ctx.MulticastSlotRxConfig.RxContinuous = false;
+                Ctx.MulticastSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_MULTICAST_SLOT;
+                Ctx.MulticastSlotRxConfig.NetworkActivation = *Ctx.LoRaMacClassBParams.NetworkActivation;
 
-                RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &multicastSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
+                RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &Ctx.MulticastSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
 
-                if( multicastSlotRxConfig.RxContinuous == false )
+                if( Ctx.MulticastSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
                 }
@@ -1388,8 +1605,8 @@ bool LoRaMacClassBRxBeacon( uint8_t *payload, uint16_t size )
                 Ctx.BeaconCtx.LastBeaconRx = Ctx.BeaconCtx.BeaconTime;
                 Ctx.BeaconCtx.LastBeaconRx.Seconds += UNIX_GPS_EPOCH_OFFSET;
 
-                // Update system time.
-                SysTimeSet( SysTimeAdd( Ctx.BeaconCtx.LastBeaconRx, timeOnAir ) );
+                // Update system time. Successive beacons track the clock drift.
+                SysTimeSync( SysTimeAdd( Ctx.BeaconCtx.LastBeaconRx, timeOnAir ) );
 
                 Ctx.BeaconCtx.Ctrl.BeaconAcquired = 1;
                 Ctx.BeaconCtx.Ctrl.BeaconMode = 1;
@@ -22,6 +22,7 @@ Maintainer: Miguel Luis ( Semtech ), Daniel Jaeckle ( STACKFORCE ), Johannes Bru
 #include "utilities.h"
 #include "LoRaMacCommands.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacInstance.h"
 
 #ifndef NUM_OF_MAC_COMMANDS
 /*!
@@ -72,7 +73,11 @@ typedef struct sLoRaMacCommandsCtx
 /*!
  * Non-volatile module context.
  */
-static LoRaMacCommandsCtx_t CommandsCtx;
+static LoRaMacCommandsCtx_t LORAMAC_INSTANCE_STATE( CommandsCtx );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define CommandsCtx                                 LORAMAC_INSTANCE( CommandsCtx )
+#endif
 
 /* Memory management functions */
 
@@ -25,6 +25,7 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #include "utilities.h"
 #include "LoRaMac.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacInstance.h"
 
 
 /*
@@ -72,7 +73,11 @@ typedef struct sLoRaMacConfirmQueueCtx
 /*
  * Module context.
  */
-static LoRaMacConfirmQueueCtx_t ConfirmQueueCtx;
+static LoRaMacConfirmQueueCtx_t LORAMAC_INSTANCE_STATE( ConfirmQueueCtx );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define ConfirmQueueCtx                             LORAMAC_INSTANCE( ConfirmQueueCtx )
+#endif
 
 static MlmeConfirmQueue_t* IncreaseBufferPointer( MlmeConfirmQueue_t* bufferPointer )
 {
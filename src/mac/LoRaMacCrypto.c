@@ -40,6 +40,7 @@
 #include "LoRaMacParser.h"
 #include "LoRaMacSerializer.h"
 #include "LoRaMacCrypto.h"
+#include "LoRaMacInstance.h"
 
 /*
  * Frame direction definition for uplink communications
@@ -98,13 +99,18 @@ typedef struct sKeyAddr
 /*
  * RJcount0 is a counter incremented with every Type 0 or 2 Rejoin frame transmitted.
  */
-static uint16_t RJcount0;
+static uint16_t LORAMAC_INSTANCE_STATE( RJcount0 );
 #endif
 
 /*
  * Non volatile module context.
  */
-static LoRaMacCryptoNvmData_t* CryptoNvm;
+static LoRaMacCryptoNvmData_t* LORAMAC_INSTANCE_STATE( CryptoNvm );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define RJcount0                                    LORAMAC_INSTANCE( RJcount0 )
+#define CryptoNvm                                   LORAMAC_INSTANCE( CryptoNvm )
+#endif
 
 /*
  * Key-Address list
@@ -524,44 +530,37 @@ static LoRaMacCryptoStatus_t GetKeyAddrItem( AddressIdentifier_t addrID, KeyAddr
 }
 
 /*
- * Derives a session key as of LoRaWAN versions prior to 1.1.0
+ * Derives the session keys as of LoRaWAN versions prior to 1.1.0
+ *
+ * The four keys are derived from the NwkKey in a single secure element call.
  *
- * \param[IN]  keyID          - Key Identifier for the key to be calculated
  * \param[IN]  joinNonce      - Sever nonce
  * \param[IN]  netID          - Network Identifier
  * \param[IN]  deviceNonce    - Device nonce
  * \retval                    - Status of the operation
  */
-static LoRaMacCryptoStatus_t DeriveSessionKey10x( KeyIdentifier_t keyID, uint32_t joinNonce, uint32_t netID, uint16_t devNonce )
+static LoRaMacCryptoStatus_t DeriveSessionKeys10x( uint32_t joinNonce, uint32_t netID, uint16_t devNonce )
 {
-    uint8_t compBase[16] = { 0 };
+    KeyIdentifier_t keyIDs[] = { APP_S_KEY, NWK_S_ENC_KEY, F_NWK_S_INT_KEY, S_NWK_S_INT_KEY };
+    uint8_t compBase[4][16] = { 0 };
 
-    switch( keyID )
+    for( uint8_t i = 0; i < 4; i++ )
     {
-        case F_NWK_S_INT_KEY:
-        case S_NWK_S_INT_KEY:
-        case NWK_S_ENC_KEY:
-            compBase[0] = 0x01;
-            break;
-        case APP_S_KEY:
-            compBase[0] = 0x02;
-            break;
-        default:
-            return LORAMAC_CRYPTO_ERROR_INVALID_KEY_ID;
-    }
+        compBase[i][0] = ( keyIDs[i] == APP_S_KEY ) ? 0x02 : 0x01;
 
-    compBase[1] = ( uint8_t )( ( joinNonce >> 0 ) & 0xFF );
-    compBase[2] = ( uint8_t )( ( joinNonce >> 8 ) & 0xFF );
-    compBase[3] = ( uint8_t )( ( joinNonce >> 16 ) & 0xFF );
+        compBase[i][1] = ( uint8_t )( ( joinNonce >> 0 ) & 0xFF );
+        compBase[i][2] = ( uint8_t )( ( joinNonce >> 8 ) & 0xFF );
+        compBase[i][3] = ( uint8_t )( ( joinNonce >> 16 ) & 0xFF );
 
-    compBase[4] = ( uint8_t )( ( netID >> 0 ) & 0xFF );
-    compBase[5] = ( uint8_t )( ( netID >> 8 ) & 0xFF );
-    compBase[6] = ( uint8_t )( ( netID >> 16 ) & 0xFF );
+        compBase[i][4] = ( uint8_t )( ( netID >> 0 ) & 0xFF );
+        compBase[i][5] = ( uint8_t )( ( netID >> 8 ) & 0xFF );
+        compBase[i][6] = ( uint8_t )( ( netID >> 16 ) & 0xFF );
 
-    compBase[7] = ( uint8_t )( ( devNonce >> 0 ) & 0xFF );
-    compBase[8] = ( uint8_t )( ( devNonce >> 8 ) & 0xFF );
+        compBase[i][7] = ( uint8_t )( ( devNonce >> 0 ) & 0xFF );
+        compBase[i][8] = ( uint8_t )( ( devNonce >> 8 ) & 0xFF );
+    }
 
-    if( SecureElementDeriveAndStoreKey( compBase, NWK_KEY, keyID ) != SECURE_ELEMENT_SUCCESS )
+    if( SecureElementDeriveAndStoreKeys( compBase[0], NWK_KEY, keyIDs, 4 ) != SECURE_ELEMENT_SUCCESS )
     {
         return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
     }
@@ -571,53 +570,48 @@ static LoRaMacCryptoStatus_t DeriveSessionKey10x( KeyIdentifier_t keyID, uint32_
 
 #if( USE_LRWAN_1_1_X_CRYPTO == 1 )
 /*
- * Derives a session key as of LoRaWAN 1.1.0
+ * Derives the session keys as of LoRaWAN 1.1.0
+ *
+ * The network session keys are derived from the NwkKey in a single secure
+ * element call. The AppSKey is derived from the AppKey.
  *
- * \param[IN]  keyID          - Key Identifier for the key to be calculated
  * \param[IN]  joinNonce      - Sever nonce
  * \param[IN]  joinEUI        - Join Server EUI
  * \param[IN]  deviceNonce    - Device nonce
  * \retval                    - Status of the operation
  */
-static LoRaMacCryptoStatus_t DeriveSessionKey11x( KeyIdentifier_t keyID, uint32_t joinNonce, uint8_t* joinEUI, uint16_t devNonce )
+static LoRaMacCryptoStatus_t DeriveSessionKeys11x( uint32_t joinNonce, uint8_t* joinEUI, uint16_t devNonce )
 {
     if( joinEUI == 0 )
     {
         return LORAMAC_CRYPTO_ERROR_NPE;
     }
 
-    uint8_t compBase[16] = { 0 };
-    KeyIdentifier_t rootKeyId = NWK_KEY;
+    // The AppSKey is the last one, the other keys share the NwkKey root
+    KeyIdentifier_t keyIDs[] = { F_NWK_S_INT_KEY, S_NWK_S_INT_KEY, NWK_S_ENC_KEY, APP_S_KEY };
+    const uint8_t prefixes[] = { 0x01, 0x03, 0x04, 0x02 };
+    uint8_t compBase[4][16] = { 0 };
 
-    switch( keyID )
+    for( uint8_t i = 0; i < 4; i++ )
     {
-        case F_NWK_S_INT_KEY:
-            compBase[0] = 0x01;
-            break;
-        case S_NWK_S_INT_KEY:
-            compBase[0] = 0x03;
-            break;
-        case NWK_S_ENC_KEY:
-            compBase[0] = 0x04;
-            break;
-        case APP_S_KEY:
-            rootKeyId = APP_KEY;
-            compBase[0] = 0x02;
-            break;
-        default:
-            return LORAMAC_CRYPTO_ERROR_INVALID_KEY_ID;
-    }
+        compBase[i][0] = prefixes[i];
 
-    compBase[1] = ( uint8_t )( ( joinNonce >> 0 ) & 0xFF );
-    compBase[2] = ( uint8_t )( ( joinNonce >> 8 ) & 0xFF );
-    compBase[3] = ( uint8_t )( ( joinNonce >> 16 ) & 0xFF );
+        compBase[i][1] = ( uint8_t )( ( joinNonce >> 0 ) & 0xFF );
+        compBase[i][2] = ( uint8_t )( ( joinNonce >> 8 ) & 0xFF );
+        compBase[i][3] = ( uint8_t )( ( joinNonce >> 16 ) & 0xFF );
 
-    memcpyr( compBase + 4, joinEUI, 8 );
+        memcpyr( compBase[i] + 4, joinEUI, 8 );
 
-    compBase[12] = ( uint8_t )( ( devNonce >> 0 ) & 0xFF );
-    compBase[13] = ( uint8_t )( ( devNonce >> 8 ) & 0xFF );
+        compBase[i][12] = ( uint8_t )( ( devNonce >> 0 ) & 0xFF );
+        compBase[i][13] = ( uint8_t )( ( devNonce >> 8 ) & 0xFF );
+    }
 
-    if( SecureElementDeriveAndStoreKey( compBase, rootKeyId, keyID ) != SECURE_ELEMENT_SUCCESS )
+    if( SecureElementDeriveAndStoreKeys( compBase[0], NWK_KEY, keyIDs, 3 ) != SECURE_ELEMENT_SUCCESS )
+    {
+        return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
+    }
+
+    if( SecureElementDeriveAndStoreKey( compBase[3], APP_KEY, APP_S_KEY ) != SECURE_ELEMENT_SUCCESS )
     {
         return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
     }
@@ -1208,25 +1202,7 @@ LoRaMacCryptoStatus_t LoRaMacCryptoHandleJoinAccept( JoinReqIdentifier_t joinReq
     {
         // Operating in LoRaWAN 1.1.x mode
 
-        retval = DeriveSessionKey11x( F_NWK_S_INT_KEY, currentJoinNonce, joinEUI, nonce );
-        if( retval != LORAMAC_CRYPTO_SUCCESS )
-        {
-            return retval;
-        }
-
-        retval = DeriveSessionKey11x( S_NWK_S_INT_KEY, currentJoinNonce, joinEUI, nonce );
-        if( retval != LORAMAC_CRYPTO_SUCCESS )
-        {
-            return retval;
-        }
-
-        retval = DeriveSessionKey11x( NWK_S_ENC_KEY, currentJoinNonce, joinEUI, nonce );
-        if( retval != LORAMAC_CRYPTO_SUCCESS )
-        {
-            return retval;
-        }
-
-        retval = DeriveSessionKey11x( APP_S_KEY, currentJoinNonce, joinEUI, nonce );
+        retval = DeriveSessionKeys11x( currentJoinNonce, joinEUI, nonce );
         if( retval != LORAMAC_CRYPTO_SUCCESS )
         {
             return retval;
@@ -1243,25 +1219,7 @@ LoRaMacCryptoStatus_t LoRaMacCryptoHandleJoinAccept( JoinReqIdentifier_t joinReq
         netID |= ( ( uint32_t )macMsg->NetID[1] << 8 );
         netID |= ( ( uint32_t )macMsg->NetID[2] << 16 );
 
-        retval = DeriveSessionKey10x( APP_S_KEY, currentJoinNonce, netID, nonce );
-        if( retval != LORAMAC_CRYPTO_SUCCESS )
-        {
-            return retval;
-        }
-
-        retval = DeriveSessionKey10x( NWK_S_ENC_KEY, currentJoinNonce, netID, nonce );
-        if( retval != LORAMAC_CRYPTO_SUCCESS )
-        {
-            return retval;
-        }
-
-        retval = DeriveSessionKey10x( F_NWK_S_INT_KEY, currentJoinNonce, netID, nonce );
-        if( retval != LORAMAC_CRYPTO_SUCCESS )
-        {
-            return retval;
-        }
-
-        retval = DeriveSessionKey10x( S_NWK_S_INT_KEY, currentJoinNonce, netID, nonce );
+        retval = DeriveSessionKeys10x( currentJoinNonce, netID, nonce );
         if( retval != LORAMAC_CRYPTO_SUCCESS )
         {
             return retval;
@@ -1522,27 +1480,19 @@ LoRaMacCryptoStatus_t LoRaMacCryptoDeriveMcSessionKeyPair( AddressIdentifier_t a
     // McAppSKey = aes128_encrypt(McKey, 0x01 | McAddr | pad16)
     // McNwkSKey = aes128_encrypt(McKey, 0x02 | McAddr | pad16)
 
-    uint8_t compBaseAppS[16] = { 0 };
-    uint8_t compBaseNwkS[16] = { 0 };
+    KeyIdentifier_t keyIDs[] = { curItem->AppSkey, curItem->NwkSkey };
+    uint8_t compBase[2][16] = { 0 };
 
-    compBaseAppS[0] = 0x01;
-    compBaseAppS[1] = mcAddr & 0xFF;
-    compBaseAppS[2] = ( mcAddr >> 8 ) & 0xFF;
-    compBaseAppS[3] = ( mcAddr >> 16 ) & 0xFF;
-    compBaseAppS[4] = ( mcAddr >> 24 ) & 0xFF;
-
-    compBaseNwkS[0] = 0x02;
-    compBaseNwkS[1] = mcAddr & 0xFF;
-    compBaseNwkS[2] = ( mcAddr >> 8 ) & 0xFF;
-    compBaseNwkS[3] = ( mcAddr >> 16 ) & 0xFF;
-    compBaseNwkS[4] = ( mcAddr >> 24 ) & 0xFF;
-
-    if( SecureElementDeriveAndStoreKey( compBaseAppS, curItem->RootKey, curItem->AppSkey ) != SECURE_ELEMENT_SUCCESS )
+    for( uint8_t i = 0; i < 2; i++ )
     {
-        return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
+        compBase[i][0] = i + 1;
+        compBase[i][1] = mcAddr & 0xFF;
+        compBase[i][2] = ( mcAddr >> 8 ) & 0xFF;
+        compBase[i][3] = ( mcAddr >> 16 ) & 0xFF;
+        compBase[i][4] = ( mcAddr >> 24 ) & 0xFF;
     }
 
-    if( SecureElementDeriveAndStoreKey( compBaseNwkS, curItem->RootKey, curItem->NwkSkey ) != SECURE_ELEMENT_SUCCESS )
+    if( SecureElementDeriveAndStoreKeys( compBase[0], curItem->RootKey, keyIDs, 2 ) != SECURE_ELEMENT_SUCCESS )
     {
         return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
     }
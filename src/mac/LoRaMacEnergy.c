@@ -0,0 +1,163 @@
+/*!
+ * \file      LoRaMacEnergy.c
+ *
+ * \brief     LoRa MAC layer energy and airtime ledger
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "utilities.h"
+#include "LoRaMacEnergy.h"
+#include "LoRaMacInstance.h"
+
+/*!
+ * Ledger
+ */
+static LoRaMacEnergyLedger_t LORAMAC_INSTANCE_STATE( Ledger );
+
+/*!
+ * Entry charged with the activities, NULL before the first uplink
+ */
+static LoRaMacEnergyEntry_t* LORAMAC_INSTANCE_STATE( Current );
+
+/*!
+ * Energy model, NULL when not set
+ */
+static const LoRaMacEnergyModel_t* LORAMAC_INSTANCE_STATE( Model );
+
+/*!
+ * Opening time of the current RX window
+ */
+static TimerTime_t LORAMAC_INSTANCE_STATE( RxStartTime );
+
+/*!
+ * Set while a RX window is opened
+ */
+static bool LORAMAC_INSTANCE_STATE( IsRxStarted );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define Ledger                                      LORAMAC_INSTANCE( Ledger )
+#define Current                                     LORAMAC_INSTANCE( Current )
+#define Model                                       LORAMAC_INSTANCE( Model )
+#define RxStartTime                                 LORAMAC_INSTANCE( RxStartTime )
+#define IsRxStarted                                 LORAMAC_INSTANCE( IsRxStarted )
+#endif
+
+void LoRaMacEnergyReset( void )
+{
+    memset1( ( uint8_t* )&Ledger, 0x00, sizeof( Ledger ) );
+    Current = NULL;
+    IsRxStarted = false;
+}
+
+void LoRaMacEnergySelect( uint8_t fPort, LoRaMacEnergyMsgType_t msgType )
+{
+    for( uint8_t i = 0; i < Ledger.NbEntries; i++ )
+    {
+        if( ( Ledger.Entries[i].FPort == fPort ) && ( Ledger.Entries[i].MsgType == msgType ) )
+        {
+            Current = &Ledger.Entries[i];
+            return;
+        }
+    }
+    if( Ledger.NbEntries < LORAMAC_ENERGY_LEDGER_SIZE )
+    {
+        Current = &Ledger.Entries[Ledger.NbEntries++];
+        Current->FPort = fPort;
+        Current->MsgType = msgType;
+        return;
+    }
+    Current = &Ledger.Overflow;
+}
+
+void LoRaMacEnergyAddTx( int8_t txPower, TimerTime_t timeOnAir )
+{
+    if( ( Current == NULL ) || ( txPower < 0 ) || ( txPower >= LORAMAC_ENERGY_TX_POWER_LEVELS ) )
+    {
+        return;
+    }
+    Current->NbTx++;
+    Current->TxTime[txPower] += timeOnAir;
+}
+
+void LoRaMacEnergyRxStart( TimerTime_t time )
+{
+    RxStartTime = time;
+    IsRxStarted = true;
+}
+
+void LoRaMacEnergyRxStop( TimerTime_t time )
+{
+    if( IsRxStarted == false )
+    {
+        return;
+    }
+    IsRxStarted = false;
+    if( Current != NULL )
+    {
+        Current->RxTime += time - RxStartTime;
+    }
+}
+
+void LoRaMacEnergyAddLbt( TimerTime_t time )
+{
+    if( Current != NULL )
+    {
+        Current->LbtTime += time;
+    }
+}
+
+void LoRaMacEnergyAddSeOp( void )
+{
+    if( Current != NULL )
+    {
+        Current->NbSeOps++;
+    }
+}
+
+const LoRaMacEnergyLedger_t* LoRaMacEnergyGetLedger( void )
+{
+    return &Ledger;
+}
+
+void LoRaMacEnergySetModel( const LoRaMacEnergyModel_t* model )
+{
+    Model = model;
+}
+
+const LoRaMacEnergyModel_t* LoRaMacEnergyGetModel( void )
+{
+    return Model;
+}
+
+uint32_t LoRaMacEnergyGetCharge( const LoRaMacEnergyEntry_t* entry )
+{
+    // ms * uA = nC
+    uint64_t charge = 0;
+
+    if( ( entry == NULL ) || ( Model == NULL ) )
+    {
+        return 0;
+    }
+    for( uint8_t i = 0; i < LORAMAC_ENERGY_TX_POWER_LEVELS; i++ )
+    {
+        charge += ( uint64_t )entry->TxTime[i] * Model->TxCurrent[i];
+    }
+    charge += ( uint64_t )( entry->RxTime + entry->LbtTime ) * Model->RxCurrent;
+    charge += ( uint64_t )entry->NbSeOps * Model->SeOpCharge;
+
+    return ( uint32_t )( charge / 1000 );
+}
@@ -0,0 +1,255 @@
+/*!
+ * \file      LoRaMacEnergy.h
+ *
+ * \brief     LoRa MAC layer energy and airtime ledger
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \defgroup  LORAMACENERGY LoRa MAC layer energy and airtime ledger
+ *
+ *            The ledger accumulates, per FPort and message type, the radio
+ *            activity caused by the uplinks:
+ *            - TX time per TX power index, retransmissions included
+ *            - RX1 and RX2 windows open time
+ *            - Listen before talk carrier sense time
+ *            - Secure element operations
+ *
+ *            The downlinks activity is charged to the last uplink. The charge
+ *            is estimated from the times with the currents of an energy model.
+ *
+ *            The ledger is only compiled when LORAMAC_ENERGY_LEDGER_ENABLED is
+ *            defined. Otherwise the LORAMAC_ENERGY_* macros expand to nothing.
+ * \{
+ */
+#ifndef __LORAMAC_ENERGY_H__
+#define __LORAMAC_ENERGY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include "timer.h"
+
+/*!
+ * Number of ledger entries. The activity of the uplinks which don't fit is
+ * accumulated in the overflow entry.
+ */
+#ifndef LORAMAC_ENERGY_LEDGER_SIZE
+#define LORAMAC_ENERGY_LEDGER_SIZE                  8
+#endif
+
+/*!
+ * Number of TX power indexes
+ */
+#define LORAMAC_ENERGY_TX_POWER_LEVELS              16
+
+/*!
+ * Ledger message types
+ */
+typedef enum eLoRaMacEnergyMsgType
+{
+    /*!
+     * Join and rejoin requests
+     */
+    LORAMAC_ENERGY_MSG_JOIN,
+    /*!
+     * Unconfirmed data uplinks
+     */
+    LORAMAC_ENERGY_MSG_UNCONFIRMED,
+    /*!
+     * Confirmed data uplinks
+     */
+    LORAMAC_ENERGY_MSG_CONFIRMED,
+    /*!
+     * Number of message types
+     */
+    LORAMAC_ENERGY_MSG_MAX
+}LoRaMacEnergyMsgType_t;
+
+/*!
+ * Energy model of the board
+ */
+typedef struct sLoRaMacEnergyModel
+{
+    /*!
+     * Radio current consumption in TX, indexed by TX power index [uA]
+     */
+    uint32_t TxCurrent[LORAMAC_ENERGY_TX_POWER_LEVELS];
+    /*!
+     * Radio current consumption in RX and during carrier sense [uA]
+     */
+    uint32_t RxCurrent;
+    /*!
+     * Charge of a secure element operation [nC]
+     */
+    uint32_t SeOpCharge;
+}LoRaMacEnergyModel_t;
+
+/*!
+ * Ledger entry
+ */
+typedef struct sLoRaMacEnergyEntry
+{
+    /*!
+     * Uplinks FPort. 0 for the join requests and MAC commands only uplinks
+     */
+    uint8_t FPort;
+    /*!
+     * Uplinks message type
+     */
+    LoRaMacEnergyMsgType_t MsgType;
+    /*!
+     * Number of transmissions, retransmissions included
+     */
+    uint32_t NbTx;
+    /*!
+     * TX time, indexed by TX power index [ms]
+     */
+    uint32_t TxTime[LORAMAC_ENERGY_TX_POWER_LEVELS];
+    /*!
+     * RX1 and RX2 windows open time [ms]
+     */
+    uint32_t RxTime;
+    /*!
+     * Listen before talk carrier sense time [ms]
+     */
+    uint32_t LbtTime;
+    /*!
+     * Number of secure element operations
+     */
+    uint32_t NbSeOps;
+}LoRaMacEnergyEntry_t;
+
+/*!
+ * Energy and airtime ledger
+ */
+typedef struct sLoRaMacEnergyLedger
+{
+    /*!
+     * Number of used entries
+     */
+    uint8_t NbEntries;
+    /*!
+     * Entries, in order of first use
+     */
+    LoRaMacEnergyEntry_t Entries[LORAMAC_ENERGY_LEDGER_SIZE];
+    /*!
+     * Activity of the uplinks which don't fit in Entries
+     */
+    LoRaMacEnergyEntry_t Overflow;
+}LoRaMacEnergyLedger_t;
+
+/*!
+ * \brief   Resets the ledger
+ */
+void LoRaMacEnergyReset( void );
+
+/*!
+ * \brief   Selects the entry charged with the next activities
+ *
+ * \param   [IN] fPort Uplink FPort
+ *
+ * \param   [IN] msgType Uplink message type
+ */
+void LoRaMacEnergySelect( uint8_t fPort, LoRaMacEnergyMsgType_t msgType );
+
+/*!
+ * \brief   Records a transmission
+ *
+ * \param   [IN] txPower TX power index
+ *
+ * \param   [IN] timeOnAir Transmission time on air [ms]
+ */
+void LoRaMacEnergyAddTx( int8_t txPower, TimerTime_t timeOnAir );
+
+/*!
+ * \brief   Records the opening of a RX window
+ *
+ * \param   [IN] time Opening time, see TimerGetCurrentTime
+ */
+void LoRaMacEnergyRxStart( TimerTime_t time );
+
+/*!
+ * \brief   Records the end of the opened RX window, if any
+ *
+ * \param   [IN] time End time, see TimerGetCurrentTime
+ */
+void LoRaMacEnergyRxStop( TimerTime_t time );
+
+/*!
+ * \brief   Records listen before talk carrier sense time
+ *
+ * \param   [IN] time Carrier sense time [ms]
+ */
+void LoRaMacEnergyAddLbt( TimerTime_t time );
+
+/*!
+ * \brief   Records a secure element operation
+ */
+void LoRaMacEnergyAddSeOp( void );
+
+/*!
+ * \brief   Gets the ledger
+ *
+ * \retval  Ledger
+ */
+const LoRaMacEnergyLedger_t* LoRaMacEnergyGetLedger( void );
+
+/*!
+ * \brief   Sets the energy model used by \ref LoRaMacEnergyGetCharge
+ *
+ * \param   [IN] model Energy model. The structure must stay valid while the
+ *                     ledger is used. NULL disables the charge estimation.
+ */
+void LoRaMacEnergySetModel( const LoRaMacEnergyModel_t* model );
+
+/*!
+ * \brief   Gets the energy model
+ *
+ * \retval  Energy model, NULL if none is set
+ */
+const LoRaMacEnergyModel_t* LoRaMacEnergyGetModel( void );
+
+/*!
+ * \brief   Estimates the charge drawn by the activity of an entry
+ *
+ * \param   [IN] entry Ledger entry
+ *
+ * \retval  Charge [uC]. 0 when no energy model is set
+ */
+uint32_t LoRaMacEnergyGetCharge( const LoRaMacEnergyEntry_t* entry );
+
+#if defined( LORAMAC_ENERGY_LEDGER_ENABLED )
+#define LORAMAC_ENERGY_ADD_TX( txPower, timeOnAir ) LoRaMacEnergyAddTx( txPower, timeOnAir )
+#define LORAMAC_ENERGY_RX_START( time )             LoRaMacEnergyRxStart( time )
+#define LORAMAC_ENERGY_RX_STOP( time )              LoRaMacEnergyRxStop( time )
+#define LORAMAC_ENERGY_ADD_LBT( time )              LoRaMacEnergyAddLbt( time )
+#define LORAMAC_ENERGY_ADD_SE_OP( )                 LoRaMacEnergyAddSeOp( )
+#else
+#define LORAMAC_ENERGY_ADD_TX( txPower, timeOnAir )
+#define LORAMAC_ENERGY_RX_START( time )
+#define LORAMAC_ENERGY_RX_STOP( time )
+#define LORAMAC_ENERGY_ADD_LBT( time )
+#define LORAMAC_ENERGY_ADD_SE_OP( )
+#endif
+
+/*! \} defgroup LORAMACENERGY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LORAMAC_ENERGY_H__
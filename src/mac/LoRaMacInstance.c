@@ -0,0 +1,89 @@
+/*!
+ * \file      LoRaMacInstance.c
+ *
+ * \brief     LoRa MAC layer instances
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#include <stddef.h>
+
+#include "LoRaMacInstance.h"
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+
+uint16_t LoRaMacInstanceId = 0;
+
+/*!
+ * Timer callback of an instance
+ */
+typedef struct sLoRaMacInstanceTimer
+{
+    void ( *Callback )( void* context );
+}LoRaMacInstanceTimer_t;
+
+/*!
+ * Timer callbacks. The address of the entry, given as timer context,
+ * identifies the instance.
+ */
+static LoRaMacInstanceTimer_t Timers[LORAMAC_NB_INSTANCES][LORAMAC_INSTANCE_NB_TIMERS];
+
+/*!
+ * \brief   Runs the callback of an expired timer with its instance selected
+ *
+ * \param   [IN] context Timer callback entry
+ */
+static void OnTimerEvent( void* context )
+{
+    LoRaMacInstanceTimer_t* timer = ( LoRaMacInstanceTimer_t* )context;
+    uint16_t id = LoRaMacInstanceId;
+
+    LoRaMacInstanceId = ( uint16_t )( ( timer - &Timers[0][0] ) / LORAMAC_INSTANCE_NB_TIMERS );
+    timer->Callback( NULL );
+    LoRaMacInstanceId = id;
+}
+
+bool LoRaMacInstanceSelect( uint16_t id )
+{
+    if( id >= LORAMAC_NB_INSTANCES )
+    {
+        return false;
+    }
+    LoRaMacInstanceId = id;
+    return true;
+}
+
+uint16_t LoRaMacInstanceGetId( void )
+{
+    return LoRaMacInstanceId;
+}
+
+void LoRaMacInstanceTimerInit( TimerEvent_t* obj, void ( *callback )( void* context ) )
+{
+    LoRaMacInstanceTimer_t* timers = Timers[LoRaMacInstanceId];
+
+    for( uint8_t i = 0; i < LORAMAC_INSTANCE_NB_TIMERS; i++ )
+    {
+        if( ( timers[i].Callback == NULL ) || ( timers[i].Callback == callback ) )
+        {
+            timers[i].Callback = callback;
+            TimerInit( obj, OnTimerEvent );
+            TimerSetContext( obj, &timers[i] );
+            return;
+        }
+    }
+    // No free entry, the callback runs with the instance selected at expiry
+    TimerInit( obj, callback );
+}
+
+#endif
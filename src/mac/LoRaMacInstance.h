@@ -0,0 +1,129 @@
+/*!
+ * \file      LoRaMacInstance.h
+ *
+ * \brief     LoRa MAC layer instances
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \defgroup  LORAMACINSTANCE LoRa MAC layer instances
+ *            This module allows a process to run several LoRaMAC devices.
+ *
+ *            When LORAMAC_MULTI_INSTANCE_ENABLED is defined, the state of the
+ *            LoRaMAC modules, of the regions and of the soft secure element is
+ *            allocated LORAMAC_NB_INSTANCES times. The LoRaMAC API, the radio
+ *            events and the LoRaMacProcess calls apply to the instance
+ *            selected with \ref LoRaMacInstanceSelect. The timers started by
+ *            an instance run their callback with the instance selected, then
+ *            restore the previous selection.
+ *
+ *            The timer list, the board and the application layer
+ *            ( LmHandler ) are not duplicated. Each instance must be given its
+ *            own radio, which raises the radio events with its instance
+ *            selected: the virtual radio of the Simulation board does so.
+ *
+ *            The instances are single threaded only: the selection is a
+ *            process wide global, so the LoRaMAC API, the radio events and the
+ *            timer callbacks of all the instances must run from the same
+ *            thread.
+ *
+ *            Otherwise a single instance is built and the LORAMAC_INSTANCE_*
+ *            macros expand to the single instance state.
+ * \{
+ */
+#ifndef __LORAMAC_INSTANCE_H__
+#define __LORAMAC_INSTANCE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+
+#ifndef LORAMAC_NB_INSTANCES
+/*!
+ * Number of LoRaMAC instances
+ */
+#define LORAMAC_NB_INSTANCES                        16
+#endif
+
+#ifndef LORAMAC_INSTANCE_NB_TIMERS
+/*!
+ * Maximum number of timers of an instance
+ */
+#define LORAMAC_INSTANCE_NB_TIMERS                  16
+#endif
+
+/*!
+ * Selected instance
+ */
+extern uint16_t LoRaMacInstanceId;
+
+/*!
+ * \brief   Selects the instance the LoRaMAC calls apply to
+ *
+ * \param   [IN] id Instance identifier [0: LORAMAC_NB_INSTANCES - 1]
+ *
+ * \retval  Returns false if the identifier is out of range
+ */
+bool LoRaMacInstanceSelect( uint16_t id );
+
+/*!
+ * \brief   Gets the selected instance
+ *
+ * \retval  Instance identifier
+ */
+uint16_t LoRaMacInstanceGetId( void );
+
+/*!
+ * \brief   Initializes a timer of the selected instance. The callback runs
+ *          with the instance selected.
+ *
+ * \param   [IN] obj      Structure containing the timer object parameters
+ * \param   [IN] callback Function callback called at the end of the timeout
+ */
+void LoRaMacInstanceTimerInit( TimerEvent_t* obj, void ( *callback )( void* context ) );
+
+/*!
+ * Declares the storage of a module state, one per instance
+ */
+#define LORAMAC_INSTANCE_STATE( name )              name##Instances[LORAMAC_NB_INSTANCES]
+/*!
+ * Module state of the selected instance
+ */
+#define LORAMAC_INSTANCE( name )                    name##Instances[LoRaMacInstanceId]
+/*!
+ * Initializes a timer of the selected instance
+ */
+#define LORAMAC_INSTANCE_TIMER_INIT( obj, callback ) LoRaMacInstanceTimerInit( obj, callback )
+
+#else
+
+#define LORAMAC_INSTANCE_STATE( name )              name
+#define LORAMAC_INSTANCE( name )                    name
+#define LORAMAC_INSTANCE_TIMER_INIT( obj, callback ) TimerInit( obj, callback )
+
+#endif
+
+/*! \} defgroup LORAMACINSTANCE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LORAMAC_INSTANCE_H__
@@ -234,6 +234,9 @@ typedef struct sLoRaMacMessageData
     uint8_t FPort;
     /*!
      * Frame payload may contain MAC commands or data (opt.)
+     *
+     * \remark When parsing, a NULL pointer requests the payload to be borrowed
+     *         from Buffer instead of being copied.
      */
     uint8_t* FRMPayload;
     /*!
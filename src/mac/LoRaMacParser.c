@@ -18,12 +18,13 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
             Daniel Jaeckle ( STACKFORCE ),  Johannes Bruder ( STACKFORCE )
 */
+#include <stddef.h>
 #include "LoRaMacParser.h"
 #include "utilities.h"
 
 LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t* macMsg )
 {
-    if( ( macMsg == 0 ) || ( macMsg->Buffer == 0 ) )
+    if( ( macMsg == NULL ) || ( macMsg->Buffer == NULL ) )
     {
         return LORAMAC_PARSER_ERROR_NPE;
     }
@@ -67,7 +68,7 @@ LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t* macMs
 
 LoRaMacParserStatus_t LoRaMacParserData( LoRaMacMessageData_t* macMsg )
 {
-    if( ( macMsg == 0 ) || ( macMsg->Buffer == 0 ) )
+    if( ( macMsg == NULL ) || ( macMsg->Buffer == NULL ) )
     {
         return LORAMAC_PARSER_ERROR_NPE;
     }
@@ -98,9 +99,22 @@ LoRaMacParserStatus_t LoRaMacParserData( LoRaMacMessageData_t* macMsg )
         macMsg->FPort = macMsg->Buffer[bufItr++];
 
         macMsg->FRMPayloadSize = ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE );
-        memcpy1( macMsg->FRMPayload, &macMsg->Buffer[bufItr], macMsg->FRMPayloadSize );
+        if( ( macMsg->FRMPayload == NULL ) || ( macMsg->FRMPayload == &macMsg->Buffer[bufItr] ) )
+        {
+            // No destination buffer: the frame payload is borrowed from the serialized buffer
+            macMsg->FRMPayload = &macMsg->Buffer[bufItr];
+        }
+        else
+        {
+            memcpy1( macMsg->FRMPayload, &macMsg->Buffer[bufItr], macMsg->FRMPayloadSize );
+        }
         bufItr = bufItr + macMsg->FRMPayloadSize;
     }
+    else if( macMsg->FRMPayload == NULL )
+    {
+        // No frame payload: borrow an empty one so that it can still be decrypted
+        macMsg->FRMPayload = &macMsg->Buffer[bufItr];
+    }
 
     macMsg->MIC = ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE )];
     macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 1] << 8 );
@@ -80,6 +80,10 @@ LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t *macMs
 /*!
  * Parse a serialized data message and fills the structured object.
  *
+ * \remark When macMsg->FRMPayload is NULL the frame payload is not copied.
+ *         FRMPayload is then set to point inside macMsg->Buffer, which allows
+ *         the payload to be decrypted in place.
+ *
  * \param[IN/OUT] macMsg       - Data message object
  * \retval                     - Status of the operation
  */
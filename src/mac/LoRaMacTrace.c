@@ -0,0 +1,137 @@
+/*!
+ * \file      LoRaMacTrace.c
+ *
+ * \brief     LoRa MAC layer execution time tracing
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ */
+#if ( defined( __unix__ ) || defined( __APPLE__ ) ) && !defined( _POSIX_C_SOURCE )
+// Required by clock_gettime on host builds
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stddef.h>
+
+#include "utilities.h"
+#include "LoRaMacTrace.h"
+
+#if defined( __ARM_ARCH_7M__ ) || defined( __ARM_ARCH_7EM__ )
+/*!
+ * Cortex-M debug exception and monitor control register
+ */
+#define LORAMAC_TRACE_DEMCR                         ( *( volatile uint32_t* )0xE000EDFC )
+/*!
+ * DWT control register
+ */
+#define LORAMAC_TRACE_DWT_CTRL                      ( *( volatile uint32_t* )0xE0001000 )
+/*!
+ * DWT cycle counter register
+ */
+#define LORAMAC_TRACE_DWT_CYCCNT                    ( *( volatile uint32_t* )0xE0001004 )
+#elif defined( __unix__ ) || defined( __APPLE__ )
+#include <time.h>
+#else
+#include "timer.h"
+#endif
+
+/*!
+ * Trace sites statistics
+ */
+static LoRaMacTraceStats_t TraceStats[LORAMAC_TRACE_SITE_MAX];
+
+void LoRaMacTraceInit( void )
+{
+#if defined( __ARM_ARCH_7M__ ) || defined( __ARM_ARCH_7EM__ )
+    // Enable the trace unit and start the cycle counter
+    LORAMAC_TRACE_DEMCR |= ( 1UL << 24 );
+    LORAMAC_TRACE_DWT_CYCCNT = 0;
+    LORAMAC_TRACE_DWT_CTRL |= 1UL;
+#endif
+    LoRaMacTraceReset( );
+}
+
+void LoRaMacTraceReset( void )
+{
+    CRITICAL_SECTION_BEGIN( );
+    memset1( ( uint8_t* )TraceStats, 0x00, sizeof( TraceStats ) );
+    for( uint8_t i = 0; i < LORAMAC_TRACE_SITE_MAX; i++ )
+    {
+        TraceStats[i].Min = UINT32_MAX;
+    }
+    CRITICAL_SECTION_END( );
+}
+
+uint32_t LoRaMacTraceGetTimestamp( void )
+{
+#if defined( __ARM_ARCH_7M__ ) || defined( __ARM_ARCH_7EM__ )
+    return LORAMAC_TRACE_DWT_CYCCNT;
+#elif defined( __unix__ ) || defined( __APPLE__ )
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( uint32_t )( ( uint64_t )ts.tv_sec * 1000000000ULL + ( uint64_t )ts.tv_nsec );
+#else
+    return ( uint32_t )TimerGetCurrentTime( );
+#endif
+}
+
+void LoRaMacTraceRecord( LoRaMacTraceSite_t site, uint32_t start )
+{
+    // Unsigned arithmetic handles the time base wrap around
+    uint32_t duration = LoRaMacTraceGetTimestamp( ) - start;
+    uint8_t bin = 0;
+
+    if( site >= LORAMAC_TRACE_SITE_MAX )
+    {
+        return;
+    }
+
+    // Bit length of the duration
+    for( uint32_t value = duration; value != 0; value >>= 1 )
+    {
+        bin++;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    LoRaMacTraceStats_t* stats = &TraceStats[site];
+
+    stats->Count++;
+    stats->Sum += duration;
+    if( duration < stats->Min )
+    {
+        stats->Min = duration;
+    }
+    if( duration > stats->Max )
+    {
+        stats->Max = duration;
+    }
+    if( stats->Histogram[bin] < UINT16_MAX )
+    {
+        stats->Histogram[bin]++;
+    }
+    CRITICAL_SECTION_END( );
+}
+
+int8_t LoRaMacTraceGetStats( LoRaMacTraceSite_t site, LoRaMacTraceStats_t* stats )
+{
+    if( ( site >= LORAMAC_TRACE_SITE_MAX ) || ( stats == NULL ) )
+    {
+        return -1;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    *stats = TraceStats[site];
+    CRITICAL_SECTION_END( );
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*!
+ * \file      LoRaMacTrace.h
+ *
+ * \brief     LoRa MAC layer execution time tracing
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \defgroup  LORAMACTRACE LoRa MAC layer execution time tracing
+ *            This module measures the execution time of the LoRaMAC hot paths.
+ *
+ *            The trace points are only compiled when LORAMAC_TRACE_ENABLED is
+ *            defined. Otherwise the LORAMAC_TRACE_* macros expand to nothing.
+ *
+ *            Time stamps unit depends on the backend:
+ *            - Cortex-M3/M4/M7: CPU cycles ( DWT cycle counter )
+ *            - Host ( POSIX ): nanoseconds ( clock_gettime )
+ *            - Other targets: milliseconds ( TimerGetCurrentTime )
+ * \{
+ */
+#ifndef __LORAMAC_TRACE_H__
+#define __LORAMAC_TRACE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Number of histogram bins. Bin n counts the durations having a bit length
+ * of n, i.e. bin 0 counts 0, bin 1 counts 1, bin 2 counts 2..3, bin 3 counts
+ * 4..7 and so on.
+ */
+#define LORAMAC_TRACE_HISTOGRAM_BINS                33
+
+/*!
+ * LoRaMAC trace sites
+ */
+typedef enum eLoRaMacTraceSite
+{
+    /*!
+     * ProcessRadioRxDone execution
+     */
+    LORAMAC_TRACE_SITE_PROCESS_RADIO_RX_DONE,
+    /*!
+     * LoRaMacCryptoUnsecureMessage execution
+     */
+    LORAMAC_TRACE_SITE_UNSECURE_MESSAGE,
+    /*!
+     * ScheduleTx execution
+     */
+    LORAMAC_TRACE_SITE_SCHEDULE_TX,
+    /*!
+     * RegionNextChannel execution
+     */
+    LORAMAC_TRACE_SITE_NEXT_CHANNEL,
+    /*!
+     * LoRaMacHandleNvm execution
+     */
+    LORAMAC_TRACE_SITE_HANDLE_NVM,
+    /*!
+     * Number of trace sites
+     */
+    LORAMAC_TRACE_SITE_MAX
+}LoRaMacTraceSite_t;
+
+/*!
+ * LoRaMAC trace site statistics
+ */
+typedef struct sLoRaMacTraceStats
+{
+    /*!
+     * Number of recorded executions
+     */
+    uint32_t Count;
+    /*!
+     * Minimum execution time
+     */
+    uint32_t Min;
+    /*!
+     * Maximum execution time
+     */
+    uint32_t Max;
+    /*!
+     * Sum of the execution times
+     */
+    uint64_t Sum;
+    /*!
+     * Execution times histogram. Counters saturate at UINT16_MAX
+     */
+    uint16_t Histogram[LORAMAC_TRACE_HISTOGRAM_BINS];
+}LoRaMacTraceStats_t;
+
+/*!
+ * \brief   Initializes the trace time base and resets all statistics
+ */
+void LoRaMacTraceInit( void );
+
+/*!
+ * \brief   Resets all statistics
+ */
+void LoRaMacTraceReset( void );
+
+/*!
+ * \brief   Gets the current trace time stamp
+ *
+ * \retval  Time stamp in the backend unit
+ */
+uint32_t LoRaMacTraceGetTimestamp( void );
+
+/*!
+ * \brief   Records the execution time of a trace site
+ *
+ * \param   [IN] site Trace site
+ *
+ * \param   [IN] start Time stamp taken at the beginning of the execution
+ */
+void LoRaMacTraceRecord( LoRaMacTraceSite_t site, uint32_t start );
+
+/*!
+ * \brief   Gets the statistics of a trace site
+ *
+ * \param   [IN] site Trace site
+ *
+ * \param   [OUT] stats Copy of the trace site statistics
+ *
+ * \retval  Returns 0 on success, -1 if the site or the pointer are invalid
+ */
+int8_t LoRaMacTraceGetStats( LoRaMacTraceSite_t site, LoRaMacTraceStats_t* stats );
+
+#if defined( LORAMAC_TRACE_ENABLED )
+#define LORAMAC_TRACE_INIT( )                       LoRaMacTraceInit( )
+#define LORAMAC_TRACE_BEGIN( start )                uint32_t start = LoRaMacTraceGetTimestamp( )
+#define LORAMAC_TRACE_END( site, start )            LoRaMacTraceRecord( site, start )
+#else
+#define LORAMAC_TRACE_INIT( )
+#define LORAMAC_TRACE_BEGIN( start )
+#define LORAMAC_TRACE_END( site, start )
+#endif
+
+/*! \} defgroup LORAMACTRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LORAMAC_TRACE_H__
@@ -1237,6 +1237,26 @@ typedef struct sChannelParams
     uint8_t Band;
 }ChannelParams_t;
 
+/*!
+ * LoRaMAC listen before talk channel occupancy statistics
+ */
+typedef struct sLbtChannelStats
+{
+    /*!
+     * Number of carrier senses performed on the channel
+     */
+    uint32_t NbCarrierSense;
+    /*!
+     * Number of carrier senses which found the channel busy
+     */
+    uint32_t NbBusy;
+    /*!
+     * Outcomes of the most recent carrier senses. Bit 0 holds the latest
+     * outcome. A bit set means that the channel was busy.
+     */
+    uint8_t BusyHistory;
+}LbtChannelStats_t;
+
 /*!
  * LoRaMAC frame types
  *
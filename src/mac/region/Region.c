@@ -30,6 +30,10 @@
  */
 #include "LoRaMac.h"
 
+#if defined( REGION_SINGLE_ENABLED )
+// The region API is bound at compile time by Region.h
+#include "Region.h"
+#else
 // Setup regions
 #ifdef REGION_AS923
 #include "RegionAS923.h"
@@ -962,6 +966,7 @@ void RegionRxBeaconSetup( LoRaMacRegion_t region, RxBeaconSetup_t* rxBeaconSetup
         }
     }
 }
+#endif /* REGION_SINGLE_ENABLED */
 
 Version_t RegionGetVersion( void )
 {
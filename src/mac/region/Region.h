@@ -315,6 +315,10 @@ typedef enum ePhyAttribute
      * The equivalent bandwith index from datarate
      */
     PHY_BW_FROM_DR,
+    /*!
+     * The listen before talk channels occupancy statistics.
+     */
+    PHY_LBT_CHANNEL_STATS,
 }PhyAttribute_t;
 
 /*!
@@ -401,6 +405,10 @@ typedef union uPhyParam
      * Duty Cycle Period
      */
     TimerTime_t DutyCycleTimePeriod;
+    /*!
+     * Pointer to the listen before talk channels statistics.
+     */
+    LbtChannelStats_t* LbtChannelStats;
 }PhyParam_t;
 
 /*!
@@ -1152,6 +1160,95 @@ void RegionRxBeaconSetup( LoRaMacRegion_t region, RxBeaconSetup_t* rxBeaconSetup
  */
 Version_t RegionGetVersion( void );
 
+#if defined( REGION_SINGLE_ENABLED )
+/*!
+ * Single region build.
+ *
+ * The only enabled region is bound at compile time. The region API calls
+ * resolve to direct calls of the region implementation and the region
+ * identifier argument is not evaluated.
+ */
+#if ( defined( REGION_AS923 ) + \
+      defined( REGION_AU915 ) + \
+      defined( REGION_CN470 ) + \
+      defined( REGION_CN779 ) + \
+      defined( REGION_EU433 ) + \
+      defined( REGION_EU868 ) + \
+      defined( REGION_KR920 ) + \
+      defined( REGION_IN865 ) + \
+      defined( REGION_US915 ) + \
+      defined( REGION_RU864 ) ) != 1
+#error "REGION_SINGLE_ENABLED requires exactly one enabled region"
+#endif
+
+#if defined( REGION_AS923 )
+#include "RegionAS923.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_AS923
+#define REGION_SINGLE_FN( fn )                      RegionAS923##fn
+#elif defined( REGION_AU915 )
+#include "RegionAU915.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_AU915
+#define REGION_SINGLE_FN( fn )                      RegionAU915##fn
+#elif defined( REGION_CN470 )
+#include "RegionCN470.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_CN470
+#define REGION_SINGLE_FN( fn )                      RegionCN470##fn
+#elif defined( REGION_CN779 )
+#include "RegionCN779.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_CN779
+#define REGION_SINGLE_FN( fn )                      RegionCN779##fn
+#elif defined( REGION_EU433 )
+#include "RegionEU433.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_EU433
+#define REGION_SINGLE_FN( fn )                      RegionEU433##fn
+#elif defined( REGION_EU868 )
+#include "RegionEU868.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_EU868
+#define REGION_SINGLE_FN( fn )                      RegionEU868##fn
+#elif defined( REGION_KR920 )
+#include "RegionKR920.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_KR920
+#define REGION_SINGLE_FN( fn )                      RegionKR920##fn
+#elif defined( REGION_IN865 )
+#include "RegionIN865.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_IN865
+#define REGION_SINGLE_FN( fn )                      RegionIN865##fn
+#elif defined( REGION_US915 )
+#include "RegionUS915.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_US915
+#define REGION_SINGLE_FN( fn )                      RegionUS915##fn
+#elif defined( REGION_RU864 )
+#include "RegionRU864.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_RU864
+#define REGION_SINGLE_FN( fn )                      RegionRU864##fn
+#endif
+
+#define RegionIsActive( region )                                                ( ( region ) == REGION_SINGLE_ID )
+#define RegionGetPhyParam( region, getPhy )                                     REGION_SINGLE_FN( GetPhyParam )( getPhy )
+#define RegionSetBandTxDone( region, txDone )                                   REGION_SINGLE_FN( SetBandTxDone )( txDone )
+#define RegionInitDefaults( region, params )                                    REGION_SINGLE_FN( InitDefaults )( params )
+#define RegionVerify( region, verify, phyAttribute )                            REGION_SINGLE_FN( Verify )( verify, phyAttribute )
+#define RegionApplyCFList( region, applyCFList )                                REGION_SINGLE_FN( ApplyCFList )( applyCFList )
+#define RegionChanMaskSet( region, chanMaskSet )                                REGION_SINGLE_FN( ChanMaskSet )( chanMaskSet )
+#define RegionRxConfig( region, rxConfig, datarate )                            REGION_SINGLE_FN( RxConfig )( rxConfig, datarate )
+#define RegionComputeRxWindowParameters( region, datarate, minRxSymbols, rxError, rxConfigParams ) \
+        REGION_SINGLE_FN( ComputeRxWindowParameters )( datarate, minRxSymbols, rxError, rxConfigParams )
+#define RegionTxConfig( region, txConfig, txPower, txTimeOnAir )                REGION_SINGLE_FN( TxConfig )( txConfig, txPower, txTimeOnAir )
+#define RegionLinkAdrReq( region, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed ) \
+        REGION_SINGLE_FN( LinkAdrReq )( linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed )
+#define RegionRxParamSetupReq( region, rxParamSetupReq )                        REGION_SINGLE_FN( RxParamSetupReq )( rxParamSetupReq )
+#define RegionNewChannelReq( region, newChannelReq )                            REGION_SINGLE_FN( NewChannelReq )( newChannelReq )
+#define RegionTxParamSetupReq( region, txParamSetupReq )                        REGION_SINGLE_FN( TxParamSetupReq )( txParamSetupReq )
+#define RegionDlChannelReq( region, dlChannelReq )                              REGION_SINGLE_FN( DlChannelReq )( dlChannelReq )
+#define RegionAlternateDr( region, currentDr, type )                            REGION_SINGLE_FN( AlternateDr )( currentDr, type )
+#define RegionNextChannel( region, nextChanParams, channel, time, aggregatedTimeOff ) \
+        REGION_SINGLE_FN( NextChannel )( nextChanParams, channel, time, aggregatedTimeOff )
+#define RegionChannelAdd( region, channelAdd )                                  REGION_SINGLE_FN( ChannelAdd )( channelAdd )
+#define RegionChannelsRemove( region, channelRemove )                           REGION_SINGLE_FN( ChannelsRemove )( channelRemove )
+#define RegionApplyDrOffset( region, downlinkDwellTime, dr, drOffset )          REGION_SINGLE_FN( ApplyDrOffset )( downlinkDwellTime, dr, drOffset )
+#define RegionRxBeaconSetup( region, rxBeaconSetup, outDr )                     REGION_SINGLE_FN( RxBeaconSetup )( rxBeaconSetup, outDr )
+#endif /* REGION_SINGLE_ENABLED */
+
 /*! \} defgroup REGION */
 
 #ifdef __cplusplus
@@ -30,6 +30,7 @@
 */
 #include "radio.h"
 #include "RegionCommon.h"
+#include "LoRaMacInstance.h"
 #include "RegionAS923.h"
 
 // Definitions
@@ -204,9 +205,24 @@
 /*
  * Non-volatile module context.
  */
-static RegionNvmDataGroup1_t* RegionNvmGroup1;
-static RegionNvmDataGroup2_t* RegionNvmGroup2;
-static Band_t* RegionBands;
+static RegionNvmDataGroup1_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup1 );
+static RegionNvmDataGroup2_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup2 );
+static Band_t* LORAMAC_INSTANCE_STATE( RegionBands );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define RegionNvmGroup1                             LORAMAC_INSTANCE( RegionNvmGroup1 )
+#define RegionNvmGroup2                             LORAMAC_INSTANCE( RegionNvmGroup2 )
+#define RegionBands                                 LORAMAC_INSTANCE( RegionBands )
+#endif
+
+#if ( ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH24_CH38_LBT ) || \
+      ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH37_CH61_LBT_DC ) )
+/*
+ * Listen before talk channels occupancy statistics. Always accessed through
+ * LORAMAC_INSTANCE, the name is also a PhyParam_t field.
+ */
+static LbtChannelStats_t LORAMAC_INSTANCE_STATE( LbtChannelStats )[AS923_MAX_NB_CHANNELS];
+#endif
 
 // Static functions
 static bool VerifyRfFreq( uint32_t freq )
@@ -449,6 +465,14 @@ PhyParam_t RegionAS923GetPhyParam( GetPhyParams_t* getPhy )
             phyParam.Value = RegionCommonGetBandwidth( getPhy->Datarate, BandwidthsAS923 );
             break;
         }
+#if ( ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH24_CH38_LBT ) || \
+      ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH37_CH61_LBT_DC ) )
+        case PHY_LBT_CHANNEL_STATS:
+        {
+            phyParam.LbtChannelStats = LORAMAC_INSTANCE( LbtChannelStats );
+            break;
+        }
+#endif
         default:
         {
             break;
@@ -505,6 +529,8 @@ void RegionAS923InitDefaults( InitDefaultsParams_t* params )
       ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH37_CH61_LBT_DC ) )
             RegionNvmGroup2->RssiFreeThreshold = AS923_RSSI_FREE_TH;
             RegionNvmGroup2->CarrierSenseTime = AS923_CARRIER_SENSE_TIME;
+
+            memset1( ( uint8_t* )LORAMAC_INSTANCE( LbtChannelStats ), 0x00, sizeof( LORAMAC_INSTANCE( LbtChannelStats ) ) );
 #endif
             break;
         }
@@ -1027,25 +1053,18 @@ LoRaMacStatus_t RegionAS923NextChannel( NextChanParams_t* nextChanParams, uint8_
 #if ( ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH24_CH38_LBT ) || \
       ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH37_CH61_LBT_DC ) )
         // Executes the LBT algorithm when operating in Japan
-        uint8_t channelNext = 0;
-
-        for( uint8_t  i = 0, j = randr( 0, nbEnabledChannels - 1 ); i < AS923_MAX_NB_CHANNELS; i++ )
-        {
-            channelNext = enabledChannels[j];
-            j = ( j + 1 ) % nbEnabledChannels;
-
-            // Perform carrier sense for AS923_CARRIER_SENSE_TIME
-            // If the channel is free, we can stop the LBT mechanism
-            if( Radio.IsChannelFree( RegionNvmGroup2->Channels[channelNext].Frequency, AS923_LBT_RX_BANDWIDTH, RegionNvmGroup2->RssiFreeThreshold, RegionNvmGroup2->CarrierSenseTime ) == true )
-            {
-                // Free channel found
-                *channel = channelNext;
-                return LORAMAC_STATUS_OK;
-            }
-        }
-        // Even if one or more channels are available according to the channel plan, no free channel
-        // was found during the LBT procedure.
-        status = LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND;
+        RegionCommonLbtNextChannelParams_t lbtParams;
+
+        lbtParams.EnabledChannels = enabledChannels;
+        lbtParams.NbEnabledChannels = nbEnabledChannels;
+        lbtParams.Channels = RegionNvmGroup2->Channels;
+        lbtParams.Stats = LORAMAC_INSTANCE( LbtChannelStats );
+        lbtParams.RxBandwidth = AS923_LBT_RX_BANDWIDTH;
+        lbtParams.RssiFreeThreshold = RegionNvmGroup2->RssiFreeThreshold;
+        lbtParams.CarrierSenseTime = RegionNvmGroup2->CarrierSenseTime;
+
+        // Perform carrier sense for AS923_CARRIER_SENSE_TIME
+        status = RegionCommonLbtNextChannel( &lbtParams, channel );
 #else
         // We found a valid channel
         *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
@@ -1115,6 +1134,10 @@ LoRaMacStatus_t RegionAS923ChannelAdd( ChannelAddParams_t* channelAdd )
     memcpy1( ( uint8_t* ) &(RegionNvmGroup2->Channels[id]), ( uint8_t* ) channelAdd->NewChannel, sizeof( RegionNvmGroup2->Channels[id] ) );
     RegionNvmGroup2->Channels[id].Band = 0;
     RegionNvmGroup2->ChannelsMask[0] |= ( 1 << id );
+#if ( ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH24_CH38_LBT ) || \
+      ( REGION_AS923_DEFAULT_CHANNEL_PLAN == CHANNEL_PLAN_GROUP_AS923_1_JP_CH37_CH61_LBT_DC ) )
+    memset1( ( uint8_t* ) &LORAMAC_INSTANCE( LbtChannelStats )[id], 0x00, sizeof( LORAMAC_INSTANCE( LbtChannelStats )[id] ) );
+#endif
     return LORAMAC_STATUS_OK;
 }
 
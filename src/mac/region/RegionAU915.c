@@ -30,6 +30,7 @@
 */
 #include "radio.h"
 #include "RegionCommon.h"
+#include "LoRaMacInstance.h"
 #include "RegionAU915.h"
 #include "RegionBaseUS.h"
 
@@ -42,9 +43,15 @@
 /*
  * Non-volatile module context.
  */
-static RegionNvmDataGroup1_t* RegionNvmGroup1;
-static RegionNvmDataGroup2_t* RegionNvmGroup2;
-static Band_t* RegionBands;
+static RegionNvmDataGroup1_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup1 );
+static RegionNvmDataGroup2_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup2 );
+static Band_t* LORAMAC_INSTANCE_STATE( RegionBands );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define RegionNvmGroup1                             LORAMAC_INSTANCE( RegionNvmGroup1 )
+#define RegionNvmGroup2                             LORAMAC_INSTANCE( RegionNvmGroup2 )
+#define RegionBands                                 LORAMAC_INSTANCE( RegionBands )
+#endif
 
 static bool VerifyRfFreq( uint32_t freq )
 {
@@ -342,6 +349,10 @@ void RegionAU915InitDefaults( InitDefaultsParams_t* params )
             // Initialize the join trials counter
             RegionNvmGroup1->JoinTrialsCounter = 0;
 
+            // No join request sent and no preferred join sub-band yet
+            RegionNvmGroup1->JoinChannelGroupLast = 0;
+            RegionNvmGroup2->JoinChannelGroupPreferred = 0;
+
             // Default bands
             memcpy1( ( uint8_t* )RegionBands, ( uint8_t* )bands, sizeof( Band_t ) * AU915_MAX_NB_BANDS );
 
@@ -811,12 +822,20 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
 
+    if( ( nextChanParams->Joined == true ) && ( RegionNvmGroup1->JoinChannelGroupLast != 0 ) )
+    { // The last join request has been accepted. Upcoming join sweeps start on its sub-band.
+        RegionNvmGroup2->JoinChannelGroupPreferred = RegionNvmGroup1->JoinChannelGroupLast;
+        RegionNvmGroup1->JoinChannelGroupsCurrentIndex = RegionNvmGroup1->JoinChannelGroupLast - 1;
+        RegionNvmGroup1->JoinChannelGroupLast = 0;
+    }
+    uint8_t preferredGroup = ( RegionNvmGroup2->JoinChannelGroupPreferred != 0 ) ? ( RegionNvmGroup2->JoinChannelGroupPreferred - 1 ) : 0;
+
     // Count 125kHz channels
     if( RegionCommonCountChannels( RegionNvmGroup1->ChannelsMaskRemaining, 0, 4 ) == 0 )
     { // Reactivate default channels
         RegionCommonChanMaskCopy( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, 4  );
 
-        RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+        RegionNvmGroup1->JoinChannelGroupsCurrentIndex = preferredGroup;
     }
     // Check other channels
     if( nextChanParams->Datarate >= DR_6 )
@@ -863,6 +882,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
             // follow a random channel selection sequence. It probes alternating one out of a
             // group of eight 125 kHz channels followed by probing one 500 kHz channel each pass.
             // Each time a 125 kHz channel will be selected from another group.
+            // The sweeps start on the sub-band of the last successful join.
 
             // 125kHz Channels (0 - 63) DR2
             if( nextChanParams->Datarate == DR_2 )
@@ -877,13 +897,10 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
             else
             {
                 // Choose the next available channel
-                uint8_t i = 0;
-                while( ( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) & ( 1 << i ) ) == 0 )
-                {
-                    i++;
-                }
-                *channel = 64 + i;
+                *channel = RegionBaseUSComputeNext500kHzJoinChannel( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK,
+                                                                     preferredGroup );
             }
+            RegionNvmGroup1->JoinChannelGroupLast = RegionBaseUSGetJoinChannelGroup( *channel ) + 1;
         }
 
         // Disable the channel in the mask
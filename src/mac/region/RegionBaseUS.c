@@ -134,6 +134,30 @@ LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMask
     return LORAMAC_STATUS_PARAMETER_INVALID;
 }
 
+uint8_t RegionBaseUSComputeNext500kHzJoinChannel( uint16_t channelsMask500kHzRemaining, uint8_t preferredGroup )
+{
+    uint8_t group = preferredGroup & 0x07;
+
+    for( uint8_t i = 0; i < 8; i++ )
+    {
+        if( ( channelsMask500kHzRemaining & ( 1 << group ) ) != 0 )
+        {
+            break;
+        }
+        group = ( group + 1 ) & 0x07;
+    }
+    return 64 + group;
+}
+
+uint8_t RegionBaseUSGetJoinChannelGroup( uint8_t channel )
+{
+    if( channel < 64 )
+    {
+        return channel / 8;
+    }
+    return ( channel - 64 ) & 0x07;
+}
+
 bool RegionBaseUSVerifyFrequencyGroup( uint32_t freq, uint32_t minFreq, uint32_t maxFreq, uint32_t stepwidth )
 {
     if( ( freq < minFreq ) ||
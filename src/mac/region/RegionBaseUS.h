@@ -58,6 +58,29 @@ extern "C"
 LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMaskRemaining,
                                                           uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex );
 
+/*!
+ * \brief Computes the next 500kHz channel used for join requests. The
+ *        search starts on the preferred sub-band and wraps around.
+ *
+ * \param [IN]  channelsMask500kHzRemaining Remaining 500kHz channels, bit 0 - 7.
+ *                                          At least one bit must be set.
+ *
+ * \param [IN]  preferredGroup Sub-band to start the search with [0:7].
+ *
+ * \retval Index of next available channel [64:71].
+ */
+uint8_t RegionBaseUSComputeNext500kHzJoinChannel( uint16_t channelsMask500kHzRemaining, uint8_t preferredGroup );
+
+/*!
+ * \brief Gets the sub-band of a channel. A 500kHz channel belongs to the
+ *        sub-band of the 125kHz channels it overlaps.
+ *
+ * \param [IN]  channel Channel index [0:71].
+ *
+ * \retval Sub-band [0:7].
+ */
+uint8_t RegionBaseUSGetJoinChannelGroup( uint8_t channel );
+
 /*!
  * \brief Verifies if the frequency is in the correct range with a
  *        specific stepwidth.
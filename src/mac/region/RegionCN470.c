@@ -30,6 +30,7 @@
 */
 #include "radio.h"
 #include "RegionCommon.h"
+#include "LoRaMacInstance.h"
 #include "RegionCN470.h"
 #include "RegionCN470A20.h"
 #include "RegionCN470B20.h"
@@ -151,14 +152,21 @@ typedef struct sRegionCN470ChannelPlanCtx
 /*
  * Non-volatile module context.
  */
-static RegionNvmDataGroup1_t* RegionNvmGroup1;
-static RegionNvmDataGroup2_t* RegionNvmGroup2;
-static Band_t* RegionBands;
+static RegionNvmDataGroup1_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup1 );
+static RegionNvmDataGroup2_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup2 );
+static Band_t* LORAMAC_INSTANCE_STATE( RegionBands );
 
 /*
  * Context for the current channel plan.
  */
-static RegionCN470ChannelPlanCtx_t ChannelPlanCtx;
+static RegionCN470ChannelPlanCtx_t LORAMAC_INSTANCE_STATE( ChannelPlanCtx );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define RegionNvmGroup1                             LORAMAC_INSTANCE( RegionNvmGroup1 )
+#define RegionNvmGroup2                             LORAMAC_INSTANCE( RegionNvmGroup2 )
+#define RegionBands                                 LORAMAC_INSTANCE( RegionBands )
+#define ChannelPlanCtx                              LORAMAC_INSTANCE( ChannelPlanCtx )
+#endif
 
 // Static functions
 static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, RegionCN470ChannelPlanCtx_t* ctx )
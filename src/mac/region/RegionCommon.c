@@ -185,6 +185,17 @@ static uint8_t CountChannels( uint16_t mask, uint8_t nbBits )
     return nbActiveBits;
 }
 
+static uint8_t CountLbtBusyOutcomes( uint8_t busyHistory )
+{
+    uint8_t nbBusy = 0;
+
+    for( ; busyHistory != 0; busyHistory &= busyHistory - 1 )
+    {
+        nbBusy++;
+    }
+    return nbBusy;
+}
+
 bool RegionCommonChanVerifyDr( uint8_t nbChannels, uint16_t* channelsMask, int8_t dr, int8_t minDr, int8_t maxDr, ChannelParams_t* channels )
 {
     if( RegionCommonValueInRange( dr, minDr, maxDr ) == 0 )
@@ -622,3 +633,44 @@ uint32_t RegionCommonGetBandwidth( uint32_t drIndex, const uint32_t* bandwidths
             return 2;
     }
 }
+
+LoRaMacStatus_t RegionCommonLbtNextChannel( RegionCommonLbtNextChannelParams_t* params, uint8_t* channel )
+{
+    uint8_t start = randr( 0, params->NbEnabledChannels - 1 );
+    uint32_t sensedChannels = 0;
+
+    // Visit the channels by increasing number of recent busy outcomes
+    for( uint8_t nbBusy = 0; nbBusy <= ( sizeof( params->Stats->BusyHistory ) * 8 ); nbBusy++ )
+    {
+        for( uint8_t i = 0, j = start; i < params->NbEnabledChannels; i++ )
+        {
+            uint8_t channelNext = params->EnabledChannels[j];
+            LbtChannelStats_t* stats = &params->Stats[channelNext];
+            uint32_t position = 1UL << j;
+
+            j = ( j + 1 ) % params->NbEnabledChannels;
+
+            if( ( ( sensedChannels & position ) != 0 ) || ( CountLbtBusyOutcomes( stats->BusyHistory ) != nbBusy ) )
+            {
+                continue;
+            }
+            sensedChannels |= position;
+
+            // Perform carrier sense. If the channel is free, we can stop the LBT mechanism
+            stats->NbCarrierSense++;
+            stats->BusyHistory <<= 1;
+            if( Radio.IsChannelFree( params->Channels[channelNext].Frequency, params->RxBandwidth,
+                                     params->RssiFreeThreshold, params->CarrierSenseTime ) == true )
+            {
+                // Free channel found
+                *channel = channelNext;
+                return LORAMAC_STATUS_OK;
+            }
+            stats->NbBusy++;
+            stats->BusyHistory |= 0x01;
+        }
+    }
+    // Even if one or more channels are available according to the channel plan, no free channel
+    // was found during the LBT procedure.
+    return LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND;
+}
@@ -337,6 +337,38 @@ typedef struct sRegionCommonGetNextLowerTxDrParams
     ChannelParams_t* Channels;
 }RegionCommonGetNextLowerTxDrParams_t;
 
+typedef struct sRegionCommonLbtNextChannelParams
+{
+    /*!
+     * A pointer to the channels which are available for the transmission.
+     */
+    uint8_t* EnabledChannels;
+    /*!
+     * Number of channels which are available for the transmission.
+     */
+    uint8_t NbEnabledChannels;
+    /*!
+     * A pointer to the channels.
+     */
+    ChannelParams_t* Channels;
+    /*!
+     * A pointer to the occupancy statistics, indexed by channel.
+     */
+    LbtChannelStats_t* Stats;
+    /*!
+     * Carrier sense reception bandwidth [Hz].
+     */
+    uint32_t RxBandwidth;
+    /*!
+     * RSSI threshold for a free channel [dBm].
+     */
+    int16_t RssiFreeThreshold;
+    /*!
+     * Carrier sense time [ms].
+     */
+    uint32_t CarrierSenseTime;
+}RegionCommonLbtNextChannelParams_t;
+
 /*!
  * \brief Verifies, if a value is in a given range.
  *        This is a generic function and valid for all regions.
@@ -616,6 +648,23 @@ int8_t RegionCommonLimitTxPower( int8_t txPower, int8_t maxBandTxPower );
  */
 uint32_t RegionCommonGetBandwidth( uint32_t drIndex, const uint32_t* bandwidths );
 
+/*!
+ * \brief Selects a free channel using the listen before talk procedure.
+ *
+ * \details The carrier senses are performed on the channels having the
+ *          least busy outcomes in their recent history first. Channels with
+ *          the same history are visited starting from a random position.
+ *          Each channel is sensed at most once.
+ *
+ * \param [IN] params A pointer to the input parameters.
+ *
+ * \param [OUT] channel The free channel found.
+ *
+ * \retval Status of the operation. LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND if
+ *         all enabled channels are busy.
+ */
+LoRaMacStatus_t RegionCommonLbtNextChannel( RegionCommonLbtNextChannelParams_t* params, uint8_t* channel );
+
 /*! \} defgroup REGIONCOMMON */
 
 #ifdef __cplusplus
@@ -30,6 +30,7 @@
 */
 #include "radio.h"
 #include "RegionCommon.h"
+#include "LoRaMacInstance.h"
 #include "RegionEU433.h"
 
 // Definitions
@@ -38,9 +39,15 @@
 /*
  * Non-volatile module context.
  */
-static RegionNvmDataGroup1_t* RegionNvmGroup1;
-static RegionNvmDataGroup2_t* RegionNvmGroup2;
-static Band_t* RegionBands;
+static RegionNvmDataGroup1_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup1 );
+static RegionNvmDataGroup2_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup2 );
+static Band_t* LORAMAC_INSTANCE_STATE( RegionBands );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define RegionNvmGroup1                             LORAMAC_INSTANCE( RegionNvmGroup1 )
+#define RegionNvmGroup2                             LORAMAC_INSTANCE( RegionNvmGroup2 )
+#define RegionBands                                 LORAMAC_INSTANCE( RegionBands )
+#endif
 
 // Static functions
 static bool VerifyRfFreq( uint32_t freq )
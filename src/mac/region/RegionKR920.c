@@ -30,6 +30,7 @@
 */
 #include "radio.h"
 #include "RegionCommon.h"
+#include "LoRaMacInstance.h"
 #include "RegionKR920.h"
 
 // Definitions
@@ -54,9 +55,21 @@
 /*
  * Non-volatile module context.
  */
-static RegionNvmDataGroup1_t* RegionNvmGroup1;
-static RegionNvmDataGroup2_t* RegionNvmGroup2;
-static Band_t* RegionBands;
+static RegionNvmDataGroup1_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup1 );
+static RegionNvmDataGroup2_t* LORAMAC_INSTANCE_STATE( RegionNvmGroup2 );
+static Band_t* LORAMAC_INSTANCE_STATE( RegionBands );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define RegionNvmGroup1                             LORAMAC_INSTANCE( RegionNvmGroup1 )
+#define RegionNvmGroup2                             LORAMAC_INSTANCE( RegionNvmGroup2 )
+#define RegionBands                                 LORAMAC_INSTANCE( RegionBands )
+#endif
+
+/*
+ * Listen before talk channels occupancy statistics. Always accessed through
+ * LORAMAC_INSTANCE, the name is also a PhyParam_t field.
+ */
+static LbtChannelStats_t LORAMAC_INSTANCE_STATE( LbtChannelStats )[KR920_MAX_NB_CHANNELS];
 
 // Static functions
 static int8_t GetMaxEIRP( uint32_t freq )
@@ -292,6 +305,11 @@ PhyParam_t RegionKR920GetPhyParam( GetPhyParams_t* getPhy )
             phyParam.Value = RegionCommonGetBandwidth( getPhy->Datarate, BandwidthsKR920 );
             break;
         }
+        case PHY_LBT_CHANNEL_STATS:
+        {
+            phyParam.LbtChannelStats = LORAMAC_INSTANCE( LbtChannelStats );
+            break;
+        }
         default:
         {
             break;
@@ -343,6 +361,8 @@ void RegionKR920InitDefaults( InitDefaultsParams_t* params )
 
             RegionNvmGroup2->RssiFreeThreshold = KR920_RSSI_FREE_TH;
             RegionNvmGroup2->CarrierSenseTime = KR920_CARRIER_SENSE_TIME;
+
+            memset1( ( uint8_t* )LORAMAC_INSTANCE( LbtChannelStats ), 0x00, sizeof( LORAMAC_INSTANCE( LbtChannelStats ) ) );
             break;
         }
         case INIT_TYPE_RESET_TO_DEFAULT_CHANNELS:
@@ -785,12 +805,12 @@ int8_t RegionKR920AlternateDr( int8_t currentDr, AlternateDrType_t type )
 
 LoRaMacStatus_t RegionKR920NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff )
 {
-    uint8_t channelNext = 0;
     uint8_t nbEnabledChannels = 0;
     uint8_t nbRestrictedChannels = 0;
     uint8_t enabledChannels[KR920_MAX_NB_CHANNELS] = { 0 };
     RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
+    RegionCommonLbtNextChannelParams_t lbtParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
     uint16_t joinChannels = KR920_JOIN_CHANNELS;
 
@@ -824,23 +844,16 @@ LoRaMacStatus_t RegionKR920NextChannel( NextChanParams_t* nextChanParams, uint8_
 
     if( status == LORAMAC_STATUS_OK )
     {
-        for( uint8_t  i = 0, j = randr( 0, nbEnabledChannels - 1 ); i < KR920_MAX_NB_CHANNELS; i++ )
-        {
-            channelNext = enabledChannels[j];
-            j = ( j + 1 ) % nbEnabledChannels;
+        lbtParams.EnabledChannels = enabledChannels;
+        lbtParams.NbEnabledChannels = nbEnabledChannels;
+        lbtParams.Channels = RegionNvmGroup2->Channels;
+        lbtParams.Stats = LORAMAC_INSTANCE( LbtChannelStats );
+        lbtParams.RxBandwidth = KR920_LBT_RX_BANDWIDTH;
+        lbtParams.RssiFreeThreshold = RegionNvmGroup2->RssiFreeThreshold;
+        lbtParams.CarrierSenseTime = RegionNvmGroup2->CarrierSenseTime;
 
-            // Perform carrier sense for KR920_CARRIER_SENSE_TIME
-            // If the channel is free, we can stop the LBT mechanism
-            if( Radio.IsChannelFree( RegionNvmGroup2->Channels[channelNext].Frequency, KR920_LBT_RX_BANDWIDTH, RegionNvmGroup2->RssiFreeThreshold, RegionNvmGroup2->CarrierSenseTime ) == true )
-            {
-                // Free channel found
-                *channel = channelNext;
-                return LORAMAC_STATUS_OK;
-            }
-        }
-        // Even if one or more channels are available according to the channel plan, no free channel
-        // was found during the LBT procedure.
-        status = LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND;
+        // Perform carrier sense for KR920_CARRIER_SENSE_TIME
+        status = RegionCommonLbtNextChannel( &lbtParams, channel );
     }
     else if( status == LORAMAC_STATUS_NO_CHANNEL_FOUND )
     {
@@ -906,6 +919,7 @@ LoRaMacStatus_t RegionKR920ChannelAdd( ChannelAddParams_t* channelAdd )
     memcpy1( ( uint8_t* ) &(RegionNvmGroup2->Channels[id]), ( uint8_t* ) channelAdd->NewChannel, sizeof( RegionNvmGroup2->Channels[id] ) );
     RegionNvmGroup2->Channels[id].Band = 0;
     RegionNvmGroup2->ChannelsMask[0] |= ( 1 << id );
+    memset1( ( uint8_t* ) &LORAMAC_INSTANCE( LbtChannelStats )[id], 0x00, sizeof( LORAMAC_INSTANCE( LbtChannelStats )[id] ) );
     return LORAMAC_STATUS_OK;
 }
 
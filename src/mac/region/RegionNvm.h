@@ -100,6 +100,11 @@ typedef struct sRegionNvmDataGroup1
      * Counter of join trials needed to alternate between datarates.
      */
     uint8_t JoinTrialsCounter;
+    /*!
+     * Sub-band of the last transmitted join request plus one. 0 if the
+     * last join request is unknown or has already been accounted for.
+     */
+    uint8_t JoinChannelGroupLast;
 #endif
     /*!
      * CRC32 value of the Region data structure.
@@ -152,6 +157,13 @@ typedef struct sRegionNvmDataGroup2
     */
     uint32_t CarrierSenseTime;
 #endif
+#if defined( REGION_US915 ) || defined( REGION_AU915 )
+    /*!
+     * Sub-band of the last successful join plus one. 0 if the device never
+     * joined. The join sweeps start on this sub-band.
+     */
+    uint8_t JoinChannelGroupPreferred;
+#endif
 
     /*!
      * CRC32 value of the Region data structure.
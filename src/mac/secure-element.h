@@ -148,6 +148,17 @@ SecureElementStatus_t SecureElementAesEncrypt( uint8_t* buffer, uint16_t size, K
  */
 SecureElementStatus_t SecureElementDeriveAndStoreKey( uint8_t* input, KeyIdentifier_t rootKeyID, KeyIdentifier_t targetKeyID );
 
+/*!
+ * Derives and store several keys from the same root key
+ *
+ * \param[IN]  inputs         - Input data from which the keys are derived ( 16 byte per key )
+ * \param[IN]  rootKeyID      - Key identifier of the root key to use to perform the derivations
+ * \param[IN]  targetKeyIDs   - Key identifiers of the keys which will be derived
+ * \param[IN]  nbKeys         - Number of keys to derive
+ * \retval                    - Status of the operation
+ */
+SecureElementStatus_t SecureElementDeriveAndStoreKeys( uint8_t* inputs, KeyIdentifier_t rootKeyID, KeyIdentifier_t* targetKeyIDs, uint8_t nbKeys );
+
 /*!
  * Process JoinAccept message.
  *
@@ -432,6 +432,26 @@ SecureElementStatus_t SecureElementDeriveAndStoreKey( uint8_t* input, KeyIdentif
     }
 }
 
+SecureElementStatus_t SecureElementDeriveAndStoreKeys( uint8_t* inputs, KeyIdentifier_t rootKeyID,
+                                                       KeyIdentifier_t* targetKeyIDs, uint8_t nbKeys )
+{
+    if( ( inputs == NULL ) || ( targetKeyIDs == NULL ) )
+    {
+        return SECURE_ELEMENT_ERROR_NPE;
+    }
+
+    // The KDF command derives a single key, one command is issued per key
+    for( uint8_t i = 0; i < nbKeys; i++ )
+    {
+        SecureElementStatus_t retval = SecureElementDeriveAndStoreKey( &inputs[i * 16], rootKeyID, targetKeyIDs[i] );
+        if( retval != SECURE_ELEMENT_SUCCESS )
+        {
+            return retval;
+        }
+    }
+    return SECURE_ELEMENT_SUCCESS;
+}
+
 SecureElementStatus_t SecureElementProcessJoinAccept( JoinReqIdentifier_t joinReqType, uint8_t* joinEui,
                                                       uint16_t devNonce, uint8_t* encJoinAccept,
                                                       uint8_t encJoinAcceptSize, uint8_t* decJoinAccept,
@@ -238,6 +238,32 @@ SecureElementStatus_t SecureElementDeriveAndStoreKey( uint8_t* input, KeyIdentif
     return status;
 }
 
+SecureElementStatus_t SecureElementDeriveAndStoreKeys( uint8_t* inputs, KeyIdentifier_t rootKeyID,
+                                                       KeyIdentifier_t* targetKeyIDs, uint8_t nbKeys )
+{
+    SecureElementStatus_t status = SECURE_ELEMENT_SUCCESS;
+
+    if( ( inputs == NULL ) || ( targetKeyIDs == NULL ) )
+    {
+        return SECURE_ELEMENT_ERROR_NPE;
+    }
+
+    for( uint8_t i = 0; i < nbKeys; i++ )
+    {
+        lr1110_crypto_derive_and_store_key( &LR1110, ( lr1110_crypto_status_t* ) &status,
+                                            convert_key_id_from_se_to_lr1110( rootKeyID ),
+                                            convert_key_id_from_se_to_lr1110( targetKeyIDs[i] ), &inputs[i * 16] );
+        if( status != SECURE_ELEMENT_SUCCESS )
+        {
+            return status;
+        }
+    }
+
+    // The derived keys are written to the flash at once
+    lr1110_crypto_store_to_flash( &LR1110, ( lr1110_crypto_status_t* ) &status );
+    return status;
+}
+
 SecureElementStatus_t SecureElementProcessJoinAccept( JoinReqIdentifier_t joinReqType, uint8_t* joinEui,
                                                       uint16_t devNonce, uint8_t* encJoinAccept,
                                                       uint8_t encJoinAcceptSize, uint8_t* decJoinAccept,
@@ -31,13 +31,18 @@
 #include "cmac.h"
 
 #include "LoRaMacHeaderTypes.h"
+#include "LoRaMacInstance.h"
 
 #include "secure-element.h"
 #include "secure-element-nvm.h"
 #include "se-identity.h"
 #include "soft-se-hal.h"
 
-static SecureElementNvmData_t* SeNvm;
+static SecureElementNvmData_t* LORAMAC_INSTANCE_STATE( SeNvm );
+
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define SeNvm                                       LORAMAC_INSTANCE( SeNvm )
+#endif
 
 /*
  * Local functions
@@ -303,6 +308,55 @@ SecureElementStatus_t SecureElementDeriveAndStoreKey( uint8_t* input, KeyIdentif
     return SECURE_ELEMENT_SUCCESS;
 }
 
+SecureElementStatus_t SecureElementDeriveAndStoreKeys( uint8_t* inputs, KeyIdentifier_t rootKeyID,
+                                                       KeyIdentifier_t* targetKeyIDs, uint8_t nbKeys )
+{
+    if( ( inputs == NULL ) || ( targetKeyIDs == NULL ) )
+    {
+        return SECURE_ELEMENT_ERROR_NPE;
+    }
+
+    for( uint8_t i = 0; i < nbKeys; i++ )
+    {
+        // In case of MC_KE_KEY, only McRootKey can be used as root key
+        if( ( targetKeyIDs[i] == MC_KE_KEY ) && ( rootKeyID != MC_ROOT_KEY ) )
+        {
+            return SECURE_ELEMENT_ERROR_INVALID_KEY_ID;
+        }
+    }
+
+    aes_context aesContext;
+    memset1( aesContext.ksch, '\0', 240 );
+
+    Key_t*                pItem;
+    SecureElementStatus_t retval = GetKeyByID( rootKeyID, &pItem );
+
+    if( retval != SECURE_ELEMENT_SUCCESS )
+    {
+        return retval;
+    }
+
+    // The root key schedule is computed once for all the derivations
+    aes_set_key( pItem->KeyValue, 16, &aesContext );
+
+    for( uint8_t i = 0; i < nbKeys; i++ )
+    {
+        uint8_t key[16] = { 0 };
+
+        // Derive key
+        aes_encrypt( &inputs[i * 16], key, &aesContext );
+
+        // Store key
+        retval = SecureElementSetKey( targetKeyIDs[i], key );
+        if( retval != SECURE_ELEMENT_SUCCESS )
+        {
+            return retval;
+        }
+    }
+
+    return SECURE_ELEMENT_SUCCESS;
+}
+
 SecureElementStatus_t SecureElementProcessJoinAccept( JoinReqIdentifier_t joinReqType, uint8_t* joinEui,
                                                       uint16_t devNonce, uint8_t* encJoinAccept,
                                                       uint8_t encJoinAcceptSize, uint8_t* decJoinAccept,
@@ -333,6 +333,13 @@ void RadioRxBoosted( uint32_t timeout );
  */
 void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime );
 
+/*!
+ * \brief Gets the time of the DIO IRQ which triggered the last event
+ *
+ * \retval ticks Time of the DIO IRQ in RTC ticks
+ */
+uint32_t RadioGetIrqTimestamp( void );
+
 /*!
  * Radio driver structure initialization
  */
@@ -365,6 +372,7 @@ const struct Radio_s Radio = {
     // Available on LR1110 only
     RadioRxBoosted,
     RadioSetRxDutyCycle,
+    RadioGetIrqTimestamp,
 };
 
 /*
@@ -406,6 +414,11 @@ uint8_t                           RadioRxPayload[255];
 
 bool IrqFired = false;
 
+/*!
+ * Time of the last DIO IRQ, events are notified later by RadioIrqProcess
+ */
+volatile uint32_t IrqTimestamp = 0;
+
 /*
  * LR1110 DIO IRQ callback functions prototype
  */
@@ -1190,9 +1203,15 @@ void RadioOnRxTimeoutIrq( void* context )
 
 void RadioOnDioIrq( void* context )
 {
+    IrqTimestamp = TimerGetCurrentTicks( );
     IrqFired = true;
 }
 
+uint32_t RadioGetIrqTimestamp( void )
+{
+    return IrqTimestamp;
+}
+
 /*!
  * \brief Callback - handle the interrupt get & clear
  *
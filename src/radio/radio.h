@@ -396,10 +396,19 @@ struct Radio_s
      *
      * \remark Available on SX126x radios only.
      *
-     * \param [in]  rxTime        Structure describing reception timeout value
-     * \param [in]  sleepTime     Structure describing sleep timeout value
+     * \param [in]  rxTime        Reception period [15.625 us steps]
+     * \param [in]  sleepTime     Sleep period [15.625 us steps]
      */
     void ( *SetRxDutyCycle ) ( uint32_t rxTime, uint32_t sleepTime );
+    /*!
+     * \brief Gets the time of the DIO IRQ which triggered the last event
+     *
+     * \remark Available on radios notifying the events from IrqProcess only.
+     *         The value is valid for the duration of the event callback.
+     *
+     * \retval ticks Time of the DIO IRQ [RTC ticks, see TimerGetCurrentTicks]
+     */
+    uint32_t ( *GetIrqTimestamp )( void );
 };
 
 /*!
@@ -0,0 +1,725 @@
+/*!
+ * \file      radio.c
+ *
+ * \brief     Virtual radio driver of the Simulation board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \remark    The driver transmits and receives the LoRa frames over the
+ *            virtual channel of the Simulation board. The events are raised
+ *            from the simulation events, the same way the SX1276 driver raises
+ *            them from the DIO interrupts. The FSK modem is not simulated: its
+ *            frames are never received.
+ */
+#include <stddef.h>
+#include "utilities.h"
+#include "timer.h"
+#include "delay.h"
+#include "radio.h"
+#include "sim.h"
+#include "sim-channel.h"
+#include "LoRaMacInstance.h"
+
+/*!
+ * Noise floor reported by the RSSI measurements [dBm]
+ */
+#define SIM_RADIO_NOISE_FLOOR                       -120
+
+/*!
+ * CAD duration [us]
+ */
+#define SIM_RADIO_CAD_DURATION                      2000
+
+/*!
+ * Radio configuration
+ */
+typedef struct sSimRadioConfig
+{
+    uint8_t SpreadingFactor;
+    uint8_t Bandwidth;
+    uint16_t PreambleLen;
+    bool CrcOn;
+    bool IqInverted;
+}SimRadioConfig_t;
+
+/*!
+ * \brief Initializes the radio
+ *
+ * \param [IN] events Structure containing the driver callback functions
+ */
+void RadioInit( RadioEvents_t *events );
+
+/*!
+ * Return current radio status
+ *
+ * \param status Radio status.[RF_IDLE, RF_RX_RUNNING, RF_TX_RUNNING]
+ */
+RadioState_t RadioGetStatus( void );
+
+/*!
+ * \brief Configures the radio with the given modem
+ *
+ * \param [IN] modem Modem to be used [0: FSK, 1: LoRa]
+ */
+void RadioSetModem( RadioModems_t modem );
+
+/*!
+ * \brief Sets the channel frequency
+ *
+ * \param [IN] freq         Channel RF frequency
+ */
+void RadioSetChannel( uint32_t freq );
+
+/*!
+ * \brief Checks if the channel is free for the given time
+ *
+ * \param [IN] freq                Channel RF frequency in Hertz
+ * \param [IN] rxBandwidth         Rx bandwidth in Hertz
+ * \param [IN] rssiThresh          RSSI threshold in dBm
+ * \param [IN] maxCarrierSenseTime Max time in milliseconds while the RSSI is measured
+ *
+ * \retval isFree         [true: Channel is free, false: Channel is not free]
+ */
+bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime );
+
+/*!
+ * \brief Generates a 32 bits random value from the simulation random generator
+ *
+ * \retval randomValue    32 bits random value
+ */
+uint32_t RadioRandom( void );
+
+/*!
+ * \brief Sets the reception parameters, see \ref Radio_s
+ */
+void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                          uint32_t datarate, uint8_t coderate,
+                          uint32_t bandwidthAfc, uint16_t preambleLen,
+                          uint16_t symbTimeout, bool fixLen,
+                          uint8_t payloadLen,
+                          bool crcOn, bool FreqHopOn, uint8_t HopPeriod,
+                          bool iqInverted, bool rxContinuous );
+
+/*!
+ * \brief Sets the transmission parameters, see \ref Radio_s
+ */
+void RadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                          uint32_t bandwidth, uint32_t datarate,
+                          uint8_t coderate, uint16_t preambleLen,
+                          bool fixLen, bool crcOn, bool FreqHopOn,
+                          uint8_t HopPeriod, bool iqInverted, uint32_t timeout );
+
+/*!
+ * \brief Checks if the given RF frequency is supported by the hardware
+ *
+ * \param [IN] frequency RF frequency to be checked
+ * \retval isSupported [true: supported, false: unsupported]
+ */
+bool RadioCheckRfFrequency( uint32_t frequency );
+
+/*!
+ * \brief Computes the packet time on air in ms for the given payload, see
+ *        \ref Radio_s
+ */
+uint32_t RadioTimeOnAir( RadioModems_t modem, uint32_t bandwidth,
+                              uint32_t datarate, uint8_t coderate,
+                              uint16_t preambleLen, bool fixLen, uint8_t payloadLen,
+                              bool crcOn );
+
+/*!
+ * \brief Sends the buffer of size. Prepares the packet to be sent and sets
+ *        the radio in transmission
+ *
+ * \param [IN]: buffer     Buffer pointer
+ * \param [IN]: size       Buffer size
+ */
+void RadioSend( uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Sets the radio in sleep mode
+ */
+void RadioSleep( void );
+
+/*!
+ * \brief Sets the radio in standby mode
+ */
+void RadioStandby( void );
+
+/*!
+ * \brief Sets the radio in reception mode for the given time
+ * \param [IN] timeout Reception timeout [ms]
+ *                     [0: continuous, others timeout]
+ */
+void RadioRx( uint32_t timeout );
+
+/*!
+ * \brief Start a Channel Activity Detection
+ */
+void RadioStartCad( void );
+
+/*!
+ * \brief Sets the radio in continuous wave transmission mode
+ *
+ * \param [IN]: freq       Channel RF frequency
+ * \param [IN]: power      Sets the output power [dBm]
+ * \param [IN]: time       Transmission mode timeout [s]
+ */
+void RadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time );
+
+/*!
+ * \brief Reads the current RSSI value
+ *
+ * \retval rssiValue Current RSSI value in [dBm]
+ */
+int16_t RadioRssi( RadioModems_t modem );
+
+/*!
+ * \brief Writes the radio register at the specified address. Not simulated.
+ */
+void RadioWrite( uint32_t addr, uint8_t data );
+
+/*!
+ * \brief Reads the radio register at the specified address. Not simulated.
+ */
+uint8_t RadioRead( uint32_t addr );
+
+/*!
+ * \brief Writes multiple radio registers. Not simulated.
+ */
+void RadioWriteBuffer( uint32_t addr, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Reads multiple radio registers. Not simulated.
+ */
+void RadioReadBuffer( uint32_t addr, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Sets the maximum payload length.
+ *
+ * \param [IN] modem      Radio modem to be used [0: FSK, 1: LoRa]
+ * \param [IN] max        Maximum payload length in bytes
+ */
+void RadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max );
+
+/*!
+ * \brief Sets the network to public or private. Not simulated.
+ *
+ * \param [IN] enable if true, it enables a public network
+ */
+void RadioSetPublicNetwork( bool enable );
+
+/*!
+ * \brief Gets the time required for the board plus radio to get out of sleep.[ms]
+ *
+ * \retval time Radio plus board wakeup time in ms.
+ */
+uint32_t RadioGetWakeupTime( void );
+
+/*!
+ * \brief Sets the radio in reception mode with Max LNA gain for the given time
+ * \param [IN] timeout Reception timeout [ms]
+ *                     [0: continuous, others timeout]
+ */
+void RadioRxBoosted( uint32_t timeout );
+
+/*!
+ * \brief Gets the time of the event which triggered the last callback
+ *
+ * \retval ticks Time of the event in RTC ticks
+ */
+uint32_t RadioGetIrqTimestamp( void );
+
+/*!
+ * Radio driver structure initialization
+ */
+const struct Radio_s Radio =
+{
+    RadioInit,
+    RadioGetStatus,
+    RadioSetModem,
+    RadioSetChannel,
+    RadioIsChannelFree,
+    RadioRandom,
+    RadioSetRxConfig,
+    RadioSetTxConfig,
+    RadioCheckRfFrequency,
+    RadioTimeOnAir,
+    RadioSend,
+    RadioSleep,
+    RadioStandby,
+    RadioRx,
+    RadioStartCad,
+    RadioSetTxContinuousWave,
+    RadioRssi,
+    RadioWrite,
+    RadioRead,
+    RadioWriteBuffer,
+    RadioReadBuffer,
+    RadioSetMaxPayloadLength,
+    RadioSetPublicNetwork,
+    RadioGetWakeupTime,
+    NULL, // void ( *IrqProcess )( void )
+    RadioRxBoosted,
+    NULL, // void ( *SetRxDutyCycle )( uint32_t rxTime, uint32_t sleepTime )
+    RadioGetIrqTimestamp
+};
+
+/*!
+ * Radio state
+ */
+typedef struct sSimRadio
+{
+    /*!
+     * Radio callbacks
+     */
+    RadioEvents_t* Events;
+    /*!
+     * Radio state
+     */
+    RadioState_t State;
+    /*!
+     * Active modem
+     */
+    RadioModems_t Modem;
+    /*!
+     * Channel frequency
+     */
+    uint32_t Frequency;
+    /*!
+     * Reception configuration
+     */
+    SimRadioConfig_t RxConfig;
+    /*!
+     * Reception symbol timeout
+     */
+    uint16_t RxSymbTimeout;
+    /*!
+     * Set for a continuous reception
+     */
+    bool RxContinuous;
+    /*!
+     * Transmission configuration
+     */
+    SimRadioConfig_t TxConfig;
+    /*!
+     * Transmitted or received frame
+     */
+    SimChannelFrame_t Frame;
+    /*!
+     * Time of the last event
+     */
+    uint32_t IrqTimestamp;
+    /*!
+     * Radio events
+     */
+    SimEvent_t TxDoneEvent;
+    SimEvent_t RxTimeoutEvent;
+    SimEvent_t CadDoneEvent;
+    /*!
+     * Device receiver
+     */
+    SimChannelReceiver_t Receiver;
+    /*!
+     * Set once the receiver is added to the channel
+     */
+    bool IsReceiverAdded;
+    /*!
+     * LoRaMac instance owning the radio
+     */
+    uint16_t InstanceId;
+}SimRadio_t;
+
+/*!
+ * Radio state, one per LoRaMac instance
+ */
+static SimRadio_t LORAMAC_INSTANCE_STATE( SimRadio );
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+#define SimRadio                                    LORAMAC_INSTANCE( SimRadio )
+#endif
+
+static bool OnFrameStart( void* context, const SimChannelFrame_t* frame );
+static void OnFrameEnd( void* context, const SimChannelFrame_t* frame );
+
+/*!
+ * \brief Selects the LoRaMac instance owning a radio before raising its events
+ *
+ * \param [IN] radio Radio state
+ * \retval id Instance selected before
+ */
+static uint16_t SelectOwner( const SimRadio_t* radio )
+{
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+    uint16_t id = LoRaMacInstanceGetId( );
+
+    LoRaMacInstanceSelect( radio->InstanceId );
+    return id;
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * \brief Restores the LoRaMac instance selected before the radio event
+ *
+ * \param [IN] id Instance returned by \ref SelectOwner
+ */
+static void RestoreSelection( uint16_t id )
+{
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+    LoRaMacInstanceSelect( id );
+#endif
+}
+
+/*!
+ * \brief Gets the LoRa symbol duration
+ *
+ * \retval duration Symbol duration [us]
+ */
+static SimTime_t GetSymbolTime( const SimRadioConfig_t* config )
+{
+    return ( ( SimTime_t )1000000 << config->SpreadingFactor ) / ( 125000 << config->Bandwidth );
+}
+
+/*!
+ * \brief Stops the ongoing activity
+ *
+ * \param [IN] radio Radio state
+ */
+static void StopActivity( SimRadio_t* radio )
+{
+    SimEventCancel( &radio->TxDoneEvent );
+    SimEventCancel( &radio->RxTimeoutEvent );
+    SimEventCancel( &radio->CadDoneEvent );
+    SimChannelListen( &radio->Receiver, false, 0, 0, 0, false );
+    radio->State = RF_IDLE;
+}
+
+static void OnTxDoneEvent( void* context )
+{
+    SimRadio_t* radio = ( SimRadio_t* )context;
+    uint16_t id = SelectOwner( radio );
+
+    radio->IrqTimestamp = TimerGetCurrentTicks( );
+    radio->State = RF_IDLE;
+    if( ( radio->Events != NULL ) && ( radio->Events->TxDone != NULL ) )
+    {
+        radio->Events->TxDone( );
+    }
+    RestoreSelection( id );
+}
+
+static void OnRxTimeoutEvent( void* context )
+{
+    SimRadio_t* radio = ( SimRadio_t* )context;
+    uint16_t id = SelectOwner( radio );
+
+    radio->IrqTimestamp = TimerGetCurrentTicks( );
+    StopActivity( radio );
+    if( ( radio->Events != NULL ) && ( radio->Events->RxTimeout != NULL ) )
+    {
+        radio->Events->RxTimeout( );
+    }
+    RestoreSelection( id );
+}
+
+static void OnCadDoneEvent( void* context )
+{
+    SimRadio_t* radio = ( SimRadio_t* )context;
+    uint16_t id = SelectOwner( radio );
+
+    radio->IrqTimestamp = TimerGetCurrentTicks( );
+    radio->State = RF_IDLE;
+    if( ( radio->Events != NULL ) && ( radio->Events->CadDone != NULL ) )
+    {
+        radio->Events->CadDone( SimChannelIsBusy( radio->Frequency ) );
+    }
+    RestoreSelection( id );
+}
+
+static bool OnFrameStart( void* context, const SimChannelFrame_t* frame )
+{
+    SimRadio_t* radio = ( SimRadio_t* )context;
+
+    if( ( radio->State != RF_RX_RUNNING ) || ( radio->Modem != MODEM_LORA ) )
+    {
+        return false;
+    }
+    // The preamble is detected, the reception runs until the end of the frame
+    SimEventCancel( &radio->RxTimeoutEvent );
+    return true;
+}
+
+static void OnFrameEnd( void* context, const SimChannelFrame_t* frame )
+{
+    SimRadio_t* radio = ( SimRadio_t* )context;
+    uint16_t id;
+
+    radio->IrqTimestamp = TimerGetCurrentTicks( );
+    radio->Frame = *frame;
+    if( radio->RxContinuous == false )
+    {
+        StopActivity( radio );
+    }
+    else
+    {
+        SimChannelListen( &radio->Receiver, true, radio->Frequency, radio->RxConfig.SpreadingFactor,
+                          radio->RxConfig.Bandwidth, radio->RxConfig.IqInverted );
+    }
+
+    if( radio->Events == NULL )
+    {
+        return;
+    }
+    id = SelectOwner( radio );
+    if( ( radio->Frame.IsCorrupted == true ) && ( radio->RxConfig.CrcOn == true ) )
+    {
+        if( radio->Events->RxError != NULL )
+        {
+            radio->Events->RxError( );
+        }
+    }
+    else if( radio->Events->RxDone != NULL )
+    {
+        radio->Events->RxDone( radio->Frame.Payload, radio->Frame.Size, radio->Frame.Rssi, radio->Frame.Snr );
+    }
+    RestoreSelection( id );
+}
+
+void RadioInit( RadioEvents_t *events )
+{
+    SimRadio.Events = events;
+    SimRadio.Modem = MODEM_LORA;
+#if defined( LORAMAC_MULTI_INSTANCE_ENABLED )
+    SimRadio.InstanceId = LoRaMacInstanceGetId( );
+#endif
+
+    SimEventInit( &SimRadio.TxDoneEvent, OnTxDoneEvent, &SimRadio );
+    SimEventInit( &SimRadio.RxTimeoutEvent, OnRxTimeoutEvent, &SimRadio );
+    SimEventInit( &SimRadio.CadDoneEvent, OnCadDoneEvent, &SimRadio );
+    if( SimRadio.IsReceiverAdded == false )
+    {
+        SimRadio.Receiver.Node = SIM_CHANNEL_NODE_DEVICE;
+        SimRadio.Receiver.NbDemodulators = 1;
+        SimRadio.Receiver.Context = &SimRadio;
+        SimRadio.Receiver.OnFrameStart = OnFrameStart;
+        SimRadio.Receiver.OnFrameEnd = OnFrameEnd;
+        SimChannelAddReceiver( &SimRadio.Receiver );
+        SimRadio.IsReceiverAdded = true;
+    }
+    SimRadio.State = RF_IDLE;
+}
+
+RadioState_t RadioGetStatus( void )
+{
+    return SimRadio.State;
+}
+
+void RadioSetModem( RadioModems_t modem )
+{
+    SimRadio.Modem = modem;
+}
+
+void RadioSetChannel( uint32_t freq )
+{
+    SimRadio.Frequency = freq;
+}
+
+bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+    bool status = SimChannelIsBusy( freq ) == false;
+
+    RadioSetChannel( freq );
+    // The carrier sense takes its whole duration
+    DelayMs( maxCarrierSenseTime );
+    return status;
+}
+
+uint32_t RadioRandom( void )
+{
+    return SimRandom( );
+}
+
+void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                         uint32_t datarate, uint8_t coderate,
+                         uint32_t bandwidthAfc, uint16_t preambleLen,
+                         uint16_t symbTimeout, bool fixLen,
+                         uint8_t payloadLen,
+                         bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                         bool iqInverted, bool rxContinuous )
+{
+    RadioSetModem( modem );
+    SimRadio.RxConfig.SpreadingFactor = ( modem == MODEM_LORA ) ? datarate : 0;
+    SimRadio.RxConfig.Bandwidth = ( modem == MODEM_LORA ) ? bandwidth : 0;
+    SimRadio.RxConfig.PreambleLen = preambleLen;
+    SimRadio.RxConfig.CrcOn = crcOn;
+    SimRadio.RxConfig.IqInverted = iqInverted;
+    SimRadio.RxSymbTimeout = symbTimeout;
+    SimRadio.RxContinuous = rxContinuous;
+}
+
+void RadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                        uint32_t bandwidth, uint32_t datarate,
+                        uint8_t coderate, uint16_t preambleLen,
+                        bool fixLen, bool crcOn, bool freqHopOn,
+                        uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+    RadioSetModem( modem );
+    SimRadio.TxConfig.SpreadingFactor = ( modem == MODEM_LORA ) ? datarate : 0;
+    SimRadio.TxConfig.Bandwidth = ( modem == MODEM_LORA ) ? bandwidth : 0;
+    SimRadio.TxConfig.PreambleLen = preambleLen;
+    SimRadio.TxConfig.CrcOn = crcOn;
+    SimRadio.TxConfig.IqInverted = iqInverted;
+}
+
+bool RadioCheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+uint32_t RadioTimeOnAir( RadioModems_t modem, uint32_t bandwidth,
+                              uint32_t datarate, uint8_t coderate,
+                              uint16_t preambleLen, bool fixLen, uint8_t payloadLen,
+                              bool crcOn )
+{
+    if( modem == MODEM_FSK )
+    {
+        // Preamble, sync word, length, payload and CRC bits
+        return ( ( ( preambleLen + 3 + 1 + payloadLen + ( crcOn ? 2 : 0 ) ) * 8 * 1000 ) + datarate - 1 ) / datarate;
+    }
+    return ( uint32_t )( ( SimChannelGetTimeOnAir( datarate, bandwidth, preambleLen, payloadLen, crcOn ) + 999 ) / 1000 );
+}
+
+void RadioSend( uint8_t *buffer, uint8_t size )
+{
+    SimTime_t timeOnAir;
+
+    StopActivity( &SimRadio );
+    SimRadio.Frame.Source = SIM_CHANNEL_NODE_DEVICE;
+    SimRadio.Frame.Frequency = SimRadio.Frequency;
+    SimRadio.Frame.SpreadingFactor = SimRadio.TxConfig.SpreadingFactor;
+    SimRadio.Frame.Bandwidth = SimRadio.TxConfig.Bandwidth;
+    SimRadio.Frame.IqInverted = SimRadio.TxConfig.IqInverted;
+    SimRadio.Frame.PreambleLen = SimRadio.TxConfig.PreambleLen;
+    SimRadio.Frame.Size = size;
+    memcpy1( SimRadio.Frame.Payload, buffer, size );
+
+    if( SimRadio.Modem == MODEM_LORA )
+    {
+        timeOnAir = SimChannelGetTimeOnAir( SimRadio.TxConfig.SpreadingFactor, SimRadio.TxConfig.Bandwidth,
+                                            SimRadio.TxConfig.PreambleLen, size, SimRadio.TxConfig.CrcOn );
+    }
+    else
+    {
+        timeOnAir = ( SimTime_t )RadioTimeOnAir( MODEM_FSK, 0, 50000, 0, SimRadio.TxConfig.PreambleLen, false, size,
+                                                 SimRadio.TxConfig.CrcOn ) * 1000;
+    }
+    SimChannelSend( &SimRadio.Frame, timeOnAir );
+
+    SimRadio.State = RF_TX_RUNNING;
+    SimEventSchedule( &SimRadio.TxDoneEvent, SimGetTime( ) + timeOnAir );
+}
+
+void RadioSleep( void )
+{
+    StopActivity( &SimRadio );
+}
+
+void RadioStandby( void )
+{
+    StopActivity( &SimRadio );
+}
+
+void RadioRx( uint32_t timeout )
+{
+    SimTime_t rxTimeout = 0;
+
+    StopActivity( &SimRadio );
+    SimRadio.State = RF_RX_RUNNING;
+
+    if( SimRadio.RxContinuous == false )
+    {
+        if( ( SimRadio.RxSymbTimeout != 0 ) && ( SimRadio.Modem == MODEM_LORA ) )
+        {
+            rxTimeout = SimRadio.RxSymbTimeout * GetSymbolTime( &SimRadio.RxConfig );
+        }
+        if( ( timeout != 0 ) && ( ( rxTimeout == 0 ) || ( ( ( SimTime_t )timeout * 1000 ) < rxTimeout ) ) )
+        {
+            rxTimeout = ( SimTime_t )timeout * 1000;
+        }
+    }
+    if( rxTimeout != 0 )
+    {
+        SimEventSchedule( &SimRadio.RxTimeoutEvent, SimGetTime( ) + rxTimeout );
+    }
+    // Listen last, a frame already on air cancels the timeout when detected
+    SimChannelListen( &SimRadio.Receiver, true, SimRadio.Frequency, SimRadio.RxConfig.SpreadingFactor,
+                      SimRadio.RxConfig.Bandwidth, SimRadio.RxConfig.IqInverted );
+}
+
+void RadioRxBoosted( uint32_t timeout )
+{
+    RadioRx( timeout );
+}
+
+void RadioStartCad( void )
+{
+    StopActivity( &SimRadio );
+    SimRadio.State = RF_CAD;
+    SimEventSchedule( &SimRadio.CadDoneEvent, SimGetTime( ) + SIM_RADIO_CAD_DURATION );
+}
+
+void RadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time )
+{
+    RadioSetChannel( freq );
+}
+
+int16_t RadioRssi( RadioModems_t modem )
+{
+    return SIM_RADIO_NOISE_FLOOR;
+}
+
+void RadioWrite( uint32_t addr, uint8_t data )
+{
+}
+
+uint8_t RadioRead( uint32_t addr )
+{
+    return 0;
+}
+
+void RadioWriteBuffer( uint32_t addr, uint8_t *buffer, uint8_t size )
+{
+}
+
+void RadioReadBuffer( uint32_t addr, uint8_t *buffer, uint8_t size )
+{
+}
+
+void RadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+}
+
+void RadioSetPublicNetwork( bool enable )
+{
+}
+
+uint32_t RadioGetWakeupTime( void )
+{
+    return 1;
+}
+
+uint32_t RadioGetIrqTimestamp( void )
+{
+    return SimRadio.IrqTimestamp;
+}
@@ -336,6 +336,13 @@ void RadioRxBoosted( uint32_t timeout );
  */
 void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime );
 
+/*!
+ * \brief Gets the time of the DIO IRQ which triggered the last event
+ *
+ * \retval ticks Time of the DIO IRQ in RTC ticks
+ */
+uint32_t RadioGetIrqTimestamp( void );
+
 /*!
  * \brief Add a register to the retention list
  *
@@ -375,7 +382,8 @@ const struct Radio_s Radio =
     RadioIrqProcess,
     // Available on SX126x only
     RadioRxBoosted,
-    RadioSetRxDutyCycle
+    RadioSetRxDutyCycle,
+    RadioGetIrqTimestamp
 };
 
 /*
@@ -436,6 +444,11 @@ uint8_t RadioRxPayload[255];
 
 bool IrqFired = false;
 
+/*!
+ * Time of the last DIO IRQ, events are notified later by RadioIrqProcess
+ */
+volatile uint32_t IrqTimestamp = 0;
+
 /*
  * SX126x DIO IRQ callback functions prototype
  */
@@ -1109,6 +1122,11 @@ void RadioRxBoosted( uint32_t timeout )
 
 void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime )
 {
+    SX126xSetDioIrqParams( IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
+                           IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
+                           IRQ_RADIO_NONE,
+                           IRQ_RADIO_NONE );
+
     SX126xSetRxDutyCycle( rxTime, sleepTime );
 }
 
@@ -1244,9 +1262,15 @@ void RadioOnRxTimeoutIrq( void* context )
 
 void RadioOnDioIrq( void* context )
 {
+    IrqTimestamp = TimerGetCurrentTicks( );
     IrqFired = true;
 }
 
+uint32_t RadioGetIrqTimestamp( void )
+{
+    return IrqTimestamp;
+}
+
 void RadioIrqProcess( void )
 {
     CRITICAL_SECTION_BEGIN( );
@@ -57,11 +57,39 @@ typedef struct
     uint8_t       Value;                            //!< The value of the register
 }RadioRegisters_t;
 
+/*!
+ * \brief Shadow copy of the parameters of a configuration command last
+ *        written to the radio
+ */
+typedef struct
+{
+    bool          Valid;                            //!< True when Buffer matches the radio configuration
+    uint8_t       Size;                             //!< Number of parameter bytes
+    uint8_t       Buffer[9];                        //!< Parameter bytes
+}RadioCommandCache_t;
+
 /*!
  * \brief Stores the current packet type set in the radio
  */
 static RadioPacketTypes_t PacketType;
 
+/*!
+ * \brief Configuration commands shadow copies. Retained by the radio in warm
+ *        start sleep mode
+ */
+static RadioCommandCache_t PacketTypeCache;
+static RadioCommandCache_t ModulationParamsCache;
+static RadioCommandCache_t PacketParamsCache;
+static RadioCommandCache_t RfFrequencyCache;
+static RadioCommandCache_t StopRxTimerOnPreambleCache;
+
+/*!
+ * \brief Configuration registers shadow copies. Registers are only retained
+ *        by the radio while it does not enter sleep mode
+ */
+static RadioCommandCache_t SyncWordCache;
+static RadioCommandCache_t WhiteningSeedCache;
+
 /*!
  * \brief Stores the current packet header type set in the radio
  */
@@ -86,6 +114,26 @@ static bool ImageCalibrated = false;
  */
 static uint32_t SX126xConvertFreqInHzToPllStep( uint32_t freqInHz );
 
+/*!
+ * \brief Checks if the given parameters are the ones last written to the
+ *        radio and updates the shadow copy
+ *
+ * \param [in] cache     Shadow copy of the configuration
+ * \param [in] buffer    Parameters to be written
+ * \param [in] size      Number of parameter bytes
+ *
+ * \retval isCached      True if the radio already holds the parameters and
+ *                       the write can be skipped
+ */
+static bool SX126xIsConfigCached( RadioCommandCache_t *cache, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Invalidates the configuration shadow copies
+ *
+ * \param [in] registersOnly Only invalidate the registers shadow copies
+ */
+static void SX126xInvalidateConfigCache( bool registersOnly );
+
 /*
  * SX126x DIO IRQ callback functions prototype
  */
@@ -128,6 +176,9 @@ void SX126xInit( DioIrqHandler dioIrq )
     // Force image calibration
     ImageCalibrated = false;
 
+    // The radio has been reset
+    SX126xInvalidateConfigCache( false );
+
     SX126xSetOperatingMode( MODE_STDBY_RC );
 }
 
@@ -168,7 +219,10 @@ void SX126xSendPayload( uint8_t *payload, uint8_t size, uint32_t timeout )
 
 uint8_t SX126xSetSyncWord( uint8_t *syncWord )
 {
-    SX126xWriteRegisters( REG_LR_SYNCWORDBASEADDRESS, syncWord, 8 );
+    if( SX126xIsConfigCached( &SyncWordCache, syncWord, 8 ) == false )
+    {
+        SX126xWriteRegisters( REG_LR_SYNCWORDBASEADDRESS, syncWord, 8 );
+    }
     return 0;
 }
 
@@ -215,6 +269,10 @@ void SX126xSetWhiteningSeed( uint16_t seed )
     switch( SX126xGetPacketType( ) )
     {
         case PACKET_TYPE_GFSK:
+            if( SX126xIsConfigCached( &WhiteningSeedCache, ( uint8_t[] ){ ( uint8_t )( seed >> 8 ), ( uint8_t )seed }, 2 ) == true )
+            {
+                break;
+            }
             regValue = SX126xReadRegister( REG_LR_WHITSEEDBASEADDR_MSB ) & 0xFE;
             regValue = ( ( seed >> 8 ) & 0x01 ) | regValue;
             SX126xWriteRegister( REG_LR_WHITSEEDBASEADDR_MSB, regValue ); // only 1 bit.
@@ -264,6 +322,9 @@ void SX126xSetSleep( SleepParams_t sleepConfig )
         // Force image calibration
         ImageCalibrated = false;
     }
+    // Cold start looses the whole configuration while warm start only
+    // retains the configuration commands
+    SX126xInvalidateConfigCache( sleepConfig.Fields.WarmStart == 1 );
     SX126xWriteCommand( RADIO_SET_SLEEP, &value, 1 );
     SX126xSetOperatingMode( MODE_SLEEP );
 }
@@ -361,7 +422,10 @@ void SX126xSetTxInfinitePreamble( void )
 
 void SX126xSetStopRxTimerOnPreambleDetect( bool enable )
 {
-    SX126xWriteCommand( RADIO_SET_STOPRXTIMERONPREAMBLE, ( uint8_t* )&enable, 1 );
+    if( SX126xIsConfigCached( &StopRxTimerOnPreambleCache, ( uint8_t* )&enable, 1 ) == false )
+    {
+        SX126xWriteCommand( RADIO_SET_STOPRXTIMERONPREAMBLE, ( uint8_t* )&enable, 1 );
+    }
 }
 
 void SX126xSetLoRaSymbNumTimeout( uint8_t symbNum )
@@ -510,13 +574,24 @@ void SX126xSetRfFrequency( uint32_t frequency )
     buf[1] = ( uint8_t )( ( freqInPllSteps >> 16 ) & 0xFF );
     buf[2] = ( uint8_t )( ( freqInPllSteps >> 8 ) & 0xFF );
     buf[3] = ( uint8_t )( freqInPllSteps & 0xFF );
-    SX126xWriteCommand( RADIO_SET_RFFREQUENCY, buf, 4 );
+    if( SX126xIsConfigCached( &RfFrequencyCache, buf, 4 ) == false )
+    {
+        SX126xWriteCommand( RADIO_SET_RFFREQUENCY, buf, 4 );
+    }
 }
 
 void SX126xSetPacketType( RadioPacketTypes_t packetType )
 {
     // Save packet type internally to avoid questioning the radio
     PacketType = packetType;
+    if( SX126xIsConfigCached( &PacketTypeCache, ( uint8_t* )&packetType, 1 ) == true )
+    {
+        return;
+    }
+    // Modulation and packet parameters must be written again after a
+    // packet type change
+    ModulationParamsCache.Valid = false;
+    PacketParamsCache.Valid = false;
     SX126xWriteCommand( RADIO_SET_PACKETTYPE, ( uint8_t* )&packetType, 1 );
 }
 
@@ -596,7 +671,6 @@ void SX126xSetModulationParams( ModulationParams_t *modulationParams )
         buf[5] = ( tempVal >> 16 ) & 0xFF;
         buf[6] = ( tempVal >> 8 ) & 0xFF;
         buf[7] = ( tempVal& 0xFF );
-        SX126xWriteCommand( RADIO_SET_MODULATIONPARAMS, buf, n );
         break;
     case PACKET_TYPE_LORA:
         n = 4;
@@ -604,14 +678,15 @@ void SX126xSetModulationParams( ModulationParams_t *modulationParams )
         buf[1] = modulationParams->Params.LoRa.Bandwidth;
         buf[2] = modulationParams->Params.LoRa.CodingRate;
         buf[3] = modulationParams->Params.LoRa.LowDatarateOptimize;
-
-        SX126xWriteCommand( RADIO_SET_MODULATIONPARAMS, buf, n );
-
         break;
     default:
     case PACKET_TYPE_NONE:
         return;
     }
+    if( SX126xIsConfigCached( &ModulationParamsCache, buf, n ) == false )
+    {
+        SX126xWriteCommand( RADIO_SET_MODULATIONPARAMS, buf, n );
+    }
 }
 
 void SX126xSetPacketParams( PacketParams_t *packetParams )
@@ -670,7 +745,10 @@ void SX126xSetPacketParams( PacketParams_t *packetParams )
     case PACKET_TYPE_NONE:
         return;
     }
-    SX126xWriteCommand( RADIO_SET_PACKETPARAMS, buf, n );
+    if( SX126xIsConfigCached( &PacketParamsCache, buf, n ) == false )
+    {
+        SX126xWriteCommand( RADIO_SET_PACKETPARAMS, buf, n );
+    }
 }
 
 void SX126xSetCadParams( RadioLoRaCadSymbols_t cadSymbolNum, uint8_t cadDetPeak, uint8_t cadDetMin, RadioCadExitModes_t cadExitMode, uint32_t cadTimeout )
@@ -818,3 +896,30 @@ static uint32_t SX126xConvertFreqInHzToPllStep( uint32_t freqInHz )
            ( ( ( stepsFrac << SX126X_PLL_STEP_SHIFT_AMOUNT ) + ( SX126X_PLL_STEP_SCALED >> 1 ) ) /
              SX126X_PLL_STEP_SCALED );
 }
+
+static bool SX126xIsConfigCached( RadioCommandCache_t *cache, uint8_t *buffer, uint8_t size )
+{
+    if( ( cache->Valid == true ) && ( cache->Size == size ) && ( memcmp( cache->Buffer, buffer, size ) == 0 ) )
+    {
+        return true;
+    }
+    memcpy1( cache->Buffer, buffer, size );
+    cache->Size = size;
+    cache->Valid = true;
+    return false;
+}
+
+static void SX126xInvalidateConfigCache( bool registersOnly )
+{
+    SyncWordCache.Valid = false;
+    WhiteningSeedCache.Valid = false;
+
+    if( registersOnly == false )
+    {
+        PacketTypeCache.Valid = false;
+        ModulationParamsCache.Valid = false;
+        PacketParamsCache.Valid = false;
+        RfFrequencyCache.Valid = false;
+        StopRxTimerOnPreambleCache.Valid = false;
+    }
+}
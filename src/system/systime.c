@@ -23,6 +23,8 @@
  * \author    MCD Application Team ( STMicroelectronics International )
  */
 #include <stdio.h>
+#include <stdbool.h>
+#include "utilities.h"
 #include "rtc-board.h"
 #include "systime.h"
 
@@ -101,72 +103,258 @@ SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
     return c;
 }
 
-void SysTimeSet( SysTime_t sysTime )
+/*!
+ * Clock discipline state
+ *
+ * \remark The system time is the calendar time, plus the offset stored in the
+ *         RTC backup registers, plus a correction in microseconds. The
+ *         correction is the residual of the last synchronization, the drift
+ *         compensation and the part of the last error already slewed. It is
+ *         folded into the offset at each synchronization.
+ */
+static struct
 {
-    SysTime_t deltaTime;
-  
-    SysTime_t calendarTime = { .Seconds = 0, .SubSeconds = 0 };
+    SysTime_t Reference;        //! MCU time of the last synchronization
+    int32_t Residual;           //! Correction below the offset resolution at Reference [us]
+    int32_t Slew;               //! Error to be slewed from Reference [us]
+    int32_t Drift;              //! Drift compensation [ppb]
+    SysTime_t DriftReference;   //! MCU time of the synchronization starting the drift measurement
+    int64_t DriftError;         //! Errors corrected since DriftReference [us]
+    uint32_t DriftAccuracy;     //! Accuracy of the reference time at DriftReference [ms]
+    bool IsReferenceValid;      //! Set when Reference is a synchronization on a reference time
+}SysTimeClock;
 
-    calendarTime.Seconds = RtcGetCalendarTime( ( uint16_t* )&calendarTime.SubSeconds );
+/*!
+ * \brief Computes a - b in milliseconds
+ */
+static int64_t SysTimeDiffMs( SysTime_t a, SysTime_t b )
+{
+    SysTime_t c = SysTimeSub( a, b );
 
-    // sysTime is epoch
-    deltaTime = SysTimeSub( sysTime, calendarTime );
+    return ( ( int64_t )( int32_t )c.Seconds * 1000 ) + c.SubSeconds;
+}
 
-    RtcBkupWrite( deltaTime.Seconds, ( uint32_t )deltaTime.SubSeconds );
+/*!
+ * \brief Adds a signed number of milliseconds
+ */
+static SysTime_t SysTimeAddMs( SysTime_t sysTime, int64_t ms )
+{
+    if( ms >= 0 )
+    {
+        return SysTimeAdd( sysTime, ( SysTime_t ){ .Seconds = ( uint32_t )( ms / 1000 ), .SubSeconds = ( int16_t )( ms % 1000 ) } );
+    }
+    ms = -ms;
+    return SysTimeSub( sysTime, ( SysTime_t ){ .Seconds = ( uint32_t )( ms / 1000 ), .SubSeconds = ( int16_t )( ms % 1000 ) } );
 }
 
-SysTime_t SysTimeGet( void )
+/*!
+ * \brief Rounds down microseconds to milliseconds
+ */
+static int64_t SysTimeFloorMs( int64_t us )
+{
+    return ( us >= 0 ) ? ( us / 1000 ) : ( ( us - 999 ) / 1000 );
+}
+
+/*!
+ * \brief Computes the slewed part of the last error at the given MCU time
+ *
+ * \param [IN] elapsedMs Time elapsed since the last synchronization
+ * \retval slewed Slewed error [us]
+ */
+static int64_t SysTimeGetSlewed( int64_t elapsedMs )
+{
+    int64_t slewed = ( elapsedMs > 0 ) ? ( ( elapsedMs * SYSTIME_SLEW_RATE ) / 1000 ) : 0;
+
+    if( SysTimeClock.Slew >= 0 )
+    {
+        return ( slewed < SysTimeClock.Slew ) ? slewed : SysTimeClock.Slew;
+    }
+    return ( slewed < -( int64_t )SysTimeClock.Slew ) ? -slewed : SysTimeClock.Slew;
+}
+
+/*!
+ * \brief Computes the correction to be added at the given MCU time
+ *
+ * \param [IN] mcuTime MCU time, may be in the future
+ * \retval correction Correction [us]
+ */
+static int64_t SysTimeGetCorrection( SysTime_t mcuTime )
+{
+    int64_t elapsedMs = SysTimeDiffMs( mcuTime, SysTimeClock.Reference );
+
+    return SysTimeClock.Residual + ( ( elapsedMs * SysTimeClock.Drift ) / 1000000 ) + SysTimeGetSlewed( elapsedMs );
+}
+
+/*!
+ * \brief Reads the offset stored in the RTC backup registers
+ */
+static SysTime_t SysTimeGetOffset( void )
 {
-    SysTime_t calendarTime = { .Seconds = 0, .SubSeconds = 0 };
-    SysTime_t sysTime = { .Seconds = 0, .SubSeconds = 0 };
     uint32_t seconds;
     uint32_t subSeconds;
 
-    calendarTime.Seconds = RtcGetCalendarTime( ( uint16_t* )&calendarTime.SubSeconds );
-
     RtcBkupRead( &seconds, &subSeconds );
+    return ( SysTime_t ){ .Seconds = seconds, .SubSeconds = ( int16_t )subSeconds };
+}
 
-    SysTime_t deltaTime = { .Seconds = seconds, .SubSeconds = ( int16_t )subSeconds };
+/*!
+ * \brief Sets the offset such that the system time at mcuTime is sysTime plus
+ *        residual and restarts the correction from mcuTime
+ *
+ * \param [IN] mcuTime  MCU time of the new reference
+ * \param [IN] sysTime  System time at mcuTime
+ * \param [IN] residual Sub-millisecond part of the system time [us, 0..999]
+ * \param [IN] slew     Error to be slewed from mcuTime [us]
+ */
+static void SysTimeRebase( SysTime_t mcuTime, SysTime_t sysTime, int32_t residual, int32_t slew )
+{
+    SysTime_t deltaTime = SysTimeSub( sysTime, mcuTime );
 
-    sysTime = SysTimeAdd( deltaTime, calendarTime );
+    CRITICAL_SECTION_BEGIN( );
+    RtcBkupWrite( deltaTime.Seconds, ( uint32_t )deltaTime.SubSeconds );
+    SysTimeClock.Reference = mcuTime;
+    SysTimeClock.Residual = residual;
+    SysTimeClock.Slew = slew;
+    CRITICAL_SECTION_END( );
+}
 
-    return sysTime;
+void SysTimeSet( SysTime_t sysTime )
+{
+    SysTimeRebase( SysTimeGetMcuTime( ), sysTime, 0, 0 );
+    // The accuracy of the given time is unknown
+    SysTimeClock.IsReferenceValid = false;
 }
 
-SysTime_t SysTimeGetMcuTime( void )
+/*!
+ * \brief Synchronizes the system time on a reference time
+ *
+ * \param [IN] sysTime  Reference time
+ * \param [IN] accuracy Accuracy of the reference time [ms], 0 if exact
+ */
+static void SysTimeSyncAccuracy( SysTime_t sysTime, uint32_t accuracy )
+{
+    SysTime_t mcuTime = SysTimeGetMcuTime( );
+    int64_t elapsedMs = SysTimeDiffMs( mcuTime, SysTimeClock.Reference );
+    int64_t driftElapsedMs = SysTimeDiffMs( mcuTime, SysTimeClock.DriftReference );
+    int64_t correction = SysTimeGetCorrection( mcuTime );
+    int64_t correctionMs = SysTimeFloorMs( correction );
+    SysTime_t localTime = SysTimeAddMs( SysTimeAdd( mcuTime, SysTimeGetOffset( ) ), correctionMs );
+    int64_t error = ( SysTimeDiffMs( sysTime, localTime ) * 1000 ) - ( correction - ( correctionMs * 1000 ) );
+    // The accuracies of both reference times add up to the measured drift
+    int64_t driftIntervalMs = ( ( int64_t )( accuracy + SysTimeClock.DriftAccuracy ) * 1000000000 ) / SYSTIME_DRIFT_COARSE_MAX_ERROR;
+    bool isDriftMeasured;
+
+    if( driftIntervalMs < ( SYSTIME_DRIFT_MIN_INTERVAL * 1000 ) )
+    {
+        driftIntervalMs = SYSTIME_DRIFT_MIN_INTERVAL * 1000;
+    }
+    isDriftMeasured = ( SysTimeClock.IsReferenceValid == true ) && ( driftElapsedMs >= driftIntervalMs );
+
+    if( ( error < ( ( int64_t )accuracy * 1000 ) ) && ( error > -( ( int64_t )accuracy * 1000 ) ) &&
+        ( isDriftMeasured == false ) )
+    {
+        // The time is right within the reference accuracy
+        return;
+    }
+
+    if( SysTimeClock.IsReferenceValid == true )
+    {
+        // The part of the error which is not waiting to be slewed was
+        // accumulated since the previous synchronization. The corrected
+        // errors add up to the drift over the measurement interval, whatever
+        // the accuracy of the intermediate synchronizations.
+        SysTimeClock.DriftError += error - ( SysTimeClock.Slew - SysTimeGetSlewed( elapsedMs ) );
+    }
+    if( isDriftMeasured == true )
+    {
+        int64_t drift = SysTimeClock.Drift + ( ( SysTimeClock.DriftError * 1000000 ) / driftElapsedMs / 2 );
+
+        if( drift > SYSTIME_DRIFT_MAX )
+        {
+            drift = SYSTIME_DRIFT_MAX;
+        }
+        else if( drift < -SYSTIME_DRIFT_MAX )
+        {
+            drift = -SYSTIME_DRIFT_MAX;
+        }
+        SysTimeClock.Drift = ( int32_t )drift;
+    }
+    if( ( isDriftMeasured == true ) || ( SysTimeClock.IsReferenceValid == false ) ||
+        ( accuracy < SysTimeClock.DriftAccuracy ) )
+    {
+        // Start a new drift measurement
+        SysTimeClock.DriftReference = mcuTime;
+        SysTimeClock.DriftError = 0;
+        SysTimeClock.DriftAccuracy = accuracy;
+    }
+
+    if( ( error > ( SYSTIME_SLEW_MAX_ERROR * 1000 ) ) || ( error < -( SYSTIME_SLEW_MAX_ERROR * 1000 ) ) )
+    {
+        // Step to the reference time
+        SysTimeRebase( mcuTime, sysTime, 0, 0 );
+    }
+    else
+    {
+        // Keep the current time and slew the whole error
+        SysTimeRebase( mcuTime, localTime, ( int32_t )( correction - ( correctionMs * 1000 ) ), ( int32_t )error );
+    }
+    SysTimeClock.IsReferenceValid = true;
+}
+
+void SysTimeSync( SysTime_t sysTime )
+{
+    SysTimeSyncAccuracy( sysTime, 0 );
+}
+
+void SysTimeSyncCoarse( SysTime_t sysTime, uint32_t accuracy )
+{
+    SysTimeSyncAccuracy( sysTime, accuracy );
+}
+
+int32_t SysTimeGetDrift( void )
+{
+    return SysTimeClock.Drift;
+}
+
+SysTime_t SysTimeGet( void )
 {
     SysTime_t calendarTime = { .Seconds = 0, .SubSeconds = 0 };
 
     calendarTime.Seconds = RtcGetCalendarTime( ( uint16_t* )&calendarTime.SubSeconds );
 
-    return calendarTime;
+    return SysTimeAddMs( SysTimeAdd( SysTimeGetOffset( ), calendarTime ), SysTimeFloorMs( SysTimeGetCorrection( calendarTime ) ) );
 }
 
-TimerTime_t SysTimeToMs( SysTime_t sysTime )
+SysTime_t SysTimeGetMcuTime( void )
 {
-    uint32_t seconds;
-    uint32_t subSeconds;
+    SysTime_t calendarTime = { .Seconds = 0, .SubSeconds = 0 };
 
-    RtcBkupRead( &seconds, &subSeconds );
+    calendarTime.Seconds = RtcGetCalendarTime( ( uint16_t* )&calendarTime.SubSeconds );
 
-    SysTime_t deltaTime = { .Seconds = seconds, .SubSeconds = ( int16_t )subSeconds };
+    return calendarTime;
+}
 
-    SysTime_t calendarTime = SysTimeSub( sysTime, deltaTime );
+TimerTime_t SysTimeToMs( SysTime_t sysTime )
+{
+    SysTime_t calendarTime = SysTimeSub( sysTime, SysTimeGetOffset( ) );
+    SysTime_t mcuTime = calendarTime;
 
-    return ( TimerTime_t )( calendarTime.Seconds * 1000 + calendarTime.SubSeconds );
+    // The correction depends on the MCU time to be found. It varies slowly,
+    // two iterations are enough.
+    for( uint8_t i = 0; i < 2; i++ )
+    {
+        mcuTime = SysTimeAddMs( calendarTime, -SysTimeFloorMs( SysTimeGetCorrection( mcuTime ) ) );
+    }
+    return ( TimerTime_t )( mcuTime.Seconds * 1000 + mcuTime.SubSeconds );
 }
 
 SysTime_t SysTimeFromMs( TimerTime_t timeMs )
 {
     uint32_t seconds = timeMs / 1000;
     uint32_t subSeconds = timeMs - seconds * 1000;
-    SysTime_t sysTime = { .Seconds = seconds, .SubSeconds = ( int16_t )subSeconds };
-
-    RtcBkupRead( &seconds, &subSeconds );
-
-    SysTime_t deltaTime = { .Seconds = seconds, .SubSeconds = ( int16_t )subSeconds };
+    SysTime_t mcuTime = { .Seconds = seconds, .SubSeconds = ( int16_t )subSeconds };
 
-    return SysTimeAdd( sysTime, deltaTime );
+    return SysTimeAddMs( SysTimeAdd( mcuTime, SysTimeGetOffset( ) ), SysTimeFloorMs( SysTimeGetCorrection( mcuTime ) ) );
 }
 
 uint32_t SysTimeMkTime( const struct tm* localtime )
@@ -78,6 +78,44 @@ extern "C"
  */
 #define UNIX_GPS_EPOCH_OFFSET                       315964800
 
+/*!
+ * \brief Largest error corrected by slewing the system time [ms]. Larger
+ *        errors are corrected at once by \ref SysTimeSync.
+ */
+#ifndef SYSTIME_SLEW_MAX_ERROR
+#define SYSTIME_SLEW_MAX_ERROR                      10
+#endif
+
+/*!
+ * \brief Rate at which the errors are slewed [ppm]
+ */
+#ifndef SYSTIME_SLEW_RATE
+#define SYSTIME_SLEW_RATE                           1000
+#endif
+
+/*!
+ * \brief Minimum time between two synchronizations to update the drift
+ *        estimate [s]
+ */
+#ifndef SYSTIME_DRIFT_MIN_INTERVAL
+#define SYSTIME_DRIFT_MIN_INTERVAL                  60
+#endif
+
+/*!
+ * \brief Largest drift compensation [ppb]
+ */
+#define SYSTIME_DRIFT_MAX                           200000
+
+/*!
+ * \brief Largest drift estimate error allowed by the accuracy of the
+ *        reference times given to \ref SysTimeSyncCoarse [ppb]. Sets the
+ *        minimum time between two coarse synchronizations to update the
+ *        drift estimate.
+ */
+#ifndef SYSTIME_DRIFT_COARSE_MAX_ERROR
+#define SYSTIME_DRIFT_COARSE_MAX_ERROR              20000
+#endif
+
 /*!
  * \brief Structure holding the system time in seconds and milliseconds.
  */
@@ -110,10 +148,48 @@ SysTime_t SysTimeSub( SysTime_t a, SysTime_t b );
 /*!
  * \brief Sets new system time
  *
+ * \remark The drift estimate is kept. The next \ref SysTimeSync call doesn't
+ *         update it as the accuracy of the given time is unknown.
+ *
  * \param  sysTime    New seconds/sub-seconds since UNIX epoch origin
  */
 void SysTimeSet( SysTime_t sysTime );
 
+/*!
+ * \brief Synchronizes the system time on a reference time
+ *
+ * \remark Errors up to SYSTIME_SLEW_MAX_ERROR are slewed at SYSTIME_SLEW_RATE,
+ *         larger ones are corrected at once. The drift of the MCU clock is
+ *         estimated from the errors measured by successive synchronizations,
+ *         including the corrected ones, and compensated at sub-millisecond
+ *         resolution.
+ *
+ * \param  sysTime    Reference seconds/sub-seconds since UNIX epoch origin
+ */
+void SysTimeSync( SysTime_t sysTime );
+
+/*!
+ * \brief Synchronizes the system time on a reference time of limited
+ *        accuracy, e.g. the 1 second resolution of AppTimeAns
+ *
+ * \remark Errors smaller than the accuracy are ignored. The drift estimate
+ *         is only updated when the time elapsed since the start of the drift
+ *         measurement keeps the accuracies below
+ *         SYSTIME_DRIFT_COARSE_MAX_ERROR of drift. Otherwise behaves as
+ *         \ref SysTimeSync.
+ *
+ * \param  sysTime    Reference seconds/sub-seconds since UNIX epoch origin
+ * \param  accuracy   Accuracy of the reference time [ms]
+ */
+void SysTimeSyncCoarse( SysTime_t sysTime, uint32_t accuracy );
+
+/*!
+ * \brief Gets the drift compensation estimated by \ref SysTimeSync
+ *
+ * \retval drift Drift compensation [ppb]. Positive when the MCU clock is slow
+ */
+int32_t SysTimeGetDrift( void );
+
 /*!
  * \brief Gets current system time
  *
@@ -362,6 +362,16 @@ TimerTime_t TimerGetElapsedTime( TimerTime_t past )
     return RtcTick2Ms( nowInTicks - pastInTicks );
 }
 
+uint32_t TimerGetCurrentTicks( void )
+{
+    return RtcGetTimerValue( );
+}
+
+TimerTime_t TimerTicks2Time( uint32_t ticks )
+{
+    return RtcTick2Ms( ticks );
+}
+
 static void TimerSetTimeout( TimerEvent_t *obj )
 {
     int32_t minTicks= RtcGetMinimumTimeout( );
@@ -134,6 +134,28 @@ TimerTime_t TimerGetCurrentTime( void );
  */
 TimerTime_t TimerGetElapsedTime( TimerTime_t past );
 
+/*!
+ * \brief Reads the current time in RTC ticks
+ *
+ * \remark Cheap enough to timestamp events from an IRQ handler. The tick
+ *         duration depends on the board RTC and is below 1 ms.
+ *
+ * \retval ticks returns current time in RTC ticks
+ */
+uint32_t TimerGetCurrentTicks( void );
+
+/*!
+ * \brief Converts RTC ticks to time
+ *
+ * \remark Converts a timestamp returned by TimerGetCurrentTicks to the
+ *         TimerGetCurrentTime time base, or a difference of timestamps to a
+ *         duration.
+ *
+ * \param [IN] ticks        time in RTC ticks
+ * \retval time             returns time
+ */
+TimerTime_t TimerTicks2Time( uint32_t ticks );
+
 /*!
  * \brief Computes the temperature compensation for a period of time on a
  *        specific temperature.